@@ -90,44 +90,9 @@ static int variance _ANSI_ARGS_((unsigned char *p, int lx));
 
 int temp_sxf, temp_syf, temp_sxb, temp_syb; //Tushar
 
-void set_search_0(void) { //Tushar
-	temp_sxf = temp_syf = temp_sxb = temp_syb = 30;
-	srt_model_choice = 0;
-}
-
-void set_search_1(void) { //Tushar
-	temp_sxf = temp_syf = temp_sxb = temp_syb = 20;
-	srt_model_choice = 1;
-}
-
-void set_search_2(void) { //Tushar
-	temp_sxf = temp_syf = temp_sxb = temp_syb = 15;
-	srt_model_choice = 2;
-}
-
-void set_search_3(void) { //Tushar
-	temp_sxf = temp_syf = temp_sxb = temp_syb = 10;
-	srt_model_choice = 3;
-}
-
-void set_search_4(void) { //Tushar
-	temp_sxf = temp_syf = temp_sxb = temp_syb = 5;
-	srt_model_choice = 4;
-}
-
-void set_search_5(void) { //Tushar
-	temp_sxf = temp_syf = temp_sxb = temp_syb = 2;
-	srt_model_choice = 5;
-}
-
-void set_search_6(void) { //Tushar
-	temp_sxf = temp_syf = temp_sxb = temp_syb = 1;
-	srt_model_choice = 6;
-}
-
-void set_search_7(void) { //Tushar
-	temp_sxf = temp_syf = temp_sxb = temp_syb = 0;
-	srt_model_choice = 7;
+void set_search_window(double search_radius) { //Tushar
+	temp_sxf = temp_syf = temp_sxb = temp_syb = (int)search_radius;
+	srt_model_choice = SRT_MAX_SEARCH_RADIUS - (int)search_radius; //choice index: 0 is the highest feature level
 }
 /*
  * motion estimation for progressive and interlaced frame pictures
@@ -161,15 +126,6 @@ int secondfield,ipflag;
 
 //  opp_frame_enter(frame_name_to_id[fMOTION_EST]); //Tushar
 
-  opp_rebind_func(oc_window_0, set_search_0); //Tushar
-  opp_rebind_func(oc_window_1, set_search_1); //Tushar
-  opp_rebind_func(oc_window_2, set_search_2); //Tushar
-  opp_rebind_func(oc_window_3, set_search_3); //Tushar
-  opp_rebind_func(oc_window_4, set_search_4); //Tushar
-  opp_rebind_func(oc_window_5, set_search_5); //Tushar
-  opp_rebind_func(oc_window_6, set_search_6); //Tushar
-  opp_rebind_func(oc_window_7, set_search_7); //Tushar
-
   opp_execframe_run( execframe_name_to_id[efCHOOSE_SEARCH_WINDOW] ); //Tushar
   sxf = temp_sxf; syf = temp_syf; sxb = temp_sxb; syb = temp_syb; //Tushar
   fprintf(stderr, "SRT: sxf=%d syf=%d sxb=%d syb=%d\n", sxf, syf, sxb, syb); //Tushar
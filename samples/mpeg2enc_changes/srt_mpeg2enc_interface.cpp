@@ -6,15 +6,6 @@
 #include "opp.h"
 #include "opp_debug_control.h"
 
-Opp_Caller oc_window_0;
-Opp_Caller oc_window_1;
-Opp_Caller oc_window_2;
-Opp_Caller oc_window_3;
-Opp_Caller oc_window_4;
-Opp_Caller oc_window_5;
-Opp_Caller oc_window_6;
-Opp_Caller oc_window_7;
-
 int multi_frame_count = 1; //default
 
 void fmain_fractional_enter() {
@@ -108,33 +99,7 @@ void init_srt_interface() {
 	static Opp::Frame f_motion_est;
 	frame_name_to_id[fMOTION_EST] = f_motion_est.id;
 
-	static Opp::Caller window_0;
-	static Opp::Caller window_1;
-	static Opp::Caller window_2;
-	static Opp::Caller window_3;
-	static Opp::Caller window_4;
-	static Opp::Caller window_5;
-	static Opp::Caller window_6;
-	static Opp::Caller window_7;
-
-	oc_window_0 = Opp::get_c_handle_for_caller(&window_0);
-	oc_window_1 = Opp::get_c_handle_for_caller(&window_1);
-	oc_window_2 = Opp::get_c_handle_for_caller(&window_2);
-	oc_window_3 = Opp::get_c_handle_for_caller(&window_3);
-	oc_window_4 = Opp::get_c_handle_for_caller(&window_4);
-	oc_window_5 = Opp::get_c_handle_for_caller(&window_5);
-	oc_window_6 = Opp::get_c_handle_for_caller(&window_6);
-	oc_window_7 = Opp::get_c_handle_for_caller(&window_7);
-
-	std::vector<Opp::Model> vM;
-	vM.push_back( Opp::Model(&window_0) );
-	vM.push_back( Opp::Model(&window_1) );
-	vM.push_back( Opp::Model(&window_2) );
-	vM.push_back( Opp::Model(&window_3) );
-	vM.push_back( Opp::Model(&window_4) );
-	vM.push_back( Opp::Model(&window_5) );
-	vM.push_back( Opp::Model(&window_6) );
-	vM.push_back( Opp::Model(&window_7) );
+	const int max_search_radius = SRT_MAX_SEARCH_RADIUS;
 
 	const char * srt_mode_char = std::getenv("SRT_EXP_MODE");
 	bool bFixedMode = false;
@@ -142,8 +107,10 @@ void init_srt_interface() {
 	if(srt_mode_char != 0) {
 		char mode_char = srt_mode_char[0];
 		if(mode_char >= '0' && mode_char <= '7') {
+			static const int legacy_search_radius[8] = {30, 20, 15, 10, 5, 2, 1, 0};
+				//search radius of the 8 levels previously offered, highest feature level first
 			bFixedMode = true;
-			fixedLevel = mode_char - '0';
+			fixedLevel = max_search_radius - legacy_search_radius[mode_char - '0'];
 		}
 	}
 	std::cout << "Environment variable SRT_EXP_MODE = " << (srt_mode_char != 0 ? srt_mode_char : "") << std::endl;
@@ -183,7 +150,10 @@ void init_srt_interface() {
 	std::cout << "SRT for mpeg2enc ExecFrame: force_fixed_frs_coeff = " << force_fixed_frs_coeff << std::endl;
 
 	////
-	Opp::Model model_choose_search_window(0, vM, fixedLevel, fast_reaction_strategy_coeff);
+	std::vector<Opp::Model> vM;
+	vM.push_back( Opp::Model::integer_knob(0, set_search_window, max_search_radius, 0, fixedLevel, fast_reaction_strategy_coeff) );
+		//search radius in pixels, from max_search_radius down to 0
+	Opp::Model model_choose_search_window(vM);
 
 	static Opp::ExecFrame ef_choose_search_window(model_choose_search_window, stickiness_length);
 	ef_choose_search_window.force_default_selection(bFixedMode);
@@ -20,14 +20,10 @@ typedef enum {
 Opp_FrameID_t frame_name_to_id[FRAME_COUNT];
 Opp_FrameID_t execframe_name_to_id[EXECFRAME_COUNT];
 
-extern Opp_Caller oc_window_0;
-extern Opp_Caller oc_window_1;
-extern Opp_Caller oc_window_2;
-extern Opp_Caller oc_window_3;
-extern Opp_Caller oc_window_4;
-extern Opp_Caller oc_window_5;
-extern Opp_Caller oc_window_6;
-extern Opp_Caller oc_window_7;
+#define SRT_MAX_SEARCH_RADIUS 30
+  /* search radius (pixels) of the highest feature level; the choice index of radius r is SRT_MAX_SEARCH_RADIUS - r */
+
+void set_search_window(double search_radius); //defined in motion.c
 
 void fmain_fractional_enter();
 void fmain_fractional_exit();
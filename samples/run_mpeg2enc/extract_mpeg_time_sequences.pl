@@ -1,5 +1,9 @@
 #!/usr/bin/perl -w
 
+# Prints, per frame: search window choice index (0..30, 0 = 30 pixel radius = highest feature level),
+# rescaled frame time, and its exec-time bin index.
+# The SRT debug output parsed here is printed only with feature_control_debug_message_level(DebugMsgALL).
+
 while(<>) {
 	if(/decision_vector_int_value = (\d+)/) {
 		print $1;
@@ -22,6 +22,39 @@ Opp_ExecTime_t opp_frame_exit_complete(Opp_FrameID_t frame_id)
 Opp_ExecTime_t opp_frame_exit_suspend(Opp_FrameID_t frame_id)
 { return Opp::frame_exit_suspend(frame_id); }
 
+void opp_frame_set_workload_hint(Opp_FrameID_t frame_id, int hint_index, double hint_value)
+{ Opp::frame_set_workload_hint(frame_id, hint_index, hint_value); }
+
+void opp_frame_set_statistics_windows(Opp_FrameID_t frame_id, long long window_length, double window_seconds)
+{ Opp::frame_set_statistics_windows(frame_id, window_length, window_seconds); }
+
+void opp_frame_report_quality(Opp_FrameID_t frame_id, double quality)
+{ Opp::frame_report_quality(frame_id, quality); }
+
+void opp_frame_set_name(Opp_FrameID_t frame_id, const char * name)
+{ Opp::frame_set_name(frame_id, name); }
+
+int opp_snapshot_load(const char * filename)
+{ return Opp::snapshot_load(filename) ? 1 : 0; }
+
+int opp_snapshot_save(const char * filename)
+{ return Opp::snapshot_save(filename) ? 1 : 0; }
+
+void opp_snapshot_set_autosave(const char * filename, int save_period)
+{ Opp::snapshot_set_autosave(filename, save_period); }
+
+int opp_trace_open(const char * filename, long long capacity)
+{ return Opp::trace_open(filename, capacity) ? 1 : 0; }
+
+void opp_trace_close(void)
+{ Opp::trace_close(); }
+
+int opp_stats_page_publish(const char * shm_name, int max_frames)
+{ return Opp::stats_page_publish(shm_name, max_frames) ? 1 : 0; }
+
+void opp_stats_page_unpublish(void)
+{ Opp::stats_page_unpublish(); }
+
 
 void opp_execframe_run(Opp_FrameID_t execframe_id) {
 	if(execframe_id < 0 || execframe_id >= (int)Opp::vBaseFrames.size())
@@ -28,6 +28,26 @@ Opp_ExecTime_t opp_frame_exit_complete(Opp_FrameID_t frame_id);
 
 Opp_ExecTime_t opp_frame_exit_suspend(Opp_FrameID_t frame_id);
 
+void opp_frame_set_workload_hint(Opp_FrameID_t frame_id, int hint_index, double hint_value);
+
+void opp_frame_set_statistics_windows(Opp_FrameID_t frame_id, long long window_length, double window_seconds);
+
+void opp_frame_report_quality(Opp_FrameID_t frame_id, double quality);
+void opp_frame_set_name(Opp_FrameID_t frame_id, const char * name);
+
+//Warm-start snapshots: return 1 on success, 0 on failure
+int opp_snapshot_load(const char * filename);
+int opp_snapshot_save(const char * filename);
+void opp_snapshot_set_autosave(const char * filename, int save_period);
+
+//Post-mortem tracing: returns 1 on success, 0 on failure
+int opp_trace_open(const char * filename, long long capacity);
+void opp_trace_close(void);
+
+//Live statistics in shared memory: returns 1 on success, 0 on failure
+int opp_stats_page_publish(const char * shm_name, int max_frames);
+void opp_stats_page_unpublish(void);
+
 void opp_execframe_run(Opp_FrameID_t execframe_id); //FIXME: return Opp_ExecTime_t
 
 
@@ -65,30 +65,44 @@ namespace Opp {
 	Opp_Caller get_c_handle_for_caller(Caller * caller);
 		//returns a handle so that C code can bind functions to callers
 
+	typedef void (* KnobFunc_f)(double knob_value);
+		//User-defined function that applies the value chosen for a Knob model.
+		//  Bound once when the Knob model is created, and invoked on every run of the ExecFrame.
+
 
 	class Model {
 	public:
 		friend class RunModel;
-		typedef enum {None, Binder, Sequence, Select} ModelType;
+		typedef enum {None, Binder, Sequence, Select, Knob} ModelType;
 
 	private:
 		ModelType _type;
 
 		Caller * caller;                  //defined iff type == Binder
 		std::vector<Model> modelList;     //defined iff type == Sequence OR Select
-		int select_var_id;                //defined iff type == Select
+		int select_var_id;                //defined iff type == Select OR Knob
 		std::vector<int> select_priority; //defined iff type == Select
 			//length of select_priority must be same as modelList. Gives priority for corresponding choice.
 
-		int default_choice_index_for_select_var_id; //defined iff type == Select
-			//Defines a fixed index into modelList. Normally an ExecFrame invoking this model can pick any choice from modelList.
+		int default_choice_index_for_select_var_id; //defined iff type == Select OR Knob
+			//Defines a fixed index into modelList (Knob: into its settings). Normally an ExecFrame invoking this model can pick any choice.
 			// But in a "fixed-choice" mode, the ExecFrame will only pick the choice indexed by default_choice_index_for_select_var_id,
 			//   provided default_choice_index_for_select_var_id != -1.
 
-		double fast_reaction_strategy_coeff; //defined iff type == Select
+		double fast_reaction_strategy_coeff; //defined iff type == Select OR Knob
 			//initial value of coefficient to be used if Fast Reaction Strategy is used
 			// = 0.0 => coefficient not specified
 
+		//defined iff type == Knob
+		KnobFunc_f knob_func;
+		double knob_highest_feature_value;  //value applied for setting index 0
+		double knob_lowest_feature_value;   //value applied for setting index knob_num_settings-1
+		int knob_num_settings;
+			//Settings are evenly spaced from knob_highest_feature_value to knob_lowest_feature_value, in decreasing priority.
+		bool knob_is_continuous;
+			//true => the Fast Reaction Strategy applies values between settings as well (settings only serve as
+			//  the resolution of statistics); false => the value of the nearest setting is applied
+
 	public:
 		//NOP model (do nothing)
 		Model()
@@ -114,32 +128,70 @@ namespace Opp {
 				default_choice_index_for_select_var_id(default_choice_index_for_select_var_id), fast_reaction_strategy_coeff(fast_reaction_strategy_coeff)
 		{ assert(select_priority.size() == modelList.size()); }
 
+		//Knob over the integer range [highest_feature_value .. lowest_feature_value] (either may be the larger one),
+		//  with one setting per integer. E.g., integer_knob(0, set_search_radius, 30, 0) for search radius 30 down to 0 pixels.
+		static Model integer_knob(int select_var_id, KnobFunc_f knob_func, int highest_feature_value, int lowest_feature_value,
+			int default_choice_index_for_select_var_id = -1, double fast_reaction_strategy_coeff = 0.0)
+		{
+			int num_settings = (highest_feature_value >= lowest_feature_value
+									? highest_feature_value - lowest_feature_value : lowest_feature_value - highest_feature_value) + 1;
+			return Model(select_var_id, knob_func, highest_feature_value, lowest_feature_value, num_settings, false,
+				default_choice_index_for_select_var_id, fast_reaction_strategy_coeff);
+		}
+
+		//Knob over the continuous interval [highest_feature_value, lowest_feature_value]. Statistics are kept for
+		//  num_settings evenly spaced settings, which also give the unit of fast_reaction_strategy_coeff.
+		static Model continuous_knob(int select_var_id, KnobFunc_f knob_func, double highest_feature_value, double lowest_feature_value,
+			int num_settings = 101, int default_choice_index_for_select_var_id = -1, double fast_reaction_strategy_coeff = 0.0)
+		{
+			return Model(select_var_id, knob_func, highest_feature_value, lowest_feature_value, num_settings, true,
+				default_choice_index_for_select_var_id, fast_reaction_strategy_coeff);
+		}
+
 		ModelType type() const { return _type; }
 
+		int get_num_choices() const {
+			assert(_type == Select || _type == Knob);
+			return (_type == Select ? (int)modelList.size() : knob_num_settings);
+		}
+
+		double get_knob_value(double setting_position) const;
+			//value applied by a Knob model at (fractional, if knob_is_continuous) setting index setting_position
+
 		std::vector<Model>& access_modelList() {
 			assert(_type == Sequence || _type == Select);
 			return modelList;
 		}
 
 		int& access_select_var_id() {
-			assert(_type == Select);
+			assert(_type == Select || _type == Knob);
 			return select_var_id;
 		}
 
 		std::vector<int>& access_select_priority() {
-			assert(_type == Select);
+			assert(_type == Select || _type == Knob);
 			return select_priority;
 		}
 
 		int& access_default_choice_index_for_select_var_id() {
-			assert(_type == Select);
+			assert(_type == Select || _type == Knob);
 			return default_choice_index_for_select_var_id;
 		}
 
 		double& access_fast_reaction_strategy_coeff() {
-			assert(_type == Select);
+			assert(_type == Select || _type == Knob);
 			return fast_reaction_strategy_coeff;
 		}
+
+	private:
+		//Knob Model (use integer_knob() or continuous_knob())
+		Model(int select_var_id, KnobFunc_f knob_func, double highest_feature_value, double lowest_feature_value, int num_settings, bool bContinuous,
+				int default_choice_index_for_select_var_id, double fast_reaction_strategy_coeff)
+			: _type(Knob), caller(0), select_var_id(select_var_id),
+				default_choice_index_for_select_var_id(default_choice_index_for_select_var_id), fast_reaction_strategy_coeff(fast_reaction_strategy_coeff),
+				knob_func(knob_func), knob_highest_feature_value(highest_feature_value), knob_lowest_feature_value(lowest_feature_value),
+				knob_num_settings(num_settings), knob_is_continuous(bContinuous)
+		{ assert(knob_func != 0 && num_settings > 0); }
 	};
 
 
@@ -161,6 +213,11 @@ namespace Opp {
 	//  that may get invoked within the current invocation of the constructed Frame (i.e. the
 	//  Frame with which this Constraint is associated).
 	//
+	//  The Constraint is enforced on each ExecFrame run within the Frame: decision-vectors for which
+	//  it evaluates to false are never executed. Clauses relating VIDs that are not decided by the same
+	//  ExecFrame evaluate to Unknown, and do not restrict decisions. VIDs are compared by the choice index
+	//  of their Model (for a Knob, the index of the setting, 0 being the highest feature setting).
+	//
 	//   ASSUMPTION: Specified constraints should not be unsatisfiable. Unsatisfiable
 	//     constraints will not be found to be so until evaluated on VIDs that relate to
 	//     the unsatisfiability.
@@ -172,8 +229,6 @@ namespace Opp {
 	//         is unsatisfiable when x = 0, but will evaluate to Unknown until y = 0 or 1.
 	//
 	class Constraint {
-		friend class ConstraintStructure;
-		friend class ConstraintVerifier;
 	public:
 		//post-dependence: can be best-effort or required (FIXME: incorporate, maybe??)
 
@@ -259,12 +314,13 @@ namespace Opp {
 	public:
 		const bool isDefined;
 
-		typedef enum {ObjABSOLUTE, ObjRELATIVE} Type_t;
+		typedef enum {ObjABSOLUTE, ObjRELATIVE, ObjBUDGET_SHARE, ObjQUALITY_FLOOR} Type_t;
 		Type_t type;
 
-		//defined iff type == ObjRELATIVE
+		//defined iff type == ObjRELATIVE or ObjBUDGET_SHARE
 		FrameID_t reference_frame_id;    //frame whose objective mean serves as reference value
 		double relative_mean_frac;       //gives what fraction of the reference value is to be used as current objective mean
+		                                 //  (ObjBUDGET_SHARE: only until the frames sharing the budget have learned their costs)
 
 
 		ExecTime_t mean;                 //must be provided for type == ObjABSOLUTE, else it is calculated using
@@ -281,6 +337,27 @@ namespace Opp {
 
 		ImpactRescaler_f impact_rescaler;
 
+		typedef enum {EnfPER_FRAME, EnfQUANTILE, EnfWINDOW_FRACTION} Enforcement_t;
+		Enforcement_t enforcement;
+			//EnfPER_FRAME: each invocation is steered into the window; prob is not enforced.
+			//EnfQUANTILE: the prob-quantile of execution time must not exceed mean
+			//  (window_frac_upper = 0.0; window_frac_lower gives the tolerated slack below mean).
+			//EnfWINDOW_FRACTION: atleast a prob fraction of invocations must lie within the window.
+			//For EnfQUANTILE and EnfWINDOW_FRACTION the controller steers on quantiles of execution time
+			//  estimated over approximately the last enforcement_window_length invocations, rather than
+			//  on individual invocations.
+
+		int enforcement_window_length;
+			//defined iff enforcement != EnfPER_FRAME
+
+		//defined iff type == ObjQUALITY_FLOOR (mean, window and enforcement do not apply)
+		double min_quality;
+			//quality (as reported with frame_report_quality()) that must be reached with probability prob
+		typedef enum {CostEXEC_TIME, CostCPU_TIME} Cost_t;
+		Cost_t cost;
+			//measure of an invocation's cost to be minimized: CostEXEC_TIME is wall-clock time spent in the frame
+			//  (as for the other objective types), CostCPU_TIME the CPU time consumed by the frame's thread in it
+
 		Objective()
 			: isDefined(false) { }
 
@@ -288,13 +365,64 @@ namespace Opp {
 			: isDefined(true), type(ObjABSOLUTE),
 				reference_frame_id(-1), relative_mean_frac(0.0),
 				mean(mean), window_frac_lower(window_frac_lower), window_frac_upper(window_frac_upper), prob(prob),
-				sliding_window_size(sliding_window_size), impact_rescaler(impact_rescaler) { }
+				sliding_window_size(sliding_window_size), impact_rescaler(impact_rescaler),
+				enforcement(EnfPER_FRAME), enforcement_window_length(0),
+				min_quality(0.0), cost(CostEXEC_TIME) { }
 
 		Objective(FrameID_t reference_frame_id, double relative_mean_frac, double window_frac_lower, double window_frac_upper, double prob, int sliding_window_size = 1, ImpactRescaler_f impact_rescaler = 0)
 			: isDefined(true), type(ObjRELATIVE),
 				reference_frame_id(reference_frame_id), relative_mean_frac(relative_mean_frac),
 				mean(0.0), window_frac_lower(window_frac_lower), window_frac_upper(window_frac_upper), prob(prob),
-				sliding_window_size(sliding_window_size), impact_rescaler(impact_rescaler) { }
+				sliding_window_size(sliding_window_size), impact_rescaler(impact_rescaler),
+				enforcement(EnfPER_FRAME), enforcement_window_length(0),
+				min_quality(0.0), cost(CostEXEC_TIME) { }
+
+		//"prob-quantile of execution time <= quantile_bound", e.g., quantile(0.033, 0.99) for p99 <= 33ms.
+		//  Execution times down to (1 - slack_frac_lower) * quantile_bound at the quantile are tolerated.
+		static Objective quantile(ExecTime_t quantile_bound, double prob, double slack_frac_lower = 0.1,
+			int enforcement_window_length = 1000, int sliding_window_size = 1, ImpactRescaler_f impact_rescaler = 0)
+		{
+			Objective obj(quantile_bound, slack_frac_lower, 0.0, prob, sliding_window_size, impact_rescaler);
+			obj.enforcement = EnfQUANTILE;
+			obj.enforcement_window_length = enforcement_window_length;
+			return obj;
+		}
+
+		//Mean re-apportioned on every invocation from the current objective mean of budget_frame_id (typically the
+		//  enclosing frame), among all frames with an ObjBUDGET_SHARE objective on the same budget_frame_id. Frames
+		//  that can buy more feature-level per unit of execution time (as learned for the ExecFrames they run)
+		//  receive a larger share of what remains after every sharing frame is given its lowest-feature cost.
+		static Objective budget_share(FrameID_t budget_frame_id, double initial_share_frac, double window_frac_lower, double window_frac_upper, double prob,
+			int sliding_window_size = 1, ImpactRescaler_f impact_rescaler = 0)
+		{
+			Objective obj(budget_frame_id, initial_share_frac, window_frac_lower, window_frac_upper, prob, sliding_window_size, impact_rescaler);
+			obj.type = ObjBUDGET_SHARE;
+			return obj;
+		}
+
+		//"atleast prob fraction of the last enforcement_window_length invocations lie within the window"
+		static Objective window_fraction(ExecTime_t mean, double window_frac_lower, double window_frac_upper, double prob,
+			int enforcement_window_length = 100, int sliding_window_size = 1, ImpactRescaler_f impact_rescaler = 0)
+		{
+			Objective obj(mean, window_frac_lower, window_frac_upper, prob, sliding_window_size, impact_rescaler);
+			obj.enforcement = EnfWINDOW_FRACTION;
+			obj.enforcement_window_length = enforcement_window_length;
+			return obj;
+		}
+
+		//Inverse objective: "reported quality >= min_quality with probability atleast prob, at the lowest cost".
+		//  The frame places no bound on its execution time; the decisions of ExecFrames run within it are instead
+		//  steered to the cheapest decision-vectors (as measured by cost) that are learned to keep the quality
+		//  reported for the frame's invocations (frame_report_quality()) above the floor.
+		//  Each reported quality counts as one trial of meeting the floor.
+		static Objective quality_floor(double min_quality, double prob = 0.9, Cost_t cost = CostEXEC_TIME)
+		{
+			Objective obj(0.0, 0.0, 0.0, prob);
+			obj.type = ObjQUALITY_FLOOR;
+			obj.min_quality = min_quality;
+			obj.cost = cost;
+			return obj;
+		}
 
 	};
 
@@ -316,6 +444,8 @@ namespace Opp {
 		virtual inline Type_t get_type() = 0;
 
 		const FrameID_t id; //uniquely assigned ID, assigned automatically
+
+		std::string name; //stable user-supplied name, empty if none (see frame_set_name())
 	};
 
 	class FrameInfo;
@@ -413,6 +543,85 @@ namespace Opp {
 	bool is_frame_executing(FrameID_t frame_id);
 		//returns true if executing, false if inactive or unallocated
 
+	//Feed-forward workload hints
+	void frame_set_workload_hint(FrameID_t frame_id, int hint_index, double hint_value);
+		//Attach a numeric hint describing the workload of the frame's current invocation, or of its next
+		//  invocation if the frame is Inactive (e.g., I/P/B picture-type, motion magnitude, number of tracked objects).
+		//Hints must be set before the ExecFrames within the frame are run in order to influence their choices.
+		//
+		//Hints are retained across invocations until changed. Hint indices not set are taken to be 0.0.
+		//The Fast Reaction Strategy learns how the hints affect the frame's execution time and
+		//  adjusts choices proactively (see feature_control_workload_hint_feedforward()).
+
+	void frame_clear_workload_hints(FrameID_t frame_id);
+		//Removes all hints from the frame
+
+	//Recent statistics
+	void frame_set_statistics_windows(FrameID_t frame_id, long long window_length, double window_seconds = 0.0);
+		//Maintain FrameStatistics::window_by_count over the last window_length completed invocations of the frame (0 = not
+		//  maintained), and FrameStatistics::window_by_time over its invocations completed in the last window_seconds
+		//  (0.0 = not maintained): percentiles of execution-time and of frame-to-frame jitter, and satisfaction ratio,
+		//  so that recent misbehaviour is not hidden by a long history. Restarts the windows.
+
+	//Measured quality feedback
+	void frame_report_quality(FrameID_t frame_id, double quality);
+		//Report the quality achieved by the frame's current invocation, or by its last completed invocation if
+		//  the frame is Inactive (e.g., PSNR of the encoded picture, tracking accuracy). Higher is better.
+		//
+		//The Thompson Sampling Strategy learns the expected quality of each decision of the ExecFrames
+		//  run directly within the frame, and maximizes it subject to the frame's Objective, using the
+		//  priorities of the choices only as a prior (see feature_control_quality_feedback()). Only that strategy
+		//  reads the reports: it must be enabled with feature_control_use_thompson_sampling_strategy(true), and
+		//  the Fast Reaction Strategy disabled, for the reports to affect the decisions of such frames (the Fast
+		//  Reaction and Reinforcement Learning strategies rank choices by their priorities alone).
+		//For a frame with an Objective::quality_floor(), the reported qualities instead decide whether the floor
+		//  was met, and the ExecFrames' decisions are steered by the Thompson Sampling Strategy regardless
+		//  of the strategy selected.
+
+	//Warm-start from learned state saved by a previous run
+	void frame_set_name(FrameID_t frame_id, const std::string& name);
+		//Name a Frame or ExecFrame stably across runs of the application (unlike its FrameID, which depends on
+		//  the order of construction). Names must be unique and non-empty. Only the state of named Frames,
+		//  as learned about named Frames and ExecFrames run within them, is saved and restored.
+		//Must be set before the Frame is first entered (or the ExecFrame first run) for its state to be restored.
+
+	bool snapshot_load(const std::string& filename);
+		//Read the learned state saved by snapshot_save(), to be restored into the named Frames as they are first
+		//  used, so that they start at the operating point of the saved run rather than at the most complex choices.
+		//Returns false, loading nothing, if the file does not exist or is not a snapshot of the current version.
+
+	bool snapshot_save(const std::string& filename);
+		//Write the learned state of all named Frames (replacing filename atomically). State loaded by
+		//  snapshot_load() for frames not used in the current run is written back as is.
+		//Returns false if the file could not be written.
+
+	void snapshot_set_autosave(const std::string& filename, int save_period = 0);
+		//snapshot_save(filename) at program exit, and if save_period > 0, also after every save_period
+		//  completions of top-level frames. Frames destructed before exit are not saved at exit.
+
+	//Post-mortem tracing
+	bool trace_open(const std::string& filename, long long capacity = 1 << 20);
+		//Record every executing segment of a Frame, every completed Frame invocation and every ExecFrame run (timing,
+		//  decision, objective outcome and controller state) as a fixed-size binary record into filename, a memory-mapped
+		//  ring buffer retaining the last capacity records (80 bytes each). Recording takes no system calls, and happens
+		//  after the segment, invocation or run it describes has been timed. See opp_trace.h for the file format and
+		//  TraceReader, and opp_trace_export.exe to view a trace as a timeline in chrome://tracing or the Perfetto UI.
+		//Replaces any trace already open. Returns false if filename could not be created and mapped.
+
+	void trace_close();
+		//Stop recording, and flush the trace file
+
+	//Live statistics for external monitoring
+	bool stats_page_publish(const std::string& shm_name, int max_frames = 64);
+		//Publish counters of up to max_frames Frames into the POSIX shared-memory segment shm_name (e.g. "/mpeg2enc_srt"),
+		//  updated by plain stores as Frames complete and ExecFrames run: invocation count, satisfaction ratio, mean and
+		//  variance of execution-time, failure runlength histograms, and the decision-vector and Fast Reaction Strategy
+		//  coefficients of the last ExecFrame run within each Frame. See opp_stats_page.h for the layout and StatsPageReader.
+		//Replaces any page already published. Returns false if the segment could not be created and mapped.
+
+	void stats_page_unpublish();
+		//Stop publishing, and remove the segment
+
 	
 
 
@@ -447,6 +656,32 @@ namespace Opp {
 			//User must ensure that all Callers' likely to be invoked have been rebound
 			//  to uninvoked Funcs, before each invocation to run()
 
+		void run_batch(long long num_items);
+			//A run() whose bound Funcs each process a batch of num_items (>= 1) work items, e.g. rows of macroblocks:
+			//  one decision is made and timed for the whole batch, instead of one per item. The decision weighs in the
+			//  enclosing Frames' statistics as a single run; its cost per item is learned by the ExecFrame's decision model
+			//  (steering pace()) and reported by ExecFrameStatistics.
+
+		void pace(long long items_remaining, ExecTime_t deadline, long long check_period = 1);
+			//Pacing mode, for the current invocation of the enclosing Frame: items_remaining work items remain to be run
+			//  by this ExecFrame (e.g., by run_batch() over every K items), and must complete by the time the Frame's
+			//  invocation has executed for deadline seconds. At the first run, and then at the first run after every
+			//  check_period (>= 1) items, the actual progress (the Frame's execution-time so far) is compared with the
+			//  planned one (an even share of deadline per item), and the decision-vector is shifted up or down to the highest
+			//  feature level whose recent cost per item (see ExecFrameStatistics::map_decision_to_item_cost) fits the time
+			//  left per remaining item, or the cheapest one measured if none fits; the runs in between keep it.
+			//  Mispredictions are thus absorbed by the items late in the invocation. The decision strategies learn from
+			//  the paced decision-vectors, as run, in place of their own choices.
+			//  Pacing ends once the items have run, with the Frame's invocation, or by pace(0, ...).
+
+		const std::vector<int>& run_begin();
+		void run_end(long long num_items = 1);
+			//A run() split around the user-code, for ExecFrames that dispatch their choices themselves rather than through
+			//  the Model's Callers (e.g., StaticSelect, see opp_static_select.h). run_begin() makes the decision and returns
+			//  the chosen value of each decision variable, in the order the variables are found in the Model (breadth-first);
+			//  the caller then runs the corresponding user-code and calls run_end(), which measures and learns as run() does
+			//  (as run_batch() does, for user-code that processed num_items work items).
+
 		void force_default_selection(bool bEnable);
 			//Turn on (true) or turn off (false) the picking of default model-choices.
 			//  If the model run by this ExecFrame contains Select models with default_choice_index_for_select_var_id != -1
@@ -459,6 +694,15 @@ namespace Opp {
 			//   otherwise, fast_reaction_strategy_coeff only provides the initial coefficient which can then be rescaled
 			//   (see description of Model for details).
 
+		void calibrate(int num_calibration_invocations);
+			//Spend the first num_calibration_invocations invocations of each enclosing Frame (with a mean-objective) measuring
+			//  the cost of this ExecFrame's choices, before the decision strategy takes over (0 = off, the default).
+			//  Each variable is swept from its cheapest choice towards its most complex one, with the other variables held
+			//  at their cheapest, until the Frame's execution-time exceeds the objective's upper tolerance.
+			//  The measured per-choice cost curve initializes the Fast Reaction Strategy's coefficients, replacing any
+			//  fast_reaction_strategy_coeff guess, and the measurements are learned by the other strategies as usual.
+			//  Must be set before the first run(). Skipped for state restored by snapshot_load().
+
 	private:
 		ExecFrameInfo * execframe_info;
 	};
@@ -467,13 +711,115 @@ namespace Opp {
 
 	////////// Collect Statistics ///////////
 	
+	// LatencyHistogram: fixed-memory, log-linear histogram of execution-times (in the style of HdrHistogram).
+	//   Values are counted in nanoseconds, exactly below 256 ns, and beyond that in buckets of one power of two
+	//   each split into 128 linear sub-buckets, i.e. with a relative error below 1/128 (< 0.8%). Values beyond
+	//   2^40 ns (about 18 minutes) are counted as 2^40 ns. Recording is O(1), and histograms (e.g. copies taken
+	//   at different times, or of different Frames) merge by adding counts. Removing recorded values is O(1)
+	//   as well, for histograms of sliding windows.
+	class LatencyHistogram {
+	public:
+		static const int sub_bucket_half_count_magnitude = 7;
+		static const int sub_bucket_half_count = 1 << sub_bucket_half_count_magnitude;
+		static const int bucket_count = 33;
+			//bucket b (b >= 1) spans [2^(b+7), 2^(b+8)) ns, bucket 0 spans [0, 256) ns
+		static const int counts_length = (bucket_count + 1) * sub_bucket_half_count;
+		static const long long highest_trackable_ns = (256LL << (bucket_count - 1)) - 1;
+
+	private:
+		std::vector<long long> vCounts;
+			//indexed by get_counts_index(), empty until the first value is recorded
+		long long total_count;
+		long long min_ns;
+		long long max_ns;
+		bool bExactExtremes;
+			//false once values have been removed: min and max are then found from the counts
+		double sum_ns;
+
+	public:
+		LatencyHistogram()
+		{ reset(); }
+
+		void reset();
+
+		void record(ExecTime_t exec_time); //in seconds
+		void record_ns(long long exec_time_ns);
+
+		void unrecord(ExecTime_t exec_time);
+		void unrecord_ns(long long exec_time_ns);
+			//Remove a value recorded earlier. Min and max are then reported to within the histogram's precision.
+
+		void merge(const LatencyHistogram& other);
+
+		long long get_total_count() const
+			{ return total_count; }
+
+		//in seconds, 0.0 if no values recorded
+		ExecTime_t get_min() const;
+		ExecTime_t get_max() const;
+		ExecTime_t get_mean() const;
+
+		ExecTime_t get_value_at_percentile(double percentile) const;
+			//Smallest recorded value (to within the histogram's precision) that is >= percentile % of recorded values,
+			//  for percentile in [0, 100]. Reported as the highest value of its sub-bucket. 0.0 if no values recorded.
+
+		double get_fraction_at_or_below(ExecTime_t exec_time) const;
+			//fraction of recorded values <= exec_time (to within the histogram's precision), 0.0 if no values recorded
+
+		std::string print_string() const;
+
+		static int get_counts_index(long long value_ns);
+		static long long get_lowest_value_at_index(int counts_index);
+		static long long get_highest_value_at_index(int counts_index);
+	};
+
+	// FrameWindowStatistics: statistics of the invocations of a Frame completed within a sliding window, either the last
+	//   window_length invocations (window by count) or those completed in the last window_seconds (window by time).
+	//   Maintained incrementally as invocations complete, in O(1) time per invocation (amortized, for windows by time).
+	//   Invocations that have aged out of a window by time are also dropped when FrameStatistics::refresh() reads it.
+	class FrameWindowStatistics {
+	public:
+		long long window_length; //window by count, else 0
+		double window_seconds;   //window by time, else 0.0
+
+		LatencyHistogram exec_time_histogram;
+			//measured execution-times of the invocations in the window
+		LatencyHistogram jitter_histogram;
+			//frame-to-frame jitter of the invocations in the window: |execution-time - execution-time of the previous invocation|
+		long long satisfied_count;
+			//invocations in the window whose (rescaled, sliding-window averaged) execution-time met the Frame's mean objective
+
+		FrameWindowStatistics()
+			: window_length(0), window_seconds(0.0), satisfied_count(0)
+		{ }
+
+		bool is_maintained() const
+			{ return window_length > 0 || window_seconds > 0.0; }
+
+		long long get_count() const
+			{ return exec_time_histogram.get_total_count(); }
+
+		double get_satisfaction_ratio() const
+			{ return get_count() > 0 ? satisfied_count / (double)get_count() : 0.0; }
+
+		ExecTime_t get_exec_time_percentile(double percentile) const
+			{ return exec_time_histogram.get_value_at_percentile(percentile); }
+
+		ExecTime_t get_jitter_percentile(double percentile) const
+			{ return jitter_histogram.get_value_at_percentile(percentile); }
+
+		std::string print_string() const;
+	};
+
 	class FrameStatistics {
 	public:
 		const FrameID_t frame_id;
 
 		FrameStatistics(FrameID_t frame_to_track)
 			: frame_id(frame_to_track),
-			satisfaction_ratio_wrt_specified_objective(0.0), satisfaction_ratio_wrt_active_objective(0.0)
+			satisfaction_ratio_wrt_specified_objective(0.0), satisfaction_ratio_wrt_active_objective(0.0),
+			enforced_objective_measure(0.0), satisfaction_ratio_wrt_enforced_objective(0.0),
+			controller_overhead_total(0.0), controller_overhead_per_invocation(0.0), controller_overhead_fraction(0.0)
 		{ }
 
 		FrameStatistics& refresh();
@@ -518,12 +864,52 @@ namespace Opp {
 		std::vector<long long> vFailure_Runlengths_wrt_active_objective;
 			//Element at index 'i' captures the number of runs-of-continuous-failures of lengths in interval (2^(i-1), 2^i]
 			// where the failures were w.r.t. achieving the active objective.
+
+
+		//Following are empty or 0.0 unless the Frame's Objective is a quantile or window-fraction objective
+		//  (see Objective::Enforcement_t)
+		std::vector<double> vExecTime_quantile_probs;
+		std::vector<ExecTime_t> vExecTime_quantiles;
+			//Quantiles of execution-time tracked over approximately the last enforcement_window_length invocations
+
+		double enforced_objective_measure;
+			//Current estimate of the prob-quantile (EnfQUANTILE) or of the fraction of invocations within the window (EnfWINDOW_FRACTION)
+
+		double satisfaction_ratio_wrt_enforced_objective;
+			//Fraction of invocations, after the estimates became available, at completion of which the enforced objective held
+
+
+		LatencyHistogram exec_time_histogram;
+			//High-resolution histogram of the (measured, not rescaled) execution-times of all completed invocations
+			//  of the Frame from program start. Snapshots from successive refresh() calls or of different Frames
+			//  can be combined with LatencyHistogram::merge().
+
+		ExecTime_t get_exec_time_percentile(double percentile) const
+			{ return exec_time_histogram.get_value_at_percentile(percentile); }
+
+
+		ExecTime_t controller_overhead_total;
+			//Time spent in the library during all completed invocations of the Frame, in seconds: its frame_enter(),
+			//  frame_exit_*() calls, the decisions of ExecFrames run within it, and the completion of contained Frames.
+			//  Subtracted from the measured execution-times if feature_query_subtract_controller_overhead().
+
+		ExecTime_t controller_overhead_per_invocation;
+			//controller_overhead_total averaged over completed invocations
+
+		double controller_overhead_fraction;
+			//controller_overhead_total relative to the total execution-time of completed invocations, overhead included
+
+
+		FrameWindowStatistics window_by_count;
+		FrameWindowStatistics window_by_time;
+			//Recent invocations only, as configured by frame_set_statistics_windows() (not maintained by default)
 	};
 
 	class ExecTime_vs_ModelDecision_Distribution {
 	public:
 		std::vector<ExecTime_t> vExecTime_bin_centers;
-		std::vector<int> vModelChoices;
+		std::vector<long long> vModelChoices;
+			//decision-vector int values, as keyed by the ExecFrame
 
 		std::vector< std::vector<double> > vvCounts;
 			//Table: (i, j) entry gives the occurence-count of choice vModelChoices[j] under execution-bin vExecTime_bin_centers[i]
@@ -534,7 +920,7 @@ namespace Opp {
 		const FrameID_t execframe_id;
 
 		ExecFrameStatistics(FrameID_t execframe_to_track)
-			: execframe_id(execframe_to_track) { }
+			: execframe_id(execframe_to_track), run_count(0), item_count(0), run_time_total(0.0), item_cost(0.0) { }
 
 		ExecFrameStatistics& refresh();
 			//Refreshes variables below with current statistics.
@@ -550,6 +936,17 @@ namespace Opp {
 
 		std::map<FrameID_t, ExecTime_vs_ModelDecision_Distribution> map_tracking_frame_to_exectime_distribution;
 			//for each tracking frame in vTracking_FrameIDs, gives the corresponding correlation of model-choices with execution-times of that frame
+
+		long long run_count;
+		long long item_count;
+			//work items over all runs (see ExecFrame::run_batch()), = run_count unless runs are batched
+		ExecTime_t run_time_total;
+			//measured execution-time of the user-code over all runs, excluding the controller's overhead
+		ExecTime_t item_cost;
+			//run_time_total / item_count
+		std::map<long long, ExecTime_t> map_decision_to_item_cost;
+			//recent item_cost of each decision-vector run so far (keyed as ExecTime_vs_ModelDecision_Distribution::vModelChoices):
+			//  an exponentially weighted moving average over its runs, which pace() steers by
 	};
 
 
@@ -3,6 +3,8 @@
 // Author: Tushar Kumar, tushardeveloper@gmail.com
 
 #include <vector>
+#include <iostream>
+#include <cstdlib>
 
 #include "opp.h"
 #include "opp_baseframe.h"
@@ -24,4 +26,21 @@ BaseFrame::~BaseFrame()
 	vBaseFrames.at(id) = 0;
 }
 
+void frame_set_name(FrameID_t frame_id, const std::string& name) {
+	assert(frame_id >= 0 && frame_id < (FrameID_t)vBaseFrames.size() && vBaseFrames[frame_id] != 0);
+
+	if(name.empty()) {
+		std::cerr << "frame_set_name(): ERROR: empty name for frame_id = " << frame_id << std::endl;
+		exit(1);
+	}
+	for(int i=0; i<(int)vBaseFrames.size(); i++) {
+		if(i != frame_id && vBaseFrames[i] != 0 && vBaseFrames[i]->name == name) {
+			std::cerr << "frame_set_name(): ERROR: name '" << name << "' for frame_id = " << frame_id
+				<< " already taken by frame_id = " << i << std::endl;
+			exit(1);
+		}
+	}
+	vBaseFrames[frame_id]->name = name;
+}
+
 } //namespace Opp
@@ -0,0 +1,478 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+// opp_bench: microbenchmarks of the library's hot primitives, for comparing library versions.
+//
+// Build: make bench, with the CFLAGS of the library build being measured (e.g. make clean bench CFLAGS="-O2")
+//
+// Usage: opp_bench.exe [-min_time seconds] [-filter substring]
+//   -min_time s     minimum measured time per benchmark, split over 5 repetitions (default 0.5)
+//   -filter str     only run benchmarks whose name contains str
+//
+// Prints one tab-separated line per benchmark (after '#' comment lines describing the run):
+//   benchmark  params  iterations  ns_per_op  allocs_per_op  instructions_per_op
+// ns_per_op and instructions_per_op are the lowest over the repetitions, allocs_per_op the average over all of
+//   them (operator new calls). instructions_per_op is NA where hardware performance counters are unavailable.
+//   Diff the outputs of two library versions to compare them.
+//
+// Benchmarks:
+//   frame_enter_exit_complete  depth=d        enter d nested Frames (with mean objectives), complete them innermost first
+//   execframe_run_in_frame     knobs=k,...    one invocation of a Frame running an ExecFrame of k 4-setting Knobs once
+//   select_run_in_frame        dispatch=d     one invocation of a Frame running a 4-alternative Select 16 times, as an
+//                                             ExecFrame with rebound Callers (dynamic) or a StaticSelect (static)
+//   items_run_in_frame         runs=r         one invocation of a Frame processing 256 items with a 4-alternative Select:
+//                                             a StaticSelect run per item (r=256), or StaticBatchSelect batches (r=1,16)
+//   intvaluecache_note_sample  tags=n         IntValueCache::note_sample() on 10 entries, cycling over n tags (n > 10 evicts)
+//   spread_bin_absolute        -              ExecutionTimeSpread_Absolute::get_spread_bin_index()
+//   spread_bin_center_absolute -              ExecutionTimeSpread_Absolute::get_exec_time_for_index()
+//   spread_bin_mean_relative   -              ExecutionTimeSpread_MeanRelative::get_spread_bin_index()
+//   get_decision_sets_for_parameter  -        decision sets of a 16-setting Knob, within its (trained) Frame
+//   caller_rebind              -              Caller::rebind() to a new OPP_FUNC_HANDLE()
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <new>
+#include <cstdlib>
+#include <cstring>
+
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "opp.h"
+#include "opp_debug_control.h"
+#include "opp_frame_info.h"
+#include "opp_execframe.h"
+#include "opp_decision_model.h"
+#include "opp_parameter_spread.h"
+#include "opp_exec_time_measure.h"
+#include "opp_static_select.h"
+#include "opp_srt_version.h"
+
+using namespace Opp;
+
+
+/////////////////////////////
+// Allocation counting
+/////////////////////////////
+
+static long long allocation_count = 0;
+
+void * operator new(size_t size) {
+	allocation_count++;
+	void * p = malloc(size == 0 ? 1 : size);
+	if(p == 0)
+		throw std::bad_alloc();
+	return p;
+}
+
+void * operator new[](size_t size) {
+	allocation_count++;
+	void * p = malloc(size == 0 ? 1 : size);
+	if(p == 0)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void * p) throw() { free(p); }
+void operator delete[](void * p) throw() { free(p); }
+
+
+/////////////////////////////
+// Instruction counting
+/////////////////////////////
+
+static int instructions_fd = -1; //-1 if unavailable
+
+static void open_instruction_counter() {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.size = sizeof(attr);
+	attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	instructions_fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void start_instruction_counter() {
+	if(instructions_fd == -1)
+		return;
+	ioctl(instructions_fd, PERF_EVENT_IOC_RESET, 0);
+	ioctl(instructions_fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+static long long stop_instruction_counter() {
+	if(instructions_fd == -1)
+		return -1;
+	ioctl(instructions_fd, PERF_EVENT_IOC_DISABLE, 0);
+	long long count = 0;
+	if(read(instructions_fd, &count, sizeof(count)) != sizeof(count))
+		return -1;
+	return count;
+}
+
+
+/////////////////////////////
+// Harness
+/////////////////////////////
+
+typedef void (* BenchOp_f)(long long iterations);
+	//performs iterations operations
+
+static double min_time = 0.5;
+static std::string name_filter;
+static const int num_repetitions = 5;
+
+static double get_monotonic_ns() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1.0e9 + ts.tv_nsec;
+}
+
+static bool is_selected(const std::string& name) {
+	return name_filter.empty() || name.find(name_filter) != std::string::npos;
+}
+
+static void run_benchmark(const std::string& name, const std::string& params, BenchOp_f op) {
+	//calibrate: double iterations until a repetition takes its share of min_time
+	long long iterations = 1;
+	double target_ns = min_time * 1.0e9 / num_repetitions;
+	while(true) {
+		double start_ns = get_monotonic_ns();
+		op(iterations);
+		if(get_monotonic_ns() - start_ns >= target_ns || iterations >= (1LL << 40))
+			break;
+		iterations *= 2;
+	}
+
+	double best_ns_per_op = -1.0;
+	double best_instructions_per_op = -1.0;
+	long long allocations = 0;
+	for(int r=0; r<num_repetitions; r++) {
+		long long allocation_count_before = allocation_count;
+		start_instruction_counter();
+		double start_ns = get_monotonic_ns();
+		op(iterations);
+		double elapsed_ns = get_monotonic_ns() - start_ns;
+		long long instructions = stop_instruction_counter();
+		allocations += allocation_count - allocation_count_before;
+
+		if(best_ns_per_op < 0.0 || elapsed_ns / iterations < best_ns_per_op)
+			best_ns_per_op = elapsed_ns / iterations;
+		if(instructions >= 0 && (best_instructions_per_op < 0.0 || instructions / (double)iterations < best_instructions_per_op))
+			best_instructions_per_op = instructions / (double)iterations;
+	}
+
+	std::ostringstream oss;
+	oss << name << "\t" << (params.empty() ? "-" : params) << "\t" << iterations
+		<< "\t" << best_ns_per_op << "\t" << allocations / (double)(iterations * num_repetitions) << "\t";
+	if(best_instructions_per_op >= 0.0)
+		oss << best_instructions_per_op;
+	else
+		oss << "NA";
+	std::cout << oss.str() << std::endl;
+}
+
+
+/////////////////////////////
+// Benchmarks
+/////////////////////////////
+
+static volatile double sink = 0.0;
+
+// frame_enter_exit_complete
+static std::vector<Frame *> vNestedFrames;
+
+static void bench_frame_enter_exit_complete(long long iterations) {
+	int depth = (int)vNestedFrames.size();
+	for(long long it=0; it<iterations; it++) {
+		for(int d=0; d<depth; d++)
+			frame_enter(vNestedFrames[d]->id);
+		for(int d=depth-1; d>=0; d--)
+			frame_exit_complete(vNestedFrames[d]->id);
+	}
+}
+
+// execframe_run_in_frame, get_decision_sets_for_parameter
+static Frame * bench_frame = 0;
+static ExecFrame * bench_execframe = 0;
+
+static void apply_knob(double knob_value) {
+	sink = knob_value;
+}
+
+static void bench_execframe_run_in_frame(long long iterations) {
+	for(long long it=0; it<iterations; it++) {
+		frame_enter(bench_frame->id);
+		bench_execframe->run();
+		frame_exit_complete(bench_frame->id);
+	}
+}
+
+// select_run_in_frame
+static const int select_runs_per_invocation = 16;
+
+void alternative0() { sink = 0; } //StaticSelect alternatives need external linkage
+void alternative1() { sink = 1; }
+void alternative2() { sink = 2; }
+void alternative3() { sink = 3; }
+
+static Caller select_callers[4];
+static StaticSelect<alternative0, alternative1, alternative2, alternative3> * bench_static_select = 0;
+
+static void bench_select_run_in_frame_dynamic(long long iterations) {
+	for(long long it=0; it<iterations; it++) {
+		frame_enter(bench_frame->id);
+		for(int r=0; r<select_runs_per_invocation; r++) {
+			select_callers[0].rebind(OPP_FUNC_HANDLE0(alternative0));
+			select_callers[1].rebind(OPP_FUNC_HANDLE0(alternative1));
+			select_callers[2].rebind(OPP_FUNC_HANDLE0(alternative2));
+			select_callers[3].rebind(OPP_FUNC_HANDLE0(alternative3));
+			bench_execframe->run();
+		}
+		frame_exit_complete(bench_frame->id);
+	}
+}
+
+static void bench_select_run_in_frame_static(long long iterations) {
+	for(long long it=0; it<iterations; it++) {
+		frame_enter(bench_frame->id);
+		for(int r=0; r<select_runs_per_invocation; r++)
+			bench_static_select->run();
+		frame_exit_complete(bench_frame->id);
+	}
+}
+
+// items_run_in_frame
+static const int items_per_invocation = 256;
+static int items_per_batch = 0;
+
+void item_alternative0(int item) { sink = item; }
+void item_alternative1(int item) { sink = item + 1; }
+void item_alternative2(int item) { sink = item + 2; }
+void item_alternative3(int item) { sink = item + 3; }
+
+static StaticBatchSelect<int, item_alternative0, item_alternative1, item_alternative2, item_alternative3> * bench_static_batch_select = 0;
+
+static void bench_items_run_in_frame_per_item(long long iterations) {
+	for(long long it=0; it<iterations; it++) {
+		frame_enter(bench_frame->id);
+		for(int i=0; i<items_per_invocation; i++)
+			bench_static_select->run();
+		frame_exit_complete(bench_frame->id);
+	}
+}
+
+static void bench_items_run_in_frame_batched(long long iterations) {
+	for(long long it=0; it<iterations; it++) {
+		frame_enter(bench_frame->id);
+		for(int i=0; i<items_per_invocation; i+=items_per_batch)
+			bench_static_batch_select->run_batch(items_per_batch);
+		frame_exit_complete(bench_frame->id);
+	}
+}
+
+static void bench_get_decision_sets_for_parameter(long long iterations) {
+	Parameter& decision_vector_parameter = ExecFrameInfo::get_execframe_info(bench_execframe)->decision_model.decision_vector_parameter;
+	std::vector<ParameterValue_t> vFor, vUnclassified, vAgainst;
+	std::vector<double> vForCounts, vForProbs, vUnclassifiedCounts, vUnclassifiedProbs, vAgainstCounts, vAgainstProbs;
+
+	for(long long it=0; it<iterations; it++) {
+		get_decision_sets_for_parameter(decision_vector_parameter, bench_frame,
+			vFor, vForCounts, vForProbs, vUnclassified, vUnclassifiedCounts, vUnclassifiedProbs,
+			vAgainst, vAgainstCounts, vAgainstProbs);
+		sink = (double)vFor.size();
+	}
+}
+
+// intvaluecache_note_sample
+static int num_distinct_tags = 0;
+
+static void bench_intvaluecache_note_sample(long long iterations) {
+	IntValueCache cache(ParameterExecSpread::num_entries_per_cache, ParameterExecSpread::max_count);
+	for(long long it=0; it<iterations; it++)
+		cache.note_sample((ParameterValue_t)(it % num_distinct_tags));
+	sink = cache.get_sample_count();
+}
+
+// spread binning
+static std::vector<ExecTime_t> vExecTimes; //spanning all bins, power-of-2 size
+
+static void bench_spread_bin_absolute(long long iterations) {
+	int sum = 0;
+	for(long long it=0; it<iterations; it++)
+		sum += ExecutionTimeSpread_Absolute::get_spread_bin_index(vExecTimes[it & (vExecTimes.size() - 1)]);
+	sink = sum;
+}
+
+static void bench_spread_bin_center_absolute(long long iterations) {
+	double sum = 0.0;
+	for(long long it=0; it<iterations; it++)
+		sum += ExecutionTimeSpread_Absolute::get_exec_time_for_index((int)(it % ExecutionTimeSpread_Absolute::num_bins));
+	sink = sum;
+}
+
+static void bench_spread_bin_mean_relative(long long iterations) {
+	int sum = 0;
+	for(long long it=0; it<iterations; it++)
+		sum += ExecutionTimeSpread_MeanRelative::get_spread_bin_index(vExecTimes[it & (vExecTimes.size() - 1)], 0.01);
+	sink = sum;
+}
+
+// caller_rebind
+static void bound_function(int x) {
+	sink = x;
+}
+
+static void bench_caller_rebind(long long iterations) {
+	Caller caller;
+	int x = 5;
+	for(long long it=0; it<iterations; it++)
+		caller.rebind(OPP_FUNC_HANDLE(bound_function, x));
+}
+
+
+static ExecFrame * make_knob_execframe(int num_knobs, int num_settings) {
+	std::vector<Model> vKnobs;
+	for(int k=0; k<num_knobs; k++)
+		vKnobs.push_back(Model::integer_knob(k, apply_knob, num_settings - 1, 0));
+	return new ExecFrame(Model(vKnobs));
+}
+
+
+static void usage() {
+	std::cerr << "Usage: opp_bench.exe [-min_time seconds] [-filter substring]" << std::endl;
+	exit(1);
+}
+
+int main(int argc, char * argv[]) {
+	for(int a=1; a<argc; a++) {
+		std::string option = argv[a];
+		if(a + 1 >= argc)
+			usage();
+		std::string value = argv[++a];
+
+		if(option == "-min_time") min_time = atof(value.c_str());
+		else if(option == "-filter") name_filter = value;
+		else usage();
+	}
+
+	feature_control_debug_message_level(DebugMsgNONE);
+	open_instruction_counter();
+
+	std::cout << "# opp_bench: srt_version = " << SRT_VERSION << ", min_time = " << min_time
+		<< ", repetitions = " << num_repetitions
+		<< ", instruction counter " << (instructions_fd == -1 ? "unavailable" : "available") << std::endl;
+	std::cout << "benchmark\tparams\titerations\tns_per_op\tallocs_per_op\tinstructions_per_op" << std::endl;
+
+	if(is_selected("frame_enter_exit_complete")) {
+		int depths[] = {1, 2, 4, 8};
+		for(int i=0; i<(int)(sizeof(depths)/sizeof(depths[0])); i++) {
+			for(int d=0; d<depths[i]; d++)
+				vNestedFrames.push_back(new Frame(Objective(0.001, 0.2, 0.2, 0.9, 3)));
+			std::ostringstream params;
+			params << "depth=" << depths[i];
+			run_benchmark("frame_enter_exit_complete", params.str(), bench_frame_enter_exit_complete);
+			for(int d=0; d<depths[i]; d++)
+				delete vNestedFrames[d];
+			vNestedFrames.clear();
+		}
+	}
+
+	if(is_selected("execframe_run_in_frame")) {
+		const char * strategies[] = {"thompson", "frs"};
+		int knobs[] = {1, 2, 4, 8, 16};
+		for(int s=0; s<2; s++) {
+			feature_control_use_fast_reaction_strategy(s == 1);
+			for(int i=0; i<(int)(sizeof(knobs)/sizeof(knobs[0])); i++) {
+				bench_frame = new Frame(Objective(0.001, 0.2, 0.2, 0.9, 3));
+				bench_execframe = make_knob_execframe(knobs[i], 4);
+				std::ostringstream params;
+				params << "knobs=" << knobs[i] << ",strategy=" << strategies[s];
+				run_benchmark("execframe_run_in_frame", params.str(), bench_execframe_run_in_frame);
+				delete bench_execframe;
+				delete bench_frame;
+			}
+		}
+		feature_control_use_fast_reaction_strategy(false);
+	}
+
+	if(is_selected("select_run_in_frame")) {
+		bench_frame = new Frame(Objective(0.001, 0.2, 0.2, 0.9, 3));
+		std::vector<Model> vAlternatives;
+		for(int i=0; i<4; i++)
+			vAlternatives.push_back(Model(&select_callers[i]));
+		bench_execframe = new ExecFrame(Model(0, vAlternatives));
+		run_benchmark("select_run_in_frame", "dispatch=dynamic", bench_select_run_in_frame_dynamic);
+		delete bench_execframe;
+		delete bench_frame;
+
+		bench_frame = new Frame(Objective(0.001, 0.2, 0.2, 0.9, 3));
+		bench_static_select = new StaticSelect<alternative0, alternative1, alternative2, alternative3>(0);
+		run_benchmark("select_run_in_frame", "dispatch=static", bench_select_run_in_frame_static);
+		delete bench_static_select;
+		delete bench_frame;
+	}
+
+	if(is_selected("items_run_in_frame")) {
+		bench_frame = new Frame(Objective(0.001, 0.2, 0.2, 0.9, 3));
+		bench_static_select = new StaticSelect<alternative0, alternative1, alternative2, alternative3>(0);
+		run_benchmark("items_run_in_frame", "runs=256", bench_items_run_in_frame_per_item);
+		delete bench_static_select;
+		delete bench_frame;
+
+		int batches[] = {16, 1};
+		for(int i=0; i<2; i++) {
+			items_per_batch = items_per_invocation / batches[i];
+			bench_frame = new Frame(Objective(0.001, 0.2, 0.2, 0.9, 3));
+			bench_static_batch_select = new StaticBatchSelect<int, item_alternative0, item_alternative1, item_alternative2, item_alternative3>(0);
+			std::ostringstream params;
+			params << "runs=" << batches[i];
+			run_benchmark("items_run_in_frame", params.str(), bench_items_run_in_frame_batched);
+			delete bench_static_batch_select;
+			delete bench_frame;
+		}
+	}
+
+	if(is_selected("intvaluecache_note_sample")) {
+		int tags[] = {8, 16};
+		for(int i=0; i<2; i++) {
+			num_distinct_tags = tags[i];
+			std::ostringstream params;
+			params << "tags=" << tags[i];
+			run_benchmark("intvaluecache_note_sample", params.str(), bench_intvaluecache_note_sample);
+		}
+	}
+
+	for(int i=0; i<1024; i++)
+		vExecTimes.push_back(0.0005 * (1.0 + (i * 37 % 1024) * 4.0)); //0.5ms .. ~2s
+	if(is_selected("spread_bin_absolute"))
+		run_benchmark("spread_bin_absolute", "", bench_spread_bin_absolute);
+	if(is_selected("spread_bin_center_absolute"))
+		run_benchmark("spread_bin_center_absolute", "", bench_spread_bin_center_absolute);
+	if(is_selected("spread_bin_mean_relative"))
+		run_benchmark("spread_bin_mean_relative", "", bench_spread_bin_mean_relative);
+
+	if(is_selected("get_decision_sets_for_parameter")) {
+		bench_frame = new Frame(Objective(0.001, 0.2, 0.2, 0.9, 3));
+		bench_execframe = make_knob_execframe(1, 16);
+		bench_execframe_run_in_frame(500); //train the Frame's spreads for the ExecFrame's decisions
+		frame_enter(bench_frame->id);
+		run_benchmark("get_decision_sets_for_parameter", "", bench_get_decision_sets_for_parameter);
+		frame_exit_complete(bench_frame->id);
+		delete bench_execframe;
+		delete bench_frame;
+	}
+
+	if(is_selected("caller_rebind"))
+		run_benchmark("caller_rebind", "", bench_caller_rebind);
+
+	return 0;
+}
@@ -0,0 +1,61 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#include <sstream>
+#include <cassert>
+
+#include "opp_change_point.h"
+
+namespace Opp {
+
+//////////////////////////////////////////
+//class PageHinkleyDetector definitions
+//////////////////////////////////////////
+
+void PageHinkleyDetector::initialize(double delta) {
+	assert(delta >= 0.0);
+	this->delta = delta;
+	reset();
+}
+
+void PageHinkleyDetector::reset() {
+	count = 0;
+	mean = 0.0;
+	cum_increase = 0.0;
+	min_cum_increase = 0.0;
+	cum_decrease = 0.0;
+	max_cum_decrease = 0.0;
+}
+
+int PageHinkleyDetector::note_sample(double x, double threshold) {
+	count++;
+	mean += (x - mean) / count;
+
+	cum_increase += x - mean - delta;
+	if(cum_increase < min_cum_increase)
+		min_cum_increase = cum_increase;
+
+	cum_decrease += x - mean + delta;
+	if(cum_decrease > max_cum_decrease)
+		max_cum_decrease = cum_decrease;
+
+	int detected = 0;
+	if(cum_increase - min_cum_increase > threshold)
+		detected = +1;
+	else if(max_cum_decrease - cum_decrease > threshold)
+		detected = -1;
+
+	if(detected != 0)
+		reset();
+	return detected;
+}
+
+std::string PageHinkleyDetector::print_string() const {
+	std::ostringstream oss;
+	oss << "mean = " << mean << " increase statistic = " << cum_increase - min_cum_increase
+		<< " decrease statistic = " << max_cum_decrease - cum_decrease << " over " << count << " samples";
+	return oss.str();
+}
+
+} //namespace Opp
@@ -0,0 +1,52 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_CHANGE_POINT_H
+#define OPP_CHANGE_POINT_H
+
+#include <string>
+
+namespace Opp {
+
+	/////////////////////////////////
+	// Change-point detection on a stream of samples
+	/////////////////////////////////
+
+	// PageHinkleyDetector: two-sided Page-Hinkley test (Page, Biometrika 1954; Hinkley, Biometrika 1971) for an
+	//   abrupt change in the mean of a stream. For an increase, it accumulates m_t = sum (x_i - mean_i - delta) with
+	//   mean_i the running mean of the samples so far, and detects once m_t rises more than threshold above its
+	//   minimum so far (mirrored for a decrease). Shifts smaller than delta are tolerated indefinitely.
+	//   The samples are forgotten on each detection, so that the new regime becomes the reference.
+
+	class PageHinkleyDetector {
+		double delta;
+
+		long long count;
+		double mean;
+		double cum_increase;
+		double min_cum_increase;
+		double cum_decrease;
+		double max_cum_decrease;
+
+	public:
+		PageHinkleyDetector(double delta = 0.0)
+		{ initialize(delta); }
+
+		void initialize(double delta);
+
+		void reset();
+			//forgets all samples, keeping delta
+
+		int note_sample(double x, double threshold);
+			//+1 on detecting an increase in the mean, -1 on detecting a decrease (followed by reset()), 0 otherwise
+
+		long long get_sample_count() const
+			{ return count; }
+
+		std::string print_string() const;
+	};
+
+} //namespace Opp
+
+#endif //OPP_CHANGE_POINT_H
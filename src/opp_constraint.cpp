@@ -2,7 +2,13 @@
 //
 // Author: Tushar Kumar, tushardeveloper@gmail.com
 
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cassert>
+
 #include "opp.h"
+#include "opp_constraint.h"
 
 namespace Opp {
 
@@ -39,34 +45,227 @@ Constraint operator~(Constraint c)
 //3 valued logic operations
 
 LogicValue AND(const LogicValue& lv1, const LogicValue& lv2) {
-	if(lv1.value == 0 or lv2.value == 0)
-		return LogicValue(0);
-	if(lv1.value == 1 and lv2.value == 1)
-		return LogicValue(1);
-	return LogicValue(2);
+	if(lv1.value == LogicValue::LogicFALSE || lv2.value == LogicValue::LogicFALSE)
+		return LogicValue(LogicValue::LogicFALSE);
+	if(lv1.value == LogicValue::LogicTRUE && lv2.value == LogicValue::LogicTRUE)
+		return LogicValue(LogicValue::LogicTRUE);
+	return LogicValue(LogicValue::LogicUNKNOWN);
 }
 
 LogicValue OR(const LogicValue& lv1, const LogicValue& lv2) {
-	if(lv1.value == 1 or lv2.value == 1)
-		return LogicValue(1);
-	if(lv1.value == 0 and lv2.value == 0)
-		return LogicValue(0);
-	return LogicValue(2);
+	if(lv1.value == LogicValue::LogicTRUE || lv2.value == LogicValue::LogicTRUE)
+		return LogicValue(LogicValue::LogicTRUE);
+	if(lv1.value == LogicValue::LogicFALSE && lv2.value == LogicValue::LogicFALSE)
+		return LogicValue(LogicValue::LogicFALSE);
+	return LogicValue(LogicValue::LogicUNKNOWN);
 }
 
 LogicValue XOR(const LogicValue& lv1, const LogicValue& lv2) {
-	if(lv1.isUnknown() or lv2.isUnknown())
-		return LogicValue(2);
+	if(lv1.isUnknown() || lv2.isUnknown())
+		return LogicValue(LogicValue::LogicUNKNOWN);
 
-	//Now, lv1 and lv2 both have definite values (i.e. 0 or 1)
-	return LogicValue(lv1.value ^ lv2.value);
+	//Now, lv1 and lv2 both have definite values
+	if(lv1.value != lv2.value)
+		return LogicValue(LogicValue::LogicTRUE);
+	return LogicValue(LogicValue::LogicFALSE);
 }
 
 LogicValue NOT(const LogicValue& lv) {
 	if(lv.isUnknown())
-		return LogicValue(2);
+		return LogicValue(LogicValue::LogicUNKNOWN);
+
+	if(lv.value == LogicValue::LogicTRUE)
+		return LogicValue(LogicValue::LogicFALSE);
+	return LogicValue(LogicValue::LogicTRUE);
+}
+
+
+/////////////////////////////////////////
+//class ConstraintStructure definitions
+/////////////////////////////////////////
+
+static int find_dec_var_index(int select_var_id, const std::vector<int>& vDecisionVector) {
+	for(int i=0; i<(int)vDecisionVector.size(); i++) {
+		if(vDecisionVector[i] == select_var_id)
+			return i;
+	}
+	return -1;
+}
+
+ConstraintStructure::ConstraintStructure(const Constraint& con, const std::vector<int>& vDecisionVector)
+	: type(con.get_type()), v1(-1), v2(-1), dec_var_index1(-1), dec_var_index2(-1)
+{
+	if(isLinear()) {
+		v1 = con.get_v1().select_var_id;
+		v2 = con.get_v2().select_var_id;
+		dec_var_index1 = find_dec_var_index(v1, vDecisionVector);
+		dec_var_index2 = find_dec_var_index(v2, vDecisionVector);
+		sContainedVIDs.insert(v1);
+		sContainedVIDs.insert(v2);
+	}
+	else if(isLogical()) {
+		std::vector<Constraint> vConstraints = con.get_vConstraints();
+		assert((int)vConstraints.size() == (type == Constraint::NOT ? 1 : 2));
+		for(int i=0; i<(int)vConstraints.size(); i++) {
+			vTreeChildren.push_back( ConstraintStructure(vConstraints[i], vDecisionVector) );
+			sContainedVIDs.insert(vTreeChildren.back().sContainedVIDs.begin(), vTreeChildren.back().sContainedVIDs.end());
+		}
+	}
+	else
+	{ assert(type == Constraint::UNDEF); }
+}
+
+LogicValue ConstraintStructure::evaluate(const std::vector<int>& dec_vec) const {
+	switch(type) {
+		case Constraint::UNDEF:
+			return LogicValue(LogicValue::LogicTRUE);
+
+		case Constraint::GT:
+		case Constraint::GEQ:
+		case Constraint::LT:
+		case Constraint::LEQ:
+		case Constraint::EQ: {
+			if(dec_var_index1 == -1 || dec_var_index2 == -1
+					|| dec_vec[dec_var_index1] == -1 || dec_vec[dec_var_index2] == -1)
+				return LogicValue(LogicValue::LogicUNKNOWN);
+
+			int value1 = dec_vec[dec_var_index1];
+			int value2 = dec_vec[dec_var_index2];
+			bool bResult = false;
+			if(type == Constraint::GT)
+				bResult = value1 > value2;
+			else if(type == Constraint::GEQ)
+				bResult = value1 >= value2;
+			else if(type == Constraint::LT)
+				bResult = value1 < value2;
+			else if(type == Constraint::LEQ)
+				bResult = value1 <= value2;
+			else //EQ
+				bResult = value1 == value2;
+			return LogicValue(bResult ? LogicValue::LogicTRUE : LogicValue::LogicFALSE);
+		}
+
+		case Constraint::AND:
+			return AND(vTreeChildren[0].evaluate(dec_vec), vTreeChildren[1].evaluate(dec_vec));
+		case Constraint::OR:
+			return OR(vTreeChildren[0].evaluate(dec_vec), vTreeChildren[1].evaluate(dec_vec));
+		case Constraint::XOR:
+			return XOR(vTreeChildren[0].evaluate(dec_vec), vTreeChildren[1].evaluate(dec_vec));
+		case Constraint::NOT:
+			return NOT(vTreeChildren[0].evaluate(dec_vec));
+	}
+
+	assert(0);
+	return LogicValue(LogicValue::LogicUNKNOWN);
+}
+
+bool ConstraintStructure::involves_decision_variables() const {
+	if(isLinear())
+		return (dec_var_index1 != -1 && dec_var_index2 != -1);
+	for(int i=0; i<(int)vTreeChildren.size(); i++) {
+		if(vTreeChildren[i].involves_decision_variables())
+			return true;
+	}
+	return false;
+}
+
+
+/////////////////////////////////////////
+//class DecisionValidityOracle definitions
+/////////////////////////////////////////
+
+const int DecisionValidityOracle::max_tabulated_decision_vectors;
+
+DecisionValidityOracle::DecisionValidityOracle(
+	const Constraint& con,
+	const std::vector<int>& vDecisionVector,
+	const std::vector<int>& vNum_values
+)
+	: constraint_structure(con, vDecisionVector), vNum_values(vNum_values),
+		bConstrainsDecisions(false), bTabulated(false)
+{
+	assert(vDecisionVector.size() == vNum_values.size());
+
+	bConstrainsDecisions = constraint_structure.involves_decision_variables();
+	if(bConstrainsDecisions == false)
+		return;
+
+	DecisionKey_t num_decision_vectors = 1;
+	for(int i=0; i<(int)vNum_values.size(); i++) {
+		num_decision_vectors *= vNum_values[i];
+		if(num_decision_vectors > max_tabulated_decision_vectors)
+			return; //evaluate per query
+	}
+
+	bTabulated = true;
+	vIsValid.assign(num_decision_vectors, false);
+	std::vector<int> dec_vec(vNum_values.size(), 0);
+	for(DecisionKey_t key=0; key<num_decision_vectors; key++) {
+		if(constraint_structure.evaluate(dec_vec).value != LogicValue::LogicFALSE) {
+			vIsValid[key] = true;
+			vValid_keys.push_back(key);
+		}
+
+		//advance dec_vec to the decision-vector of key+1, last variable least significant
+		for(int i=(int)dec_vec.size()-1; i >= 0; i--) {
+			dec_vec[i]++;
+			if(dec_vec[i] < vNum_values[i])
+				break;
+			dec_vec[i] = 0;
+		}
+	}
+
+	if(vValid_keys.size() == 0) {
+		std::cerr << "DecisionValidityOracle(): ERROR: Constraint admits none of the " << num_decision_vectors
+			<< " decision-vectors" << std::endl;
+		exit(1);
+	}
+}
+
+bool DecisionValidityOracle::is_valid(const std::vector<int>& dec_vec) const {
+	assert(dec_vec.size() == vNum_values.size());
+	if(bConstrainsDecisions == false)
+		return true;
+	if(bTabulated) {
+		DecisionKey_t key = 0;
+		for(int i=0; i<(int)dec_vec.size(); i++)
+			key = key * vNum_values[i] + dec_vec[i];
+		return vIsValid[key];
+	}
+	return (constraint_structure.evaluate(dec_vec).value != LogicValue::LogicFALSE);
+}
+
+bool DecisionValidityOracle::is_valid_key(DecisionKey_t decision_int_value) const {
+	if(bConstrainsDecisions == false)
+		return true;
+	if(bTabulated)
+		return vIsValid.at(decision_int_value);
+
+	std::vector<int> dec_vec(vNum_values.size(), 0);
+	for(int i=(int)vNum_values.size()-1; i >= 0; i--) {
+		dec_vec[i] = (int)(decision_int_value % vNum_values[i]);
+		decision_int_value /= vNum_values[i];
+	}
+	assert(decision_int_value == 0);
+	return (constraint_structure.evaluate(dec_vec).value != LogicValue::LogicFALSE);
+}
+
+bool DecisionValidityOracle::is_consistent(const std::vector<int>& partial_dec_vec) const {
+	assert(partial_dec_vec.size() == vNum_values.size());
+	if(bConstrainsDecisions == false)
+		return true;
+	return (constraint_structure.evaluate(partial_dec_vec).value != LogicValue::LogicFALSE);
+}
 
-	return LogicValue(1 - lv.value);
+std::string DecisionValidityOracle::print_string() const {
+	std::ostringstream oss;
+	if(bConstrainsDecisions == false)
+		oss << "unconstrained";
+	else if(bTabulated)
+		oss << "tabulated: " << vValid_keys.size() << " of " << vIsValid.size() << " decision-vectors valid";
+	else
+		oss << "evaluated per decision-vector";
+	return oss.str();
 }
 
-}; //namespace Opp
+} //namespace Opp
@@ -24,7 +24,8 @@ namespace Opp {
 
 
 	void feature_control_probability_of_exploration(double new_setting);
-		//Enables probabilistic exploration of decision-values in an ExecFrame when vForDecisionSet is empty.
+		//Enables probabilistic exploration of decision-values in an ExecFrame when vForDecisionSet is empty,
+		//  or when the Thompson Sampling Strategy is in use.
 		//This is useful for avoiding lock-step exploration across multiple models within same Frame.
 		//
 		//probability_of_exploration = 0.0 disables probabilistic exploration.
@@ -57,6 +58,21 @@ namespace Opp {
 
 	std::pair<bool, double> feature_query_ForgetHistoryBelowBetaThreshold();
 		//Returns current value for (enable, forget_history_threshold_ratio_beta)
+
+
+	void feature_control_change_point_detection(bool enable, double threshold);
+		//Detects abrupt shifts in the execution time of a Frame with a mean-objective (e.g., on scene cuts), with a
+		//  Page-Hinkley test over the residual of each invocation's execution time w.r.t. the time recently seen for
+		//  the same decisions of the ExecFrames run within it, measured in half-widths of the objective window.
+		//  A change-point is detected once the residuals accumulate beyond 'threshold' in one direction
+		//  (e.g., threshold = 8.0 detects a shift of 5 half-widths within 2 invocations).
+		//On detection, the Frame retains only a small fraction of its learned history and forgets faster than
+		//  deemphasize_history_rate_alpha for a few invocations, instead of unlearning the old regime slowly.
+		//
+		//Default setting = (true, 8.0)
+
+	std::pair<bool, double> feature_query_change_point_detection();
+		//Returns current value for (enable, change_point_threshold)
 	
 
 
@@ -66,9 +82,88 @@ namespace Opp {
 	bool feature_query_use_fast_reaction_strategy();
 
 
+	void feature_control_use_thompson_sampling_strategy(bool new_setting);
+		//When the Fast Reaction Strategy is not in use, choose decision-vectors by Thompson Sampling
+		//  (contextual bandit over decision-vectors, rewarding feature priority when the Objective is met
+		//   and penalizing misses) instead of the Reinforcement Learning strategy based on decision-sets.
+		//  An invocation counts as a success by the test of the Objective's enforcement (e.g., exec time <= bound
+		//  for a quantile objective).
+		//Experimental: does not yet match the Fast Reaction Strategy on bimodal or lagging workloads (opp_sim.exe -suite).
+		//
+		//Default setting = false
+
+	bool feature_query_use_thompson_sampling_strategy();
+
+
+	void feature_control_workload_hint_feedforward(bool new_setting);
+		//When a Frame has been given workload hints (see frame_set_workload_hint()), the Fast Reaction Strategy
+		//  predicts the effect of the current hints on the Frame's execution time, relative to recently typical hints,
+		//  and corrects choices before the ExecFrame runs, instead of only reacting to the previous invocation's outcome.
+		//Has no effect on Frames without hints.
+		//
+		//Default setting = true
+
+	bool feature_query_workload_hint_feedforward();
+
+
+	void feature_control_intra_frame_slack_reclaiming(bool new_setting);
+		//When a Frame runs one or more ExecFrames, the Fast Reaction Strategy compares the Frame's elapsed time at each
+		//  run against the elapsed time usually seen at that run, and has the run make up for time lost (or use time saved)
+		//  by earlier parts of the same invocation, instead of only reacting on the next invocation.
+		//
+		//Default setting = true
+
+	bool feature_query_intra_frame_slack_reclaiming();
+
+
+	void feature_control_quality_feedback(bool new_setting);
+		//When the application reports qualities (see frame_report_quality()), the Thompson Sampling Strategy
+		//  rewards decision-vectors by their expected quality learned from the reports, instead of by the
+		//  priorities of their choices. Has no effect on Frames without quality reports, nor unless the Thompson
+		//  Sampling Strategy decides (see feature_control_use_thompson_sampling_strategy(), default false).
+		//
+		//Default setting = true
+
+	bool feature_query_quality_feedback();
+
+
+	void feature_control_max_enumerated_decision_vectors(long long new_setting);
+		//ExecFrames whose decision space (the product of their decision-variables' ranges) holds more decision-vectors
+		//  than this are decided by Thompson Sampling over per-variable posteriors, maximized with the strategy set by
+		//  feature_control_decision_search_strategy() (see opp_decision_search.h), instead of by visiting every decision-vector.
+		//Such ExecFrames use this even when Thompson Sampling is disabled, unless the Fast Reaction Strategy is in use.
+		//
+		//Default setting = 4096
+
+	long long feature_query_max_enumerated_decision_vectors();
+
+
+	void feature_control_subtract_controller_overhead(bool new_setting);
+		//The library measures its own time within each Frame invocation (frame_enter(), frame_exit_*(), the decisions of
+		//  ExecFrames run and the completion of contained Frames; see FrameStatistics::controller_overhead_total).
+		//  When enabled, this overhead is subtracted from the Frame's measured execution-time, so that the decision
+		//  strategies do not learn it as a cost of the application's choices. Frames measuring CPU time are unaffected.
+		//
+		//Default setting = false
+
+	bool feature_query_subtract_controller_overhead();
+
+
 	//Debug Messages: Levels
 
-		//controls not added yet
+	typedef enum {
+		DebugMsgNONE = 0,
+		DebugMsgEVENTS = 1,    //changes of feature controls, and rare events (snapshots, change-points, calibration, rescaling)
+		DebugMsgDECISIONS = 2, //additionally, the decision of every ExecFrame run and the objective outcome of every Frame invocation
+		DebugMsgALL = 3        //additionally, the internal state of the decision strategies and timing on every run
+	} DebugMessageLevel_t;
+
+	void feature_control_debug_message_level(DebugMessageLevel_t new_setting);
+		//Messages printed to std::cout. Errors are always printed to std::cerr.
+		//
+		//Default setting = DebugMsgALL
+
+	DebugMessageLevel_t feature_query_debug_message_level();
 }
 
 #endif //OPP_DEBUG_CONTROL_H
@@ -4,12 +4,18 @@
 
 #include <algorithm>
 #include <iostream>
+#include <cmath>
 
 #include "opp_frame_info.h"
 #include "opp_frame.h"
 #include "opp_decision_model.h"
+#include "opp_snapshot.h"
+#include "opp_trace.h"
+#include "opp_stats_page.h"
+#include "opp_timing.h"
 
 #include "opp_debug_control.h"
+#include "opp_utilities.h"
 
 namespace Opp {
 
@@ -43,7 +49,13 @@ void Parameter::add_consumer(Frame * consumer) {
 			);
 	consumer_frame_dec_model.map_parm_to_curr_record[this] = exec_time_parameter_cache;
 
+	consumer_frame_dec_model.map_parm_to_thompson_model[this] = new ThompsonSamplingModel();
+
+	consumer_frame_dec_model.map_parm_to_fast_reaction_state[this] = new FastReactionState();
+
 	map_consumer_caches[consumer] = exec_time_parameter_cache;
+
+	snapshot_restore_consumer_state(consumer, this);
 }
 
 
@@ -63,36 +75,465 @@ void Parameter::remove_consumer(Frame * consumer) {
 	assert(consumer_frame_dec_model.map_parm_to_curr_record.count(this) == 1);
 	delete consumer_frame_dec_model.map_parm_to_curr_record[this];
 	consumer_frame_dec_model.map_parm_to_curr_record.erase(this);
+
+	assert(consumer_frame_dec_model.map_parm_to_thompson_model.count(this) == 1);
+	delete consumer_frame_dec_model.map_parm_to_thompson_model[this];
+	consumer_frame_dec_model.map_parm_to_thompson_model.erase(this);
+
+	assert(consumer_frame_dec_model.map_parm_to_fast_reaction_state.count(this) == 1);
+	delete consumer_frame_dec_model.map_parm_to_fast_reaction_state[this];
+	consumer_frame_dec_model.map_parm_to_fast_reaction_state.erase(this);
 }
 
 
 void Parameter::inform_enclosing_active_consumers_of_sample_measurement(
-	std::vector<Frame *> vActiveEnclosingFrames,
-	int sample_value
+	Frame * innermost_active_enclosing_frame,
+	ParameterValue_t sample_value
 ) {
-	for(int i=0; i<(int)vActiveEnclosingFrames.size(); i++) {
-		Frame * enclosing_consumer = vActiveEnclosingFrames[i];
-		if(map_consumer_caches.count(enclosing_consumer) == 0)
+	//walks the chain get_dynamically_enclosing_frames() would return, without building it on every measurement
+	for(Frame * enclosing_consumer = innermost_active_enclosing_frame;
+		enclosing_consumer != 0;
+		enclosing_consumer = FrameInfo::get_frame_info(enclosing_consumer)->curr_parent_frame)
+	{
+		std::map<Frame *, IntValueCache *>::iterator mit = map_consumer_caches.find(enclosing_consumer);
+		if(mit == map_consumer_caches.end())
 			continue;
-		assert(map_consumer_caches.count(enclosing_consumer) == 1);
-		IntValueCache * tracking_parm_cache = map_consumer_caches[enclosing_consumer];
+		IntValueCache * tracking_parm_cache = mit->second;
 		tracking_parm_cache->note_sample(sample_value);
 	}
 }
 
+
+/////////////////////////////////////////
+//class FrameStatisticsWindow definitions
+/////////////////////////////////////////
+
+void FrameStatisticsWindow::add(timeval completion_timeval, ExecTime_t exec_time, bool bHasJitter, ExecTime_t jitter, bool bSatisfied) {
+	Sample sample;
+	sample.completion_timeval = completion_timeval;
+	sample.exec_time = exec_time;
+	sample.bHasJitter = bHasJitter;
+	sample.jitter = jitter;
+	sample.bSatisfied = bSatisfied;
+	dqSamples.push_back(sample);
+
+	stats.exec_time_histogram.record(exec_time);
+	if(bHasJitter)
+		stats.jitter_histogram.record(jitter);
+	if(bSatisfied)
+		stats.satisfied_count++;
+
+	if(stats.window_length > 0) {
+		while((long long)dqSamples.size() > stats.window_length)
+			evict_oldest();
+	}
+	else
+		evict_expired(completion_timeval);
+}
+
+void FrameStatisticsWindow::evict_expired(timeval now) {
+	if(stats.window_seconds <= 0.0)
+		return;
+	while(dqSamples.empty() == false && diff_time(dqSamples.front().completion_timeval, now) > stats.window_seconds)
+		evict_oldest();
+}
+
+void FrameStatisticsWindow::evict_oldest() {
+	const Sample& oldest = dqSamples.front();
+	stats.exec_time_histogram.unrecord(oldest.exec_time);
+	if(oldest.bHasJitter)
+		stats.jitter_histogram.unrecord(oldest.jitter);
+	if(oldest.bSatisfied)
+		stats.satisfied_count--;
+	dqSamples.pop_front();
+}
+
+
+////////////////////////////////////
+//class FastReactionState definitions
+////////////////////////////////////
+
+void FastReactionState::restart_rescaling_statistics(ExecTime_t mean_objective) {
+	for(int i=0; i<(int)vAverage_X_deviation.size(); i++)
+		vAverage_X_deviation[i] = 0.0;
+	for(int i=0; i<(int)vSum_X_deviation.size(); i++)
+		vSum_X_deviation[i] = 0.0;
+	current_window_length_X_deviation = 0;
+
+	current_failure_unidirectional_runlenth = 0;
+	average_continuous_unidirectional_failure_runlength = 0.0;
+	current_number_unidirectional_runs = 0;
+
+	halfcycle_start_deflection_sign = (previous_Y <= mean_objective ? -1 : +1);
+	halfcycle_Y_positive_max_deflection = 0.0;
+	halfcycle_Y_negative_max_deflection = 0.0;
+	halfcycle_length = 0;
+	has_halfcycle_crossed_mean = false;
+	sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window = 0.0;
+
+	contiguous_onesided_failure_runlength = 0;
+	for(int i=0; i<(int)vDeflectionInX_during_onesided_failure.size(); i++)
+		vDeflectionInX_during_onesided_failure[i] = 0.0;
+	correction_runlength_onesided_failure = 0;
+	for(int i=0; i<(int)correction_vDeflectionInX_during_onesided_failure.size(); i++)
+		correction_vDeflectionInX_during_onesided_failure[i] = 0.0;
+}
+
+void FastReactionState::save_snapshot(SnapshotWriter& writer) const {
+	writer.put_vector(vCoeffs_a);
+
+	writer.put_vector(vPrevious_model_choice_double_value);
+	writer.put_vector(vUnbounded_Previous_model_choice_double_value);
+	writer.put_vector(vAverage_X_deviation);
+	writer.put_i64(current_window_length_X_deviation);
+	writer.put_vector(vSum_X_deviation);
+	writer.put_i64(current_failure_unidirectional_runlenth);
+	writer.put_double(average_continuous_unidirectional_failure_runlength);
+	writer.put_i64(current_number_unidirectional_runs);
+
+	writer.put_double(previous_Y);
+	writer.put_i64(halfcycle_start_deflection_sign);
+	writer.put_double(halfcycle_Y_positive_max_deflection);
+	writer.put_double(halfcycle_Y_negative_max_deflection);
+	writer.put_i64(halfcycle_length);
+	writer.put_bool(has_halfcycle_crossed_mean);
+	writer.put_double(sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window);
+
+	writer.put_i64(contiguous_onesided_failure_runlength);
+	writer.put_vector(vDeflectionInX_during_onesided_failure);
+	writer.put_i64(correction_runlength_onesided_failure);
+	writer.put_vector(correction_vDeflectionInX_during_onesided_failure);
+
+	writer.put_i64((long long)vvvVarChoiceStats.size());
+	for(int i=0; i<(int)vvvVarChoiceStats.size(); i++) {
+		writer.put_i64((long long)vvvVarChoiceStats[i].size());
+		for(int v=0; v<(int)vvvVarChoiceStats[i].size(); v++)
+			writer.put_vector(vvvVarChoiceStats[i][v]);
+	}
+
+	workload_hint_regression.save_snapshot(writer);
+
+	writer.put_vector(vExpected_elapsed_at_run);
+	writer.put_vector(vExpected_elapsed_at_run_sample_count);
+
+	writer.put_vector(vMax_X);
+}
+
+bool FastReactionState::load_snapshot(SnapshotReader& reader) {
+	reader.get_vector(vCoeffs_a);
+
+	reader.get_vector(vPrevious_model_choice_double_value);
+	reader.get_vector(vUnbounded_Previous_model_choice_double_value);
+	reader.get_vector(vAverage_X_deviation);
+	reader.get_i64(current_window_length_X_deviation);
+	reader.get_vector(vSum_X_deviation);
+	reader.get_i64(current_failure_unidirectional_runlenth);
+	reader.get_double(average_continuous_unidirectional_failure_runlength);
+	reader.get_i64(current_number_unidirectional_runs);
+
+	reader.get_double(previous_Y);
+	reader.get_int(halfcycle_start_deflection_sign);
+	reader.get_double(halfcycle_Y_positive_max_deflection);
+	reader.get_double(halfcycle_Y_negative_max_deflection);
+	reader.get_i64(halfcycle_length);
+	reader.get_bool(has_halfcycle_crossed_mean);
+	reader.get_double(sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window);
+
+	reader.get_i64(contiguous_onesided_failure_runlength);
+	reader.get_vector(vDeflectionInX_during_onesided_failure);
+	reader.get_i64(correction_runlength_onesided_failure);
+	reader.get_vector(correction_vDeflectionInX_during_onesided_failure);
+
+	long long num_variables = 0;
+	if(reader.get_length(num_variables, sizeof(long long)) == false)
+		return false;
+	vvvVarChoiceStats.resize((size_t)num_variables);
+	for(int i=0; i<(int)num_variables && reader.ok(); i++) {
+		long long num_values = 0;
+		if(reader.get_length(num_values, sizeof(long long)) == false)
+			return false;
+		vvvVarChoiceStats[i].resize((size_t)num_values);
+		for(int v=0; v<(int)num_values && reader.ok(); v++)
+			reader.get_vector(vvvVarChoiceStats[i][v]);
+	}
+
+	if(reader.ok() == false || workload_hint_regression.load_snapshot(reader) == false)
+		return false;
+
+	reader.get_vector(vExpected_elapsed_at_run);
+	reader.get_vector(vExpected_elapsed_at_run_sample_count);
+	if(vExpected_elapsed_at_run.size() != vExpected_elapsed_at_run_sample_count.size())
+		return false;
+
+	reader.get_vector(vMax_X);
+	return reader.ok();
+}
+
+
+////////////////////////////////////
+//class FrameDecisionModel definitions
+////////////////////////////////////
+
+const double FrameDecisionModel::recent_exec_time_rate = 0.1;
+
+void FrameDecisionModel::initialize_quality_floor(double min_quality, double quality_floor_prob, Objective::Cost_t cost) {
+	assert(isObjectiveInitialized() && bHasMeanObjectiveDefined == false);
+
+	if(quality_floor_prob <= 0.0 || quality_floor_prob >= 1.0) {
+		std::cerr << "FrameDecisionModel::initialize_quality_floor(): ERROR: quality floor objectives"
+			<< " need 0.0 < prob < 1.0, given prob = " << quality_floor_prob << std::endl;
+		exit(1);
+	}
+
+	this->bHasQualityFloorObjective = true;
+	this->min_quality = min_quality;
+	this->quality_floor_prob = quality_floor_prob;
+	this->cost = cost;
+}
+
+void FrameDecisionModel::initialize_enforcement(Objective::Enforcement_t enforcement, int enforcement_window_length) {
+	this->enforcement = enforcement;
+	this->enforcement_window_length = enforcement_window_length;
+
+	if(enforcement == Objective::EnfPER_FRAME)
+		return;
+
+	if(bHasMeanObjectiveDefined == false || prob <= 0.0 || prob >= 1.0) {
+		std::cerr << "FrameDecisionModel::initialize_enforcement(): ERROR: quantile and window-fraction objectives"
+			<< " need a mean and 0.0 < prob < 1.0, given prob = " << prob << std::endl;
+		exit(1);
+	}
+
+	std::vector<double> vQuantileProbs;
+	if(enforcement == Objective::EnfQUANTILE) {
+		vQuantileProbs.push_back(0.5);
+		vQuantileProbs.push_back(prob);
+	}
+	else { //Objective::EnfWINDOW_FRACTION
+		vQuantileProbs.push_back((1.0 - prob) / 2.0);
+		vQuantileProbs.push_back(0.5);
+		vQuantileProbs.push_back((1.0 + prob) / 2.0);
+	}
+
+	double min_samples = 1.0 / (1.0 - vQuantileProbs[vQuantileProbs.size()-1]);
+	if(enforcement_window_length < min_samples) {
+		std::cerr << "FrameDecisionModel::initialize_enforcement(): ERROR: enforcement_window_length = " << enforcement_window_length
+			<< " is too short to observe the tail for prob = " << prob << ", need atleast " << min_samples << std::endl;
+		exit(1);
+	}
+
+	exec_time_quantile_sketch.initialize(vQuantileProbs, enforcement_window_length);
+	window_fraction_counter.initialize(enforcement_window_length);
+}
+
+bool FrameDecisionModel::is_enforcement_estimate_available() const {
+	if(enforcement == Objective::EnfPER_FRAME)
+		return false;
+
+	const std::vector<double>& vQuantileProbs = exec_time_quantile_sketch.get_quantile_probs();
+	double min_samples = 1.0 / (1.0 - vQuantileProbs[vQuantileProbs.size()-1]);
+	if(min_samples < 5.0)
+		min_samples = 5.0;
+	return (exec_time_quantile_sketch.get_sample_count() >= min_samples);
+}
+
+void FrameDecisionModel::note_invocation_for_enforcement(ExecTime_t rescaled_exec_time, bool bWithinWindow) {
+	if(enforcement == Objective::EnfPER_FRAME)
+		return;
+
+	exec_time_quantile_sketch.note_sample(rescaled_exec_time);
+	window_fraction_counter.note_event(bWithinWindow);
+
+	if(is_enforcement_estimate_available() == false)
+		return;
+
+	bool bEnforcedObjectiveSatisfied;
+	if(enforcement == Objective::EnfQUANTILE) {
+		enforced_objective_measure = exec_time_quantile_sketch.get_quantile(1);
+		bEnforcedObjectiveSatisfied = (enforced_objective_measure <= mean_objective);
+	}
+	else { //Objective::EnfWINDOW_FRACTION
+		enforced_objective_measure = window_fraction_counter.get_fraction();
+		bEnforcedObjectiveSatisfied = (enforced_objective_measure >= prob);
+	}
+
+	enforced_objective_evaluated_count++;
+	if(bEnforcedObjectiveSatisfied)
+		enforced_objective_satisfied_count++;
+}
+
+bool FrameDecisionModel::is_invocation_objective_success(ExecTime_t rescaled_exec_time) const {
+	if(enforcement == Objective::EnfQUANTILE)
+		return (rescaled_exec_time <= mean_objective);
+
+	return ( rescaled_exec_time >= mean_objective * (1.0 - window_frac_lower)
+		&& rescaled_exec_time <= mean_objective * (1.0 + window_frac_upper) );
+}
+
+ExecTime_t FrameDecisionModel::get_steering_exec_time(ExecTime_t rescaled_exec_time) const {
+	if(is_enforcement_estimate_available() == false)
+		return rescaled_exec_time;
+
+	if(enforcement == Objective::EnfQUANTILE) {
+		//quantile <= mean  <=>  typical invocation + tail offset <= mean
+		ExecTime_t tail_offset = exec_time_quantile_sketch.get_quantile(1) - exec_time_quantile_sketch.get_quantile(0);
+		return rescaled_exec_time + tail_offset;
+	}
+
+	//Objective::EnfWINDOW_FRACTION
+	//  The central prob mass [median - lower_offset, median + upper_offset] must fit in [window_lower, window_upper].
+	//  So the median must lie in [window_lower + lower_offset, window_upper - upper_offset], which is mapped
+	//  linearly onto the objective window.
+	ExecTime_t lower_offset = exec_time_quantile_sketch.get_quantile(1) - exec_time_quantile_sketch.get_quantile(0);
+	ExecTime_t upper_offset = exec_time_quantile_sketch.get_quantile(2) - exec_time_quantile_sketch.get_quantile(1);
+	ExecTime_t window_lower = mean_objective * (1.0 - window_frac_lower);
+	ExecTime_t window_upper = mean_objective * (1.0 + window_frac_upper);
+	ExecTime_t feasible_lower = window_lower + lower_offset;
+	ExecTime_t feasible_upper = window_upper - upper_offset;
+
+	if(feasible_upper > feasible_lower)
+		return window_lower + (rescaled_exec_time - feasible_lower) * (window_upper - window_lower) / (feasible_upper - feasible_lower);
+
+	//spread too wide to fit in window: best effort is to center the central mass on the window
+	ExecTime_t central_mass_center = rescaled_exec_time + (upper_offset - lower_offset) / 2.0;
+	return mean_objective + central_mass_center - (window_lower + window_upper) / 2.0;
+}
+
+void FrameDecisionModel::refresh_local_objective_bins_cache() const {
+	if(bLocalObjectiveBinsCached
+		&& cached_bHasMeanObjectiveDefined == bHasMeanObjectiveDefined
+		&& cached_mean_objective == mean_objective
+		&& cached_window_frac_lower == window_frac_lower
+		&& cached_window_frac_upper == window_frac_upper
+		&& cached_num_spread_bins == exec_time_parameter_num_spread_bins)
+	{ return; }
+
+	bLocalObjectiveBinsCached = true;
+	cached_bHasMeanObjectiveDefined = bHasMeanObjectiveDefined;
+	cached_mean_objective = mean_objective;
+	cached_window_frac_lower = window_frac_lower;
+	cached_window_frac_upper = window_frac_upper;
+	cached_num_spread_bins = exec_time_parameter_num_spread_bins;
+
+	cached_local_vFOR_ObjectiveWindowBinIndices.clear();
+	cached_local_vAGAINST_ObjectiveBinIndices.clear();
+	cached_local_range_min_bin_index = 0;
+	cached_local_range_max_bin_index = -1;
+	if(bHasMeanObjectiveDefined) {
+		cached_local_range_min_bin_index = convert_exec_time_to_int_bin(
+				((1.0 - window_frac_lower) * mean_objective) );
+		cached_local_range_max_bin_index = convert_exec_time_to_int_bin(
+				((1.0 + window_frac_upper) * mean_objective) );
+
+		for(int i=cached_local_range_min_bin_index; i<=cached_local_range_max_bin_index; i++)
+			cached_local_vFOR_ObjectiveWindowBinIndices.push_back(i);
+
+		for(int i=0; i<cached_local_range_min_bin_index; i++)
+			cached_local_vAGAINST_ObjectiveBinIndices.push_back(i);
+		for(int i=cached_local_range_max_bin_index+1; i<exec_time_parameter_num_spread_bins; i++)
+			cached_local_vAGAINST_ObjectiveBinIndices.push_back(i);
+	}
+}
+
+void FrameDecisionModel::retarget_mean_objective(ExecTime_t mean_objective) {
+	assert(bHasMeanObjectiveDefined && mean_objective > 0.0);
+	this->mean_objective = mean_objective;
+
+	for(std::map<Parameter *, FastReactionState *>::iterator mit = map_parm_to_fast_reaction_state.begin();
+		mit != map_parm_to_fast_reaction_state.end(); mit++)
+	{
+		FastReactionState& frs = *(mit->second);
+		bool bPreviousYAbove = (frs.previous_Y > mean_objective);
+		bool bPreviousYBelow = (frs.previous_Y < mean_objective);
+		bool bConsistent = (frs.has_halfcycle_crossed_mean
+				? (frs.halfcycle_start_deflection_sign == -1 ? !bPreviousYBelow : !bPreviousYAbove)
+				: (frs.halfcycle_start_deflection_sign == -1 ? !bPreviousYAbove : !bPreviousYBelow) );
+		if(bConsistent)
+			continue;
+
+		//start new potential halfcycle w.r.t. the new mean
+		frs.halfcycle_start_deflection_sign = (bPreviousYAbove ? +1 : -1);
+		frs.halfcycle_Y_positive_max_deflection = 0.0;
+		frs.halfcycle_Y_negative_max_deflection = 0.0;
+		frs.halfcycle_length = 0;
+		frs.has_halfcycle_crossed_mean = false;
+	}
+}
+
+bool FrameDecisionModel::get_feature_cost_range(ExecTime_t& cost_at_lowest_feature, ExecTime_t& cost_at_highest_feature) const {
+	if(recent_exec_time == 0.0)
+		return false;
+
+	//Y = a1 * x1 + ... + an * xn with a_i < 0.0 and x_i = 0 at the highest feature level
+	double cost_decrease_to_lowest = 0.0;
+	double cost_increase_to_highest = 0.0;
+	bool bLearned = false;
+	for(std::map<Parameter *, FastReactionState *>::const_iterator mit = map_parm_to_fast_reaction_state.begin();
+		mit != map_parm_to_fast_reaction_state.end(); mit++)
+	{
+		const FastReactionState& frs = *(mit->second);
+		for(int i=0; i<(int)frs.vPrevious_model_choice_double_value.size(); i++) {
+			double X = frs.vPrevious_model_choice_double_value[i];
+			if(X < 0.0) //no choice made yet
+				continue;
+			double slope = fabs(frs.vCoeffs_a.at(i));
+			cost_decrease_to_lowest += slope * (frs.vMax_X.at(i) - X);
+			cost_increase_to_highest += slope * X;
+			bLearned = true;
+		}
+	}
+	if(bLearned == false)
+		return false;
+
+	cost_at_lowest_feature = recent_exec_time - cost_decrease_to_lowest;
+	if(cost_at_lowest_feature < 0.0)
+		cost_at_lowest_feature = 0.0;
+	cost_at_highest_feature = recent_exec_time + cost_increase_to_highest;
+	return true;
+}
+
+
+////////////////////////////////////////
+//class ExecFrameDecisionModel definitions
+////////////////////////////////////////
+
+const double ExecFrameDecisionModel::recent_item_cost_rate = 0.1;
+
+void ExecFrameDecisionModel::note_run(DecisionKey_t decision_int_value, ExecTime_t run_time, long long num_items) {
+	assert(num_items >= 1);
+	total_runs++;
+	total_items += num_items;
+	total_run_time += run_time;
+
+	ExecTime_t run_item_cost = run_time / num_items;
+	std::map<DecisionKey_t, ExecTime_t>::iterator mit = map_decision_to_item_cost.find(decision_int_value);
+	if(mit == map_decision_to_item_cost.end()) //first run of decision_int_value
+		map_decision_to_item_cost[decision_int_value] = run_item_cost;
+	else
+		mit->second += recent_item_cost_rate * (run_item_cost - mit->second);
+}
+
+bool ExecFrameDecisionModel::get_item_cost(DecisionKey_t decision_int_value, ExecTime_t& item_cost) const {
+	std::map<DecisionKey_t, ExecTime_t>::const_iterator mit = map_decision_to_item_cost.find(decision_int_value);
+	if(mit == map_decision_to_item_cost.end())
+		return false;
+	item_cost = mit->second;
+	return true;
+}
+
 ////////////////////////////
 
 #define MIN(x, y) ((x) < (y) ? (x) : (y))
 #define MAX(x, y) ((x) > (y) ? (x) : (y))
 
 void intersect_sorted_bin_vectors(
-	const std::vector<int>& vInputSet1,
+	const std::vector<ParameterValue_t>& vInputSet1,
 	const std::vector<double>& vInputSet1_Counts,
 	const std::vector<double>& vInputSet1_Probs,
-	const std::vector<int>& vInputSet2,
+	const std::vector<ParameterValue_t>& vInputSet2,
 	const std::vector<double>& vInputSet2_Counts,
 	const std::vector<double>& vInputSet2_Probs,
-	std::vector<int>& vReturnSet,
+	std::vector<ParameterValue_t>& vReturnSet,
 	std::vector<double>& vReturnSet_Counts,
 	std::vector<double>& vReturnSet_Probs
 )
@@ -128,13 +569,13 @@ void intersect_sorted_bin_vectors(
 }
 
 void union_sorted_bin_vectors(
-	const std::vector<int>& vInputSet1,
+	const std::vector<ParameterValue_t>& vInputSet1,
 	const std::vector<double>& vInputSet1_Counts,
 	const std::vector<double>& vInputSet1_Probs,
-	const std::vector<int>& vInputSet2,
+	const std::vector<ParameterValue_t>& vInputSet2,
 	const std::vector<double>& vInputSet2_Counts,
 	const std::vector<double>& vInputSet2_Probs,
-	std::vector<int>& vReturnSet,
+	std::vector<ParameterValue_t>& vReturnSet,
 	std::vector<double>& vReturnSet_Counts,
 	std::vector<double>& vReturnSet_Probs
 )
@@ -193,13 +634,13 @@ bool get_decision_sets_for_parameter(
 	Parameter& deciding_parameter,
 	Frame * innermost_deciding_ancestor_frame,
 		//return values:
-	std::vector<int>& vForDecisionSet,
+	std::vector<ParameterValue_t>& vForDecisionSet,
 	std::vector<double>& vForDecisionSet_Counts,
 	std::vector<double>& vForDecisionSet_Probs,
-	std::vector<int>& vUnclassifiedDecisionSet,
+	std::vector<ParameterValue_t>& vUnclassifiedDecisionSet,
 	std::vector<double>& vUnclassifiedDecisionSet_Counts,
 	std::vector<double>& vUnclassifiedDecisionSet_Probs,
-	std::vector<int>& vAgainstDecisionSet,
+	std::vector<ParameterValue_t>& vAgainstDecisionSet,
 	std::vector<double>& vAgainstDecisionSet_Counts,
 	std::vector<double>& vAgainstDecisionSet_Probs
 )
@@ -252,19 +693,19 @@ bool get_decision_sets_for_parameter(
 	//   Also return boolean flag indicating whether dec_index search was terminated early (thereby preventing atleast
 	//      one lower ancestor from expressing its preference).
 
-	std::vector< std::vector<int> > vMostDesirableDecisionSets;
+	std::vector< std::vector<ParameterValue_t> > vMostDesirableDecisionSets;
 	std::vector< std::vector<double> > vMostDesirableDecisionSetCounts;
 	std::vector< std::vector<double> > vMostDesirableDecisionSetProbs;
 
-	std::vector< std::vector<int> > vUnknownDesirableDecisionSets;
+	std::vector< std::vector<ParameterValue_t> > vUnknownDesirableDecisionSets;
 	std::vector< std::vector<double> > vUnknownDesirableDecisionSetCounts;
 	std::vector< std::vector<double> > vUnknownDesirableDecisionSetProbs;
 
-	std::vector< std::vector<int> > vLeastDesirableDecisionSets;
+	std::vector< std::vector<ParameterValue_t> > vLeastDesirableDecisionSets;
 	std::vector< std::vector<double> > vLeastDesirableDecisionSetCounts;
 	std::vector< std::vector<double> > vLeastDesirableDecisionSetProbs;
 
-	std::vector<int> previous_UnclassifiedDecisionSet;
+	std::vector<ParameterValue_t> previous_UnclassifiedDecisionSet;
 	std::vector<double> previous_UnclassifiedDecisionSetCount;
 	std::vector<double> previous_UnclassifiedDecisionSetProb;
 
@@ -279,26 +720,26 @@ bool get_decision_sets_for_parameter(
 		ParameterExecSpread * spread
 			= ancestor_dec_model.map_parm_to_spread[ &(deciding_parameter) ];
 
-		std::vector<int> ancestor_MostDesirableDecisionSet;
+		std::vector<ParameterValue_t> ancestor_MostDesirableDecisionSet;
 		std::vector<double> ancestor_MostDesirableDecisionSetCount;
 		std::vector<double> ancestor_MostDesirableDecisionSetProb;
 
-		std::vector<int> ancestor_UnclassifiedDecisionSet;
+		std::vector<ParameterValue_t> ancestor_UnclassifiedDecisionSet;
 		std::vector<double> ancestor_UnclassifiedDecisionSetCount;
 		std::vector<double> ancestor_UnclassifiedDecisionSetProb;
 
-		std::vector<int> ancestor_LeastDesirableDecisionSet;
+		std::vector<ParameterValue_t> ancestor_LeastDesirableDecisionSet;
 		std::vector<double> ancestor_LeastDesirableDecisionSetCount;
 		std::vector<double> ancestor_LeastDesirableDecisionSetProb;
 
-		std::cout << "get_decision_sets_for_parameter: parent's vFOR_ObjectiveBinIndices = [";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "get_decision_sets_for_parameter: parent's vFOR_ObjectiveBinIndices = [";
 		for(int i=0; i<(int)ancestor_dec_model.vFOR_ObjectiveBinIndices.size(); i++)
-			std::cout << ancestor_dec_model.vFOR_ObjectiveBinIndices[i] << " ";
-		std::cout << "]" << std::endl;
-		std::cout << "get_decision_sets_for_parameter: parent's vAGAINST_ObjectiveBinIndices= [";
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << ancestor_dec_model.vFOR_ObjectiveBinIndices[i] << " ";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]" << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "get_decision_sets_for_parameter: parent's vAGAINST_ObjectiveBinIndices= [";
 		for(int i=0; i<(int)ancestor_dec_model.vAGAINST_ObjectiveBinIndices.size(); i++)
-			std::cout << ancestor_dec_model.vAGAINST_ObjectiveBinIndices[i] << " ";
-		std::cout << "]" << std::endl;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << ancestor_dec_model.vAGAINST_ObjectiveBinIndices[i] << " ";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]" << std::endl;
 		spread->get_discriminating_values(
 			ancestor_dec_model.vFOR_ObjectiveBinIndices, 0.80,
 				//return values:
@@ -315,7 +756,7 @@ bool get_decision_sets_for_parameter(
 		);
 
 		//construct unclassified set
-		std::vector<int> ancestor_AllDecisionSet;
+		std::vector<ParameterValue_t> ancestor_AllDecisionSet;
 		std::vector<double> ancestor_AllDecisionSetCount;
 		std::vector<double> ancestor_AllDecisionSetProb;
 		spread->get_discriminating_values(
@@ -326,10 +767,10 @@ bool get_decision_sets_for_parameter(
 			ancestor_AllDecisionSetProb
 		);
 
-		std::cout << " **** ancestor_AllDecisionSet = [";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << " **** ancestor_AllDecisionSet = [";
 		for(int x=0; x<(int)ancestor_AllDecisionSet.size(); x++)
-			std::cout << ancestor_AllDecisionSet[x] << ", ";
-		std::cout << "]" << std::endl;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << ancestor_AllDecisionSet[x] << ", ";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]" << std::endl;
 
 		int j=0;
 		int k=0;
@@ -357,12 +798,12 @@ bool get_decision_sets_for_parameter(
 			ancestor_UnclassifiedDecisionSetProb.push_back( ancestor_AllDecisionSetProb.at(i) );
 		}
 
-		std::cout << " **** ancestor_UnclassifiedDecisionSet = [";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << " **** ancestor_UnclassifiedDecisionSet = [";
 		for(int x=0; x<(int)ancestor_UnclassifiedDecisionSet.size(); x++)
-			std::cout << ancestor_UnclassifiedDecisionSet[x] << ", ";
-		std::cout << "]" << std::endl;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << ancestor_UnclassifiedDecisionSet[x] << ", ";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]" << std::endl;
 
-		std::vector<int> cumulative_UnclassifiedDecisionSet;
+		std::vector<ParameterValue_t> cumulative_UnclassifiedDecisionSet;
 		std::vector<double> cumulative_UnclassifiedDecisionSetCount;
 		std::vector<double> cumulative_UnclassifiedDecisionSetProb;
 
@@ -371,10 +812,10 @@ bool get_decision_sets_for_parameter(
 			ancestor_UnclassifiedDecisionSet, ancestor_UnclassifiedDecisionSetCount, ancestor_UnclassifiedDecisionSetProb,
 			cumulative_UnclassifiedDecisionSet, cumulative_UnclassifiedDecisionSetCount, cumulative_UnclassifiedDecisionSetProb);
 			
-		std::cout << " **** cumulative_UnclassifiedDecisionSet = [";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << " **** cumulative_UnclassifiedDecisionSet = [";
 		for(int x=0; x<(int)cumulative_UnclassifiedDecisionSet.size(); x++)
-			std::cout << cumulative_UnclassifiedDecisionSet[x] << ", ";
-		std::cout << "]" << std::endl;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << cumulative_UnclassifiedDecisionSet[x] << ", ";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]" << std::endl;
 
 		previous_UnclassifiedDecisionSet = cumulative_UnclassifiedDecisionSet;
 		previous_UnclassifiedDecisionSetCount = cumulative_UnclassifiedDecisionSetCount;
@@ -415,29 +856,29 @@ bool get_decision_sets_for_parameter(
 
 	int num_deciding_levels = (int)vMostDesirableDecisionSets.size();
 
-	std::cout << "get_decision_sets_for_parameter(): num_deciding_levels = " << num_deciding_levels << std::endl;
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "get_decision_sets_for_parameter(): num_deciding_levels = " << num_deciding_levels << std::endl;
 	for(int dli = num_deciding_levels-1; dli >= 0; dli--) {
-		std::cout << "   vMostDesirableDecisionSets[" << dli << "] = [";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "   vMostDesirableDecisionSets[" << dli << "] = [";
 		for(int x=0; x<(int)vMostDesirableDecisionSets[dli].size(); x++)
-			std::cout << vMostDesirableDecisionSets[dli][x] << " ";
-		std::cout << "]\n" << std::endl;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << vMostDesirableDecisionSets[dli][x] << " ";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]\n" << std::endl;
 
-		std::cout << "   vLeastDesirableDecisionSets[" << dli << "] = [";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "   vLeastDesirableDecisionSets[" << dli << "] = [";
 		for(int x=0; x<(int)vLeastDesirableDecisionSets[dli].size(); x++)
-			std::cout << vLeastDesirableDecisionSets[dli][x] << " ";
-		std::cout << "]\n" << std::endl;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << vLeastDesirableDecisionSets[dli][x] << " ";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]\n" << std::endl;
 	}
 
 	//Progressive intersections and unions
-	std::vector< std::vector<int> > vForSet(num_deciding_levels);
+	std::vector< std::vector<ParameterValue_t> > vForSet(num_deciding_levels);
 	std::vector< std::vector<double> > vForSetCounts(num_deciding_levels);
 	std::vector< std::vector<double> > vForSetProbs(num_deciding_levels);
 
-	std::vector< std::vector<int> > vUnclassifiedSet(num_deciding_levels);
+	std::vector< std::vector<ParameterValue_t> > vUnclassifiedSet(num_deciding_levels);
 	std::vector< std::vector<double> > vUnclassifiedSetCounts(num_deciding_levels);
 	std::vector< std::vector<double> > vUnclassifiedSetProbs(num_deciding_levels);
 
-	std::vector< std::vector<int> > vAgainstSet(num_deciding_levels);
+	std::vector< std::vector<ParameterValue_t> > vAgainstSet(num_deciding_levels);
 	std::vector< std::vector<double> > vAgainstSetCounts(num_deciding_levels);
 	std::vector< std::vector<double> > vAgainstSetProbs(num_deciding_levels);
 
@@ -537,10 +978,93 @@ bool get_decision_sets_for_parameter(
 
 
 
+//Re-apportions the mean objective of the budget frame among the frames sharing it (see Objective::budget_share()),
+//  and retargets the mean objective of 'frame' to its share.
+//  Every sharing frame is first given its cost at the lowest feature level. The remainder of the budget is handed
+//  out in increasing order of the cost of each frame's full feature range, i.e. to the frames that gain the most
+//  feature-level per unit of execution time first, each upto its cost at the highest feature level.
+//  Sharing frames are assumed to run once per invocation of the budget frame.
+void retarget_budget_share_objective(Frame * frame) {
+	FrameInfo * frame_info = FrameInfo::get_frame_info(frame);
+	FrameDecisionModel& frame_dec = frame_info->decision_model;
+
+	Frame * budget_frame = get_frame_from_frame_id(frame_info->objective.reference_frame_id);
+	FrameDecisionModel& budget_dec = FrameInfo::get_frame_info(budget_frame)->decision_model;
+	const std::vector<Frame *>& vShares = budget_dec.vBudget_share_frames;
+
+	//budget of the sharing frames = objective of the budget frame less its execution time outside them
+	ExecTime_t budget = budget_dec.mean_objective;
+	ExecTime_t sum_recent_exec_time = 0.0;
+	for(int i=0; i<(int)vShares.size(); i++)
+		sum_recent_exec_time += FrameInfo::get_frame_info(vShares[i])->decision_model.recent_exec_time;
+	if(budget_dec.recent_exec_time > sum_recent_exec_time)
+		budget -= budget_dec.recent_exec_time - sum_recent_exec_time;
+
+	std::vector<ExecTime_t> vShare(vShares.size(), 0.0);
+	std::vector<ExecTime_t> vCostRange(vShares.size(), -1.0); //-1.0 => cost not yet learned
+	std::vector<int> vLearned;
+	ExecTime_t sum_cost_at_lowest_feature = 0.0;
+	int my_index = -1;
+	for(int i=0; i<(int)vShares.size(); i++) {
+		FrameInfo * share_info = FrameInfo::get_frame_info(vShares[i]);
+		if(vShares[i] == frame)
+			my_index = i;
+
+		ExecTime_t cost_at_lowest_feature, cost_at_highest_feature;
+		if(share_info->decision_model.get_feature_cost_range(cost_at_lowest_feature, cost_at_highest_feature)) {
+			vShare[i] = cost_at_lowest_feature;
+			vCostRange[i] = cost_at_highest_feature - cost_at_lowest_feature;
+			sum_cost_at_lowest_feature += cost_at_lowest_feature;
+			vLearned.push_back(i);
+		}
+		else { //initial share
+			vShare[i] = budget_dec.mean_objective * share_info->objective.relative_mean_frac;
+			budget -= vShare[i];
+		}
+	}
+	assert(my_index != -1);
+
+	if(vCostRange[my_index] >= 0.0) {
+		if(budget <= sum_cost_at_lowest_feature) { //over budget even at lowest feature levels: scale down proportionately
+			for(int j=0; j<(int)vLearned.size(); j++) {
+				int i = vLearned[j];
+				vShare[i] = (sum_cost_at_lowest_feature > 0.0 ? vShare[i] * budget / sum_cost_at_lowest_feature : budget / vLearned.size());
+			}
+		}
+		else {
+			ExecTime_t remaining_budget = budget - sum_cost_at_lowest_feature;
+			while(remaining_budget > 0.0) {
+				int cheapest = -1;
+				for(int j=0; j<(int)vLearned.size(); j++) {
+					int i = vLearned[j];
+					if(vCostRange[i] > 0.0 && (cheapest == -1 || vCostRange[i] < vCostRange[cheapest]))
+						cheapest = i;
+				}
+				if(cheapest == -1) //every sharing frame can afford its highest feature level
+					break;
+
+				ExecTime_t increase = MIN(remaining_budget, vCostRange[cheapest]);
+				vShare[cheapest] += increase;
+				remaining_budget -= increase;
+				vCostRange[cheapest] = 0.0; //exhausted
+			}
+		}
+	}
+
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "Frame #" << frame->id << " retarget_budget_share_objective(): budget_frame #" << budget_frame->id
+		<< " budget = " << budget << " share = " << vShare[my_index] << " (previous mean_objective = " << frame_dec.mean_objective << ")" << std::endl;
+
+	if(vShare[my_index] > 0.0)
+		frame_dec.retarget_mean_objective(vShare[my_index]);
+	//else keep previous mean_objective: no meaningful share exists for the frame
+}
+
 void activate_decision_model_and_decide_setting(Frame * frame) {
 	FrameInfo * frame_info = FrameInfo::get_frame_info(frame);
 	FrameDecisionModel& frame_dec = frame_info->decision_model;
 
+	frame_dec.invocation_index++;
+
 	//Make sure parent tracks current frame's execution-time-parameter
 	if(frame_info->curr_parent_frame != 0) {
 		if(frame_dec.exec_time_parameter.has_consumer(frame_info->curr_parent_frame) == false)
@@ -583,11 +1107,16 @@ void activate_decision_model_and_decide_setting(Frame * frame) {
 	//        progressive AGAINST set (at the same level) becomes the current-frame's vAGAINST_ObjectiveBinIndices.
 	
 	if(frame_dec.isObjectiveInitialized() == false) {
-		if(frame_info->objective.isDefined) {
+		if(frame_info->objective.isDefined && frame_info->objective.type == Objective::ObjQUALITY_FLOOR) {
+			//no mean-objective: execution time is minimized rather than steered into a window
+			frame_dec.initialize_objective(false);
+			frame_dec.initialize_quality_floor(frame_info->objective.min_quality, frame_info->objective.prob, frame_info->objective.cost);
+		}
+		else if(frame_info->objective.isDefined) {
 			ExecTime_t mean = 0.0;
 			if(frame_info->objective.type == Objective::ObjABSOLUTE)
 			{ mean = frame_info->objective.mean; }
-			else { //Objective::ObjRELATIVE
+			else { //Objective::ObjRELATIVE or Objective::ObjBUDGET_SHARE
 				Frame * ref_frame = get_frame_from_frame_id(frame_info->objective.reference_frame_id);
 				FrameInfo * ref_frame_info = FrameInfo::get_frame_info(ref_frame);
 
@@ -595,30 +1124,37 @@ void activate_decision_model_and_decide_setting(Frame * frame) {
 				assert(ref_frame_info->decision_model.bHasMeanObjectiveDefined == true);
 
 				mean = ref_frame_info->decision_model.mean_objective * frame_info->objective.relative_mean_frac;
+
+				if(frame_info->objective.type == Objective::ObjBUDGET_SHARE)
+					ref_frame_info->decision_model.vBudget_share_frames.push_back(frame);
 			}
 
 			frame_dec.initialize_objective(true,
-				mean, frame_info->objective.window_frac_lower, frame_info->objective.window_frac_upper, frame_info->objective.prob, frame_info->objective.sliding_window_size, frame_info->objective.impact_rescaler);
+				mean, frame_info->objective.window_frac_lower, frame_info->objective.window_frac_upper, frame_info->objective.prob, frame_info->objective.sliding_window_size, frame_info->objective.impact_rescaler,
+				frame_info->objective.enforcement, frame_info->objective.enforcement_window_length);
 		}
 		else //no mean-objective specified
 		{ frame_dec.initialize_objective(false); }
+
+		snapshot_restore_frame_state(frame);
 	}
 
+	if(frame_info->objective.isDefined && frame_info->objective.type == Objective::ObjBUDGET_SHARE)
+		retarget_budget_share_objective(frame);
+
 	//Local setting for objective-bins
-	std::vector<int> local_vFOR_ObjectiveWindowBinIndices;
-	std::vector<int> local_vAGAINST_ObjectiveBinIndices;
-	frame_dec.get_ObjectiveWindowBinIndices_for_local_objective(
-		local_vFOR_ObjectiveWindowBinIndices, local_vAGAINST_ObjectiveBinIndices);
+	const std::vector<int>& local_vFOR_ObjectiveWindowBinIndices = frame_dec.get_local_objective_vFOR_bin_indices();
+	const std::vector<int>& local_vAGAINST_ObjectiveBinIndices = frame_dec.get_local_objective_vAGAINST_bin_indices();
 
 	//Preference of dynamic parents
 	bool bUpperParentBlocksLowerParentsPreferences = false;
-	std::vector<int> vForDecisionSet;
+	std::vector<ParameterValue_t> vForDecisionSet;
 	std::vector<double> vForDecisionSet_Counts;
 	std::vector<double> vForDecisionSet_Probs;
-	std::vector<int> vUnclassifiedDecisionSet;
+	std::vector<ParameterValue_t> vUnclassifiedDecisionSet;
 	std::vector<double> vUnclassifiedDecisionSet_Counts;
 	std::vector<double> vUnclassifiedDecisionSet_Probs;
-	std::vector<int> vAgainstDecisionSet;
+	std::vector<ParameterValue_t> vAgainstDecisionSet;
 	std::vector<double> vAgainstDecisionSet_Counts;
 	std::vector<double> vAgainstDecisionSet_Probs;
 
@@ -633,8 +1169,8 @@ void activate_decision_model_and_decide_setting(Frame * frame) {
 	}
 
 	if(bUpperParentBlocksLowerParentsPreferences == true) { //since a upper-level consumer blocks, local-settings will also be blocked
-		frame_dec.vFOR_ObjectiveBinIndices = vForDecisionSet;
-		frame_dec.vAGAINST_ObjectiveBinIndices = vAgainstDecisionSet;
+		frame_dec.vFOR_ObjectiveBinIndices.assign(vForDecisionSet.begin(), vForDecisionSet.end());
+		frame_dec.vAGAINST_ObjectiveBinIndices.assign(vAgainstDecisionSet.begin(), vAgainstDecisionSet.end());
 	}
 	else { //upper-level does not block, attempt to incorporate local-settings as well
 		if(vForDecisionSet.size() == 0 && vAgainstDecisionSet.size() == 0) { //no preferences from parents
@@ -642,37 +1178,43 @@ void activate_decision_model_and_decide_setting(Frame * frame) {
 			frame_dec.vAGAINST_ObjectiveBinIndices = local_vAGAINST_ObjectiveBinIndices;
 		}
 		else { //some preferences from parents
-			std::vector<int> vFOR_ReturnSet;
+			std::vector<ParameterValue_t> local_vFOR_ObjectiveWindowBinValues(
+				local_vFOR_ObjectiveWindowBinIndices.begin(), local_vFOR_ObjectiveWindowBinIndices.end());
+			std::vector<ParameterValue_t> local_vAGAINST_ObjectiveBinValues(
+				local_vAGAINST_ObjectiveBinIndices.begin(), local_vAGAINST_ObjectiveBinIndices.end());
+				//as values of the exec_time_parameter, for combining with the parents' preferences
+
+			std::vector<ParameterValue_t> vFOR_ReturnSet;
 			std::vector<double> vFOR_ReturnSet_Counts;
 			std::vector<double> vFOR_ReturnSet_Probs;
 
 			//assumption: vForDecisionSet, local_vFOR_ObjectiveWindowBinIndices are sorted in ascending order
 			intersect_sorted_bin_vectors(
 				vForDecisionSet, vForDecisionSet_Counts, vForDecisionSet_Probs,
-				local_vFOR_ObjectiveWindowBinIndices, std::vector<double>(local_vFOR_ObjectiveWindowBinIndices.size(), 0.0),
+				local_vFOR_ObjectiveWindowBinValues, std::vector<double>(local_vFOR_ObjectiveWindowBinValues.size(), 0.0),
 					std::vector<double>(local_vFOR_ObjectiveWindowBinIndices.size(), 0.0),
 				vFOR_ReturnSet, vFOR_ReturnSet_Counts, vFOR_ReturnSet_Probs
 			);
 
-			std::vector<int> vAGAINST_ReturnSet;
+			std::vector<ParameterValue_t> vAGAINST_ReturnSet;
 			std::vector<double> vAGAINST_ReturnSet_Counts;
 			std::vector<double> vAGAINST_ReturnSet_Probs;
 
 			//assumption: vAgainstDecisionSet, local_vAGAINST_ObjectiveBinIndices are sorted in ascending order
 			union_sorted_bin_vectors(
 				vAgainstDecisionSet, vAgainstDecisionSet_Counts, vAgainstDecisionSet_Probs,
-				local_vAGAINST_ObjectiveBinIndices, std::vector<double>(local_vAGAINST_ObjectiveBinIndices.size(), 0.0),
+				local_vAGAINST_ObjectiveBinValues, std::vector<double>(local_vAGAINST_ObjectiveBinValues.size(), 0.0),
 					std::vector<double>(local_vAGAINST_ObjectiveBinIndices.size(), 0.0),
 				vAGAINST_ReturnSet, vAGAINST_ReturnSet_Counts, vAGAINST_ReturnSet_Probs
 			);
 
 			if(vFOR_ReturnSet.size() == 0) { //upper-levels block local-settings
-				frame_dec.vFOR_ObjectiveBinIndices = vForDecisionSet;
-				frame_dec.vAGAINST_ObjectiveBinIndices = vAgainstDecisionSet;
+				frame_dec.vFOR_ObjectiveBinIndices.assign(vForDecisionSet.begin(), vForDecisionSet.end());
+				frame_dec.vAGAINST_ObjectiveBinIndices.assign(vAgainstDecisionSet.begin(), vAgainstDecisionSet.end());
 			}
 			else { //all levels including local-settings can express preference
-				frame_dec.vFOR_ObjectiveBinIndices = vFOR_ReturnSet;
-				frame_dec.vAGAINST_ObjectiveBinIndices = vAGAINST_ReturnSet;
+				frame_dec.vFOR_ObjectiveBinIndices.assign(vFOR_ReturnSet.begin(), vFOR_ReturnSet.end());
+				frame_dec.vAGAINST_ObjectiveBinIndices.assign(vAGAINST_ReturnSet.begin(), vAGAINST_ReturnSet.end());
 			}
 		}
 	}
@@ -684,7 +1226,7 @@ bool bMagnifyCount_by_SuccessFailure_DeviationDegree = true;
 
 void feature_control_MagnifyCount_by_SuccessFailure_DeviationDegree(bool new_setting) {
 	bMagnifyCount_by_SuccessFailure_DeviationDegree = new_setting;
-	std::cout << "SRT Feature Control: bMagnifyCount_by_SuccessFailure_DeviationDegree = " << bMagnifyCount_by_SuccessFailure_DeviationDegree
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: bMagnifyCount_by_SuccessFailure_DeviationDegree = " << bMagnifyCount_by_SuccessFailure_DeviationDegree
 		<< std::endl;
 }
 
@@ -707,7 +1249,7 @@ double deemphasize_history_rate_alpha = 0.99;
 void feature_control_DeemphasizeHistoryWithAlphaRate(bool enable, double alpha_rate) {
 	bDeemphasizeHistoryWithAlphaRate = enable;
 	deemphasize_history_rate_alpha = alpha_rate;
-	std::cout << "SRT Feature Control: bDeemphasizeHistoryWithAlphaRate = " << bDeemphasizeHistoryWithAlphaRate << " deemphasize_history_rate_alpha = " << deemphasize_history_rate_alpha
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: bDeemphasizeHistoryWithAlphaRate = " << bDeemphasizeHistoryWithAlphaRate << " deemphasize_history_rate_alpha = " << deemphasize_history_rate_alpha
 		<< std::endl;
 }
 
@@ -728,7 +1270,7 @@ double forget_history_threshold_ratio_beta = 0.001;
 void feature_control_ForgetHistoryBelowBetaThreshold(bool enable, double beta_ratio) {
 	bForgetHistoryBelowBetaThreshold = enable;
 	forget_history_threshold_ratio_beta = beta_ratio;
-	std::cout << "SRT Feature Control: bForgetHistoryBelowBetaThreshold = " << bForgetHistoryBelowBetaThreshold << " forget_history_threshold_ratio_beta = " << forget_history_threshold_ratio_beta
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: bForgetHistoryBelowBetaThreshold = " << bForgetHistoryBelowBetaThreshold << " forget_history_threshold_ratio_beta = " << forget_history_threshold_ratio_beta
 		<< std::endl;
 }
 
@@ -737,9 +1279,176 @@ std::pair<bool, double> feature_query_ForgetHistoryBelowBetaThreshold() {
 }
 
 
+//debug control
+
+bool bChangePointDetection = true;
+
+double change_point_threshold = 8.0;
+	//Page-Hinkley threshold on the accumulated deviation (in objective window half-widths) from the running mean
+
+void feature_control_change_point_detection(bool enable, double threshold) {
+	if(threshold <= 0.0) {
+		std::cerr << "feature_control_change_point_detection(): ERROR: threshold must be positive, given " << threshold << std::endl;
+		exit(1);
+	}
+	bChangePointDetection = enable;
+	change_point_threshold = threshold;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: bChangePointDetection = " << bChangePointDetection << " change_point_threshold = " << change_point_threshold
+		<< std::endl;
+}
+
+std::pair<bool, double> feature_query_change_point_detection() {
+	return std::make_pair(bChangePointDetection, change_point_threshold);
+}
+
+
+const double FrameDecisionModel::change_point_drift_tolerance = 0.5;
+const double FrameDecisionModel::change_point_min_window_frac = 0.05;
+const double FrameDecisionModel::change_point_history_retention = 0.1;
+const double FrameDecisionModel::change_point_min_baseline_weight = 1.0;
+const double FrameDecisionModel::change_point_prediction_weight = 1.0;
+const int FrameDecisionModel::change_point_recovery_length = 10;
+const double FrameDecisionModel::change_point_recovery_alpha = 0.9;
+
+bool FrameDecisionModel::note_invocation_for_change_point_detection(ExecTime_t rescaled_exec_time) {
+	if(bChangePointDetection == false || bHasMeanObjectiveDefined == false)
+		return false;
+
+	//Residual w.r.t. the execution time expected for the decisions taken, so that the decision strategies' own
+	//  moves (e.g., exploration) are not mistaken for change-points. With several ExecFrames, the expectations
+	//  conditioned on each one's decisions are averaged.
+	std::vector< std::pair<std::pair<long long int, DecisionKey_t>, double> > vDecisions;
+		//decisions of the invocation, with the fraction of their ExecFrame's decisions that took each
+	double sum_expected = 0.0;
+	int num_expected = 0;
+	for(std::map<Parameter *, IntValueCache *>::iterator mit = map_parm_to_curr_record.begin();
+		mit != map_parm_to_curr_record.end(); mit++)
+	{
+		Parameter * parm = mit->first;
+		IntValueCache * ivc = mit->second;
+		double total_count = ivc->get_sample_count();
+		if(parm->source->get_type() != BaseFrame::EXECFRAME || total_count <= 0.0)
+			continue;
+
+		double expected = 0.0;
+		bool bHasBaseline = true;
+		for(int i=0; i<(int)ivc->vCacheEntries.size(); i++) {
+			IntCacheEntry& ce = ivc->vCacheEntries[i];
+			if(ce.valid == false)
+				continue;
+			std::pair<long long int, DecisionKey_t> key(parm->parmID, ce.tag);
+			vDecisions.push_back( std::make_pair(key, ce.count / total_count) );
+
+			std::map< std::pair<long long int, DecisionKey_t>, std::pair<double, double> >::const_iterator bit
+				= map_ParmDecision_ExecTimeSumWeight.find(key);
+			if(bit == map_ParmDecision_ExecTimeSumWeight.end() || bit->second.second < change_point_min_baseline_weight)
+				bHasBaseline = false;
+			else
+				expected += ce.count / total_count * bit->second.first / bit->second.second;
+		}
+		if(bHasBaseline) {
+			sum_expected += expected;
+			num_expected++;
+		}
+	}
+
+	bool bDetected = false;
+	if(num_expected > 0 && sum_expected > 0.0) {
+		double window_half_width_frac = (window_frac_lower + window_frac_upper) / 2.0;
+		if(window_half_width_frac < change_point_min_window_frac)
+			window_half_width_frac = change_point_min_window_frac;
+		double residual = (rescaled_exec_time - sum_expected / num_expected) / (mean_objective * window_half_width_frac);
+
+		int detected = change_point_detector.note_sample(residual, change_point_threshold);
+		if(detected != 0) {
+			change_point_count++;
+			OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "FrameDecisionModel::note_invocation_for_change_point_detection(): CHANGE-POINT #" << change_point_count
+				<< (detected > 0 ? " (increase)" : " (decrease)") << " detected on rescaled_exec_time = " << rescaled_exec_time
+				<< " expected = " << sum_expected / num_expected << " residual = " << residual << std::endl;
+			react_to_change_point(rescaled_exec_time / (sum_expected / num_expected));
+			bDetected = true;
+		}
+	}
+
+	//update the expectations, forgetting at the rate of the rest of the history
+	double alpha_rate = (bDeemphasizeHistoryWithAlphaRate ? deemphasize_history_rate_alpha : 1.0);
+	if(change_point_recovery_remaining > 0 && alpha_rate > change_point_recovery_alpha)
+		alpha_rate = change_point_recovery_alpha;
+	std::map< std::pair<long long int, DecisionKey_t>, std::pair<double, double> >::iterator bit = map_ParmDecision_ExecTimeSumWeight.begin();
+	while(bit != map_ParmDecision_ExecTimeSumWeight.end()) {
+		bit->second.first *= alpha_rate;
+		bit->second.second *= alpha_rate;
+		if(bit->second.second < ThompsonSamplingModel::min_retained_count)
+			map_ParmDecision_ExecTimeSumWeight.erase(bit++);
+		else
+			bit++;
+	}
+	for(int k=0; k<(int)vDecisions.size(); k++) {
+		std::pair<double, double>& sum_weight = map_ParmDecision_ExecTimeSumWeight[vDecisions[k].first];
+		sum_weight.first += vDecisions[k].second * rescaled_exec_time;
+		sum_weight.second += vDecisions[k].second;
+	}
+
+	return bDetected;
+}
+
+void FrameDecisionModel::react_to_change_point(double shift_ratio) {
+	//Decisions are assumed to keep their relative costs across the change-point: the expected execution times are
+	//  re-based by shift_ratio rather than forgotten, and predict the outcome of each decision in the new regime.
+	ExecTime_t window_lower = mean_objective * (1.0 - window_frac_lower);
+	ExecTime_t window_upper = mean_objective * (1.0 + window_frac_upper);
+
+	std::map<long long int, ThompsonSamplingModel *> map_parmID_to_thompson_model;
+	for(std::map<Parameter *, ThompsonSamplingModel *>::iterator mit = map_parm_to_thompson_model.begin();
+		mit != map_parm_to_thompson_model.end(); mit++)
+	{
+		mit->second->deemphasize_history(change_point_history_retention);
+		map_parmID_to_thompson_model[mit->first->parmID] = mit->second;
+	}
+
+	for(std::map< std::pair<long long int, DecisionKey_t>, std::pair<double, double> >::iterator bit = map_ParmDecision_ExecTimeSumWeight.begin();
+		bit != map_ParmDecision_ExecTimeSumWeight.end(); bit++)
+	{
+		bit->second.first *= shift_ratio * change_point_history_retention;
+		bit->second.second *= change_point_history_retention;
+
+		std::map<long long int, ThompsonSamplingModel *>::iterator tit = map_parmID_to_thompson_model.find(bit->first.first);
+		if(tit == map_parmID_to_thompson_model.end())
+			continue;
+		ExecTime_t predicted_exec_time = bit->second.first / bit->second.second;
+		bool bPredictedSuccess = (predicted_exec_time >= window_lower && predicted_exec_time <= window_upper);
+		for(int c=0; c<ThompsonSamplingModel::num_context_bins; c++)
+			tit->second->note_outcome(c, bit->first.second, change_point_prediction_weight, bPredictedSuccess);
+	}
+
+	for(std::map<Parameter *, ParameterExecSpread *>::iterator mit = map_parm_to_spread.begin();
+		mit != map_parm_to_spread.end(); mit++)
+	{
+		ParameterExecSpread& parm_exec_spread = *(mit->second);
+		for(int i=0; i<(int)parm_exec_spread.vExecSpreadBins.size(); i++) {
+			IntValueCache& ivc = parm_exec_spread.vExecSpreadBins[i];
+			ivc.normalize_wrt_new_sample_count( ivc.get_sample_count() * change_point_history_retention );
+		}
+	}
+
+	for(std::map<Parameter *, FastReactionState *>::iterator mit = map_parm_to_fast_reaction_state.begin();
+		mit != map_parm_to_fast_reaction_state.end(); mit++)
+	{
+		FastReactionState& frs = *(mit->second);
+		for(int i=0; i<(int)frs.vCoeffs_a.size(); i++)
+			frs.vCoeffs_a[i] *= shift_ratio;
+		frs.restart_rescaling_statistics(mean_objective);
+	}
+
+	exec_time_sliding_window.initialize(sliding_window_size);
+	recent_exec_time = 0.0; //re-based on the current invocation
+	change_point_recovery_remaining = change_point_recovery_length;
+}
+
+
 void update_decision_model_on_completion(Frame * frame) {
 	//1. Read frame_info->current_invocation_exec_time, update statistics
-	//    - frame_dec.exec_time_record
+	//    - frame_dec.exec_time_record, frame_dec.exec_time_histogram, controller overhead totals
 	//    - frame_dec.exec_time_parameter
 	//
 	//2. Update map_parm_to_spread using *normalized* map_parm_to_curr_record, and clear map_parm_to_curr_record
@@ -756,12 +1465,35 @@ void update_decision_model_on_completion(Frame * frame) {
 	FrameInfo * frame_info = FrameInfo::get_frame_info(frame);
 	FrameDecisionModel& frame_dec = frame_info->decision_model;
 
+	ExecTime_t rescaled_invocation_exec_time = frame_dec.impact_rescaler(frame_info->current_invocation_exec_time);
+
+	//a new workload regime makes the history learned so far, including the sliding window, misleading
+	frame_dec.note_invocation_for_change_point_detection(rescaled_invocation_exec_time);
+
+	double history_alpha = deemphasize_history_rate_alpha;
+	bool bDeemphasizeHistory = bDeemphasizeHistoryWithAlphaRate;
+	if(frame_dec.change_point_recovery_remaining > 0) {
+		if(bDeemphasizeHistory == false || history_alpha > FrameDecisionModel::change_point_recovery_alpha)
+			history_alpha = FrameDecisionModel::change_point_recovery_alpha;
+		bDeemphasizeHistory = true;
+		frame_dec.change_point_recovery_remaining--;
+	}
+
+	frame_dec.exec_time_histogram.record(frame_info->current_invocation_exec_time);
+	frame_dec.total_controller_overhead += frame_info->current_invocation_controller_overhead;
+	frame_dec.total_exec_time_with_controller_overhead += frame_info->current_invocation_exec_time
+		+ (feature_query_subtract_controller_overhead() ? frame_info->current_invocation_controller_overhead : 0.0);
 	frame_dec.exec_time_sliding_window.push(frame_info->current_invocation_exec_time);
-	std::cout << "  exec_time_sliding_window = " << frame_dec.exec_time_sliding_window.print_string() << std::endl;
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "  exec_time_sliding_window = " << frame_dec.exec_time_sliding_window.print_string() << std::endl;
 
 	ExecTime_t rescaled_current_invocation_exec_time
 		= frame_dec.impact_rescaler( frame_dec.exec_time_sliding_window.get_average() );
 
+	if(frame_dec.recent_exec_time == 0.0)
+		frame_dec.recent_exec_time = rescaled_invocation_exec_time;
+	else
+		frame_dec.recent_exec_time += FrameDecisionModel::recent_exec_time_rate * (rescaled_invocation_exec_time - frame_dec.recent_exec_time);
+
 	
 	if(frame_dec.bHasMeanObjectiveDefined) {
 		bool bUnbinnedObjectiveSuccess = ( rescaled_current_invocation_exec_time >= frame_dec.mean_objective * (1.0 - frame_dec.window_frac_lower)
@@ -777,17 +1509,19 @@ void update_decision_model_on_completion(Frame * frame) {
 		frame_dec.unbinned_variance = frame_dec.unbinned_sq_mean - frame_dec.unbinned_mean * frame_dec.unbinned_mean;
 
 		frame_dec.unbinned_variance_from_mean_objective = frame_dec.unbinned_sq_mean - frame_dec.mean_objective * frame_dec.mean_objective;
+
+		frame_dec.note_invocation_for_enforcement(rescaled_current_invocation_exec_time, bUnbinnedObjectiveSuccess);
 	}
 
 	int current_exec_time_as_bin_index
 		= frame_dec.convert_exec_time_to_int_bin(rescaled_current_invocation_exec_time);
 
 	frame_dec.exec_time_parameter.inform_enclosing_active_consumers_of_sample_measurement(
-			get_dynamically_enclosing_frames(frame), current_exec_time_as_bin_index);
+			frame_info->curr_parent_frame, current_exec_time_as_bin_index);
 
 	double unbinned_std = sqrt(frame_dec.unbinned_variance);
 	double unbinned_std_from_mean_objective = sqrt(frame_dec.unbinned_variance_from_mean_objective);
-	std::cout << "Frame #" << frame->id << " exec-time occurred: current_exec_time_as_bin_index = "
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "Frame #" << frame->id << " exec-time occurred: current_exec_time_as_bin_index = "
 		<< current_exec_time_as_bin_index
 		<< " on rescaled_current_invocation_exec_time = " << rescaled_current_invocation_exec_time
 		<< " unbinned_satisfaction_ratio = " << frame_dec.unbinned_satisfaction_ratio << " total_invoke_count = " << frame_dec.total_invoke_count
@@ -817,6 +1551,10 @@ void update_decision_model_on_completion(Frame * frame) {
 		double range = upper_boundary - lower_boundary; // strictly > 0.0
 
 		double mean = frame_dec.mean_objective;
+		if(mean < lower_boundary) //parents' preferences may exclude a retargeted mean_objective
+			mean = lower_boundary;
+		if(mean > upper_boundary)
+			mean = upper_boundary;
 		double deviation = fabs(rescaled_current_invocation_exec_time - mean) / range; // 0 <= deviation < 1.0
 		assert(0 <= deviation && deviation < 1.0);
 
@@ -825,8 +1563,8 @@ void update_decision_model_on_completion(Frame * frame) {
 		if(not bMagnifyCount_by_SuccessFailure_DeviationDegree)
 			magnified_count = 1.0;
 
-		std::cout << "Frame #" << frame->id << " Objective SUCCESS: magnified_count = " << magnified_count << " on deviation = " << deviation;
-		std::cout << " for current_exec_time_as_bin_index = " << current_exec_time_as_bin_index << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "Frame #" << frame->id << " Objective SUCCESS: magnified_count = " << magnified_count << " on deviation = " << deviation;
+		OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << " for current_exec_time_as_bin_index = " << current_exec_time_as_bin_index << std::endl;
 	}
 	
 	else if(bActiveObjectiveFailure) {
@@ -855,14 +1593,14 @@ void update_decision_model_on_completion(Frame * frame) {
 			if(not bMagnifyCount_by_SuccessFailure_DeviationDegree)
 				magnified_count = 1.0;
 
-			std::cout << "Frame #" << frame->id << " Objective FAILURE: magnified_count = " << magnified_count << " on deviation = " << deviation;
+			OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "Frame #" << frame->id << " Objective FAILURE: magnified_count = " << magnified_count << " on deviation = " << deviation;
 		}
 		else { // vFOR_ObjectiveBinIndices empty, so no way to judge severity of deviation
 			magnified_count = 1.0;
 
-			std::cout << "Frame #" << frame->id << " Objective FAILURE: magnified_count = " << magnified_count << " on deviation = N/A";
+			OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "Frame #" << frame->id << " Objective FAILURE: magnified_count = " << magnified_count << " on deviation = N/A";
 		}
-		std::cout << " for current_exec_time_as_bin_index = " << current_exec_time_as_bin_index << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << " for current_exec_time_as_bin_index = " << current_exec_time_as_bin_index << std::endl;
 	}
 
 	//Update failure run-length statistics
@@ -881,14 +1619,7 @@ void update_decision_model_on_completion(Frame * frame) {
 		}
 	}
 
-	std::vector<int> local_vFOR_ObjectiveWindowBinIndices;
-	std::vector<int> local_vAGAINST_ObjectiveBinIndices;
-	frame_dec.get_ObjectiveWindowBinIndices_for_local_objective(
-		local_vFOR_ObjectiveWindowBinIndices, local_vAGAINST_ObjectiveBinIndices);
-
-	bool bSpecifiedObjectiveFailure = ( std::find(
-			local_vAGAINST_ObjectiveBinIndices.begin(), local_vAGAINST_ObjectiveBinIndices.end(),
-			current_exec_time_as_bin_index) != local_vAGAINST_ObjectiveBinIndices.end() );
+	bool bSpecifiedObjectiveFailure = frame_dec.is_bin_against_local_objective(current_exec_time_as_bin_index);
 	if(bSpecifiedObjectiveFailure)
 	{ frame_dec.specified_objective_failure_run_length++; }
 	else {
@@ -904,6 +1635,60 @@ void update_decision_model_on_completion(Frame * frame) {
 		}
 	}
 
+	//Update Thompson Sampling posteriors (before map_parm_to_curr_record is normalized and cleared below)
+	if(frame_dec.bHasMeanObjectiveDefined || frame_dec.bHasQualityFloorObjective) {
+		//credit the decisions with the outcome of this invocation alone, not of the sliding-window average
+		bool bInvocationObjectiveSuccess = false;
+		if(frame_dec.bHasMeanObjectiveDefined) {
+			bInvocationObjectiveSuccess = frame_dec.is_invocation_objective_success(
+				frame_dec.impact_rescaler(frame_info->current_invocation_exec_time) );
+		}
+		//else quality floor: the outcomes are the qualities reported for the invocation
+
+		for(std::map<Parameter *, ThompsonSamplingModel *>::iterator mit = frame_dec.map_parm_to_thompson_model.begin();
+				mit != frame_dec.map_parm_to_thompson_model.end();
+				mit++
+		) {
+			ThompsonSamplingModel * thompson_model = mit->second;
+			if(thompson_model->active_context_bin == -1) { //Thompson Sampling Strategy not used for parm in this invocation
+				thompson_model->note_last_invocation_decisions( std::vector< std::pair<DecisionKey_t, double> >() );
+				continue;
+			}
+
+			assert(frame_dec.map_parm_to_curr_record.count(mit->first) > 0);
+			IntValueCache * ivc = frame_dec.map_parm_to_curr_record[mit->first];
+			double total_count = ivc->get_sample_count();
+			std::vector< std::pair<DecisionKey_t, double> > vDecisions;
+			for(int i=0; i<(int)ivc->vCacheEntries.size(); i++) {
+				IntCacheEntry& ce = ivc->vCacheEntries[i];
+				if(ce.valid && total_count > 0.0) {
+					if(frame_dec.bHasMeanObjectiveDefined)
+						thompson_model->note_outcome(thompson_model->active_context_bin, ce.tag, ce.count / total_count, bInvocationObjectiveSuccess);
+					vDecisions.push_back( std::make_pair(ce.tag, ce.count / total_count) );
+				}
+			}
+
+			thompson_model->note_last_invocation_decisions(vDecisions);
+			if(frame_dec.bHasQualityFloorObjective)
+				thompson_model->note_cost_of_last_invocation( frame_info->get_current_invocation_cost() );
+			for(int q=0; q<(int)frame_info->vQuality_reports_of_current_invocation.size(); q++) {
+				double quality = frame_info->vQuality_reports_of_current_invocation[q];
+				thompson_model->note_quality_of_last_invocation(quality);
+				if(frame_dec.bHasQualityFloorObjective)
+					thompson_model->note_outcome_of_last_invocation(thompson_model->active_context_bin, quality >= frame_dec.min_quality);
+			}
+
+			if(bDeemphasizeHistory)
+				thompson_model->deemphasize_history(history_alpha);
+
+			thompson_model->active_context_bin = -1;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << "Frame #" << frame->id << " thompson_model for parmID = " << mit->first->parmID
+				<< ": " << thompson_model->print_string() << std::endl;
+		}
+	}
+
+	frame_info->vQuality_reports_of_current_invocation.clear();
+
 	//Update spread
 	for(std::map<Parameter *, IntValueCache *>::iterator mit = frame_dec.map_parm_to_curr_record.begin();
 			mit != frame_dec.map_parm_to_curr_record.end();
@@ -935,7 +1720,7 @@ void update_decision_model_on_completion(Frame * frame) {
 		ivc->clear();
 	}
 
-	if(bDeemphasizeHistoryWithAlphaRate) {
+	if(bDeemphasizeHistory) {
 		//Uniformly de-emphasize history
 		for(std::map<Parameter *, ParameterExecSpread *>::iterator mit
 					= frame_dec.map_parm_to_spread.begin();
@@ -945,7 +1730,7 @@ void update_decision_model_on_completion(Frame * frame) {
 			ParameterExecSpread& parm_exec_spread = *(mit->second);
 			for(int i=0; i<(int)parm_exec_spread.vExecSpreadBins.size(); i++) {
 				IntValueCache& ivc = parm_exec_spread.vExecSpreadBins[i];
-				ivc.normalize_wrt_new_sample_count( ivc.get_sample_count() * deemphasize_history_rate_alpha );
+				ivc.normalize_wrt_new_sample_count( ivc.get_sample_count() * history_alpha );
 			}
 		}
 	}
@@ -963,6 +1748,8 @@ void update_decision_model_on_completion(Frame * frame) {
 
 			for(int i=0; i<(int)parm_exec_spread.vExecSpreadBins.size(); i++) {
 				IntValueCache& ivc = parm_exec_spread.vExecSpreadBins[i];
+				if(ivc.get_sample_count() == 0.0) //nothing learned in this bin
+					continue;
 				for(int j=0; j<(int)ivc.vCacheEntries.size(); j++) {
 					IntCacheEntry& cache_entry = ivc.vCacheEntries[j];
 					if(cache_entry.valid && cache_entry.count < min_threshold)
@@ -972,7 +1759,54 @@ void update_decision_model_on_completion(Frame * frame) {
 		}
 	}
 	
-	frame_dec.previous_invocation_exec_time = rescaled_current_invocation_exec_time;
+	for(std::map<Parameter *, FastReactionState *>::iterator mit = frame_dec.map_parm_to_fast_reaction_state.begin();
+			mit != frame_dec.map_parm_to_fast_reaction_state.end();
+			mit++
+	) {
+		FastReactionState& frs = *(mit->second);
+		if(frame_info->vWorkload_hints.size() > 0 && frs.vCurrent_invocation_model_choice_double_value.size() > 0) {
+			//learn from the current invocation's own execution time, not the sliding-window average
+			frs.workload_hint_regression.note_invocation(
+				frame_info->vWorkload_hints,
+				frs.vCurrent_invocation_model_choice_double_value,
+				frame_dec.impact_rescaler(frame_info->current_invocation_exec_time)
+			);
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << "Frame #" << frame->id << " workload_hint_regression for parmID = " << mit->first->parmID
+				<< ": " << frs.workload_hint_regression.print_string() << std::endl;
+		}
+		frs.vCurrent_invocation_model_choice_double_value.clear();
+	}
+
+	frame_dec.previous_invocation_exec_time = frame_dec.get_steering_exec_time(rescaled_current_invocation_exec_time);
+	if(frame_dec.enforcement != Objective::EnfPER_FRAME) {
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "Frame #" << frame->id << " enforcement: exec_time_quantile_sketch = " << frame_dec.exec_time_quantile_sketch.print_string()
+			<< " window_fraction = " << frame_dec.window_fraction_counter.get_fraction()
+			<< " enforced_objective_measure = " << frame_dec.enforced_objective_measure
+			<< " steering exec_time = " << frame_dec.previous_invocation_exec_time << std::endl;
+	}
+
+	if(frame_dec.statistics_window_by_count.stats.is_maintained() || frame_dec.statistics_window_by_time.stats.is_maintained()) {
+		bool bSatisfied = frame_dec.bHasMeanObjectiveDefined
+			&& rescaled_current_invocation_exec_time >= frame_dec.mean_objective * (1.0 - frame_dec.window_frac_lower)
+			&& rescaled_current_invocation_exec_time <= frame_dec.mean_objective * (1.0 + frame_dec.window_frac_upper);
+		ExecTime_t exec_time = frame_info->current_invocation_exec_time;
+		ExecTime_t jitter = frame_dec.bHasLastWindowedExecTime ? fabs(exec_time - frame_dec.last_windowed_exec_time) : 0.0;
+		timeval completion_timeval = {0, 0};
+		if(frame_dec.statistics_window_by_time.stats.is_maintained())
+			completion_timeval = get_curr_timeval();
+
+		if(frame_dec.statistics_window_by_count.stats.is_maintained())
+			frame_dec.statistics_window_by_count.add(completion_timeval, exec_time, frame_dec.bHasLastWindowedExecTime, jitter, bSatisfied);
+		if(frame_dec.statistics_window_by_time.stats.is_maintained())
+			frame_dec.statistics_window_by_time.add(completion_timeval, exec_time, frame_dec.bHasLastWindowedExecTime, jitter, bSatisfied);
+		frame_dec.bHasLastWindowedExecTime = true;
+		frame_dec.last_windowed_exec_time = exec_time;
+	}
+
+	if(bTraceOpen)
+		trace_note_frame_completion(frame, rescaled_current_invocation_exec_time);
+	if(bStatsPagePublished)
+		stats_page_note_frame_completion(frame);
 }
 
 
@@ -8,9 +8,15 @@
 #include <sstream>
 #include <list>
 #include <map>
+#include <deque>
+#include <sys/time.h>
 
 #include "opp_exec_time_measure.h"
 #include "opp_parameter_spread.h"
+#include "opp_workload_hints.h"
+#include "opp_thompson_sampling.h"
+#include "opp_quantile_sketch.h"
+#include "opp_change_point.h"
 
 namespace Opp {
 
@@ -80,9 +86,10 @@ namespace Opp {
 		void remove_consumer(Frame * consumer);
 
 		void inform_enclosing_active_consumers_of_sample_measurement(
-			std::vector<Frame *> vActiveEnclosingFrames,
-			int sample_value
+			Frame * innermost_active_enclosing_frame,
+			ParameterValue_t sample_value
 		);
+			//informs innermost_active_enclosing_frame and the frames dynamically enclosing it (none if 0)
 
 	};
 
@@ -134,67 +141,50 @@ namespace Opp {
 		}
 	};
 
-	ExecTime_t IDENTITY_impact_rescaler(ExecTime_t measured_execution_time_in_seconds);
-
-	class FrameDecisionModel {
-	public:
-		//definitions for IntValueCache that will cache exec_time_parameter values
-		static const int exec_time_parameter_cache_num_entries = 10;
-		static const double exec_time_parameter_cache_max_count = 100.0;
-
-
-	//following fields should be set only via initialize_objective(),
-	//  and should be treated as read-only after that
-		bool bHasMeanObjectiveDefined;
-			// == true iff corresponding frame has been provided a mean-objective
-
-			// defined iff bHasMeanObjectiveDefined == true
-		ExecTime_t mean_objective;
-		double window_frac_lower;
-		double window_frac_upper;
-		double prob;
-		int sliding_window_size;
-		ImpactRescaler_f impact_rescaler;
+	class FrameStatisticsWindow {
+		//Maintains a FrameWindowStatistics over a sliding window of completed invocations: samples leaving the window
+		//  are unrecorded from its histograms as new ones arrive.
 
-		int exec_time_parameter_num_spread_bins;
-	//till here
+		struct Sample {
+			timeval completion_timeval;
+			ExecTime_t exec_time;
+			bool bHasJitter;
+			ExecTime_t jitter;
+			bool bSatisfied;
+		};
+		std::deque<Sample> dqSamples;
 
-		SlidingWindow<ExecTime_t> exec_time_sliding_window;
-
-
-		Parameter exec_time_parameter;
-			//communicates execution-time of current frame
+	public:
+		FrameWindowStatistics stats;
 
-		IntValueCache exec_time_record;
-			//tracks the execution-time distribution of the current frame
+		void initialize(long long window_length, double window_seconds) {
+			dqSamples.clear();
+			stats = FrameWindowStatistics();
+			stats.window_length = window_length;
+			stats.window_seconds = window_seconds;
+		}
 
-		long long specified_objective_failure_run_length; //defined iff bHasMeanObjectiveDefined = true
-		std::vector<long long> vFailure_Runlengths_wrt_specified_objective;
-		
-		long long active_objective_failure_run_length; //w.r.t. to current vAGAINST_ObjectiveBinIndices
-		std::vector<long long> vFailure_Runlengths_wrt_active_objective;
-		
+		void add(timeval completion_timeval, ExecTime_t exec_time, bool bHasJitter, ExecTime_t jitter, bool bSatisfied);
+			//completion_timeval is only used by windows by time
 
-		std::map<Parameter *, ParameterExecSpread *> map_parm_to_spread;
+		void evict_expired(timeval now);
+			//for windows by time, unrecords the samples completed more than window_seconds before now,
+			//  so that the window does not keep stale samples while no invocations complete
 
-		std::map<Parameter *, IntValueCache *> map_parm_to_curr_record;
-			//Caches values taken by a parameter within the current invocation of
-			//  frame. Used to update corresponding map_parm_to_spread entry.
-			//  Therefore. map_parm_to_curr_record and map_parm_to_spread must
-			//    have an identical set of Parameter * keys.
+	private:
+		void evict_oldest();
+	};
 
-		//NOTE: all allocation & de-allocation of map_parm_to_spread
-		//  and map_parm_to_curr_record entries must be done via the
-		//  Parameter::add_consumer() & Parameter::remove_consumer() calls
+	class FastReactionState {
+	public:
+		//Fast Reaction Strategy's state for one ExecFrame's decision-vector, as controlled to meet the objective
+		//  of a consuming (parent) Frame. Kept separately for each ExecFrame run within the Frame.
 
-			//Following relevant for Fast Reaction Strategy
 		std::vector<double> vCoeffs_a;
 				//Coefficients for Y = a1 * x1 + a2 * x2 + ..n an * xn
-		ExecTime_t previous_invocation_exec_time;
-				//Execution Time consumed by previous invocation of this frame. =0.0 if first invocation
 		//RESCALE for RANGE-PRECESION
 		std::vector<double> vPrevious_model_choice_double_value;
-				//Choices made by each model (if any) within this frame. Values bounded to lie within valid range.
+				//Choices made by each model (if any) of this ExecFrame. Values bounded to lie within valid range.
 		std::vector<double> vUnbounded_Previous_model_choice_double_value;
 				//Same as vPrevious_model_choice_double_value values, except without being bounded to lie within valid range
 		std::vector<double> vAverage_X_deviation;
@@ -237,7 +227,197 @@ namespace Opp {
 
 		std::vector< std::vector< std::vector<long long int> > > vvvVarChoiceStats;
 				//Statistics, for each variable: for each choice value taken: window boundaries into which observed exectime fell
-			//till here
+
+		//FEED-FORWARD from Workload Hints
+		WorkloadHintRegression workload_hint_regression;
+				//learns execution time of the parent frame from its workload hints and the choices made for this ExecFrame
+		std::vector<double> vCurrent_invocation_model_choice_double_value;
+				//Choices actually run within the parent's current invocation, i.e. vPrevious_model_choice_double_value
+				//  after feed-forward and intra-frame corrections. Empty if no choice made yet in current invocation.
+
+		//INTRA-FRAME SLACK RECLAIMING
+		long long int last_decided_invocation_index;
+				//parent's invocation_index for which vBase_X was computed, -1 if never
+		std::vector<double> vBase_X;
+				//Choices computed from the parent's previous invocations (including feed-forward) for the parent's
+				//  current invocation. Re-used by all runs of the ExecFrame within the current invocation.
+		int current_invocation_run_index;
+				//number of runs of the ExecFrame within the parent's current invocation, less one
+		std::vector<double> vExpected_elapsed_at_run;
+				//Learned (rescaled) elapsed time of the parent invocation at the start of the k-th run of the ExecFrame
+		std::vector<long long int> vExpected_elapsed_at_run_sample_count;
+
+		//HIERARCHICAL BUDGETING
+		std::vector<double> vMax_X;
+				//upper bound of the valid range of each model's choice (lowest feature level)
+
+		//STARTUP CALIBRATION (ExecFrame::calibrate())
+		int calibration_invocations_remaining;
+				//calibration choices still to be made, -1 if calibration has not started
+		bool bCalibrationDone;
+				//calibration completed, or did not apply: the decision strategy is in control
+		int calibration_var_index;
+		int calibration_step;
+				//variable currently swept, and the index of its current point from the cheapest choice
+		std::vector<double> vCalibration_X;
+				//choices of the pending calibration invocation of the parent, empty if none
+		std::vector< std::vector< std::pair<double, double> > > vvCalibration_samples;
+				//for each variable: (choice, parent's execution time) measured while the variable was swept
+
+		FastReactionState()
+			: current_window_length_X_deviation(0), current_failure_unidirectional_runlenth(0),
+				average_continuous_unidirectional_failure_runlength(0.0), current_number_unidirectional_runs(0),
+				previous_Y(0.0), halfcycle_start_deflection_sign(-1), halfcycle_Y_positive_max_deflection(0.0), halfcycle_Y_negative_max_deflection(0.0),
+				halfcycle_length(0), has_halfcycle_crossed_mean(false), sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window(0.0),
+				contiguous_onesided_failure_runlength(0), correction_runlength_onesided_failure(0),
+				last_decided_invocation_index(-1), current_invocation_run_index(0),
+				calibration_invocations_remaining(-1), bCalibrationDone(false), calibration_var_index(0), calibration_step(0)
+		{ }
+
+		void restart_rescaling_statistics(ExecTime_t mean_objective);
+			//Discards the statistics gathered towards rescaling vCoeffs_a, and starts a new potential halfcycle
+
+		void save_snapshot(SnapshotWriter& writer) const;
+		bool load_snapshot(SnapshotReader& reader);
+			//restores the learned state written by save_snapshot() (not the state of the parent's
+			//  current invocation, nor of an unfinished calibration), returns false if malformed
+	};
+
+	ExecTime_t IDENTITY_impact_rescaler(ExecTime_t measured_execution_time_in_seconds);
+
+	class FrameDecisionModel {
+	public:
+		//definitions for IntValueCache that will cache exec_time_parameter values
+		static const int exec_time_parameter_cache_num_entries = 10;
+		static const double exec_time_parameter_cache_max_count = 100.0;
+
+
+	//following fields should be set only via initialize_objective(),
+	//  and should be treated as read-only after that (except mean_objective, see retarget_mean_objective())
+		bool bHasMeanObjectiveDefined;
+			// == true iff corresponding frame has been provided a mean-objective
+
+			// defined iff bHasMeanObjectiveDefined == true
+		ExecTime_t mean_objective;
+		double window_frac_lower;
+		double window_frac_upper;
+		double prob;
+		int sliding_window_size;
+		ImpactRescaler_f impact_rescaler;
+
+		int exec_time_parameter_num_spread_bins;
+
+		Objective::Enforcement_t enforcement;
+		int enforcement_window_length;
+
+		bool bHasQualityFloorObjective;
+			// == true iff corresponding frame has been provided a quality_floor() objective
+			//   (then bHasMeanObjectiveDefined == false)
+
+			// defined iff bHasQualityFloorObjective == true
+		double min_quality;
+		double quality_floor_prob;
+		Objective::Cost_t cost;
+	//till here
+
+		SlidingWindow<ExecTime_t> exec_time_sliding_window;
+
+
+		Parameter exec_time_parameter;
+			//communicates execution-time of current frame
+
+		IntValueCache exec_time_record;
+			//tracks the execution-time distribution of the current frame
+
+		LatencyHistogram exec_time_histogram;
+			//high-resolution histogram of the measured execution-times of all completed invocations
+
+		ExecTime_t total_controller_overhead;
+		ExecTime_t total_exec_time_with_controller_overhead;
+			//over all completed invocations (see FrameInfo::current_invocation_controller_overhead)
+
+		FrameStatisticsWindow statistics_window_by_count;
+		FrameStatisticsWindow statistics_window_by_time;
+			//see frame_set_statistics_windows()
+		bool bHasLastWindowedExecTime;
+		ExecTime_t last_windowed_exec_time;
+			//measured execution-time of the previous completed invocation, for frame-to-frame jitter
+
+		long long specified_objective_failure_run_length; //defined iff bHasMeanObjectiveDefined = true
+		std::vector<long long> vFailure_Runlengths_wrt_specified_objective;
+		
+		long long active_objective_failure_run_length; //w.r.t. to current vAGAINST_ObjectiveBinIndices
+		std::vector<long long> vFailure_Runlengths_wrt_active_objective;
+		
+
+		std::map<Parameter *, ParameterExecSpread *> map_parm_to_spread;
+
+		std::map<Parameter *, IntValueCache *> map_parm_to_curr_record;
+			//Caches values taken by a parameter within the current invocation of
+			//  frame. Used to update corresponding map_parm_to_spread entry.
+			//  Therefore. map_parm_to_curr_record and map_parm_to_spread must
+			//    have an identical set of Parameter * keys.
+
+		std::map<Parameter *, ThompsonSamplingModel *> map_parm_to_thompson_model;
+			//Thompson Sampling Strategy's posteriors over the values taken by a parameter
+			//  (must have an identical set of Parameter * keys as map_parm_to_spread)
+
+		//NOTE: all allocation & de-allocation of map_parm_to_spread, map_parm_to_curr_record,
+		//  map_parm_to_thompson_model and map_parm_to_fast_reaction_state entries must be done via the
+		//  Parameter::add_consumer() & Parameter::remove_consumer() calls
+
+		ExecTime_t previous_invocation_exec_time;
+				//Execution Time consumed by previous invocation of this frame. =0.0 if first invocation
+				//  (as mapped by get_steering_exec_time() for quantile and window-fraction objectives)
+		long long int invocation_index;
+				//number of invocations of this frame started so far
+
+		std::map<Parameter *, FastReactionState *> map_parm_to_fast_reaction_state;
+			//Fast Reaction Strategy's state for the decision-vector Parameter of each ExecFrame run within this frame
+			//  (must have an identical set of Parameter * keys as map_parm_to_spread)
+
+		//ENFORCEMENT of Quantile and Window-Fraction Objectives (enforcement != Objective::EnfPER_FRAME)
+		StreamingQuantileSketch exec_time_quantile_sketch;
+				//EnfQUANTILE: quantiles (0.5, prob); EnfWINDOW_FRACTION: quantiles ((1-prob)/2, 0.5, (1+prob)/2)
+				//  of the rescaled execution time over approximately the last enforcement_window_length invocations
+		WindowFractionCounter window_fraction_counter;
+				//fraction of approximately the last enforcement_window_length invocations within the objective window
+		double enforced_objective_measure;
+				//EnfQUANTILE: estimated prob-quantile; EnfWINDOW_FRACTION: fraction within window. 0.0 until available
+		long long int enforced_objective_evaluated_count;
+		long long int enforced_objective_satisfied_count;
+				//invocations at completion of which the enforced objective was evaluated, and found satisfied
+
+		//HIERARCHICAL BUDGETING (Objective::ObjBUDGET_SHARE)
+		std::vector<Frame *> vBudget_share_frames;
+				//frames whose ObjBUDGET_SHARE objective apportions this frame's mean_objective
+		ExecTime_t recent_exec_time;
+				//exponentially weighted moving average of the rescaled execution time of invocations, =0.0 if none yet
+		static const double recent_exec_time_rate;
+
+		//CHANGE-POINT DETECTION (see feature_control_change_point_detection())
+		std::map< std::pair<long long int, DecisionKey_t>, std::pair<double, double> > map_ParmDecision_ExecTimeSumWeight;
+				//(parmID of an ExecFrame's decision-vector Parameter, decision-vector int value) ->
+				//  (weighted sum of rescaled execution times of invocations that took it, sum of weights)
+		PageHinkleyDetector change_point_detector;
+				//over the residual of each invocation's rescaled execution time w.r.t. that expected for its decisions
+				//  from map_ParmDecision_ExecTimeSumWeight, in half-widths of the objective window
+		int change_point_recovery_remaining;
+				//invocations left in which history is forgotten at change_point_recovery_alpha, following a change-point
+		long long int change_point_count;
+				//change-points detected so far
+		static const double change_point_drift_tolerance;
+				//deviation (in objective window half-widths) tolerated without accumulating evidence of a change-point
+		static const double change_point_min_window_frac;
+				//lower bound on the objective window half-width (as fraction of mean_objective) used for deviations
+		static const double change_point_history_retention;
+				//fraction of learned history retained on a change-point
+		static const double change_point_min_baseline_weight;
+				//weight of observations of a decision-vector needed before residuals are measured against it
+		static const double change_point_prediction_weight;
+				//weight of the outcome predicted for each decision-vector by its re-based expected execution time
+		static const int change_point_recovery_length;
+		static const double change_point_recovery_alpha;
 
 		double unbinned_satisfaction_ratio;
 		long long int total_invoke_count;
@@ -246,14 +426,39 @@ namespace Opp {
 		double unbinned_variance;
 		double unbinned_variance_from_mean_objective;
 
+	private:
+		//get_ObjectiveWindowBinIndices_for_local_objective() is needed on every invocation, so its bins are
+		//  cached, and recomputed only when the objective they were computed for changes (retarget_mean_objective())
+		mutable bool bLocalObjectiveBinsCached;
+		mutable bool cached_bHasMeanObjectiveDefined;
+		mutable ExecTime_t cached_mean_objective;
+		mutable double cached_window_frac_lower;
+		mutable double cached_window_frac_upper;
+		mutable int cached_num_spread_bins;
+		mutable int cached_local_range_min_bin_index;
+		mutable int cached_local_range_max_bin_index;
+		mutable std::vector<int> cached_local_vFOR_ObjectiveWindowBinIndices;
+		mutable std::vector<int> cached_local_vAGAINST_ObjectiveBinIndices;
+
+		void refresh_local_objective_bins_cache() const;
+
+	public:
 		FrameDecisionModel(Frame * my_frame)
 			: bHasMeanObjectiveDefined(false),
 				mean_objective(0.0), window_frac_lower(0.0), window_frac_upper(0.0), prob(0.0), sliding_window_size(1), impact_rescaler(0),
 				exec_time_parameter_num_spread_bins(-1),
+				enforcement(Objective::EnfPER_FRAME), enforcement_window_length(0),
+				bHasQualityFloorObjective(false), min_quality(0.0), quality_floor_prob(0.0), cost(Objective::CostEXEC_TIME),
 				exec_time_sliding_window(1), exec_time_parameter(my_frame),
+				total_controller_overhead(0.0), total_exec_time_with_controller_overhead(0.0),
+				bHasLastWindowedExecTime(false), last_windowed_exec_time(0.0),
 				specified_objective_failure_run_length(0), active_objective_failure_run_length(0),
-				previous_invocation_exec_time(0.0),
-				unbinned_satisfaction_ratio(0.0), total_invoke_count(0), unbinned_mean(0.0), unbinned_sq_mean(0.0), unbinned_variance(0.0), unbinned_variance_from_mean_objective(0.0)
+				previous_invocation_exec_time(0.0), invocation_index(0),
+				enforced_objective_measure(0.0), enforced_objective_evaluated_count(0), enforced_objective_satisfied_count(0),
+				recent_exec_time(0.0),
+				change_point_detector(change_point_drift_tolerance), change_point_recovery_remaining(0), change_point_count(0),
+				unbinned_satisfaction_ratio(0.0), total_invoke_count(0), unbinned_mean(0.0), unbinned_sq_mean(0.0), unbinned_variance(0.0), unbinned_variance_from_mean_objective(0.0),
+				bLocalObjectiveBinsCached(false)
 		{ }
 
 		~FrameDecisionModel() { } //FIXME: must deallocate all dynamically allocated stuff in map_parm_to_spread, map_parm_to_curr_record
@@ -269,7 +474,9 @@ namespace Opp {
 			double window_frac_upper = 0.0,
 			double prob = 0.0,
 			int sliding_window_size = 1,
-			ImpactRescaler_f impact_rescaler = 0
+			ImpactRescaler_f impact_rescaler = 0,
+			Objective::Enforcement_t enforcement = Objective::EnfPER_FRAME,
+			int enforcement_window_length = 0
 		)
 		{
 			assert(exec_time_parameter_num_spread_bins == -1);
@@ -292,8 +499,54 @@ namespace Opp {
 			exec_time_sliding_window.initialize(sliding_window_size);
 
 			exec_time_record = IntValueCache(exec_time_parameter_num_spread_bins, 100000.0);
+
+			initialize_enforcement(enforcement, enforcement_window_length);
 		}
 
+		void initialize_quality_floor(double min_quality, double quality_floor_prob, Objective::Cost_t cost);
+			//follows initialize_objective(false), for a frame whose objective is a quality_floor()
+
+		void initialize_enforcement(Objective::Enforcement_t enforcement, int enforcement_window_length);
+			//called by initialize_objective(); validates the objective's enforcement settings
+
+		bool is_enforcement_estimate_available() const;
+			//true iff enforcement != EnfPER_FRAME and enough invocations have been seen to estimate its quantiles
+
+		void note_invocation_for_enforcement(ExecTime_t rescaled_exec_time, bool bWithinWindow);
+			//updates exec_time_quantile_sketch, window_fraction_counter and enforced_objective_* fields
+
+		bool is_invocation_objective_success(ExecTime_t rescaled_exec_time) const;
+			//Outcome of a single invocation w.r.t. the enforced objective: the event whose frequency the enforcement
+			//  bounds by prob, i.e. exec time <= mean_objective for EnfQUANTILE, and exec time within the objective
+			//  window for EnfWINDOW_FRACTION and EnfPER_FRAME.
+
+		ExecTime_t get_steering_exec_time(ExecTime_t rescaled_exec_time) const;
+			//Maps the execution time of an invocation to the value the decision strategies should steer into
+			//  the objective window, such that the enforced quantile or window-fraction objective is met.
+			//  Identity for EnfPER_FRAME, or while the quantile estimates are not yet available.
+
+		void retarget_mean_objective(ExecTime_t mean_objective);
+			//Changes mean_objective. Spread bins are relative to mean_objective, so accumulated statistics carry over
+			//  to the new mean; Fast Reaction Strategy halfcycles left inconsistent by the move are restarted.
+
+		bool get_feature_cost_range(ExecTime_t& cost_at_lowest_feature, ExecTime_t& cost_at_highest_feature) const;
+			//Linear estimate of this frame's (rescaled) execution time with all ExecFrames run within it at their
+			//  lowest and at their highest feature levels, extrapolated from recent_exec_time along the
+			//  Fast Reaction Strategy's learned coefficients. Returns false if nothing has been learned yet.
+
+		bool note_invocation_for_change_point_detection(ExecTime_t rescaled_exec_time);
+			//Called on completion of an invocation, before map_parm_to_curr_record is cleared. Returns true if the
+			//  invocation is detected to start a new workload regime (e.g., a scene cut), in which the execution time
+			//  of the decisions taken has shifted abruptly, and reacts with react_to_change_point(). Needs a mean-objective.
+
+		void react_to_change_point(double shift_ratio);
+			//Retains only change_point_history_retention of the history learned about the frame's Parameters, and
+			//  re-bases what transfers to the new regime by the ratio shift_ratio of the current to the expected
+			//  execution time: the expected execution times of decision-vectors (each then credited to the Thompson
+			//  Sampling posteriors with the outcome it predicts) and the Fast Reaction Strategy's coefficients.
+			//  Restarts the Fast Reaction Strategy's rescaling statistics and the frame's moving averages, and
+			//  forgets history faster for the next change_point_recovery_length invocations.
+
 
 			//Get the vFOR and vAGAINST window bin indices based only on the
 			//  Objective specified by the user for this frame.
@@ -303,22 +556,27 @@ namespace Opp {
 			std::vector<int>& local_vFOR_ObjectiveWindowBinIndices,
 			std::vector<int>& local_vAGAINST_ObjectiveBinIndices
 		) const {
-			local_vFOR_ObjectiveWindowBinIndices.clear();
-			local_vAGAINST_ObjectiveBinIndices.clear();
-			if(bHasMeanObjectiveDefined) {
-				int range_min_bin_index = convert_exec_time_to_int_bin(
-						((1.0 - window_frac_lower) * mean_objective) );
-				int range_max_bin_index = convert_exec_time_to_int_bin(
-						((1.0 + window_frac_upper) * mean_objective) );
-
-				for(int i=range_min_bin_index; i<=range_max_bin_index; i++)
-					local_vFOR_ObjectiveWindowBinIndices.push_back(i);
-
-				for(int i=0; i<range_min_bin_index; i++)
-					local_vAGAINST_ObjectiveBinIndices.push_back(i);
-				for(int i=range_max_bin_index+1; i<exec_time_parameter_num_spread_bins; i++)
-					local_vAGAINST_ObjectiveBinIndices.push_back(i);
-			}
+			local_vFOR_ObjectiveWindowBinIndices = get_local_objective_vFOR_bin_indices();
+			local_vAGAINST_ObjectiveBinIndices = get_local_objective_vAGAINST_bin_indices();
+		}
+
+			//Same as above, without copying: valid until the objective changes
+		const std::vector<int>& get_local_objective_vFOR_bin_indices() const {
+			refresh_local_objective_bins_cache();
+			return cached_local_vFOR_ObjectiveWindowBinIndices;
+		}
+		const std::vector<int>& get_local_objective_vAGAINST_bin_indices() const {
+			refresh_local_objective_bins_cache();
+			return cached_local_vAGAINST_ObjectiveBinIndices;
+		}
+
+			//true iff int_bin is in get_local_objective_vAGAINST_bin_indices()
+		bool is_bin_against_local_objective(int int_bin) const {
+			refresh_local_objective_bins_cache();
+			if(not bHasMeanObjectiveDefined)
+				return false;
+			return (0 <= int_bin && int_bin < cached_local_range_min_bin_index)
+				|| (cached_local_range_max_bin_index < int_bin && int_bin < exec_time_parameter_num_spread_bins);
 		}
 
 
@@ -376,11 +634,28 @@ namespace Opp {
 		Parameter decision_vector_parameter;
 		//Parameter exec_time_parameter; //FIXME: ignoring for now
 
+		long long total_runs;
+		long long total_items;
+			//work items over all runs: 1 per run(), num_items per run_batch()
+		ExecTime_t total_run_time;
+			//measured execution-time of the user-code, over all runs
+		std::map<DecisionKey_t, ExecTime_t> map_decision_to_item_cost;
+			//exponentially weighted moving average of the execution-time per work item of the runs of each decision-vector,
+			//  so that the cost measured tracks changes in the work items
+		static const double recent_item_cost_rate;
+
 		ExecFrameDecisionModel(ExecFrame * my_execframe)
-			: decision_vector_parameter(my_execframe)//,
-				//exec_time_parameter(my_execframe)
+			: decision_vector_parameter(my_execframe),
+				//exec_time_parameter(my_execframe),
+				total_runs(0), total_items(0), total_run_time(0.0)
 		{ }
 
+		void note_run(DecisionKey_t decision_int_value, ExecTime_t run_time, long long num_items);
+			//learns from a completed run of num_items work items
+
+		bool get_item_cost(DecisionKey_t decision_int_value, ExecTime_t& item_cost) const;
+			//recent execution-time per work item of decision_int_value; false if it has not been run
+
 
 		// class static Conversion utilities between measured execution-time and int-bin
 
@@ -395,17 +670,21 @@ namespace Opp {
 	void activate_decision_model_and_decide_setting(Frame * frame);
 	void update_decision_model_on_completion(Frame * frame);
 
+	void retarget_budget_share_objective(Frame * frame);
+		//for a frame with an ObjBUDGET_SHARE objective, re-apportions the budget among the frames sharing it
+		//  and retargets the frame's mean objective to its share (called on each invocation of the frame)
+
 	bool get_decision_sets_for_parameter(
 		Parameter& deciding_parameter,
 		Frame * innermost_deciding_ancestor_frame,
 			//return values:
-		std::vector<int>& vForDecisionSet,
+		std::vector<ParameterValue_t>& vForDecisionSet,
 		std::vector<double>& vForDecisionSet_Counts,
 		std::vector<double>& vForDecisionSet_Probs,
-		std::vector<int>& vUnclassifiedDecisionSet,
+		std::vector<ParameterValue_t>& vUnclassifiedDecisionSet,
 		std::vector<double>& vUnclassifiedDecisionSet_Counts,
 		std::vector<double>& vUnclassifiedDecisionSet_Probs,
-		std::vector<int>& vAgainstDecisionSet,
+		std::vector<ParameterValue_t>& vAgainstDecisionSet,
 		std::vector<double>& vAgainstDecisionSet_Counts,
 		std::vector<double>& vAgainstDecisionSet_Probs
 	);
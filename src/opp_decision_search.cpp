@@ -0,0 +1,156 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+
+#include "opp_decision_search.h"
+
+namespace Opp {
+
+static void assert_valid_decision_vector(const DecisionSearchProblem& problem, const std::vector<int>& dec_vec) {
+	assert((int)dec_vec.size() == problem.get_num_variables());
+	for(int i=0; i<(int)dec_vec.size(); i++)
+		assert(0 <= dec_vec[i] && dec_vec[i] < problem.get_num_values(i));
+}
+
+std::vector<int> search_decision_vector(
+	const DecisionSearchProblem& problem,
+	DecisionSearch_t strategy,
+	const std::vector<int>& initial_dec_vec
+)
+{
+	switch(strategy) {
+		case SearchCOORDINATE_DESCENT:
+			return coordinate_descent_search(problem, initial_dec_vec, 4);
+		case SearchGREEDY_MARGINAL_UTILITY:
+			return greedy_marginal_utility_search(problem, initial_dec_vec);
+		case SearchBEAM:
+			return beam_search(problem, initial_dec_vec, 4);
+	}
+
+	std::cerr << "search_decision_vector(): ERROR: unknown strategy = " << strategy << std::endl;
+	exit(1);
+}
+
+std::vector<int> coordinate_descent_search(
+	const DecisionSearchProblem& problem,
+	const std::vector<int>& initial_dec_vec,
+	int max_sweeps
+)
+{
+	assert_valid_decision_vector(problem, initial_dec_vec);
+
+	std::vector<int> dec_vec = initial_dec_vec;
+	double best_score = problem.score(dec_vec);
+
+	for(int sweep=0; sweep<max_sweeps; sweep++) {
+		bool bChanged = false;
+		for(int i=0; i<(int)dec_vec.size(); i++) {
+			int best_value = dec_vec[i];
+			for(int v=0; v<problem.get_num_values(i); v++) {
+				if(v == best_value)
+					continue;
+				dec_vec[i] = v;
+				double score = problem.score(dec_vec);
+				if(score > best_score) {
+					best_score = score;
+					best_value = v;
+					bChanged = true;
+				}
+			}
+			dec_vec[i] = best_value;
+		}
+		if(bChanged == false)
+			break;
+	}
+	return dec_vec;
+}
+
+std::vector<int> greedy_marginal_utility_search(
+	const DecisionSearchProblem& problem,
+	const std::vector<int>& initial_dec_vec
+)
+{
+	assert_valid_decision_vector(problem, initial_dec_vec);
+
+	std::vector<int> dec_vec = initial_dec_vec;
+	double curr_score = problem.score(dec_vec);
+
+	int max_steps = 0;
+	for(int i=0; i<(int)dec_vec.size(); i++)
+		max_steps += problem.get_num_values(i);
+		//each variable's value can improve at most (num_values - 1) times, bounding the climb
+
+	for(int step=0; step<max_steps; step++) {
+		int best_var = -1;
+		int best_value = -1;
+		double best_score = curr_score;
+		for(int i=0; i<(int)dec_vec.size(); i++) {
+			int saved_value = dec_vec[i];
+			for(int v=0; v<problem.get_num_values(i); v++) {
+				if(v == saved_value)
+					continue;
+				dec_vec[i] = v;
+				double score = problem.score(dec_vec);
+				if(score > best_score) {
+					best_score = score;
+					best_var = i;
+					best_value = v;
+				}
+			}
+			dec_vec[i] = saved_value;
+		}
+		if(best_var == -1)
+			break;
+		dec_vec[best_var] = best_value;
+		curr_score = best_score;
+	}
+	return dec_vec;
+}
+
+static bool sort_helper_beam_candidates(const std::pair<double, std::pair<int, int> >& a, const std::pair<double, std::pair<int, int> >& b) {
+	return a.first > b.first;
+}
+
+std::vector<int> beam_search(
+	const DecisionSearchProblem& problem,
+	const std::vector<int>& initial_dec_vec,
+	int beam_width
+)
+{
+	assert_valid_decision_vector(problem, initial_dec_vec);
+	assert(beam_width >= 1);
+
+	std::vector< std::vector<int> > vBeam(1, initial_dec_vec);
+	std::vector< std::pair<double, std::pair<int, int> > > vCandidates;
+		//<score, <index in vBeam, value of the variable being assigned> >
+
+	for(int i=0; i<(int)initial_dec_vec.size(); i++) {
+		vCandidates.clear();
+		for(int b=0; b<(int)vBeam.size(); b++) {
+			std::vector<int>& dec_vec = vBeam[b];
+			int saved_value = dec_vec[i];
+			for(int v=0; v<problem.get_num_values(i); v++) {
+				dec_vec[i] = v;
+				vCandidates.push_back( std::make_pair(problem.score(dec_vec), std::make_pair(b, v)) );
+			}
+			dec_vec[i] = saved_value;
+		}
+		int num_kept = std::min(beam_width, (int)vCandidates.size());
+		std::partial_sort(vCandidates.begin(), vCandidates.begin() + num_kept, vCandidates.end(), sort_helper_beam_candidates);
+
+		std::vector< std::vector<int> > vNextBeam;
+		for(int k=0; k<num_kept; k++) {
+			vNextBeam.push_back( vBeam[ vCandidates[k].second.first ] );
+			vNextBeam.back()[i] = vCandidates[k].second.second;
+		}
+		vBeam.swap(vNextBeam);
+	}
+	return vBeam[0];
+}
+
+} //namespace Opp
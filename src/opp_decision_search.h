@@ -0,0 +1,75 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_DECISION_SEARCH_H
+#define OPP_DECISION_SEARCH_H
+
+#include <vector>
+
+namespace Opp {
+
+	/////////////////////////////////
+	// Search over Factored Decision Spaces
+	/////////////////////////////////
+
+	// A decision-vector assigns each of its variables a value in [0 .. num_values-1]. With many variables
+	//   the Cartesian product of their ranges is too large to enumerate, so the strategies below only
+	//   ever evaluate decision-vectors differing from a current one in a single variable (or, for beam
+	//   search, a bounded number of partial assignments), i.e. O(sum of ranges) evaluations per step.
+
+	typedef enum {
+		SearchCOORDINATE_DESCENT,
+			//sweep the variables, setting each to its best value with the others held fixed, until no change
+		SearchGREEDY_MARGINAL_UTILITY,
+			//repeatedly apply the single-variable change with the largest gain in score, until none gains
+		SearchBEAM
+			//assign the variables in order, keeping the beam_width best partial assignments
+			//  (unassigned variables keep their initial values while scoring)
+	} DecisionSearch_t;
+
+	void feature_control_decision_search_strategy(DecisionSearch_t new_setting);
+		//Search strategy for decision spaces larger than feature_query_max_enumerated_decision_vectors()
+		//  (see opp_debug_control.h).
+		//
+		//Default setting = SearchCOORDINATE_DESCENT
+
+	DecisionSearch_t feature_query_decision_search_strategy();
+
+	class DecisionSearchProblem {
+	public:
+		virtual int get_num_variables() const = 0;
+		virtual int get_num_values(int variable_index) const = 0;
+
+		virtual double score(const std::vector<int>& dec_vec) const = 0;
+			//higher is better; need not be separable across variables
+
+		virtual ~DecisionSearchProblem() { }
+	};
+
+	std::vector<int> search_decision_vector(
+		const DecisionSearchProblem& problem,
+		DecisionSearch_t strategy,
+		const std::vector<int>& initial_dec_vec
+	);
+
+	std::vector<int> coordinate_descent_search(
+		const DecisionSearchProblem& problem,
+		const std::vector<int>& initial_dec_vec,
+		int max_sweeps
+	);
+
+	std::vector<int> greedy_marginal_utility_search(
+		const DecisionSearchProblem& problem,
+		const std::vector<int>& initial_dec_vec
+	);
+
+	std::vector<int> beam_search(
+		const DecisionSearchProblem& problem,
+		const std::vector<int>& initial_dec_vec,
+		int beam_width
+	);
+
+} //namespace Opp
+
+#endif //OPP_DECISION_SEARCH_H
@@ -7,6 +7,7 @@
 #include <sys/time.h>
 #include <algorithm>
 #include <cstdlib>
+#include <cmath>
 
 #include "opp.h"
 #include "opp_timing.h"
@@ -15,6 +16,11 @@
 #include "opp_frame_info.h"
 #include "opp_decision_model.h"
 #include "opp_execframe.h"
+#include "opp_thompson_sampling.h"
+#include "opp_random.h"
+#include "opp_decision_search.h"
+#include "opp_trace.h"
+#include "opp_stats_page.h"
 
 #include "opp_utilities.h"
 
@@ -44,6 +50,52 @@ void ExecFrame::run() {
 	execframe_info->run();
 }
 
+const std::vector<int>& ExecFrame::run_begin() {
+	ExecFrameInfo * execframe_info = ExecFrameInfo::get_execframe_info(this);
+	return execframe_info->begin_run();
+}
+
+void ExecFrame::run_end(long long num_items) {
+	if(num_items < 1) {
+		std::cerr << "ExecFrame::run_end(): ERROR: invalid num_items = " << num_items << " for ExecFrame #" << id << std::endl;
+		exit(1);
+	}
+	ExecFrameInfo * execframe_info = ExecFrameInfo::get_execframe_info(this);
+	execframe_info->end_run(num_items);
+}
+
+void ExecFrame::pace(long long items_remaining, ExecTime_t deadline, long long check_period) {
+	ExecFrameInfo * execframe_info = ExecFrameInfo::get_execframe_info(this);
+	if(items_remaining <= 0) {
+		execframe_info->pacing_parent_frame = 0;
+		return;
+	}
+
+	Frame * parent_frame = get_innermost_executing_frame();
+	if(parent_frame == 0 || deadline <= 0.0 || check_period < 1) {
+		std::cerr << "ExecFrame::pace(): ERROR: for ExecFrame #" << id << (parent_frame == 0 ? " no enclosing Frame is executing" : "")
+			<< " deadline = " << deadline << " must be > 0.0, check_period = " << check_period << " must be >= 1" << std::endl;
+		exit(1);
+	}
+
+	execframe_info->pacing_parent_frame = parent_frame;
+	execframe_info->pacing_parent_invocation_index = FrameInfo::get_frame_info(parent_frame)->decision_model.invocation_index;
+	execframe_info->pacing_items_remaining = items_remaining;
+	execframe_info->pacing_deadline = deadline;
+	execframe_info->pacing_check_period = check_period;
+	execframe_info->pacing_items_since_check = 0;
+	execframe_info->pacing_decision_vector_int_value = -1;
+}
+
+void ExecFrame::run_batch(long long num_items) {
+	if(num_items < 1) {
+		std::cerr << "ExecFrame::run_batch(): ERROR: invalid num_items = " << num_items << " for ExecFrame #" << id << std::endl;
+		exit(1);
+	}
+	ExecFrameInfo * execframe_info = ExecFrameInfo::get_execframe_info(this);
+	execframe_info->run(num_items);
+}
+
 void ExecFrame::force_default_selection(bool bEnable) {
 	ExecFrameInfo * execframe_info = ExecFrameInfo::get_execframe_info(this);
 	execframe_info->bForceDefaultSelectChoice = bEnable;
@@ -54,6 +106,16 @@ void ExecFrame::force_fast_reaction_strategy_fixed_coeff(bool bEnable) {
 	execframe_info->bForceFixedCoeff_in_FastReactionStrategy = bEnable;
 }
 
+void ExecFrame::calibrate(int num_calibration_invocations) {
+	if(num_calibration_invocations < 0) {
+		std::cerr << "ExecFrame::calibrate(): ERROR: ExecFrame #" << id << " given negative num_calibration_invocations = "
+			<< num_calibration_invocations << std::endl;
+		exit(1);
+	}
+	ExecFrameInfo * execframe_info = ExecFrameInfo::get_execframe_info(this);
+	execframe_info->num_calibration_invocations = num_calibration_invocations;
+}
+
 
 /////////////////////////////
 //API function-calls related to ExecFrame
@@ -75,13 +137,26 @@ ExecFrame * get_execframe_from_execframe_id(FrameID_t execframe_id)
 //class ExecFrameInfo definitions
 /////////////////////////////
 
+//debug control
+DebugMessageLevel_t debug_message_level = DebugMsgALL;
+
+void feature_control_debug_message_level(DebugMessageLevel_t new_setting) {
+	debug_message_level = new_setting;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: debug_message_level = " << debug_message_level << std::endl;
+}
+
+DebugMessageLevel_t feature_query_debug_message_level() {
+	return debug_message_level;
+}
+
+
 //debug control
 double probability_of_exploration = 0.0;
 
 void feature_control_probability_of_exploration(double new_setting) {
 	assert(0.0 <= new_setting && new_setting < 1.0);
 	probability_of_exploration = new_setting;
-	std::cout << "SRT Feature Control: probability_of_exploration = " << probability_of_exploration << std::endl;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: probability_of_exploration = " << probability_of_exploration << std::endl;
 }
 
 double feature_query_probability_of_exploration() {
@@ -94,7 +169,7 @@ bool use_fast_reaction_strategy = false;
 
 void feature_control_use_fast_reaction_strategy(bool new_setting) {
 	use_fast_reaction_strategy = new_setting;
-	std::cout << "SRT Feature Control: use_fast_reaction_strategy = " << use_fast_reaction_strategy << std::endl;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: use_fast_reaction_strategy = " << use_fast_reaction_strategy << std::endl;
 }
 
 bool feature_query_use_fast_reaction_strategy() {
@@ -102,11 +177,246 @@ bool feature_query_use_fast_reaction_strategy() {
 }
 
 
+//debug control
+bool use_thompson_sampling_strategy = false;
+
+void feature_control_use_thompson_sampling_strategy(bool new_setting) {
+	use_thompson_sampling_strategy = new_setting;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: use_thompson_sampling_strategy = " << use_thompson_sampling_strategy << std::endl;
+}
+
+bool feature_query_use_thompson_sampling_strategy() {
+	return use_thompson_sampling_strategy;
+}
+
+
+//debug control
+bool bWorkloadHintFeedforward = true;
+
+void feature_control_workload_hint_feedforward(bool new_setting) {
+	bWorkloadHintFeedforward = new_setting;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: bWorkloadHintFeedforward = " << bWorkloadHintFeedforward << std::endl;
+}
+
+bool feature_query_workload_hint_feedforward() {
+	return bWorkloadHintFeedforward;
+}
+
+
+
+//debug control
+bool bQualityFeedback = true;
+
+void feature_control_quality_feedback(bool new_setting) {
+	bQualityFeedback = new_setting;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: bQualityFeedback = " << bQualityFeedback << std::endl;
+}
+
+bool feature_query_quality_feedback() {
+	return bQualityFeedback;
+}
+
+
+//debug control
+long long max_enumerated_decision_vectors = 4096;
+
+void feature_control_max_enumerated_decision_vectors(long long new_setting) {
+	assert(new_setting >= 0);
+	max_enumerated_decision_vectors = new_setting;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: max_enumerated_decision_vectors = " << max_enumerated_decision_vectors << std::endl;
+}
+
+long long feature_query_max_enumerated_decision_vectors() {
+	return max_enumerated_decision_vectors;
+}
+
+
+//debug control
+DecisionSearch_t decision_search_strategy = SearchCOORDINATE_DESCENT;
+
+void feature_control_decision_search_strategy(DecisionSearch_t new_setting) {
+	decision_search_strategy = new_setting;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: decision_search_strategy = " << decision_search_strategy << std::endl;
+}
+
+DecisionSearch_t feature_query_decision_search_strategy() {
+	return decision_search_strategy;
+}
+
+
+
+void ExecFrameInfo::activate_validity_oracles() {
+	vActive_validity_oracles.clear();
+	if(curr_parent_frame == 0)
+		return;
+
+	//curr_parent_frame and the frames dynamically enclosing it, innermost first
+	for(Frame * frame = curr_parent_frame; frame != 0; frame = FrameInfo::get_frame_info(frame)->curr_parent_frame) {
+		const Constraint& constraint = FrameInfo::get_frame_info(frame)->constraint;
+		if(constraint.get_type() == Constraint::UNDEF)
+			continue;
+
+		if(map_constraining_frame_to_validity_oracle.count(frame) == 0) { //compile once
+			std::vector<int> vNum_values;
+			for(int j=0; j<(int)vVarPriority.size(); j++)
+				vNum_values.push_back( (int)vVarPriority[j].size() );
+			DecisionValidityOracle * oracle = new DecisionValidityOracle(constraint, vDecisionVector, vNum_values);
+			map_constraining_frame_to_validity_oracle[frame] = oracle;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrameInfo::activate_validity_oracles(): ExecFrame #" << my_execframe->id
+				<< " under Constraint of Frame #" << frame->id << ": " << oracle->print_string() << std::endl;
+		}
+
+		const DecisionValidityOracle * oracle = map_constraining_frame_to_validity_oracle[frame];
+		if(oracle->constrains_decisions())
+			vActive_validity_oracles.push_back(oracle);
+	}
+}
+
+const std::vector<DecisionKey_t>& ExecFrameInfo::get_valid_decision_keys() {
+	std::map<std::vector<const DecisionValidityOracle *>, std::vector<DecisionKey_t> >::iterator mit
+		= map_active_oracles_to_valid_decision_keys.find(vActive_validity_oracles);
+	if(mit != map_active_oracles_to_valid_decision_keys.end())
+		return mit->second;
+
+	const DecisionValidityOracle * smallest_tabulated_oracle = 0;
+	for(int i=0; i<(int)vActive_validity_oracles.size(); i++) {
+		const DecisionValidityOracle * oracle = vActive_validity_oracles[i];
+		if(oracle->is_tabulated() && (smallest_tabulated_oracle == 0
+				|| oracle->get_valid_keys().size() < smallest_tabulated_oracle->get_valid_keys().size()))
+			smallest_tabulated_oracle = oracle;
+	}
+
+	std::vector<DecisionKey_t>& vValid_keys = map_active_oracles_to_valid_decision_keys[vActive_validity_oracles];
+	if(smallest_tabulated_oracle != 0) { //enumerate only the decision-vectors it admits
+		const std::vector<DecisionKey_t>& vCandidate_keys = smallest_tabulated_oracle->get_valid_keys();
+		for(int i=0; i<(int)vCandidate_keys.size(); i++) {
+			if(is_valid_decision_key(vCandidate_keys[i]))
+				vValid_keys.push_back(vCandidate_keys[i]);
+		}
+	}
+	else {
+		DecisionKey_t num_decision_vectors = get_num_decision_vectors();
+		for(DecisionKey_t key=0; key<num_decision_vectors; key++) {
+			if(is_valid_decision_key(key))
+				vValid_keys.push_back(key);
+		}
+	}
+	return vValid_keys;
+}
+
+	// Closeness of a decision-vector to a target decision-vector, heavily penalized when invalid.
+class NearestValidDecisionProblem : public DecisionSearchProblem {
+public:
+	static const double invalid_penalty;
+
+	const ExecFrameInfo * execframe_info;
+	std::vector<int> target_dec_vec;
+
+	NearestValidDecisionProblem(const ExecFrameInfo * execframe_info, const std::vector<int>& target_dec_vec)
+		: execframe_info(execframe_info), target_dec_vec(target_dec_vec) { }
+
+	int get_num_variables() const
+		{ return (int)execframe_info->vVarPriority.size(); }
+
+	int get_num_values(int variable_index) const
+		{ return (int)execframe_info->vVarPriority.at(variable_index).size(); }
+
+	double score(const std::vector<int>& dec_vec) const {
+		int distance = 0;
+		for(int i=0; i<(int)dec_vec.size(); i++)
+			distance += abs(dec_vec[i] - target_dec_vec[i]);
+		double result = -distance + 0.5 * execframe_info->get_feature_level(dec_vec);
+			//feature level only breaks ties in distance
+		if(execframe_info->is_valid_decision_vector(dec_vec) == false)
+			result -= invalid_penalty;
+		return result;
+	}
+};
+
+const double NearestValidDecisionProblem::invalid_penalty = 1.0e6;
+
+const int max_nearest_valid_search_nodes = 100000;
+
+bool ExecFrameInfo::assign_nearest_consistent_values(
+	std::vector<int>& partial_dec_vec,
+	int dec_var_index,
+	const std::vector<int>& target_dec_vec,
+	int& remaining_node_budget
+) const
+{
+	if(dec_var_index == (int)partial_dec_vec.size())
+		return is_valid_decision_vector(partial_dec_vec);
+
+	//try values in increasing distance from the target, higher feature level first on equal distance
+	int num_values = (int)vVarPriority[dec_var_index].size();
+	int target_value = target_dec_vec[dec_var_index];
+	std::vector< std::pair<double, int> > vOrder_Value;
+	for(int v=0; v<num_values; v++)
+		vOrder_Value.push_back( std::make_pair(abs(v - target_value) - 0.5 * get_variable_feature_level(dec_var_index, v), v) );
+	std::sort(vOrder_Value.begin(), vOrder_Value.end());
+
+	for(int k=0; k<num_values; k++) {
+		if(remaining_node_budget-- <= 0)
+			return false;
+		partial_dec_vec[dec_var_index] = vOrder_Value[k].second;
+		if(is_consistent_partial_decision_vector(partial_dec_vec)
+				&& assign_nearest_consistent_values(partial_dec_vec, dec_var_index+1, target_dec_vec, remaining_node_budget))
+			return true;
+	}
+	partial_dec_vec[dec_var_index] = -1;
+	return false;
+}
+
+std::vector<int> ExecFrameInfo::get_nearest_valid_decision_vector(const std::vector<int>& dec_vec) const {
+	if(is_valid_decision_vector(dec_vec))
+		return dec_vec;
+
+	NearestValidDecisionProblem problem(this, dec_vec);
+	std::vector<int> nearest_dec_vec = coordinate_descent_search(problem, dec_vec, (int)dec_vec.size() + 1);
+	if(is_valid_decision_vector(nearest_dec_vec))
+		return nearest_dec_vec;
+
+	//single-variable moves could not reach a valid decision-vector:
+	//  assign variables in turn, backtracking when the partial assignment is found inconsistent
+	std::vector<int> partial_dec_vec(dec_vec.size(), -1);
+	int remaining_node_budget = max_nearest_valid_search_nodes;
+	if(assign_nearest_consistent_values(partial_dec_vec, 0, dec_vec, remaining_node_budget))
+		return partial_dec_vec;
+
+	std::cerr << "ExecFrameInfo::get_nearest_valid_decision_vector(): ERROR: no valid decision-vector found for ExecFrame #"
+		<< my_execframe->id << std::endl;
+	exit(1);
+}
+
+
+
+void ExecFrameInfo::remove_invalid_decision_keys(
+	std::vector<DecisionKey_t>& vDecisionSet,
+	std::vector<double>& vDecisionSet_Counts,
+	std::vector<double>& vDecisionSet_Probs
+) const
+{
+	int num_kept = 0;
+	for(int i=0; i<(int)vDecisionSet.size(); i++) {
+		if(is_valid_decision_key(vDecisionSet[i]) == false)
+			continue;
+		vDecisionSet[num_kept] = vDecisionSet[i];
+		vDecisionSet_Counts[num_kept] = vDecisionSet_Counts[i];
+		vDecisionSet_Probs[num_kept] = vDecisionSet_Probs[i];
+		num_kept++;
+	}
+	vDecisionSet.resize(num_kept);
+	vDecisionSet_Counts.resize(num_kept);
+	vDecisionSet_Probs.resize(num_kept);
+}
 
 bool sort_helper_vRank_Index(std::pair<double, int> x, std::pair<double, int> y)
 { return (y.first < x.first); } //sort descending
 
-int ExecFrameInfo::choose_decision_vector_int_value() {
+bool sort_helper_vReward_DecisionKey(std::pair<double, DecisionKey_t> x, std::pair<double, DecisionKey_t> y)
+{ return (y.first < x.first); } //sort descending
+
+DecisionKey_t ExecFrameInfo::choose_decision_vector_int_value() {
 	ExecFrameInfo * execframe_info = this;
 
 	ExecFrameDecisionModel& execframe_dec_model = execframe_info->decision_model;
@@ -118,20 +428,33 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 
 	// Now, curr_parent_frame != 0, parent frame present
 
-	std::cout << "ExecFrameInfo::choose_decision_vector_int_value(): has parent frame" << std::endl;
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrameInfo::choose_decision_vector_int_value(): has parent frame" << std::endl;
+
+	DecisionKey_t calibration_decision_vector_int_value = -1;
+	if(calibration_choice_int_value(calibration_decision_vector_int_value))
+		return calibration_decision_vector_int_value;
+
+	if(FrameInfo::get_frame_info(curr_parent_frame)->decision_model.bHasQualityFloorObjective) {
+		//only the Thompson Sampling Strategy learns from reported quality
+		return thompson_sampling_strategy_choice_int_value();
+	}
 	
 	if(use_fast_reaction_strategy) {
 		return fast_reaction_strategy_choice_int_value();
 	}
 
+	if(use_thompson_sampling_strategy || get_num_decision_vectors() > max_enumerated_decision_vectors) {
+		return thompson_sampling_strategy_choice_int_value();
+	}
+
 
-	std::vector<int> vForDecisionSet;
+	std::vector<DecisionKey_t> vForDecisionSet;
 	std::vector<double> vForDecisionSet_Counts;
 	std::vector<double> vForDecisionSet_Probs;
-	std::vector<int> vUnclassifiedDecisionSet;
+	std::vector<DecisionKey_t> vUnclassifiedDecisionSet;
 	std::vector<double> vUnclassifiedDecisionSet_Counts;
 	std::vector<double> vUnclassifiedDecisionSet_Probs;
-	std::vector<int> vAgainstDecisionSet;
+	std::vector<DecisionKey_t> vAgainstDecisionSet;
 	std::vector<double> vAgainstDecisionSet_Counts;
 	std::vector<double> vAgainstDecisionSet_Probs;
 	bool bUpperParentBlocksLowerParentsPreferences
@@ -143,6 +466,10 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 				vAgainstDecisionSet, vAgainstDecisionSet_Counts, vAgainstDecisionSet_Probs
 			);
 
+	remove_invalid_decision_keys(vForDecisionSet, vForDecisionSet_Counts, vForDecisionSet_Probs);
+	remove_invalid_decision_keys(vUnclassifiedDecisionSet, vUnclassifiedDecisionSet_Counts, vUnclassifiedDecisionSet_Probs);
+	remove_invalid_decision_keys(vAgainstDecisionSet, vAgainstDecisionSet_Counts, vAgainstDecisionSet_Probs);
+
 	if(vForDecisionSet.size() > 0) { //some discrimating decision-vectors are known
 		//pick highest 'rank' one from the known decision-vectors at the decision-level dec_index
 		// Sort Criteria (in decreasing order of importance)
@@ -152,15 +479,15 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 		// ==> create 'rank' for each decision-vector value
 		//        (OPTIMIZATION: rank can be stored and incrementally adjusted, instead of recomputed)
 
-		std::cout << "ExecFrameInfo::choose_decision_vector_int_value(): decision-vector ranks FOR:";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrameInfo::choose_decision_vector_int_value(): decision-vector ranks FOR:";
 		std::vector<double> vRanks(vForDecisionSet.size(), 0.0); //corresponding to values in vForDecisionSet
 		for(int i=0; i<(int)vForDecisionSet.size(); i++) {
 			double rank = vForDecisionSet_Probs[i] * 100.0 + vForDecisionSet_Counts[i] * 10.0
 				- ((double)vForDecisionSet[i]) / ((double)get_num_decision_vectors());
 			vRanks[i] = rank;
-			std::cout << "(" << vForDecisionSet[i] << ", " << rank << ") ";
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << "(" << vForDecisionSet[i] << ", " << rank << ") ";
 		}
-		std::cout << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << std::endl;
 		double max_rank = vRanks.at(0);
 		int max_rank_index = 0;
 		for(int i=1; i<(int)vRanks.size(); i++) {
@@ -194,22 +521,22 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 		//         0.8 * 0.5 + w * 1 <= 1 * 1 + w * 0 => w <= 0.6. Choose w = 0.6
 		//
 
-		std::cout << "ExecFrameInfo::choose_decision_vector_int_value(): no decision level worked" << std::endl;
-		std::cout << "   vAgainstDecisionSet = [";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrameInfo::choose_decision_vector_int_value(): no decision level worked" << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "   vAgainstDecisionSet = [";
 		for(int x=0; x<(int)vAgainstDecisionSet.size(); x++)
-			std::cout << vAgainstDecisionSet[x] << " ";
-		std::cout << "]" << std::endl;
-		std::cout << "   Unprocessed vUnclassifiedDecisionSet_Probs = [";
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << vAgainstDecisionSet[x] << " ";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]" << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "   Unprocessed vUnclassifiedDecisionSet_Probs = [";
 		for(int x=0; x<(int)vUnclassifiedDecisionSet.size(); x++)
-			std::cout << vUnclassifiedDecisionSet[x] << " ";
-		std::cout << "]" << std::endl;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << vUnclassifiedDecisionSet[x] << " ";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]" << std::endl;
 
 		std::vector<int> highest_po_dec_vec = get_highest_priority_order_decision_vector();
 
 		std::vector<int> curr_dec_vec = highest_po_dec_vec;
-		int curr_dec_vec_int_val = -1;
-		int last_dec_vec_int_val = -1;
-		int first_prob_expl_skipped_dec_vec_int_val = -1;
+		DecisionKey_t curr_dec_vec_int_val = -1;
+		DecisionKey_t last_dec_vec_int_val = -1;
+		DecisionKey_t first_prob_expl_skipped_dec_vec_int_val = -1;
 		int first_prob_expl_skipped_stickiness_runlength = 0;
 
 		//Add to vUnclassifiedDecisionSet_Probs all decision-vectors which are not already present
@@ -234,7 +561,7 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 					}
 				}
 
-				if(isPresentInAgainstSet == false) { //add to vUnclassifiedDecisionSet
+				if(isPresentInAgainstSet == false && is_valid_decision_key(curr_dec_vec_int_val)) { //add to vUnclassifiedDecisionSet
 					vUnclassifiedDecisionSet.push_back( curr_dec_vec_int_val );
 					vUnclassifiedDecisionSet_Counts.push_back( 0.0 );
 					vUnclassifiedDecisionSet_Probs.push_back( 1.0 );
@@ -262,9 +589,9 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 			total_count = 1.0; //safe to do, since all numerators == 0
 
 		//Compute ranks
-		int num_decision_vectors = get_num_decision_vectors();
+		DecisionKey_t num_decision_vectors = get_num_decision_vectors();
 		for(int i=0; i<(int)vUnclassifiedDecisionSet.size(); i++) {
-			int dec_vec_int_val = vUnclassifiedDecisionSet[i];
+			DecisionKey_t dec_vec_int_val = vUnclassifiedDecisionSet[i];
 			double count_ratio = vUnclassifiedDecisionSet_Counts.at(i) / total_count;
 			double normalized_priority = 1.0 - ((double)dec_vec_int_val) / num_decision_vectors;
 			double prob_success = vUnclassifiedDecisionSet_Probs.at(i);
@@ -278,18 +605,18 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 
 		std::sort(vRank_Index.begin(), vRank_Index.end(), sort_helper_vRank_Index);
 
-		std::cout << "   vUnclassifiedDecisionSet = [";
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "   vUnclassifiedDecisionSet = [";
 		for(int x=0; x<(int)vRank_Index.size(); x++) {
 			double rank = vRank_Index[x].first;
 			int index = vRank_Index[x].second;
 
-			int dec_vec_int_val = vUnclassifiedDecisionSet.at(index);
+			DecisionKey_t dec_vec_int_val = vUnclassifiedDecisionSet.at(index);
 			double count = vUnclassifiedDecisionSet_Counts.at(index);
 			double prob = vUnclassifiedDecisionSet_Probs.at(index);
 
-			std::cout << "(" << dec_vec_int_val << ", " << rank << " {" << count << "," << prob << "}), ";
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << "(" << dec_vec_int_val << ", " << rank << " {" << count << "," << prob << "}), ";
 		}
-		std::cout << "]" << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "]" << std::endl;
 
 		//choose a decision-vector in rank order
 		curr_dec_vec_int_val = -1;
@@ -303,7 +630,7 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 			}
 
 			if(probability_of_exploration > 0.0) { //debug control: probabilitic exploration
-				double random_sample = (std::rand() % 1000) / 1000.0; // 0 <= random_sample <= 1
+				double random_sample = random_uniform(); // 0 <= random_sample < 1
 				if(probability_of_exploration > random_sample) {
 					//pretend curr_dec_vec_int_val cannot be used, force further exploration
 					if(first_prob_expl_skipped_dec_vec_int_val == -1) { //is this the first value being skipped
@@ -311,7 +638,7 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 						first_prob_expl_skipped_stickiness_runlength = stickiness_runlength_remaining;
 					}
 
-					std::cout << "ExecFrame #" << my_execframe->id << ": Probabilistic Exploration forced past workable "
+					OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrame #" << my_execframe->id << ": Probabilistic Exploration forced past workable "
 						<< "curr_dec_vec_int_val = " << curr_dec_vec_int_val << std::endl;
 
 					curr_dec_vec_int_val = -1;
@@ -336,15 +663,15 @@ int ExecFrameInfo::choose_decision_vector_int_value() {
 				return first_prob_expl_skipped_dec_vec_int_val;
 			} //else: no probabilistic skipping occured, no workable values exist, have to use vAgainstDecisionSet
 
-			std::cout << "ExecFrameInfo::choose_decision_vector_int_value(): decision-vector ranks AGAINST:";
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrameInfo::choose_decision_vector_int_value(): decision-vector ranks AGAINST:";
 			std::vector<double> vRanks(vAgainstDecisionSet.size(), 0.0); //corresponding to values in vAgainstDecisionSet
 			for(int i=0; i<(int)vAgainstDecisionSet.size(); i++) {
 				double rank = - vAgainstDecisionSet_Probs[i] * 100.0 - vAgainstDecisionSet_Counts[i] * 10.0
 					- ((double)vAgainstDecisionSet[i]) / ((double)get_num_decision_vectors());
 				vRanks[i] = rank;
-				std::cout << "(" << vAgainstDecisionSet[i] << ", " << rank << ") ";
+				OPP_DEBUG_MESSAGE(DebugMsgALL) << "(" << vAgainstDecisionSet[i] << ", " << rank << ") ";
 			}
-			std::cout << std::endl;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << std::endl;
 			double max_rank = vRanks.at(0);
 			int max_rank_index = 0;
 			for(int i=1; i<(int)vRanks.size(); i++) {
@@ -378,6 +705,177 @@ const double deviation_geometric_convergence_short = 1.0 / (1.0 - deviation_weig
 const double array_StatWindowBoundaries[] = {-1.0, -.75, -.40, -.20, -.10, .10, .20, .40, .75, 1.0, 1.5, 2.0, 3.0, 5.0};
 const std::vector<double> vStatWindowBoundaries( array_StatWindowBoundaries, array_StatWindowBoundaries + sizeof(array_StatWindowBoundaries)/sizeof(*array_StatWindowBoundaries) );
 
+//number of points at which variable var_index is measured by a calibration of num_calibration_invocations invocations:
+//  the invocations are split evenly across the variables having a choice, and each is measured atleast at its two ends
+static int get_calibration_num_points(
+	const std::vector< std::vector<int> >& vVarPriority,
+	int num_calibration_invocations,
+	int var_index
+)
+{
+	int num_swept_vars = 0;
+	for(int i=0; i<(int)vVarPriority.size(); i++) {
+		if(vVarPriority[i].size() > 1)
+			num_swept_vars++;
+	}
+	assert(num_swept_vars > 0);
+
+	int num_points = std::max(2, num_calibration_invocations / num_swept_vars);
+	return std::min(num_points, (int)vVarPriority.at(var_index).size());
+}
+
+bool ExecFrameInfo::calibration_choice_int_value(DecisionKey_t& result_decision_vector_int_value) {
+	assert(curr_parent_frame != 0);
+
+	if(num_calibration_invocations == 0)
+		return false;
+
+	FrameInfo * parent_frame_info = FrameInfo::get_frame_info(curr_parent_frame);
+	FrameDecisionModel& parent_frame_dec = parent_frame_info->decision_model;
+
+	if(parent_frame_dec.bHasMeanObjectiveDefined == false) //no objective tolerance to calibrate against
+		return false;
+
+	Parameter * ptr_decision_vector_parameter = &(decision_model.decision_vector_parameter);
+	assert(parent_frame_dec.map_parm_to_fast_reaction_state.count(ptr_decision_vector_parameter) > 0);
+	FastReactionState& frs = *(parent_frame_dec.map_parm_to_fast_reaction_state[ptr_decision_vector_parameter]);
+
+	if(frs.bCalibrationDone)
+		return false;
+
+	if(frs.calibration_invocations_remaining == -1) { //not started
+		if(frs.vPrevious_model_choice_double_value.size() > 0) { //already learned, e.g. restored by snapshot_load()
+			frs.bCalibrationDone = true;
+			return false;
+		}
+		frs.calibration_invocations_remaining = num_calibration_invocations;
+		frs.calibration_var_index = 0;
+		frs.calibration_step = 0;
+		frs.vCalibration_X.clear();
+		frs.vvCalibration_samples.clear();
+		frs.vvCalibration_samples.resize( vDecisionVector.size() );
+	}
+
+	if(frs.vCalibration_X.size() > 0 && frs.last_decided_invocation_index == parent_frame_dec.invocation_index) {
+		//subsequent run within the same invocation of the parent: re-use its calibration choice
+		frs.current_invocation_run_index++;
+	}
+	else {
+		if(frs.vCalibration_X.size() > 0 && frs.last_decided_invocation_index == parent_frame_dec.invocation_index - 1) {
+			//the parent's previous invocation ran the pending calibration choice
+			int var_index = frs.calibration_var_index;
+			double Y = parent_frame_dec.previous_invocation_exec_time;
+			frs.vvCalibration_samples.at(var_index).push_back( std::make_pair(frs.vCalibration_X.at(var_index), Y) );
+			frs.calibration_step++;
+
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrameInfo::calibration_choice_int_value(): ExecFrame #" << my_execframe->id
+				<< " X" << var_index << " = " << frs.vCalibration_X[var_index] << " measured Y = " << Y << std::endl;
+
+			if(Y > parent_frame_dec.mean_objective * (1.0 + parent_frame_dec.window_frac_upper) //more complex choices only exceed the tolerance further
+				|| frs.calibration_step >= get_calibration_num_points(vVarPriority, num_calibration_invocations, var_index))
+			{
+				frs.calibration_var_index++;
+				frs.calibration_step = 0;
+			}
+		}
+		//else: the parent's previous invocation did not run this ExecFrame, so re-try the pending choice
+
+		while(frs.calibration_var_index < (int)vDecisionVector.size() && vVarPriority[frs.calibration_var_index].size() <= 1)
+			frs.calibration_var_index++; //nothing to measure for a variable with a single choice
+
+		if(frs.calibration_invocations_remaining == 0 || frs.calibration_var_index >= (int)vDecisionVector.size()) {
+			complete_calibration(parent_frame_dec, frs);
+			return false;
+		}
+		frs.calibration_invocations_remaining--;
+
+		//variable being swept moves from its cheapest choice towards its most complex one (choice 0),
+		//  while the others are held at their cheapest
+		int var_index = frs.calibration_var_index;
+		int max_X = vVarPriority[var_index].size() - 1;
+		int num_points = get_calibration_num_points(vVarPriority, num_calibration_invocations, var_index);
+
+		frs.vCalibration_X.clear();
+		for(int i=0; i<(int)vDecisionVector.size(); i++)
+			frs.vCalibration_X.push_back( vVarPriority[i].size() - 1 );
+		frs.vCalibration_X[var_index] = (double)int( max_X - frs.calibration_step * max_X / (double)(num_points - 1) + 0.5 );
+
+		frs.last_decided_invocation_index = parent_frame_dec.invocation_index;
+		frs.current_invocation_run_index = 0;
+	}
+
+	//the calibration runs are learned by all strategies: credit the Thompson Sampling Strategy's posteriors too
+	assert(parent_frame_dec.map_parm_to_thompson_model.count(ptr_decision_vector_parameter) > 0);
+	ThompsonSamplingModel * thompson_model = parent_frame_dec.map_parm_to_thompson_model[ptr_decision_vector_parameter];
+	if(thompson_model->active_context_bin == -1) {
+		thompson_model->active_context_bin = ThompsonSamplingModel::get_context_bin(
+				parent_frame_dec.previous_invocation_exec_time, parent_frame_dec.mean_objective,
+				parent_frame_dec.window_frac_lower, parent_frame_dec.window_frac_upper );
+	}
+
+	frs.vCurrent_invocation_model_choice_double_value = frs.vCalibration_X;
+	vChosen_decision_vector_positions = frs.vCalibration_X;
+
+	std::vector<int> vDecisionValues;
+	for(int i=0; i<(int)frs.vCalibration_X.size(); i++)
+		vDecisionValues.push_back( int(frs.vCalibration_X[i]) );
+	result_decision_vector_int_value = convert_decision_vector_to_int( vDecisionValues );
+
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrameInfo::calibration_choice_int_value(): ExecFrame #" << my_execframe->id
+		<< " CALIBRATING with vCalibration_X = " << vector_print_string(frs.vCalibration_X)
+		<< " calibration_invocations_remaining = " << frs.calibration_invocations_remaining << std::endl;
+	return true;
+}
+
+void ExecFrameInfo::complete_calibration(
+	const FrameDecisionModel& parent_frame_dec,
+	FastReactionState& frs
+)
+{
+	initialize_fast_reaction_state(parent_frame_dec, frs);
+
+	//Y = a_i * x_i + c: least-squares slope over the choices measured for each variable.
+	//  A non-negative slope (measurements dominated by noise) keeps the initial coefficient.
+	for(int i=0; i<(int)frs.vvCalibration_samples.size(); i++) {
+		const std::vector< std::pair<double, double> >& vSamples = frs.vvCalibration_samples[i];
+		if(vSamples.size() < 2)
+			continue;
+
+		double mean_X = 0.0;
+		double mean_Y = 0.0;
+		for(int k=0; k<(int)vSamples.size(); k++) {
+			mean_X += vSamples[k].first;
+			mean_Y += vSamples[k].second;
+		}
+		mean_X /= vSamples.size();
+		mean_Y /= vSamples.size();
+
+		double sum_XX = 0.0;
+		double sum_XY = 0.0;
+		for(int k=0; k<(int)vSamples.size(); k++) {
+			sum_XX += (vSamples[k].first - mean_X) * (vSamples[k].first - mean_X);
+			sum_XY += (vSamples[k].first - mean_X) * (vSamples[k].second - mean_Y);
+		}
+		if(sum_XX > 0.0 && sum_XY < 0.0)
+			frs.vCoeffs_a[i] = sum_XY / sum_XX;
+	}
+
+	//resume from the last calibration choice, whose outcome the parent's next invocation sees as its previous one
+	if(frs.vCalibration_X.size() > 0) {
+		frs.vPrevious_model_choice_double_value = frs.vCalibration_X;
+		frs.vUnbounded_Previous_model_choice_double_value = frs.vCalibration_X;
+	}
+
+	frs.vCalibration_X.clear();
+	frs.vvCalibration_samples.clear();
+	frs.bCalibrationDone = true;
+
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "ExecFrameInfo::complete_calibration(): ExecFrame #" << my_execframe->id
+		<< " calibrated vCoeffs_a = " << vector_print_string(frs.vCoeffs_a)
+		<< " resuming from vPrevious_model_choice_double_value = " << vector_print_string(frs.vPrevious_model_choice_double_value) << std::endl;
+}
+
+
 #include "opp_srt_version.h"
 #ifndef SRT_VERSION
 #error "Macro variable SRT_VERSION must be set to current path or current version of SRT for reporting in logs"
@@ -385,7 +883,7 @@ const std::vector<double> vStatWindowBoundaries( array_StatWindowBoundaries, arr
 
 bool bFirstTime = true;
 
-int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
+DecisionKey_t ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 	assert(curr_parent_frame != 0);
 
 	//Decision Strategy optimizes only for achieving the immediate parent's objective.
@@ -395,7 +893,7 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 	FrameDecisionModel& parent_frame_dec = parent_frame_info->decision_model;
 
 	if(bFirstTime) {
-		std::cout << "INVOKING fast_reaction_strategy_choice_int_value from SRT_VERSION: " << SRT_VERSION << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "INVOKING fast_reaction_strategy_choice_int_value from SRT_VERSION: " << SRT_VERSION << std::endl;
 		bFirstTime = false;
 	}
 
@@ -403,107 +901,150 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 		return 0; //impose most complex choice for all (x1, x2, .. xn)
 	}
 
-	double Y_failure_delta = parent_frame_dec.previous_invocation_exec_time - parent_frame_dec.mean_objective;
+	Parameter * ptr_decision_vector_parameter = &(decision_model.decision_vector_parameter);
+	assert(parent_frame_dec.map_parm_to_fast_reaction_state.count(ptr_decision_vector_parameter) > 0);
+	FastReactionState& frs = *(parent_frame_dec.map_parm_to_fast_reaction_state[ptr_decision_vector_parameter]);
 
-	assert(vDecisionVector.size() > 0); //Model must contain atleast one Select model, which can then be controlled to achieve Objective
-	if(parent_frame_dec.vPrevious_model_choice_double_value.size() == 0) { //not initialized
-		parent_frame_dec.vPrevious_model_choice_double_value.resize( vDecisionVector.size(), -1.0 );
-		parent_frame_dec.vUnbounded_Previous_model_choice_double_value.resize( vDecisionVector.size(), -1.0 );
-		parent_frame_dec.vAverage_X_deviation.resize( vDecisionVector.size(), 0.0 );
-		parent_frame_dec.vSum_X_deviation.resize( vDecisionVector.size(), 0.0 );
-
-		parent_frame_dec.vCoeffs_a.resize( vDecisionVector.size(), -1.0/5000.0 );
-		for(int i=0; i<(int)parent_frame_dec.vCoeffs_a.size(); i++) {
-			if(vInitialCoeffs_fast_reaction_strategy.at(i) != 0.0)
-				parent_frame_dec.vCoeffs_a[i] = (-1) * vInitialCoeffs_fast_reaction_strategy[i];
-		}
-		
-		parent_frame_dec.current_window_length_X_deviation = 0;
-		parent_frame_dec.current_failure_unidirectional_runlenth = 0;
-		parent_frame_dec.average_continuous_unidirectional_failure_runlength = 0.0;
-		parent_frame_dec.current_number_unidirectional_runs = 0;
-
-		parent_frame_dec.previous_Y = 0.0;
-		parent_frame_dec.halfcycle_start_deflection_sign = (parent_frame_dec.previous_Y <= parent_frame_dec.mean_objective ? -1 : +1);
-		parent_frame_dec.halfcycle_Y_positive_max_deflection = 0.0;
-		parent_frame_dec.halfcycle_Y_negative_max_deflection = 0.0;
-		parent_frame_dec.halfcycle_length = 0;
-		parent_frame_dec.has_halfcycle_crossed_mean = false;
-		parent_frame_dec.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window = 0.0;
-
-		parent_frame_dec.contiguous_onesided_failure_runlength = 0;
-		parent_frame_dec.vDeflectionInX_during_onesided_failure.resize( vDecisionVector.size(), 0.0 );
-		parent_frame_dec.correction_runlength_onesided_failure = 0;
-		parent_frame_dec.correction_vDeflectionInX_during_onesided_failure.resize( vDecisionVector.size(), 0.0 );
-
-		parent_frame_dec.vvvVarChoiceStats.resize( vDecisionVector.size() );
-		for(int i=0; i<(int)parent_frame_dec.vvvVarChoiceStats.size(); i++) { //for each variable
-			parent_frame_dec.vvvVarChoiceStats[i].resize( vVarPriority[i].size(), std::vector<long long int>(vStatWindowBoundaries.size(), 0) );
-		}
+	//The feedback from the parent's previous invocations is applied once per invocation of the parent,
+	//  subsequent runs within the same invocation only re-apply the intra-frame correction to it.
+	if(frs.last_decided_invocation_index != parent_frame_dec.invocation_index) {
+		frs.vBase_X = fast_reaction_strategy_base_choice(parent_frame_info, frs);
+		frs.last_decided_invocation_index = parent_frame_dec.invocation_index;
+		frs.current_invocation_run_index = 0;
+	}
+	else
+		frs.current_invocation_run_index++;
+
+	std::vector<double> vX = apply_intra_frame_slack_reclaiming(parent_frame_info, frs, frs.vBase_X);
+	frs.vCurrent_invocation_model_choice_double_value = vX;
+	vChosen_decision_vector_positions = vX;
+
+	std::vector<int> vDecisionValues;
+	for(int i=0; i<(int)vX.size(); i++)
+		vDecisionValues.push_back( int(vX[i] + 0.5) );
+	return convert_decision_vector_to_int( vDecisionValues );
+}
 
-		std::cout << "fast_reaction_strategy_choice_int_value(): Initializing: vCoeffs_a = " << vector_print_string(parent_frame_dec.vCoeffs_a) << std::endl;
+
+void ExecFrameInfo::initialize_fast_reaction_state(
+	const FrameDecisionModel& parent_frame_dec,
+	FastReactionState& frs
+)
+{
+	frs.vPrevious_model_choice_double_value.resize( vDecisionVector.size(), -1.0 );
+	frs.vUnbounded_Previous_model_choice_double_value.resize( vDecisionVector.size(), -1.0 );
+	frs.vAverage_X_deviation.resize( vDecisionVector.size(), 0.0 );
+	frs.vSum_X_deviation.resize( vDecisionVector.size(), 0.0 );
+
+	frs.vCoeffs_a.resize( vDecisionVector.size(), -1.0/5000.0 );
+	for(int i=0; i<(int)frs.vCoeffs_a.size(); i++) {
+		if(vInitialCoeffs_fast_reaction_strategy.at(i) != 0.0)
+			frs.vCoeffs_a[i] = (-1) * vInitialCoeffs_fast_reaction_strategy[i];
+	}
+	
+	frs.current_window_length_X_deviation = 0;
+	frs.current_failure_unidirectional_runlenth = 0;
+	frs.average_continuous_unidirectional_failure_runlength = 0.0;
+	frs.current_number_unidirectional_runs = 0;
+
+	frs.previous_Y = 0.0;
+	frs.halfcycle_start_deflection_sign = (frs.previous_Y <= parent_frame_dec.mean_objective ? -1 : +1);
+	frs.halfcycle_Y_positive_max_deflection = 0.0;
+	frs.halfcycle_Y_negative_max_deflection = 0.0;
+	frs.halfcycle_length = 0;
+	frs.has_halfcycle_crossed_mean = false;
+	frs.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window = 0.0;
+
+	frs.contiguous_onesided_failure_runlength = 0;
+	frs.vDeflectionInX_during_onesided_failure.resize( vDecisionVector.size(), 0.0 );
+	frs.correction_runlength_onesided_failure = 0;
+	frs.correction_vDeflectionInX_during_onesided_failure.resize( vDecisionVector.size(), 0.0 );
+
+	frs.vvvVarChoiceStats.resize( vDecisionVector.size() );
+	for(int i=0; i<(int)frs.vvvVarChoiceStats.size(); i++) { //for each variable
+		frs.vvvVarChoiceStats[i].resize( vVarPriority[i].size(), std::vector<long long int>(vStatWindowBoundaries.size(), 0) );
 	}
 
+	for(int i=0; i<(int)vDecisionVector.size(); i++)
+		frs.vMax_X.push_back( vVarPriority.at(i).size() - 1 );
+
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "fast_reaction_strategy_choice_int_value(): Initializing: vCoeffs_a = " << vector_print_string(frs.vCoeffs_a) << std::endl;
+}
+
+
+std::vector<double> ExecFrameInfo::fast_reaction_strategy_base_choice(
+	FrameInfo * parent_frame_info,
+	FastReactionState& frs
+)
+{
+	FrameDecisionModel& parent_frame_dec = parent_frame_info->decision_model;
+
+	double Y_failure_delta = parent_frame_dec.previous_invocation_exec_time - parent_frame_dec.mean_objective;
+
+	assert(vDecisionVector.size() > 0); //Model must contain atleast one Select model, which can then be controlled to achieve Objective
+	if(frs.vPrevious_model_choice_double_value.size() == 0) //not initialized
+		initialize_fast_reaction_state(parent_frame_dec, frs);
+
 	//half-cycle updates
-	double Y_deflection_since_previous = parent_frame_dec.previous_invocation_exec_time - parent_frame_dec.previous_Y;
+	double Y_deflection_since_previous = parent_frame_dec.previous_invocation_exec_time - frs.previous_Y;
 
 
-	if(parent_frame_dec.has_halfcycle_crossed_mean == true) { //previously crossed mean-objective => true halfcycle
-		assert( (parent_frame_dec.halfcycle_start_deflection_sign == -1 && parent_frame_dec.previous_Y >= parent_frame_dec.mean_objective)
-			|| (parent_frame_dec.halfcycle_start_deflection_sign == +1 && parent_frame_dec.previous_Y <= parent_frame_dec.mean_objective) );
+	if(frs.has_halfcycle_crossed_mean == true) { //previously crossed mean-objective => true halfcycle
+		assert( (frs.halfcycle_start_deflection_sign == -1 && frs.previous_Y >= parent_frame_dec.mean_objective)
+			|| (frs.halfcycle_start_deflection_sign == +1 && frs.previous_Y <= parent_frame_dec.mean_objective) );
 
 		//potentially end true halfcycle
 		if(
-			(parent_frame_dec.halfcycle_start_deflection_sign == -1 && Y_deflection_since_previous < 0.0)
-			|| (parent_frame_dec.halfcycle_start_deflection_sign == +1 && Y_deflection_since_previous > 0.0)
+			(frs.halfcycle_start_deflection_sign == -1 && Y_deflection_since_previous < 0.0)
+			|| (frs.halfcycle_start_deflection_sign == +1 && Y_deflection_since_previous > 0.0)
 		) {
 			//end current true halfcycle
-			assert(parent_frame_dec.halfcycle_length > 0);
-			double magnitude_wrt_sliding_window = (parent_frame_dec.halfcycle_Y_positive_max_deflection - parent_frame_dec.halfcycle_Y_negative_max_deflection)
-														/ (parent_frame_dec.halfcycle_length / (double)parent_frame_dec.sliding_window_size);
+			assert(frs.halfcycle_length > 0);
+			double magnitude_wrt_sliding_window = (frs.halfcycle_Y_positive_max_deflection - frs.halfcycle_Y_negative_max_deflection)
+														/ (frs.halfcycle_length / (double)parent_frame_dec.sliding_window_size);
 
-			parent_frame_dec.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window
-				= parent_frame_dec.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window * deviation_weight_short
+			frs.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window
+				= frs.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window * deviation_weight_short
 					+ magnitude_wrt_sliding_window;
 
 			//start new potential halfcycle
-			parent_frame_dec.halfcycle_start_deflection_sign = (Y_failure_delta > 0.0 ? +1 : -1);
-			parent_frame_dec.halfcycle_Y_positive_max_deflection = (Y_failure_delta >= 0.0 ? Y_failure_delta : 0.0);
-			parent_frame_dec.halfcycle_Y_negative_max_deflection = (Y_failure_delta <= 0.0 ? Y_failure_delta : 0.0);
-			parent_frame_dec.halfcycle_length = 0;
-			parent_frame_dec.has_halfcycle_crossed_mean = false;
+			frs.halfcycle_start_deflection_sign = (Y_failure_delta > 0.0 ? +1 : -1);
+			frs.halfcycle_Y_positive_max_deflection = (Y_failure_delta >= 0.0 ? Y_failure_delta : 0.0);
+			frs.halfcycle_Y_negative_max_deflection = (Y_failure_delta <= 0.0 ? Y_failure_delta : 0.0);
+			frs.halfcycle_length = 0;
+			frs.has_halfcycle_crossed_mean = false;
 		}
 	}
 	else { //halfcycle has not previously crossed mean-objective => not yet a true halfcycle
-		assert( (parent_frame_dec.halfcycle_start_deflection_sign == -1 && parent_frame_dec.previous_Y <= parent_frame_dec.mean_objective)
-			|| (parent_frame_dec.halfcycle_start_deflection_sign == +1 && parent_frame_dec.previous_Y >= parent_frame_dec.mean_objective) );
+		assert( (frs.halfcycle_start_deflection_sign == -1 && frs.previous_Y <= parent_frame_dec.mean_objective)
+			|| (frs.halfcycle_start_deflection_sign == +1 && frs.previous_Y >= parent_frame_dec.mean_objective) );
 
 		if( //check for mean-crossing
-			(parent_frame_dec.halfcycle_start_deflection_sign == -1 && Y_failure_delta > 0.0)
-			|| (parent_frame_dec.halfcycle_start_deflection_sign == +1 && Y_failure_delta < 0.0)
+			(frs.halfcycle_start_deflection_sign == -1 && Y_failure_delta > 0.0)
+			|| (frs.halfcycle_start_deflection_sign == +1 && Y_failure_delta < 0.0)
 		)
-		{ parent_frame_dec.has_halfcycle_crossed_mean = true; }
+		{ frs.has_halfcycle_crossed_mean = true; }
 	}
 
-	if(Y_failure_delta > parent_frame_dec.halfcycle_Y_positive_max_deflection)
-		parent_frame_dec.halfcycle_Y_positive_max_deflection = Y_failure_delta;
-	if(Y_failure_delta < parent_frame_dec.halfcycle_Y_negative_max_deflection)
-		parent_frame_dec.halfcycle_Y_negative_max_deflection = Y_failure_delta;
-	assert(parent_frame_dec.halfcycle_Y_positive_max_deflection >= 0.0);
-	assert(parent_frame_dec.halfcycle_Y_negative_max_deflection <= 0.0);
+	if(Y_failure_delta > frs.halfcycle_Y_positive_max_deflection)
+		frs.halfcycle_Y_positive_max_deflection = Y_failure_delta;
+	if(Y_failure_delta < frs.halfcycle_Y_negative_max_deflection)
+		frs.halfcycle_Y_negative_max_deflection = Y_failure_delta;
+	assert(frs.halfcycle_Y_positive_max_deflection >= 0.0);
+	assert(frs.halfcycle_Y_negative_max_deflection <= 0.0);
 
-	parent_frame_dec.halfcycle_length++;
-	parent_frame_dec.previous_Y = parent_frame_dec.previous_invocation_exec_time;
+	frs.halfcycle_length++;
+	frs.previous_Y = parent_frame_dec.previous_invocation_exec_time;
 
 
-	std::cout << "fast_reaction_strategy_choice_int_value(): Y_failure_delta = " << Y_failure_delta
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "fast_reaction_strategy_choice_int_value(): Y_failure_delta = " << Y_failure_delta
 		<< " Y_deflection_since_previous = " << Y_deflection_since_previous
-		<< " halfcycle_start_deflection_sign = " << parent_frame_dec.halfcycle_start_deflection_sign
-		<< " halfcycle_Y_positive_max_deflection = " << parent_frame_dec.halfcycle_Y_positive_max_deflection
-		<< " halfcycle_Y_negative_max_deflection = " << parent_frame_dec.halfcycle_Y_negative_max_deflection
-		<< " halfcycle_length = " << parent_frame_dec.halfcycle_length
-		<< " has_halfcycle_crossed_mean = " << parent_frame_dec.has_halfcycle_crossed_mean
-		<< " sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window = " << parent_frame_dec.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window
+		<< " halfcycle_start_deflection_sign = " << frs.halfcycle_start_deflection_sign
+		<< " halfcycle_Y_positive_max_deflection = " << frs.halfcycle_Y_positive_max_deflection
+		<< " halfcycle_Y_negative_max_deflection = " << frs.halfcycle_Y_negative_max_deflection
+		<< " halfcycle_length = " << frs.halfcycle_length
+		<< " has_halfcycle_crossed_mean = " << frs.has_halfcycle_crossed_mean
+		<< " sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window = " << frs.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window
 		<< std::endl;
 
 
@@ -528,25 +1069,27 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 	}
 	assert(occured_stat_window_bin >= 0 && occured_stat_window_bin < (int)vStatWindowBoundaries.size());
 
-	for(int i=0; i<(int)parent_frame_dec.vvvVarChoiceStats.size(); i++) { //for each variable
-		int previous_choice = int(parent_frame_dec.vPrevious_model_choice_double_value[i] + 0.5);
+	for(int i=0; i<(int)frs.vvvVarChoiceStats.size(); i++) { //for each variable
+		int previous_choice = int(frs.vPrevious_model_choice_double_value[i] + 0.5);
 		if(previous_choice < 0) //first time
 			continue;
 
-		parent_frame_dec.vvvVarChoiceStats[i].at(previous_choice).at(occured_stat_window_bin)++;
+		frs.vvvVarChoiceStats[i].at(previous_choice).at(occured_stat_window_bin)++;
 	}
 
-	std::cout << " fast_reaction_strategy_choice_int_value(): vvvVarChoiceStats:" << std::endl;
-	for(int i=0; i<(int)parent_frame_dec.vvvVarChoiceStats.size(); i++) { //for each variable
-		std::cout << " X" << i << ":";
-		for(int k=0; k<(int)vStatWindowBoundaries.size(); k++)
-			std::cout << vStatWindowBoundaries[k]*100.0 << "%" << "  ";
-		std::cout << std::endl;
-		for(int j=0; j<(int)parent_frame_dec.vvvVarChoiceStats[i].size(); j++) { //for each choice value of current variable
-			std::cout << "   " << j << ": ";
-			for(int k=0; k<(int)parent_frame_dec.vvvVarChoiceStats[i][j].size(); k++)
-				std::cout << parent_frame_dec.vvvVarChoiceStats[i][j][k] << "    ";
-			std::cout << std::endl;
+	if(debug_message_level >= DebugMsgALL) { //the loops alone cost as much as the decision when not printing
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << " fast_reaction_strategy_choice_int_value(): vvvVarChoiceStats:" << std::endl;
+		for(int i=0; i<(int)frs.vvvVarChoiceStats.size(); i++) { //for each variable
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << " X" << i << ":";
+			for(int k=0; k<(int)vStatWindowBoundaries.size(); k++)
+				OPP_DEBUG_MESSAGE(DebugMsgALL) << vStatWindowBoundaries[k]*100.0 << "%" << "  ";
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << std::endl;
+			for(int j=0; j<(int)frs.vvvVarChoiceStats[i].size(); j++) { //for each choice value of current variable
+				OPP_DEBUG_MESSAGE(DebugMsgALL) << "   " << j << ": ";
+				for(int k=0; k<(int)frs.vvvVarChoiceStats[i][j].size(); k++)
+					OPP_DEBUG_MESSAGE(DebugMsgALL) << frs.vvvVarChoiceStats[i][j][k] << "    ";
+				OPP_DEBUG_MESSAGE(DebugMsgALL) << std::endl;
+			}
 		}
 	}
 
@@ -567,64 +1110,64 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 
 
 	if(bActiveObjectiveSuccess) {
-		std::cout << "fast_reaction_strategy_choice_int_value(): previous SUCCESS: re-use" << std::endl;
-		std::vector<int> vNewDecisionValues;
-		for(int i=0; i<(int)parent_frame_dec.vPrevious_model_choice_double_value.size(); i++) {
-			int new_decision_val;
-			if(parent_frame_dec.vPrevious_model_choice_double_value[i] < 0.0) //first time
-				new_decision_val = 0;
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "fast_reaction_strategy_choice_int_value(): previous SUCCESS: re-use" << std::endl;
+		std::vector<double> vReused_X;
+		for(int i=0; i<(int)frs.vPrevious_model_choice_double_value.size(); i++) {
+			double reused_X;
+			if(frs.vPrevious_model_choice_double_value[i] < 0.0) //first time
+				reused_X = 0.0;
 			else
-				new_decision_val = int(parent_frame_dec.vPrevious_model_choice_double_value[i] + 0.5);
-			vNewDecisionValues.push_back( new_decision_val );
+				reused_X = (double)int(frs.vPrevious_model_choice_double_value[i] + 0.5);
+			vReused_X.push_back( reused_X );
 
 			//Downgrade distortion metrics
 
 			//double X_deviation = 0.0; //since SUCCESS //FIXME: HACK!
-			//parent_frame_dec.vAverage_X_deviation[i] = ( parent_frame_dec.vAverage_X_deviation[i] * (parent_frame_dec.current_window_length_X_deviation - 1)
-			//								+ X_deviation ) / parent_frame_dec.current_window_length_X_deviation;
+			//frs.vAverage_X_deviation[i] = ( frs.vAverage_X_deviation[i] * (frs.current_window_length_X_deviation - 1)
+			//								+ X_deviation ) / frs.current_window_length_X_deviation;
 			
-			//parent_frame_dec.vSum_X_deviation[i] = parent_frame_dec.vSum_X_deviation[i] * deviation_weight + X_deviation;
+			//frs.vSum_X_deviation[i] = frs.vSum_X_deviation[i] * deviation_weight + X_deviation;
 		}
 
-		if(parent_frame_dec.current_failure_unidirectional_runlenth != 0) //this success terminated a run
+		if(frs.current_failure_unidirectional_runlenth != 0) //this success terminated a run
 		{
-			parent_frame_dec.current_number_unidirectional_runs++;
-			parent_frame_dec.average_continuous_unidirectional_failure_runlength =
-				( parent_frame_dec.average_continuous_unidirectional_failure_runlength * (parent_frame_dec.current_number_unidirectional_runs - 1)
-					+ fabs(parent_frame_dec.current_failure_unidirectional_runlenth) ) / parent_frame_dec.current_number_unidirectional_runs;
-			parent_frame_dec.current_failure_unidirectional_runlenth = 0; //success => no start of failure run
+			frs.current_number_unidirectional_runs++;
+			frs.average_continuous_unidirectional_failure_runlength =
+				( frs.average_continuous_unidirectional_failure_runlength * (frs.current_number_unidirectional_runs - 1)
+					+ fabs(frs.current_failure_unidirectional_runlenth) ) / frs.current_number_unidirectional_runs;
+			frs.current_failure_unidirectional_runlenth = 0; //success => no start of failure run
 		}
 
-		parent_frame_dec.correction_runlength_onesided_failure = fabs(parent_frame_dec.contiguous_onesided_failure_runlength);
-		parent_frame_dec.contiguous_onesided_failure_runlength = 0;
-		parent_frame_dec.correction_vDeflectionInX_during_onesided_failure = parent_frame_dec.vDeflectionInX_during_onesided_failure;
-		for(int i=0; i<(int)parent_frame_dec.vDeflectionInX_during_onesided_failure.size(); i++)
-			parent_frame_dec.vDeflectionInX_during_onesided_failure[i] = 0.0;
+		frs.correction_runlength_onesided_failure = fabs(frs.contiguous_onesided_failure_runlength);
+		frs.contiguous_onesided_failure_runlength = 0;
+		frs.correction_vDeflectionInX_during_onesided_failure = frs.vDeflectionInX_during_onesided_failure;
+		for(int i=0; i<(int)frs.vDeflectionInX_during_onesided_failure.size(); i++)
+			frs.vDeflectionInX_during_onesided_failure[i] = 0.0;
 
-		return convert_decision_vector_to_int( vNewDecisionValues );
+		return apply_workload_hint_feedforward(parent_frame_info, frs, vReused_X);
 	}
 
 	//Now: bActiveObjectiveSuccess == false ==> FAILURE
 	
-	parent_frame_dec.current_window_length_X_deviation++;
+	frs.current_window_length_X_deviation++;
 
 	if(
-		(Y_failure_delta > 0.0 && parent_frame_dec.contiguous_onesided_failure_runlength < 0)
-		|| (Y_failure_delta < 0.0 && parent_frame_dec.contiguous_onesided_failure_runlength > 0)
-		|| ( fabs(parent_frame_dec.contiguous_onesided_failure_runlength) >= 2 * parent_frame_dec.sliding_window_size )
+		(Y_failure_delta > 0.0 && frs.contiguous_onesided_failure_runlength < 0)
+		|| (Y_failure_delta < 0.0 && frs.contiguous_onesided_failure_runlength > 0)
+		|| ( fabs(frs.contiguous_onesided_failure_runlength) >= 2 * parent_frame_dec.sliding_window_size )
 	)
 	{
-		parent_frame_dec.correction_runlength_onesided_failure = fabs(parent_frame_dec.contiguous_onesided_failure_runlength);
-		parent_frame_dec.contiguous_onesided_failure_runlength = 0;
-		parent_frame_dec.correction_vDeflectionInX_during_onesided_failure = parent_frame_dec.vDeflectionInX_during_onesided_failure;
-		for(int i=0; i<(int)parent_frame_dec.vDeflectionInX_during_onesided_failure.size(); i++)
-			parent_frame_dec.vDeflectionInX_during_onesided_failure[i] = 0.0;
+		frs.correction_runlength_onesided_failure = fabs(frs.contiguous_onesided_failure_runlength);
+		frs.contiguous_onesided_failure_runlength = 0;
+		frs.correction_vDeflectionInX_during_onesided_failure = frs.vDeflectionInX_during_onesided_failure;
+		for(int i=0; i<(int)frs.vDeflectionInX_during_onesided_failure.size(); i++)
+			frs.vDeflectionInX_during_onesided_failure[i] = 0.0;
 	}
 
 	if(Y_failure_delta >= 0.0)
-		parent_frame_dec.contiguous_onesided_failure_runlength++;
+		frs.contiguous_onesided_failure_runlength++;
 	else
-		parent_frame_dec.contiguous_onesided_failure_runlength--;
+		frs.contiguous_onesided_failure_runlength--;
 		
 
 #if 0
@@ -640,26 +1183,26 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 	
 
 	double a_square = 0.0;
-	for(int i=0; i<(int)parent_frame_dec.vCoeffs_a.size(); i++)
-		a_square += parent_frame_dec.vCoeffs_a[i] * parent_frame_dec.vCoeffs_a[i];
+	for(int i=0; i<(int)frs.vCoeffs_a.size(); i++)
+		a_square += frs.vCoeffs_a[i] * frs.vCoeffs_a[i];
 
 	assert(a_square > 0.0);
 	double t = Y_failure_delta / a_square;
 
-	std::vector<double> vNew_X(parent_frame_dec.vPrevious_model_choice_double_value.size(), 0.0);
+	std::vector<double> vNew_X(frs.vPrevious_model_choice_double_value.size(), 0.0);
 	for(int i=0; i<(int)vNew_X.size(); i++) {
-		if(parent_frame_dec.vPrevious_model_choice_double_value[i] < 0.0) //first time
+		if(frs.vPrevious_model_choice_double_value[i] < 0.0) //first time
 			vNew_X[i] = 0.0; //start with most complex
 		else {
-			vNew_X[i] = parent_frame_dec.vPrevious_model_choice_double_value[i] - parent_frame_dec.vCoeffs_a[i] * t;
+			vNew_X[i] = frs.vPrevious_model_choice_double_value[i] - frs.vCoeffs_a[i] * t;
 
-			double X_deviation = fabs(vNew_X[i] - parent_frame_dec.vPrevious_model_choice_double_value[i]);
-			parent_frame_dec.vAverage_X_deviation[i] = ( parent_frame_dec.vAverage_X_deviation[i] * (parent_frame_dec.current_window_length_X_deviation - 1)
-											+ X_deviation ) / parent_frame_dec.current_window_length_X_deviation;
+			double X_deviation = fabs(vNew_X[i] - frs.vPrevious_model_choice_double_value[i]);
+			frs.vAverage_X_deviation[i] = ( frs.vAverage_X_deviation[i] * (frs.current_window_length_X_deviation - 1)
+											+ X_deviation ) / frs.current_window_length_X_deviation;
 			
-			parent_frame_dec.vSum_X_deviation[i] = parent_frame_dec.vSum_X_deviation[i] * deviation_weight + X_deviation;
+			frs.vSum_X_deviation[i] = frs.vSum_X_deviation[i] * deviation_weight + X_deviation;
 
-			parent_frame_dec.vDeflectionInX_during_onesided_failure[i] += X_deviation;
+			frs.vDeflectionInX_during_onesided_failure[i] += X_deviation;
 		}
 	}
 #else
@@ -671,20 +1214,20 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 	//
 	// dx1 = 1/a1 * dy, dx2 = 1/a2 * dy, ... dxn = 1/an * dy
 
-	std::vector<double> vNew_X(parent_frame_dec.vPrevious_model_choice_double_value.size(), 0.0);
+	std::vector<double> vNew_X(frs.vPrevious_model_choice_double_value.size(), 0.0);
 	for(int i=0; i<(int)vNew_X.size(); i++) {
-		if(parent_frame_dec.vPrevious_model_choice_double_value[i] < 0.0) //first time
+		if(frs.vPrevious_model_choice_double_value[i] < 0.0) //first time
 			vNew_X[i] = 0.0; //start with most complex
 		else {
-			vNew_X[i] = parent_frame_dec.vPrevious_model_choice_double_value[i] - 1.0 / parent_frame_dec.vCoeffs_a[i] * Y_failure_delta;
+			vNew_X[i] = frs.vPrevious_model_choice_double_value[i] - 1.0 / frs.vCoeffs_a[i] * Y_failure_delta;
 
-			double X_deviation = fabs(vNew_X[i] - parent_frame_dec.vPrevious_model_choice_double_value[i]);
-			parent_frame_dec.vAverage_X_deviation[i] = ( parent_frame_dec.vAverage_X_deviation[i] * (parent_frame_dec.current_window_length_X_deviation - 1)
-											+ X_deviation ) / parent_frame_dec.current_window_length_X_deviation;
+			double X_deviation = fabs(vNew_X[i] - frs.vPrevious_model_choice_double_value[i]);
+			frs.vAverage_X_deviation[i] = ( frs.vAverage_X_deviation[i] * (frs.current_window_length_X_deviation - 1)
+											+ X_deviation ) / frs.current_window_length_X_deviation;
 			
-			parent_frame_dec.vSum_X_deviation[i] = parent_frame_dec.vSum_X_deviation[i] * deviation_weight + X_deviation;
+			frs.vSum_X_deviation[i] = frs.vSum_X_deviation[i] * deviation_weight + X_deviation;
 
-			parent_frame_dec.vDeflectionInX_during_onesided_failure[i] += X_deviation;
+			frs.vDeflectionInX_during_onesided_failure[i] += X_deviation;
 		}
 	}
 	
@@ -698,17 +1241,15 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 			vNew_X_bounded[i] = vVarPriority[i].size() - 1;
 	}
 
-	std::vector<int> vNewDecisionValues;
-	for(int i=0; i<(int)vNew_X_bounded.size(); i++)
-		vNewDecisionValues.push_back( int(vNew_X_bounded[i] + 0.5) );
+	std::vector<double> vNew_X_corrected = apply_workload_hint_feedforward(parent_frame_info, frs, vNew_X_bounded);
 
 	
 	std::vector<bool> vX_StuckAtBoundary(vNew_X.size(), false);
 		//indicates for each variable whether it has already exceeded a bound previously, and continues to be stuck at bound this time
 	for(int i=0; i<(int)vNew_X.size(); i++) {
 		if(
-			(parent_frame_dec.vUnbounded_Previous_model_choice_double_value[i] < 0.0 && vNew_X[i] < 0.0)           //stuck below lower bound
-			|| (parent_frame_dec.vUnbounded_Previous_model_choice_double_value[i] > vVarPriority.at(i).size() - 1
+			(frs.vUnbounded_Previous_model_choice_double_value[i] < 0.0 && vNew_X[i] < 0.0)           //stuck below lower bound
+			|| (frs.vUnbounded_Previous_model_choice_double_value[i] > vVarPriority.at(i).size() - 1
 					&& vNew_X[i] > vVarPriority.at(i).size() - 1)                                                  //stuck above upper bound
 		)
 		{ vX_StuckAtBoundary[i] = true; }
@@ -719,64 +1260,64 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 		bAll_X_StuckAtBoundary = bAll_X_StuckAtBoundary && vX_StuckAtBoundary[i];
 
 	if(bAll_X_StuckAtBoundary == false) {
-		if(Y_failure_delta > 0 && parent_frame_dec.current_failure_unidirectional_runlenth >= 0) //+ve add to run-magnitude
-			parent_frame_dec.current_failure_unidirectional_runlenth++;
-		else if(Y_failure_delta < 0 && parent_frame_dec.current_failure_unidirectional_runlenth <= 0) //-ve add to run-magnitude
-			parent_frame_dec.current_failure_unidirectional_runlenth--;
+		if(Y_failure_delta > 0 && frs.current_failure_unidirectional_runlenth >= 0) //+ve add to run-magnitude
+			frs.current_failure_unidirectional_runlenth++;
+		else if(Y_failure_delta < 0 && frs.current_failure_unidirectional_runlenth <= 0) //-ve add to run-magnitude
+			frs.current_failure_unidirectional_runlenth--;
 		else //current_failure_unidirectional_runlenth != 0 and of opposite sign to Y_failure_delta => end of previous run, start of new run
 		{
-			parent_frame_dec.current_number_unidirectional_runs++;
-			parent_frame_dec.average_continuous_unidirectional_failure_runlength =
-				( parent_frame_dec.average_continuous_unidirectional_failure_runlength * (parent_frame_dec.current_number_unidirectional_runs - 1)
-					+ fabs(parent_frame_dec.current_failure_unidirectional_runlenth) ) / parent_frame_dec.current_number_unidirectional_runs;
-			parent_frame_dec.current_failure_unidirectional_runlenth = 1; //since this failure was first leg of run in opposite direction
+			frs.current_number_unidirectional_runs++;
+			frs.average_continuous_unidirectional_failure_runlength =
+				( frs.average_continuous_unidirectional_failure_runlength * (frs.current_number_unidirectional_runs - 1)
+					+ fabs(frs.current_failure_unidirectional_runlenth) ) / frs.current_number_unidirectional_runs;
+			frs.current_failure_unidirectional_runlenth = 1; //since this failure was first leg of run in opposite direction
 		}
 	}
 	else //bAll_X_StuckAtBoundary == true, Range Saturation occured for all variables
 	{
-		if(parent_frame_dec.current_failure_unidirectional_runlenth != 0) { //a run was on previously
-			parent_frame_dec.current_number_unidirectional_runs++;
-			parent_frame_dec.average_continuous_unidirectional_failure_runlength =
-				( parent_frame_dec.average_continuous_unidirectional_failure_runlength * (parent_frame_dec.current_number_unidirectional_runs - 1)
-					+ fabs(parent_frame_dec.current_failure_unidirectional_runlenth) ) / parent_frame_dec.current_number_unidirectional_runs;
-			parent_frame_dec.current_failure_unidirectional_runlenth = 0; //since still saturated, this failure makes no contribution to a run
+		if(frs.current_failure_unidirectional_runlenth != 0) { //a run was on previously
+			frs.current_number_unidirectional_runs++;
+			frs.average_continuous_unidirectional_failure_runlength =
+				( frs.average_continuous_unidirectional_failure_runlength * (frs.current_number_unidirectional_runs - 1)
+					+ fabs(frs.current_failure_unidirectional_runlenth) ) / frs.current_number_unidirectional_runs;
+			frs.current_failure_unidirectional_runlenth = 0; //since still saturated, this failure makes no contribution to a run
 		}
 	}
 
 	
 
-	std::cout << "fast_reaction_strategy_choice_int_value(): previous FAILURE: Y_failure_delta = " << Y_failure_delta
-			<< " vPrevious_model_choice_double_value = " << vector_print_string(parent_frame_dec.vPrevious_model_choice_double_value)
-			<< " vNew_X = " << vector_print_string(vNew_X) << " vNewDecisionValues = " << vector_print_string(vNewDecisionValues)
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "fast_reaction_strategy_choice_int_value(): previous FAILURE: Y_failure_delta = " << Y_failure_delta
+			<< " vPrevious_model_choice_double_value = " << vector_print_string(frs.vPrevious_model_choice_double_value)
+			<< " vNew_X = " << vector_print_string(vNew_X) << " vNew_X_corrected = " << vector_print_string(vNew_X_corrected)
 			<< std::endl
-			<< "fast_reaction_strategy_choice_int_value(): vAverage_X_deviation = " << vector_print_string(parent_frame_dec.vAverage_X_deviation)
-			<< " vSum_X_deviation = " << vector_print_string(parent_frame_dec.vSum_X_deviation)
-			<< " current_window_length_X_deviation = " << parent_frame_dec.current_window_length_X_deviation
+			<< "fast_reaction_strategy_choice_int_value(): vAverage_X_deviation = " << vector_print_string(frs.vAverage_X_deviation)
+			<< " vSum_X_deviation = " << vector_print_string(frs.vSum_X_deviation)
+			<< " current_window_length_X_deviation = " << frs.current_window_length_X_deviation
 			<< std::endl
-			<< " fast_reaction_strategy_choice_int_value(): average_continuous_unidirectional_failure_runlength = " << parent_frame_dec.average_continuous_unidirectional_failure_runlength
-			<< " current_failure_unidirectional_runlenth = " << parent_frame_dec.current_failure_unidirectional_runlenth
-			<< " current_number_unidirectional_runs = " << parent_frame_dec.current_number_unidirectional_runs
+			<< " fast_reaction_strategy_choice_int_value(): average_continuous_unidirectional_failure_runlength = " << frs.average_continuous_unidirectional_failure_runlength
+			<< " current_failure_unidirectional_runlenth = " << frs.current_failure_unidirectional_runlenth
+			<< " current_number_unidirectional_runs = " << frs.current_number_unidirectional_runs
 			<< std::endl;
 
-	std::cout << "fast_reaction_strategy_choice_int_value(): contiguous_onesided_failure_runlength = " << parent_frame_dec.contiguous_onesided_failure_runlength
-			<< " vDeflectionInX_during_onesided_failure = " << vector_print_string(parent_frame_dec.vDeflectionInX_during_onesided_failure)
-			<< " correction_runlength_onesided_failure = " << parent_frame_dec.correction_runlength_onesided_failure
-			<< " correction_vDeflectionInX_during_onesided_failure = " << vector_print_string(parent_frame_dec.correction_vDeflectionInX_during_onesided_failure)
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "fast_reaction_strategy_choice_int_value(): contiguous_onesided_failure_runlength = " << frs.contiguous_onesided_failure_runlength
+			<< " vDeflectionInX_during_onesided_failure = " << vector_print_string(frs.vDeflectionInX_during_onesided_failure)
+			<< " correction_runlength_onesided_failure = " << frs.correction_runlength_onesided_failure
+			<< " correction_vDeflectionInX_during_onesided_failure = " << vector_print_string(frs.correction_vDeflectionInX_during_onesided_failure)
 			<< std::endl;
 
 
 	//Update System-Model Parameters, if needed
-	std::vector<double> vRescale_X_factors( parent_frame_dec.vPrevious_model_choice_double_value.size(), 0.0 );
+	std::vector<double> vRescale_X_factors( frs.vPrevious_model_choice_double_value.size(), 0.0 );
 	std::string rescale_cause = "";
-	for(int i=0; i<(int)parent_frame_dec.vSum_X_deviation.size(); i++) { //RESCALING for RANGE PRECISION
-		//if(parent_frame_dec.vSum_X_deviation[i] > deviation_geometric_convergence * vVarPriority.at(i).size()) //excessive deviation accumulated
-		if(parent_frame_dec.vSum_X_deviation[i] > deviation_geometric_convergence * 1.0) //excessive deviation accumulated
+	for(int i=0; i<(int)frs.vSum_X_deviation.size(); i++) { //RESCALING for RANGE PRECISION
+		//if(frs.vSum_X_deviation[i] > deviation_geometric_convergence * vVarPriority.at(i).size()) //excessive deviation accumulated
+		if(frs.vSum_X_deviation[i] > deviation_geometric_convergence * 1.0) //excessive deviation accumulated
 		{
 			double rescale_factor = 0.0;
-			//if(parent_frame_dec.vAverage_X_deviation[i] >= vVarPriority.at(i).size()) //variation is end-to-end, variations saturate range => reduce variation in X
-			if(parent_frame_dec.vAverage_X_deviation[i] >= 1.0) //variation is end-to-end, variations saturate range => reduce variation in X
+			//if(frs.vAverage_X_deviation[i] >= vVarPriority.at(i).size()) //variation is end-to-end, variations saturate range => reduce variation in X
+			if(frs.vAverage_X_deviation[i] >= 1.0) //variation is end-to-end, variations saturate range => reduce variation in X
 			{
-				rescale_factor = parent_frame_dec.vAverage_X_deviation[i];
+				rescale_factor = frs.vAverage_X_deviation[i];
 					//reduce average variation down to size of 1.0
 			}
 			//else: deviation is accumuluting due to continuous recent failures, but failures are not due to incorrect range scaling
@@ -790,20 +1331,20 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 
 #if 0
 	if(overall_rescale_factor == 0.0) { //RESCALING for RESPONSIVENESS
-		if(parent_frame_dec.average_continuous_unidirectional_failure_runlength >= 2.0) {
-			overall_rescale_factor = 1.0 / parent_frame_dec.average_continuous_unidirectional_failure_runlength;
+		if(frs.average_continuous_unidirectional_failure_runlength >= 2.0) {
+			overall_rescale_factor = 1.0 / frs.average_continuous_unidirectional_failure_runlength;
 		}
 		overall_rescale_factor = 0.0; //FIXME: HACK!
 	}
 #endif
 	if(rescale_cause == "") { //RESCALING for RESPONSIVENESS
-		if(parent_frame_dec.correction_runlength_onesided_failure > parent_frame_dec.sliding_window_size) {
-			double num_failure_sliding_windows = parent_frame_dec.correction_runlength_onesided_failure / parent_frame_dec.sliding_window_size;
+		if(frs.correction_runlength_onesided_failure > parent_frame_dec.sliding_window_size) {
+			double num_failure_sliding_windows = frs.correction_runlength_onesided_failure / parent_frame_dec.sliding_window_size;
 
 			double min_rescale_factor = 0.0;
 			int min_rescale_var_pos = -1;
-			for(int i=0; i<(int)parent_frame_dec.correction_vDeflectionInX_during_onesided_failure.size(); i++) {
-				double X_distortion_per_sliding_window = parent_frame_dec.correction_vDeflectionInX_during_onesided_failure[i] / num_failure_sliding_windows;
+			for(int i=0; i<(int)frs.correction_vDeflectionInX_during_onesided_failure.size(); i++) {
+				double X_distortion_per_sliding_window = frs.correction_vDeflectionInX_during_onesided_failure[i] / num_failure_sliding_windows;
 				double local_rescale_factor = 0.0;
 				if(X_distortion_per_sliding_window < 1.0)
 					local_rescale_factor = X_distortion_per_sliding_window / 1.0;
@@ -819,7 +1360,7 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 				vRescale_X_factors.at(min_rescale_var_pos) = min_rescale_factor;
 				rescale_cause = "RESPONSIVENESS";
 			}
-			//overall_rescale_factor = parent_frame_dec.sliding_window_size / (double)parent_frame_dec.correction_runlength_onesided_failure;
+			//overall_rescale_factor = parent_frame_dec.sliding_window_size / (double)frs.correction_runlength_onesided_failure;
 		}
 	}
 
@@ -827,14 +1368,14 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 		double objective_window_height = parent_frame_dec.mean_objective * (parent_frame_dec.window_frac_lower + parent_frame_dec.window_frac_upper);
 		double threshold = deviation_geometric_convergence_short * objective_window_height * 1.0;
 		double rescale_factor = 0.0;
-		if(parent_frame_dec.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window > threshold) 
-		{ rescale_factor = parent_frame_dec.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window / threshold; }
+		if(frs.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window > threshold) 
+		{ rescale_factor = frs.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window / threshold; }
 		if(rescale_factor < 1.2)
 			rescale_factor = 0.0;
 
 		if(rescale_factor != 0.0) {
 			vRescale_X_factors.clear();
-			vRescale_X_factors.resize( parent_frame_dec.vPrevious_model_choice_double_value.size(), rescale_factor );
+			vRescale_X_factors.resize( frs.vPrevious_model_choice_double_value.size(), rescale_factor );
 			rescale_cause = "CONTROL-LAG";
 		}
 	}
@@ -843,57 +1384,421 @@ int ExecFrameInfo::fast_reaction_strategy_choice_int_value() {
 		rescale_cause = "";
 
 	if(
-		((rescale_cause == "RANGE-PRECISION" || rescale_cause == "CONTROL-LAG") && parent_frame_dec.current_window_length_X_deviation < parent_frame_dec.sliding_window_size) //RANGE PRECISION or CONTROL-LAG
-		//|| (overall_rescale_factor < 1.0 && parent_frame_dec.current_number_unidirectional_runs < parent_frame_dec.sliding_window_size) //RESPONSIVENESS
+		((rescale_cause == "RANGE-PRECISION" || rescale_cause == "CONTROL-LAG") && frs.current_window_length_X_deviation < parent_frame_dec.sliding_window_size) //RANGE PRECISION or CONTROL-LAG
+		//|| (overall_rescale_factor < 1.0 && frs.current_number_unidirectional_runs < parent_frame_dec.sliding_window_size) //RESPONSIVENESS
 	) //wait for atleast one period before considering rescaling => o.w., a single outlier behavior can mess up estimation of rescaling parameters
 	{
 		vRescale_X_factors.clear();
-		vRescale_X_factors.resize( parent_frame_dec.vPrevious_model_choice_double_value.size(), 0.0 );
+		vRescale_X_factors.resize( frs.vPrevious_model_choice_double_value.size(), 0.0 );
 		rescale_cause = "";
 	}
 
 	if(rescale_cause != "") {
-		for(int i=0; i<(int)parent_frame_dec.vCoeffs_a.size(); i++) {
+		for(int i=0; i<(int)frs.vCoeffs_a.size(); i++) {
 			if(vRescale_X_factors[i] != 0.0)
-				parent_frame_dec.vCoeffs_a[i] *= vRescale_X_factors[i];
-			parent_frame_dec.vAverage_X_deviation[i] = 0.0;
-			parent_frame_dec.vSum_X_deviation[i] = 0.0;
+				frs.vCoeffs_a[i] *= vRescale_X_factors[i];
+		}
+		frs.restart_rescaling_statistics(parent_frame_dec.mean_objective); //previous_Y == previous_invocation_exec_time
+
+		OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "fast_reaction_strategy_choice_int_value: RESCALING vCoeffs_a by vRescale_X_factors = " << vector_print_string(vRescale_X_factors)
+			<< " for " << rescale_cause << "  NEW vCoeffs_a = " << vector_print_string(frs.vCoeffs_a)
+			<< std::endl;
+	}
+
+	for(int i=0; i<(int)frs.vPrevious_model_choice_double_value.size(); i++) {
+		frs.vPrevious_model_choice_double_value[i] = vNew_X_bounded[i];
+		frs.vUnbounded_Previous_model_choice_double_value[i] = vNew_X[i];
+	}
+
+	return vNew_X_corrected;
+}
+
+
+std::vector<double> ExecFrameInfo::apply_workload_hint_feedforward(
+	FrameInfo * parent_frame_info,
+	FastReactionState& frs,
+	const std::vector<double>& vBase_X
+)
+{
+	std::vector<double> vX = vBase_X;
+	if(bWorkloadHintFeedforward && parent_frame_info->vWorkload_hints.size() > 0) {
+		//Feed-forward is transient: vPrevious_model_choice_double_value continues to track the feedback choice,
+		//  so that the correction is undone once the hints return to their nominal values.
+		ExecTime_t Y_feedforward_delta = frs.workload_hint_regression.predict_deviation_from_nominal(
+											parent_frame_info->vWorkload_hints, vBase_X);
+		if(Y_feedforward_delta != 0.0) {
+			for(int i=0; i<(int)vX.size(); i++) {
+				vX[i] = vBase_X[i] - 1.0 / frs.vCoeffs_a.at(i) * Y_feedforward_delta;
+				if(vX[i] < 0.0)
+					vX[i] = 0.0;
+				if(vX[i] > (int)vVarPriority.at(i).size() - 1)
+					vX[i] = vVarPriority[i].size() - 1;
+			}
+
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << "fast_reaction_strategy_choice_int_value(): FEED-FORWARD: Y_feedforward_delta = " << Y_feedforward_delta
+				<< " for vWorkload_hints = " << vector_print_string(parent_frame_info->vWorkload_hints)
+				<< " vBase_X = " << vector_print_string(vBase_X) << " corrected vX = " << vector_print_string(vX)
+				<< std::endl;
+		}
+	}
+
+	return vX;
+}
+
+
+//debug control
+bool bIntraFrameSlackReclaiming = true;
+
+void feature_control_intra_frame_slack_reclaiming(bool new_setting) {
+	bIntraFrameSlackReclaiming = new_setting;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: bIntraFrameSlackReclaiming = " << bIntraFrameSlackReclaiming << std::endl;
+}
+
+bool feature_query_intra_frame_slack_reclaiming() {
+	return bIntraFrameSlackReclaiming;
+}
+
+
+const int max_tracked_runs_per_invocation = 1024;
+	//runs of an ExecFrame beyond these many within one invocation of the parent are not corrected
+const long long int min_samples_expected_elapsed = 3;
+	//invocations of parent needed before the expected elapsed time at a run is trusted
+const double expected_elapsed_rate = 0.1;
+	//EWMA rate for learning the expected elapsed time at a run (after the first 1/rate samples)
+
+std::vector<double> ExecFrameInfo::apply_intra_frame_slack_reclaiming(
+	FrameInfo * parent_frame_info,
+	FastReactionState& frs,
+	const std::vector<double>& vBase_X
+)
+{
+	FrameDecisionModel& parent_frame_dec = parent_frame_info->decision_model;
+
+	int run_index = frs.current_invocation_run_index;
+	if(run_index >= max_tracked_runs_per_invocation)
+		return vBase_X;
+
+	if(run_index >= (int)frs.vExpected_elapsed_at_run.size()) {
+		frs.vExpected_elapsed_at_run.resize(run_index + 1, 0.0);
+		frs.vExpected_elapsed_at_run_sample_count.resize(run_index + 1, 0);
+	}
+
+	ExecTime_t elapsed = parent_frame_info->get_elapsed_exec_time_of_current_invocation();
+	ExecTime_t& expected_elapsed = frs.vExpected_elapsed_at_run[run_index];
+	long long int& sample_count = frs.vExpected_elapsed_at_run_sample_count[run_index];
+
+	std::vector<double> vX = vBase_X;
+	if(bIntraFrameSlackReclaiming && sample_count >= min_samples_expected_elapsed) {
+		//Time spent by the parent so far in excess of what is usual at this point must be made up by this run
+		//  (and vice versa for time saved), since the choices in vBase_X assume a usual invocation.
+		ExecTime_t Y_slack_delta = parent_frame_dec.impact_rescaler(elapsed) - parent_frame_dec.impact_rescaler(expected_elapsed);
+		for(int i=0; i<(int)vX.size(); i++) {
+			vX[i] = vBase_X[i] - 1.0 / frs.vCoeffs_a.at(i) * Y_slack_delta;
+			if(vX[i] < 0.0)
+				vX[i] = 0.0;
+			if(vX[i] > (int)vVarPriority.at(i).size() - 1)
+				vX[i] = vVarPriority[i].size() - 1;
+		}
+
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "fast_reaction_strategy_choice_int_value(): INTRA-FRAME: run_index = " << run_index
+			<< " elapsed = " << elapsed << " expected_elapsed = " << expected_elapsed << " Y_slack_delta = " << Y_slack_delta
+			<< " vBase_X = " << vector_print_string(vBase_X) << " corrected vX = " << vector_print_string(vX)
+			<< std::endl;
+	}
+
+	sample_count++;
+	double rate = 1.0 / sample_count;
+	if(rate < expected_elapsed_rate)
+		rate = expected_elapsed_rate;
+	expected_elapsed += rate * (elapsed - expected_elapsed);
+
+	return vX;
+}
+
+
+DecisionKey_t ExecFrameInfo::thompson_sampling_strategy_choice_int_value() {
+	assert(curr_parent_frame != 0);
+
+	//Decision Strategy optimizes only for achieving the immediate parent's objective.
+
+	FrameInfo * parent_frame_info = FrameInfo::get_frame_info(curr_parent_frame);
+	FrameDecisionModel& parent_frame_dec = parent_frame_info->decision_model;
+
+	if(parent_frame_dec.bHasMeanObjectiveDefined == false && parent_frame_dec.bHasQualityFloorObjective == false) {
+		std::vector<int> highest_po_dec_vec = get_nearest_valid_decision_vector( get_highest_priority_order_decision_vector() );
+		return convert_decision_vector_to_int(highest_po_dec_vec);
+	}
+
+	Parameter * ptr_decision_vector_parameter = &(decision_model.decision_vector_parameter);
+	assert(parent_frame_dec.map_parm_to_thompson_model.count(ptr_decision_vector_parameter) > 0);
+	ThompsonSamplingModel * thompson_model = parent_frame_dec.map_parm_to_thompson_model[ptr_decision_vector_parameter];
+
+	//all decisions within one invocation of the parent share the context in which the invocation started
+	if(thompson_model->active_context_bin == -1) {
+		if(parent_frame_dec.bHasQualityFloorObjective)
+			thompson_model->active_context_bin = ThompsonSamplingModel::quality_floor_context_bin;
+		else
+			thompson_model->active_context_bin = ThompsonSamplingModel::get_context_bin(
+					parent_frame_dec.previous_invocation_exec_time, parent_frame_dec.mean_objective,
+					parent_frame_dec.window_frac_lower, parent_frame_dec.window_frac_upper );
+	}
+	int context_bin = thompson_model->active_context_bin;
+
+	DecisionKey_t curr_dec_vec_int_val = -1;
+	if(get_num_decision_vectors() > max_enumerated_decision_vectors) {
+		curr_dec_vec_int_val = thompson_sampling_factored_search_int_value(thompson_model, context_bin, parent_frame_dec);
+	}
+	else {
+		std::vector< std::pair<double, DecisionKey_t> > vReward_DecisionInt;
+		const std::vector<DecisionKey_t>& vValid_keys = get_valid_decision_keys();
+		for(int k=0; k<(int)vValid_keys.size(); k++) {
+			DecisionKey_t dec_vec_int_val = vValid_keys[k];
+			double theta = thompson_model->sample_success_probability(context_bin, dec_vec_int_val);
+			double feature_level = get_feature_level( convert_int_to_decision_vector(dec_vec_int_val) );
+			double reward = 0.0;
+			if(parent_frame_dec.bHasQualityFloorObjective) {
+				double cost_level = thompson_model->get_expected_cost_level(dec_vec_int_val, feature_level);
+				reward = ThompsonSamplingModel::quality_floor_reward(theta, parent_frame_dec.quality_floor_prob, cost_level);
+			}
+			else {
+				if(bQualityFeedback)
+					feature_level = thompson_model->get_expected_quality_level(dec_vec_int_val, feature_level);
+				reward = theta * feature_level - (1.0 - theta) * ThompsonSamplingModel::miss_penalty;
+			}
+			vReward_DecisionInt.push_back( std::make_pair(reward, dec_vec_int_val) );
 		}
-		parent_frame_dec.current_window_length_X_deviation = 0;
-
-		parent_frame_dec.current_failure_unidirectional_runlenth = 0;
-		parent_frame_dec.average_continuous_unidirectional_failure_runlength = 0.0;
-		parent_frame_dec.current_number_unidirectional_runs = 0;
-
-		parent_frame_dec.halfcycle_start_deflection_sign = (parent_frame_dec.previous_invocation_exec_time <= parent_frame_dec.mean_objective ? -1 : +1);
-		parent_frame_dec.halfcycle_Y_positive_max_deflection = 0.0;
-		parent_frame_dec.halfcycle_Y_negative_max_deflection = 0.0;
-		parent_frame_dec.halfcycle_length = 0;
-		parent_frame_dec.has_halfcycle_crossed_mean = false;
-		parent_frame_dec.sum_of_weighted_quantity_of_halfcycles_completed_per_sliding_window = 0.0;
-
-		parent_frame_dec.contiguous_onesided_failure_runlength = 0;
-		for(int i=0; i<(int)parent_frame_dec.vDeflectionInX_during_onesided_failure.size(); i++)
-			parent_frame_dec.vDeflectionInX_during_onesided_failure[i] = 0.0;
-		parent_frame_dec.correction_runlength_onesided_failure = 0;
-		for(int i=0; i<(int)parent_frame_dec.correction_vDeflectionInX_during_onesided_failure.size(); i++)
-			parent_frame_dec.correction_vDeflectionInX_during_onesided_failure[i] = 0.0;
-
-		std::cout << "fast_reaction_strategy_choice_int_value: RESCALING vCoeffs_a by vRescale_X_factors = " << vector_print_string(vRescale_X_factors)
-			<< " for " << rescale_cause << "  NEW vCoeffs_a = " << vector_print_string(parent_frame_dec.vCoeffs_a)
+
+		//Sort vReward_DecisionInt in descending order of sampled reward
+		std::sort(vReward_DecisionInt.begin(), vReward_DecisionInt.end(), sort_helper_vReward_DecisionKey);
+
+		int chosen_index = 0;
+		if(probability_of_exploration > 0.0) { //debug control: probabilitic exploration
+			while(chosen_index < (int)vReward_DecisionInt.size() && probability_of_exploration > random_uniform()) {
+				OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrame #" << my_execframe->id << ": Probabilistic Exploration forced past workable "
+					<< "curr_dec_vec_int_val = " << vReward_DecisionInt[chosen_index].second << std::endl;
+				chosen_index++;
+			}
+			if(chosen_index == (int)vReward_DecisionInt.size()) //everything skipped, use the first value skipped
+				chosen_index = 0;
+		}
+
+		curr_dec_vec_int_val = vReward_DecisionInt.at(chosen_index).second;
+
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "thompson_sampling_strategy_choice_int_value(): context_bin = " << context_bin
+			<< " chosen curr_dec_vec_int_val = " << curr_dec_vec_int_val
+			<< " with sampled reward = " << vReward_DecisionInt[chosen_index].first
+			<< " (best sampled reward = " << vReward_DecisionInt[0].first << " for " << vReward_DecisionInt[0].second << ")"
 			<< std::endl;
 	}
 
-	for(int i=0; i<(int)parent_frame_dec.vPrevious_model_choice_double_value.size(); i++) {
-		parent_frame_dec.vPrevious_model_choice_double_value[i] = vNew_X_bounded[i];
-		parent_frame_dec.vUnbounded_Previous_model_choice_double_value[i] = vNew_X[i];
+	stickiness_runlength_remaining = 0;
+	if(thompson_model->get_observation_count(context_bin, curr_dec_vec_int_val) < my_execframe->stickiness_length) {
+		stickiness_runlength_remaining = my_execframe->stickiness_length;
+		sticky_decision_vector_int_val = curr_dec_vec_int_val;
+	}
+
+	return curr_dec_vec_int_val;
+}
+
+	// Sampled Thompson reward of a decision-vector from per-variable posteriors: theta is the geometric mean
+	//   of the sampled thetas of the decision-vector's values, feature level the mean of their levels
+	//   (for a quality floor objective, the mean of their cost levels).
+class FactoredThompsonRewardProblem : public DecisionSearchProblem {
+public:
+	const ExecFrameInfo * execframe_info;
+		//decision-vectors invalid under its active Constraints are penalized out of consideration
+
+	bool bQualityFloor;
+	double quality_floor_prob; //defined iff bQualityFloor
+
+	std::vector< std::vector<double> > vvLogTheta;
+	std::vector< std::vector<double> > vvFeatureLevel;
+		//indexed by [decision-variable index][value]; cost levels if bQualityFloor
+
+	int get_num_variables() const
+		{ return (int)vvLogTheta.size(); }
+
+	int get_num_values(int variable_index) const
+		{ return (int)vvLogTheta.at(variable_index).size(); }
+
+	double score(const std::vector<int>& dec_vec) const {
+		double sum_log_theta = 0.0;
+		double sum_level = 0.0;
+		for(int i=0; i<(int)dec_vec.size(); i++) {
+			sum_log_theta += vvLogTheta[i][ dec_vec[i] ];
+			sum_level += vvFeatureLevel[i][ dec_vec[i] ];
+		}
+		double theta = exp(sum_log_theta / dec_vec.size());
+		double feature_level = sum_level / dec_vec.size();
+		double reward = bQualityFloor
+			? ThompsonSamplingModel::quality_floor_reward(theta, quality_floor_prob, feature_level)
+			: theta * feature_level - (1.0 - theta) * ThompsonSamplingModel::miss_penalty;
+		if(execframe_info->is_valid_decision_vector(dec_vec) == false)
+			reward -= NearestValidDecisionProblem::invalid_penalty;
+		return reward;
+	}
+};
+
+DecisionKey_t ExecFrameInfo::thompson_sampling_factored_search_int_value(
+	ThompsonSamplingModel * thompson_model,
+	int context_bin,
+	const FrameDecisionModel& parent_frame_dec
+)
+{
+	int num_variables = (int)vVarPriority.size();
+	assert(num_variables > 0);
+
+	if(thompson_model->is_factorized() == false) {
+		std::vector<int> vNum_values;
+		for(int i=0; i<num_variables; i++)
+			vNum_values.push_back( (int)vVarPriority[i].size() );
+		thompson_model->initialize_factorization(vNum_values);
+	}
+
+	FactoredThompsonRewardProblem problem;
+	problem.execframe_info = this;
+	problem.bQualityFloor = parent_frame_dec.bHasQualityFloorObjective;
+	problem.quality_floor_prob = parent_frame_dec.quality_floor_prob;
+	problem.vvLogTheta.resize(num_variables);
+	problem.vvFeatureLevel.resize(num_variables);
+	for(int i=0; i<num_variables; i++) {
+		for(int v=0; v<(int)vVarPriority[i].size(); v++) {
+			double theta = thompson_model->sample_variable_success_probability(context_bin, i, v);
+			problem.vvLogTheta[i].push_back( log(std::max(theta, 1e-300)) );
+			double variable_feature_level = get_variable_feature_level(i, v);
+			if(problem.bQualityFloor)
+				variable_feature_level = thompson_model->get_expected_variable_cost_level(i, v, variable_feature_level);
+			else if(bQualityFeedback)
+				variable_feature_level = thompson_model->get_expected_variable_quality_level(i, v, variable_feature_level);
+			problem.vvFeatureLevel[i].push_back(variable_feature_level);
+		}
+	}
+
+	//greedy marginal utility buys feature level up from the cheapest decision-vector,
+	//  the other strategies refine the previous choice
+	std::vector<int> initial_dec_vec;
+	if(decision_search_strategy == SearchGREEDY_MARGINAL_UTILITY)
+		initial_dec_vec = get_lowest_priority_order_decision_vector();
+	else if((int)thompson_model->vIncumbent_decision_vector.size() == num_variables)
+		initial_dec_vec = thompson_model->vIncumbent_decision_vector;
+	else
+		initial_dec_vec = get_highest_priority_order_decision_vector();
+
+	initial_dec_vec = get_nearest_valid_decision_vector(initial_dec_vec);
+
+	std::vector<int> dec_vec = search_decision_vector(problem, decision_search_strategy, initial_dec_vec);
+	double searched_reward = problem.score(dec_vec);
+
+	if(probability_of_exploration > random_uniform()) { //debug control: probabilitic exploration
+		int dec_var_index = (int)(random_next_u64() % num_variables);
+		int searched_value = dec_vec[dec_var_index];
+		dec_vec[dec_var_index] = (int)(random_next_u64() % vVarPriority[dec_var_index].size());
+		if(is_valid_decision_vector(dec_vec) == false)
+			dec_vec[dec_var_index] = searched_value;
+		OPP_DEBUG_MESSAGE(DebugMsgALL) << "ExecFrame #" << my_execframe->id << ": Probabilistic Exploration set decision-variable #"
+			<< dec_var_index << " to " << dec_vec[dec_var_index] << std::endl;
 	}
+	thompson_model->vIncumbent_decision_vector = dec_vec;
+
+	DecisionKey_t curr_dec_vec_int_val = convert_decision_vector_to_int(dec_vec);
+
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "thompson_sampling_factored_search_int_value(): context_bin = " << context_bin
+		<< " strategy = " << decision_search_strategy
+		<< " chosen curr_dec_vec_int_val = " << curr_dec_vec_int_val
+		<< " with searched reward = " << searched_reward
+		<< std::endl;
 
-	return convert_decision_vector_to_int( vNewDecisionValues );
+	return curr_dec_vec_int_val;
 }
 
 
-void ExecFrameInfo::run() {
+void ExecFrameInfo::run(long long num_items) {
+	begin_run();
+	RunModel::run_model_on_decision_vector(model, vDecisionVector, vRunning_decision_vector_values, vChosen_decision_vector_positions); //run user-code
+	end_run(num_items);
+}
+
+bool ExecFrameInfo::is_pacing_current_parent_invocation() const {
+	return pacing_parent_frame != 0 && pacing_parent_frame == curr_parent_frame
+		&& FrameInfo::get_frame_info(curr_parent_frame)->decision_model.invocation_index == pacing_parent_invocation_index;
+}
+
+DecisionKey_t ExecFrameInfo::paced_decision_vector_int_value(DecisionKey_t decision_vector_int_value) {
+	FrameInfo * parent_frame_info = FrameInfo::get_frame_info(curr_parent_frame);
+	ExecTime_t time_left = pacing_deadline - parent_frame_info->get_elapsed_exec_time_of_current_invocation();
+	ExecTime_t item_budget = time_left / pacing_items_remaining;
+
+	//Candidates are the decision-vectors measured to fit item_budget, and, taking cost per item to grow with feature level,
+	//  those not measured yet whose feature level is below that of every decision-vector measured not to fit (optimistically).
+	const std::map<DecisionKey_t, ExecTime_t>& map_measured = decision_model.map_decision_to_item_cost;
+
+	double lowest_unfitting_feature_level = 2.0; //above any feature level
+	DecisionKey_t cheapest_key = -1;
+	ExecTime_t cheapest_item_cost = 0.0;
+	std::vector<DecisionKey_t> vMeasured_keys;
+	for(std::map<DecisionKey_t, ExecTime_t>::const_iterator mit = map_measured.begin(); mit != map_measured.end(); mit++) {
+		if(is_valid_decision_key(mit->first) == false)
+			continue;
+		ExecTime_t item_cost = mit->second;
+		if(cheapest_key == -1 || item_cost < cheapest_item_cost) {
+			cheapest_key = mit->first;
+			cheapest_item_cost = item_cost;
+		}
+		if(item_cost > item_budget)
+			lowest_unfitting_feature_level = std::min(lowest_unfitting_feature_level, get_feature_level( convert_int_to_decision_vector(mit->first) ));
+		vMeasured_keys.push_back(mit->first);
+	}
+
+	const std::vector<DecisionKey_t> * pCandidate_keys = &vMeasured_keys;
+	if(get_num_decision_vectors() <= max_enumerated_decision_vectors)
+		pCandidate_keys = &get_valid_decision_keys();
+	else
+		vMeasured_keys.push_back( convert_decision_vector_to_int( get_nearest_valid_decision_vector( get_lowest_priority_order_decision_vector() ) ) );
+	const std::vector<DecisionKey_t>& vCandidate_keys = *pCandidate_keys;
+
+	DecisionKey_t fitting_key = -1;
+	double fitting_feature_level = -1.0;
+	for(int i=0; i<(int)vCandidate_keys.size(); i++) {
+		double feature_level = get_feature_level( convert_int_to_decision_vector(vCandidate_keys[i]) );
+		ExecTime_t item_cost = 0.0;
+		bool bFits = decision_model.get_item_cost(vCandidate_keys[i], item_cost)
+			? item_cost <= item_budget
+			: feature_level < lowest_unfitting_feature_level;
+		if(bFits && feature_level > fitting_feature_level) {
+			fitting_key = vCandidate_keys[i];
+			fitting_feature_level = feature_level;
+		}
+	}
+
+	DecisionKey_t paced_key = (fitting_key != -1 ? fitting_key : cheapest_key);
+	if(paced_key == -1) //no costs measured yet
+		paced_key = decision_vector_int_value;
+
+	OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "ExecFrameInfo::begin_run() : ExecFrame #" << my_execframe->id << " PACED items_remaining = " << pacing_items_remaining
+		<< " time_left = " << time_left << " item_budget = " << item_budget << " decision_vector_int_value = " << decision_vector_int_value
+		<< " -> " << paced_key << std::endl;
+	return paced_key;
+}
+
+void ExecFrameInfo::note_paced_override(DecisionKey_t paced_decision_vector_int_value) {
+	//The Thompson Sampling Strategy and the parent's spread are credited from the parent's record of the decision-vectors
+	//  run (see end_run()), which holds the paced one. The Fast Reaction Strategy's record of the choice run is corrected here.
+	FrameDecisionModel& parent_frame_dec = FrameInfo::get_frame_info(curr_parent_frame)->decision_model;
+	Parameter * ptr_decision_vector_parameter = &(decision_model.decision_vector_parameter);
+	if(parent_frame_dec.map_parm_to_fast_reaction_state.count(ptr_decision_vector_parameter) == 0)
+		return;
+
+	FastReactionState& frs = *(parent_frame_dec.map_parm_to_fast_reaction_state[ptr_decision_vector_parameter]);
+	if(frs.vCurrent_invocation_model_choice_double_value.size() == 0) //strategy not deciding in the current invocation
+		return;
+
+	std::vector<int> vPaced_values = convert_int_to_decision_vector(paced_decision_vector_int_value);
+	for(int i=0; i<(int)vPaced_values.size(); i++)
+		frs.vCurrent_invocation_model_choice_double_value[i] = (double)vPaced_values[i];
+}
+
+const std::vector<int>& ExecFrameInfo::begin_run() {
+	controller_overhead_begin();
 	curr_parent_frame = get_innermost_executing_frame();
 	
 	ExecFrameDecisionModel& execframe_dec_model = this->decision_model;
@@ -904,10 +1809,12 @@ void ExecFrameInfo::run() {
 		}
 	}
 
+	vChosen_decision_vector_positions.clear();
+
 	//check if curr_parent_frame != 0, and this is not first invocation
 	//   of current execframe since curr_parent_frame was last Activated.
 	//   if so => use previously cached decision-vector, else recompute it
-	int decision_vector_int_value = -1;
+	DecisionKey_t decision_vector_int_value = -1;
 
 #if 0
 	bool bWillUseForcedDefaultSelectChoice = bForceDefaultSelectChoice
@@ -920,7 +1827,7 @@ void ExecFrameInfo::run() {
 			&& 0 <= model.access_default_choice_index_for_select_var_id()
 			&& model.access_default_choice_index_for_select_var_id() < (int)vVarPriority.at(0).size() ); //FIXME: see above FIXME
 		decision_vector_int_value = model.access_default_choice_index_for_select_var_id();
-		std::cout << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " Forced DEFAULT Select model choice decision_vector_int_value = " << decision_vector_int_value << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " Forced DEFAULT Select model choice decision_vector_int_value = " << decision_vector_int_value << std::endl;
 	}
 #else
 	if(bForceDefaultSelectChoice) {
@@ -939,7 +1846,7 @@ void ExecFrameInfo::run() {
 
 		if(num_default_choices > 0) {
 			decision_vector_int_value = convert_decision_vector_to_int( vDefaultChoice_DecisionValues );
-			std::cout << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " Forced DEFAULT for Select sub-models choice decision_vector_int_value = " << decision_vector_int_value << std::endl;
+			OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " Forced DEFAULT for Select sub-models choice decision_vector_int_value = " << decision_vector_int_value << std::endl;
 		}
 	}
 #endif
@@ -960,45 +1867,85 @@ void ExecFrameInfo::run() {
 			IntCacheEntry& ce = ptr_value_cache->vCacheEntries[i];
 			if(ce.valid) { //found one
 				decision_vector_int_value = ce.tag;
-				std::cout << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " REUSING decision_vector_int_value = " << decision_vector_int_value << std::endl;
+				OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " REUSING decision_vector_int_value = " << decision_vector_int_value << std::endl;
 				break;
 			}
 		}
 	}
 #endif
 
-	if(stickiness_runlength_remaining > 0) {
+	activate_validity_oracles();
+
+	if(stickiness_runlength_remaining > 0 && is_valid_decision_key(sticky_decision_vector_int_val)) {
 		decision_vector_int_value = sticky_decision_vector_int_val;
 		stickiness_runlength_remaining--;
-		std::cout << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " STICKY decision_vector_int_value = " << decision_vector_int_value << " with stickiness_runlength_remaining = " << stickiness_runlength_remaining << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " STICKY decision_vector_int_value = " << decision_vector_int_value << " with stickiness_runlength_remaining = " << stickiness_runlength_remaining << std::endl;
 	}
 	
 	if(decision_vector_int_value == -1) { //re-usable decision-vector not found
 		decision_vector_int_value = choose_decision_vector_int_value();
-		std::cout << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " NEW decision_vector_int_value = " << decision_vector_int_value << std::endl;
+		OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " NEW decision_vector_int_value = " << decision_vector_int_value << std::endl;
+	}
+	if(is_valid_decision_key(decision_vector_int_value) == false) { //e.g., rounded Fast Reaction choice, or forced default
+		decision_vector_int_value = convert_decision_vector_to_int(
+			get_nearest_valid_decision_vector( convert_int_to_decision_vector(decision_vector_int_value) ) );
+		vChosen_decision_vector_positions.clear();
+		OPP_DEBUG_MESSAGE(DebugMsgDECISIONS) << "ExecFrameInfo::run() : ExecFrame #" << my_execframe->id << " CONSTRAINED to decision_vector_int_value = " << decision_vector_int_value << std::endl;
+	}
+	if(is_pacing_current_parent_invocation()) {
+		//re-decided every pacing_check_period items; in between, the runs keep the paced decision-vector
+		if(pacing_decision_vector_int_value == -1 || pacing_items_since_check >= pacing_check_period
+				|| is_valid_decision_key(pacing_decision_vector_int_value) == false) {
+			pacing_decision_vector_int_value = paced_decision_vector_int_value(decision_vector_int_value);
+			pacing_items_since_check = 0;
+		}
+		if(pacing_decision_vector_int_value != decision_vector_int_value) {
+			decision_vector_int_value = pacing_decision_vector_int_value;
+			vChosen_decision_vector_positions.clear();
+			note_paced_override(decision_vector_int_value);
+		}
 	}
-	std::vector<int> decision_vector_values_to_run = convert_int_to_decision_vector(decision_vector_int_value);
 
+	running_decision_vector_int_value = decision_vector_int_value;
+	convert_int_to_decision_vector(decision_vector_int_value, vRunning_decision_vector_values);
+
+	running_start_timeval = controller_overhead_end();
+	return vRunning_decision_vector_values;
+}
 
-	//Run
-	timeval start_timeval = get_curr_timeval();
-	RunModel::run_model_on_decision_vector(model, vDecisionVector, decision_vector_values_to_run); //run user-code
-	timeval end_timeval = get_curr_timeval();
+void ExecFrameInfo::end_run(long long num_items) {
+	timeval end_timeval = controller_overhead_begin();
+	timeval start_timeval = running_start_timeval;
+	DecisionKey_t decision_vector_int_value = running_decision_vector_int_value;
 
 
 	//update Parameters
 	ExecTime_t consumed_time = diff_time(start_timeval, end_timeval);
 	int consumed_time_int_bin = decision_model.convert_exec_time_to_int_bin(consumed_time);
 		//FIXME: update exec_time_parameter
+
+	decision_model.note_run(decision_vector_int_value, consumed_time, num_items);
+
+	if(is_pacing_current_parent_invocation()) {
+		pacing_items_remaining -= num_items;
+		pacing_items_since_check += num_items;
+		if(pacing_items_remaining <= 0)
+			pacing_parent_frame = 0;
+	}
+
+	if(bTraceOpen)
+		trace_note_execframe_run(my_execframe, curr_parent_frame, start_timeval, consumed_time, decision_vector_int_value);
+	if(bStatsPagePublished)
+		stats_page_note_execframe_run(my_execframe, curr_parent_frame, decision_vector_int_value, vRunning_decision_vector_values);
 	
 	if(curr_parent_frame != 0) {
-		std::vector<Frame *> vActiveParents = get_dynamically_enclosing_frames(curr_parent_frame);
-		vActiveParents.insert(vActiveParents.begin(), curr_parent_frame);
-
 		decision_model.decision_vector_parameter.inform_enclosing_active_consumers_of_sample_measurement(
-			vActiveParents, decision_vector_int_value);
+			curr_parent_frame, decision_vector_int_value);
+			//one decision per batch, however many items it ran: a weight growing with num_items would saturate
+			//  the parents' records (see IntValueCache::note_sample()), erasing the invocation's other decisions
 	}
 
+	controller_overhead_end();
 }
 
 
@@ -1039,11 +1986,15 @@ void extract_decision_vector(
 				break;
 			}
 		case Model::Select:
+		case Model::Knob:
 			{
-				std::vector<Model>& modelList = curr_model->access_modelList();
-				for(int i=0; i<(int)modelList.size(); i++) {
-					queue.push_back( &(modelList[i]) );
+				if(curr_model->type() == Model::Select) {
+					std::vector<Model>& modelList = curr_model->access_modelList();
+					for(int i=0; i<(int)modelList.size(); i++) {
+						queue.push_back( &(modelList[i]) );
+					}
 				}
+				int num_choices = curr_model->get_num_choices();
 
 				int select_var_id = curr_model->access_select_var_id();
 				int default_choice_index_for_select_var_id = curr_model->access_default_choice_index_for_select_var_id();
@@ -1057,10 +2008,10 @@ void extract_decision_vector(
 				}
 
 				std::vector<int>& select_priority = curr_model->access_select_priority();
-				assert(select_priority.size() == 0 || select_priority.size() == modelList.size());
+				assert(select_priority.size() == 0 || (int)select_priority.size() == num_choices);
 
 				if(found_loc != -1) { //select variable is a repeat
-					if(result_vVarPriority.at(found_loc).size() != modelList.size()) {
+					if((int)result_vVarPriority.at(found_loc).size() != num_choices) {
 						std::cerr << "extract_decision_vector(): ERROR:"
 								<< " model contains unequal selection sizes across"
 								<< "\n   multiple occurences of select_var_id = " << select_var_id
@@ -1118,7 +2069,7 @@ void extract_decision_vector(
 					result_vInitialCoeffs_fast_reaction_strategy.push_back(fast_reaction_strategy_coeff);
 
 					if(select_priority.size() == 0) {
-						result_vVarPriority.push_back( std::vector<int>(modelList.size(), 0) );
+						result_vVarPriority.push_back( std::vector<int>(num_choices, 0) );
 						//equal priorities of 0
 					}
 					else
@@ -1155,6 +2106,27 @@ void extract_decision_vector(
 
 
 
+/////////////////////////////
+//class Model definitions
+/////////////////////////////
+
+double Model::get_knob_value(double setting_position) const {
+	assert(_type == Knob);
+	if(knob_num_settings == 1)
+		return knob_highest_feature_value;
+
+	if(setting_position < 0.0)
+		setting_position = 0.0;
+	if(setting_position > knob_num_settings - 1)
+		setting_position = knob_num_settings - 1;
+	if(knob_is_continuous == false)
+		setting_position = floor(setting_position + 0.5);
+
+	return knob_highest_feature_value
+		+ setting_position * (knob_lowest_feature_value - knob_highest_feature_value) / (knob_num_settings - 1);
+}
+
+
 /////////////////////////////
 //class RunModel definitions
 /////////////////////////////
@@ -1162,7 +2134,8 @@ void extract_decision_vector(
 void RunModel::run_model_on_decision_vector(
 	const Model& model,
 	const std::vector<int>& vDecisionVector_variableIDs,
-	const std::vector<int>& vDecisionVector_values
+	const std::vector<int>& vDecisionVector_values,
+	const std::vector<double>& vDecisionVector_positions
 )
 {
 	switch(model.type()) {
@@ -1186,7 +2159,7 @@ void RunModel::run_model_on_decision_vector(
 		case Model::Sequence: {
 			for(int i=0; i<(int)model.modelList.size(); i++)
 				run_model_on_decision_vector(
-					model.modelList[i], vDecisionVector_variableIDs, vDecisionVector_values);
+					model.modelList[i], vDecisionVector_variableIDs, vDecisionVector_values, vDecisionVector_positions);
 
 			break;
 		}
@@ -1203,7 +2176,24 @@ void RunModel::run_model_on_decision_vector(
 
 			int choice_value = vDecisionVector_values.at(variable_index);
 			run_model_on_decision_vector(
-				model.modelList.at(choice_value), vDecisionVector_variableIDs, vDecisionVector_values);
+				model.modelList.at(choice_value), vDecisionVector_variableIDs, vDecisionVector_values, vDecisionVector_positions);
+
+			break;
+		}
+
+		case Model::Knob: {
+			int variable_index = -1;
+			for(int i=0; i<(int)vDecisionVector_variableIDs.size(); i++) {
+				if(vDecisionVector_variableIDs[i] == model.select_var_id) {
+					variable_index = i;
+					break;
+				}
+			}
+			assert(variable_index != -1);
+
+			double setting_position = (vDecisionVector_positions.size() > 0
+											? vDecisionVector_positions.at(variable_index) : vDecisionVector_values.at(variable_index));
+			model.knob_func( model.get_knob_value(setting_position) );
 
 			break;
 		}
@@ -10,9 +10,13 @@
 #include <algorithm>
 #include "opp.h"
 #include "opp_decision_model.h"
+#include "opp_constraint.h"
+#include "opp_utilities.h"
 
 namespace Opp {
 
+	class FrameInfo;
+
 	ExecFrame * get_execframe_from_execframe_id(FrameID_t execframe_id);
 
 	void extract_decision_vector(
@@ -48,20 +52,67 @@ namespace Opp {
 		bool bForceFixedCoeff_in_FastReactionStrategy;
 			//Suppresses rescaling of coefficients
 
+		int num_calibration_invocations;
+			//invocations of each parent frame spent measuring the cost of choices before control begins, 0 if none
+
 		Frame * curr_parent_frame;
 			//curr_parent_frame = 0 for a top-level frame.
 			//Defined only while the execframe is executing.
 
 		int stickiness_runlength_remaining;
-		int sticky_decision_vector_int_val;
+		DecisionKey_t sticky_decision_vector_int_val;
+
+		std::map<Frame *, DecisionValidityOracle *> map_constraining_frame_to_validity_oracle;
+			//Constraint of each Frame with one, within which this ExecFrame has run, compiled for this ExecFrame's decision-vectors
+		std::vector<const DecisionValidityOracle *> vActive_validity_oracles;
+			//oracles of curr_parent_frame and its dynamically enclosing Frames that restrict this ExecFrame's decisions.
+			//Defined only while the execframe is executing.
+		std::map<std::vector<const DecisionValidityOracle *>, std::vector<DecisionKey_t> > map_active_oracles_to_valid_decision_keys;
+			//get_valid_decision_keys() for each set of active oracles encountered, enumerated once: the valid keys change
+			//  only with the Constraints in force
+
+		std::vector<double> vChosen_decision_vector_positions;
+			//Unrounded choices of the Fast Reaction Strategy for the current run, applied as is by continuous Knob models.
+			//  Empty if the decision-vector was chosen otherwise.
+
+		DecisionKey_t running_decision_vector_int_value;
+		std::vector<int> vRunning_decision_vector_values;
+		timeval running_start_timeval;
+			//decision-vector of the current run, and when its user-code started.
+			//Defined only while the execframe is executing.
+
+		Frame * pacing_parent_frame;
+			//parent whose invocation is paced (see ExecFrame::pace()), 0 if none
+		long long int pacing_parent_invocation_index;
+		long long int pacing_items_remaining;
+		ExecTime_t pacing_deadline;
+		long long int pacing_check_period;
+		long long int pacing_items_since_check;
+		DecisionKey_t pacing_decision_vector_int_value;
+			//paced decision-vector kept until check_period items have run since it was decided, -1 if none yet
 
 		ExecFrameInfo(ExecFrame * my_execframe, const Model& model)
 			: my_execframe(my_execframe), decision_model(my_execframe),
 				model(model), bForceDefaultSelectChoice(false), bForceFixedCoeff_in_FastReactionStrategy(false),
-				curr_parent_frame(0), stickiness_runlength_remaining(0), sticky_decision_vector_int_val(-1)
+				num_calibration_invocations(0), curr_parent_frame(0), stickiness_runlength_remaining(0), sticky_decision_vector_int_val(-1),
+				running_decision_vector_int_value(-1),
+				pacing_parent_frame(0), pacing_parent_invocation_index(-1), pacing_items_remaining(0), pacing_deadline(0.0),
+				pacing_check_period(1), pacing_items_since_check(0), pacing_decision_vector_int_value(-1)
 		{
 			extract_decision_vector(model, vDecisionVector, vVarPriority, vDefaultChoice_DecisionValues, vInitialCoeffs_fast_reaction_strategy);
 
+			DecisionKey_t max_key = (DecisionKey_t)(~0ULL >> 1);
+			DecisionKey_t num_decision_vectors = 1;
+			for(int i=0; i<(int)vVarPriority.size(); i++) {
+				DecisionKey_t dim_size = vVarPriority[i].size();
+				if(num_decision_vectors > max_key / dim_size) {
+					std::cerr << "ExecFrameInfo(): ERROR: ExecFrame #" << my_execframe->id << " has more than "
+						<< max_key << " decision-vectors, which cannot be keyed" << std::endl;
+					exit(1);
+				}
+				num_decision_vectors *= dim_size;
+			}
+
 			vVariable_SortedPairs_Priority_Value.resize(vVarPriority.size());
 			for(int dec_var_index=0; dec_var_index<(int)vVarPriority.size(); dec_var_index++) {
 				std::vector< std::pair<int, int> > vPairs_Priority_Value;
@@ -75,18 +126,29 @@ namespace Opp {
 				vVariable_SortedPairs_Priority_Value[dec_var_index] = vPairs_Priority_Value;
 			}
 
-			std::cout << "vVariable_SortedPairs_Priority_Value:" << std::endl;;
+			OPP_DEBUG_MESSAGE(DebugMsgALL) << "vVariable_SortedPairs_Priority_Value:" << std::endl;;
 			for(int dec_var_index=0; dec_var_index<(int)vVariable_SortedPairs_Priority_Value.size(); dec_var_index++) {
-				std::cout << "  [" << dec_var_index << "] = [";
+				OPP_DEBUG_MESSAGE(DebugMsgALL) << "  [" << dec_var_index << "] = [";
 				for(int i=0; i<(int)vVariable_SortedPairs_Priority_Value[dec_var_index].size(); i++) {
-					std::cout << "(" << vVariable_SortedPairs_Priority_Value[dec_var_index][i].first
+					OPP_DEBUG_MESSAGE(DebugMsgALL) << "(" << vVariable_SortedPairs_Priority_Value[dec_var_index][i].first
 						<< ", " << vVariable_SortedPairs_Priority_Value[dec_var_index][i].second << ")";
 				}
-				std::cout << "]" << std::endl;
+				OPP_DEBUG_MESSAGE(DebugMsgALL) << "]" << std::endl;
 			}
 		}
 
-		void run();
+		~ExecFrameInfo() {
+			for(std::map<Frame *, DecisionValidityOracle *>::iterator mit = map_constraining_frame_to_validity_oracle.begin();
+					mit != map_constraining_frame_to_validity_oracle.end(); mit++)
+				delete mit->second;
+		}
+
+		void run(long long num_items = 1);
+			//num_items: work items processed by the run, see ExecFrame::run_batch()
+
+		const std::vector<int>& begin_run();
+		void end_run(long long num_items = 1);
+			//run() without running the model, see ExecFrame::run_begin()
 
 		//returns -1 if select_var_id not found in vDecisionVector
 		int find_index_of_select_var(int select_var_id) const {
@@ -107,12 +169,12 @@ namespace Opp {
 
 		// Conversion utilities between decision-vector-values and int-for-caching
 
-		int convert_decision_vector_to_int(std::vector<int> vDecisionValues) const {
+		DecisionKey_t convert_decision_vector_to_int(const std::vector<int>& vDecisionValues) const {
 			assert(vDecisionValues.size() == vVarPriority.size());
 
-			int int_val = 0;
+			DecisionKey_t int_val = 0;
 			for(int i=0; i<(int)vDecisionValues.size(); i++) {
-				int dim_size = vVarPriority[i].size();
+				DecisionKey_t dim_size = vVarPriority[i].size();
 				int_val *= dim_size;
 
 				int dec_var_val = vDecisionValues[i];
@@ -122,23 +184,29 @@ namespace Opp {
 			return int_val;
 		}
 
-		std::vector<int> convert_int_to_decision_vector(int int_val) const {
-			std::vector<int> dec_vec(vVarPriority.size(), 0);
+		std::vector<int> convert_int_to_decision_vector(DecisionKey_t int_val) const {
+			std::vector<int> dec_vec;
+			convert_int_to_decision_vector(int_val, dec_vec);
+			return dec_vec;
+		}
+
+			//as above, into dec_vec (re-using its storage)
+		void convert_int_to_decision_vector(DecisionKey_t int_val, std::vector<int>& dec_vec) const {
+			dec_vec.resize(vVarPriority.size());
 			for(int i=(int)vVarPriority.size()-1; i >= 0; i--) {
 				dec_vec[i] = int_val % ((int)vVarPriority[i].size());
 				int_val /= (int)vVarPriority[i].size();
 			}
 			assert(int_val == 0);
-			return dec_vec;
 		}
 
 
 		// Utilities related to priorities of decision-vectors
 
-		int get_num_decision_vectors() const {
-			int result = 1;
+		DecisionKey_t get_num_decision_vectors() const {
+			DecisionKey_t result = 1;
 			for(int i=0; i<(int)vVarPriority.size(); i++)
-				result *= (int)vVarPriority[i].size();
+				result *= (DecisionKey_t)vVarPriority[i].size();
 			return result;
 		}
 
@@ -149,6 +217,13 @@ namespace Opp {
 			return dec_vec;
 		}
 
+		std::vector<int> get_lowest_priority_order_decision_vector() const {
+			std::vector<int> dec_vec;
+			for(int i=0; i<(int)vVariable_SortedPairs_Priority_Value.size(); i++)
+				dec_vec.push_back( vVariable_SortedPairs_Priority_Value[i].back().second );
+			return dec_vec;
+		}
+
 		bool is_lowest_priority_order_decision_vector(const std::vector<int>& dec_vec) const {
 			assert(dec_vec.size() == vVariable_SortedPairs_Priority_Value.size());
 
@@ -163,7 +238,7 @@ namespace Opp {
 
 		std::vector<int> get_next_lower_priority_order_decision_vector(const std::vector<int>& dec_vec) const {
 			assert(dec_vec.size() == vVariable_SortedPairs_Priority_Value.size());
-			std::vector<int> next_dec_vec;
+			std::vector<int> next_dec_vec = dec_vec;
 
 			bool continue_to_upper_variable = true;
 			for(int i=(int)vVariable_SortedPairs_Priority_Value.size()-1; i >= 0; i--) {
@@ -187,7 +262,7 @@ namespace Opp {
 					next_value = vVariable_SortedPairs_Priority_Value[i][0].second; //cycle around
 					continue_to_upper_variable = true;
 				}
-				next_dec_vec.push_back(next_value);
+				next_dec_vec[i] = next_value;
 			}
 			if(continue_to_upper_variable == true) //have cycled through all variables
 				return dec_vec; //this was already lowest-value, repeat to signal end
@@ -195,6 +270,72 @@ namespace Opp {
 			return next_dec_vec;
 		}
 
+			//returns 1.0 for the highest priority order decision-vector, down to 0.0 for the lowest.
+			//Each variable contributes equally, by the rank of its value in priority order
+			//  (values of equal priority are ranked in increasing order of value).
+		double get_feature_level(const std::vector<int>& dec_vec) const {
+			assert(dec_vec.size() == vVarPriority.size());
+			if(dec_vec.size() == 0)
+				return 1.0;
+
+			double sum_level = 0.0;
+			for(int i=0; i<(int)dec_vec.size(); i++)
+				sum_level += get_variable_feature_level(i, dec_vec[i]);
+			return sum_level / dec_vec.size();
+		}
+
+			//contribution of variable dec_var_index taking 'value' to get_feature_level(), before averaging
+		double get_variable_feature_level(int dec_var_index, int value) const {
+			int num_values = (int)vVarPriority.at(dec_var_index).size();
+			assert(0 <= value && value < num_values);
+			if(num_values == 1)
+				return 1.0;
+
+			int priority = vVarPriority[dec_var_index][value];
+			int rank = 0;
+			for(int v=0; v<num_values; v++) {
+				if(vVarPriority[dec_var_index][v] < priority || (vVarPriority[dec_var_index][v] == priority && v < value))
+					rank++;
+			}
+			return 1.0 - rank / (double)(num_values - 1);
+		}
+
+		// Validity of decision-vectors under the Constraints of the enclosing Frames
+
+		bool is_valid_decision_vector(const std::vector<int>& dec_vec) const {
+			for(int i=0; i<(int)vActive_validity_oracles.size(); i++) {
+				if(vActive_validity_oracles[i]->is_valid(dec_vec) == false)
+					return false;
+			}
+			return true;
+		}
+
+		bool is_valid_decision_key(DecisionKey_t decision_int_value) const {
+			for(int i=0; i<(int)vActive_validity_oracles.size(); i++) {
+				if(vActive_validity_oracles[i]->is_valid_key(decision_int_value) == false)
+					return false;
+			}
+			return true;
+		}
+
+		bool is_consistent_partial_decision_vector(const std::vector<int>& partial_dec_vec) const {
+			for(int i=0; i<(int)vActive_validity_oracles.size(); i++) {
+				if(vActive_validity_oracles[i]->is_consistent(partial_dec_vec) == false)
+					return false;
+			}
+			return true;
+		}
+
+		void activate_validity_oracles();
+			//compiles the Constraints of newly encountered enclosing Frames, and sets vActive_validity_oracles
+
+		const std::vector<DecisionKey_t>& get_valid_decision_keys();
+			//ascending; for decision spaces small enough to enumerate. Cached per set of vActive_validity_oracles.
+
+		std::vector<int> get_nearest_valid_decision_vector(const std::vector<int>& dec_vec) const;
+			//dec_vec itself if valid, else a valid decision-vector close in values to dec_vec
+			//  (ties broken in favor of higher feature level)
+
 			//compares priorities; returns -1 when dec1 < dec2, 0 when dec1 == dec2, +1 when dec1 > dec2
 		int cmp_decision_vectors_on_priority(
 			const std::vector<int>& dec1,
@@ -237,9 +378,80 @@ namespace Opp {
 				return false;
 		}
 
-		int choose_decision_vector_int_value();
+		void remove_invalid_decision_keys(
+			std::vector<DecisionKey_t>& vDecisionSet,
+			std::vector<double>& vDecisionSet_Counts,
+			std::vector<double>& vDecisionSet_Probs
+		) const;
+
+		bool assign_nearest_consistent_values(
+			std::vector<int>& partial_dec_vec,
+			int dec_var_index,
+			const std::vector<int>& target_dec_vec,
+			int& remaining_node_budget
+		) const;
+		//Backtracking assignment of variables dec_var_index onwards, each taking the consistent value closest to its target.
+
+		DecisionKey_t choose_decision_vector_int_value();
+
+		bool is_pacing_current_parent_invocation() const;
+
+		DecisionKey_t paced_decision_vector_int_value(DecisionKey_t decision_vector_int_value);
+		//Shifts the chosen decision_vector_int_value to the one fitting the time left per remaining item (see ExecFrame::pace())
 
-		int fast_reaction_strategy_choice_int_value();
+		void note_paced_override(DecisionKey_t paced_decision_vector_int_value);
+		//Records that pacing ran paced_decision_vector_int_value instead of the decision strategy's choice
+
+		bool calibration_choice_int_value(DecisionKey_t& result_decision_vector_int_value);
+		//Startup calibration (see ExecFrame::calibrate()): chooses the next calibration decision-vector for the parent's
+		//  current invocation and records the cost measured for the previous one.
+		//  Returns false once calibration is complete, or if none applies to the current parent.
+
+		void complete_calibration(
+			const FrameDecisionModel& parent_frame_dec,
+			FastReactionState& frs
+		);
+		//Fits the Fast Reaction Strategy's coefficients to the calibration samples, and resumes it from the last calibration choice
+
+		DecisionKey_t fast_reaction_strategy_choice_int_value();
+
+		void initialize_fast_reaction_state(
+			const FrameDecisionModel& parent_frame_dec,
+			FastReactionState& frs
+		);
+
+		std::vector<double> fast_reaction_strategy_base_choice(
+			FrameInfo * parent_frame_info,
+			FastReactionState& frs
+		);
+		//Computes the choices for the parent's current invocation from the outcome of its previous invocation.
+		//Invoked once per invocation of the parent.
+
+		std::vector<double> apply_workload_hint_feedforward(
+			FrameInfo * parent_frame_info,
+			FastReactionState& frs,
+			const std::vector<double>& vBase_X
+		);
+		//Corrects the Fast Reaction Strategy's choices vBase_X for the anticipated effect of the parent frame's
+		//  workload hints.
+
+		std::vector<double> apply_intra_frame_slack_reclaiming(
+			FrameInfo * parent_frame_info,
+			FastReactionState& frs,
+			const std::vector<double>& vBase_X
+		);
+		//Corrects vBase_X for the time the parent's current invocation has spent so far, relative to the time
+		//  usually spent by the current run of this ExecFrame within the invocation, and learns the latter.
+
+		DecisionKey_t thompson_sampling_strategy_choice_int_value();
+
+		DecisionKey_t thompson_sampling_factored_search_int_value(
+			ThompsonSamplingModel * thompson_model,
+			int context_bin,
+			const FrameDecisionModel& parent_frame_dec
+		);
+		//Thompson Sampling over per-variable posteriors, for decision spaces too large to enumerate:
+		//  the sampled reward is maximized by the decision search strategy, never visiting the whole product.
 	};
 
 	class RunModel {
@@ -247,8 +459,10 @@ namespace Opp {
 		static void run_model_on_decision_vector(
 			const Model& model,
 			const std::vector<int>& vDecisionVector_variableIDs,
-			const std::vector<int>& vDecisionVector_values
+			const std::vector<int>& vDecisionVector_values,
+			const std::vector<double>& vDecisionVector_positions
 		);
+		//vDecisionVector_positions: fractional setting indices for Knob models, empty to use vDecisionVector_values
 	};
 
 } //namespace Opp
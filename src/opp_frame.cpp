@@ -5,6 +5,7 @@
 #include <iostream>
 #include <cstdlib>
 #include <vector>
+#include <algorithm>
 
 #include "opp.h"
 #include "opp_timing.h"
@@ -12,6 +13,9 @@
 #include "opp_frame_info.h"
 #include "opp_frame.h"
 #include "opp_execframe.h"
+#include "opp_snapshot.h"
+#include "opp_trace.h"
+#include "opp_debug_control.h"
 
 namespace Opp {
 
@@ -29,6 +33,14 @@ Frame::Frame(const Objective& obj)
 	: BaseFrame()
 { frame_info = new FrameInfo(this, obj); }
 
+Frame::Frame(const Constraint& con)
+	: BaseFrame()
+{ frame_info = new FrameInfo(this, Objective(), con); }
+
+Frame::Frame(const Objective& obj, const Constraint& con)
+	: BaseFrame()
+{ frame_info = new FrameInfo(this, obj, con); }
+
 
 Frame::~Frame() {
 	delete frame_info;
@@ -97,6 +109,19 @@ Frame * get_frame_from_frame_id(FrameID_t frame_id)
 
 
 
+//debug control
+bool bSubtractControllerOverhead = false;
+
+void feature_control_subtract_controller_overhead(bool new_setting) {
+	bSubtractControllerOverhead = new_setting;
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "SRT Feature Control: bSubtractControllerOverhead = " << bSubtractControllerOverhead << std::endl;
+}
+
+bool feature_query_subtract_controller_overhead() {
+	return bSubtractControllerOverhead;
+}
+
+
 void frame_enter(FrameID_t frame_id) {
 	FrameID_t parent_frame_id = -1; //assume top-level
 
@@ -108,7 +133,7 @@ void frame_enter(FrameID_t frame_id) {
 }
 
 void frame_enter(FrameID_t frame_id, FrameID_t chosen_parent_frame_id) {
-	timeval curr_timeval = get_curr_timeval();
+	timeval curr_timeval = controller_overhead_begin();
 
 	assert(frame_id >= 0 && frame_id < vBaseFrames.size());
 
@@ -120,6 +145,9 @@ void frame_enter(FrameID_t frame_id, FrameID_t chosen_parent_frame_id) {
 		frame_info->bIsActive = true;
 		frame_info->bIsSuspended = false;
 		frame_info->current_invocation_exec_time = 0.0;
+		frame_info->invocation_start_timeval = curr_timeval;
+		frame_info->current_invocation_cpu_time = 0.0;
+		frame_info->current_invocation_controller_overhead = 0.0;
 
 		frame_info->stack_index = (int)vFrameStack.size();
 		vFrameStack.push_back(frame);
@@ -179,11 +207,16 @@ void frame_enter(FrameID_t frame_id, FrameID_t chosen_parent_frame_id) {
 	}
 
 	frame_info->curr_enter_timeval = curr_timeval;
+	frame_info->curr_enter_controller_overhead = get_controller_overhead_until(curr_timeval);
+	if(frame_info->bMeasuresCpuTime)
+		frame_info->curr_enter_cpu_time = get_thread_cpu_time();
 
 	assert(frame == get_innermost_executing_frame());
+	controller_overhead_end();
 }
 
 ExecTime_t frame_exit_complete(FrameID_t frame_id) {
+	controller_overhead_begin();
 	assert(frame_id >= 0 && frame_id < vBaseFrames.size());
 
 	Frame * frame = dynamic_cast<Frame *>(vBaseFrames[frame_id]);
@@ -220,7 +253,11 @@ ExecTime_t frame_exit_complete(FrameID_t frame_id) {
 	update_decision_model_on_completion(frame);
 	ExecTime_t total_execution_time_for_invocation = frame_info->current_invocation_exec_time;
 	frame_info->current_invocation_exec_time = 0.0;
+	frame_info->current_invocation_cpu_time = 0.0;
 	
+	if(frame_info->curr_parent_frame == 0)
+		snapshot_note_top_level_completion();
+
 	// - Inactivate and nullify on stack
 	if(frame_info->curr_parent_frame != 0) {
 		FrameInfo * parent_frame_info = FrameInfo::get_frame_info(frame_info->curr_parent_frame);
@@ -251,11 +288,13 @@ ExecTime_t frame_exit_complete(FrameID_t frame_id) {
 		vFrameStack.resize(new_size);
 	}
 
+	controller_overhead_end();
 	return total_execution_time_for_invocation;
 }
 
 
 ExecTime_t frame_exit_suspend(FrameID_t frame_id) {
+	timeval curr_timeval = controller_overhead_begin();
 	assert(frame_id >= 0 && frame_id < vBaseFrames.size());
 
 	Frame * frame = dynamic_cast<Frame *>(vBaseFrames[frame_id]);
@@ -284,13 +323,23 @@ ExecTime_t frame_exit_suspend(FrameID_t frame_id) {
 		}
 	}
 
-	// - measure elapsed time
-	timeval curr_timeval = get_curr_timeval();
+	// - measure elapsed time, and the library's share of it (including decisions and completions of contained frames)
 	ExecTime_t elapsed_piece_time = diff_time(frame_info->curr_enter_timeval, curr_timeval);
+	ExecTime_t piece_controller_overhead = std::min(elapsed_piece_time,
+		get_controller_overhead_until(curr_timeval) - frame_info->curr_enter_controller_overhead);
+	frame_info->current_invocation_controller_overhead += piece_controller_overhead;
+	if(bSubtractControllerOverhead)
+		elapsed_piece_time -= piece_controller_overhead;
 	frame_info->current_invocation_exec_time += elapsed_piece_time;
+	if(frame_info->bMeasuresCpuTime)
+		frame_info->current_invocation_cpu_time += get_thread_cpu_time() - frame_info->curr_enter_cpu_time;
 
 	frame_info->bIsSuspended = true;
 
+	if(bTraceOpen)
+		trace_note_frame_segment(frame, elapsed_piece_time);
+
+	controller_overhead_end();
 	return elapsed_piece_time;
 }
 
@@ -327,6 +376,64 @@ bool is_frame_executing(FrameID_t frame_id) {
 }
 
 
+void frame_set_workload_hint(FrameID_t frame_id, int hint_index, double hint_value) {
+	if(hint_index < 0) {
+		std::cerr << "frame_set_workload_hint(): ERROR: invalid hint_index = " << hint_index
+			<< "\n    for frame_id = " << frame_id << std::endl;
+		exit(1);
+	}
+
+	Frame * frame = get_frame_from_frame_id(frame_id);
+	FrameInfo * frame_info = FrameInfo::get_frame_info(frame);
+
+	if(hint_index >= (int)frame_info->vWorkload_hints.size())
+		frame_info->vWorkload_hints.resize(hint_index+1, 0.0);
+	frame_info->vWorkload_hints[hint_index] = hint_value;
+}
+
+void frame_clear_workload_hints(FrameID_t frame_id) {
+	Frame * frame = get_frame_from_frame_id(frame_id);
+	FrameInfo * frame_info = FrameInfo::get_frame_info(frame);
+
+	frame_info->vWorkload_hints.clear();
+}
+
+void frame_set_statistics_windows(FrameID_t frame_id, long long window_length, double window_seconds) {
+	if(window_length < 0 || window_seconds < 0.0) {
+		std::cerr << "frame_set_statistics_windows(): ERROR: invalid window_length = " << window_length
+			<< " or window_seconds = " << window_seconds << "\n    for frame_id = " << frame_id << std::endl;
+		exit(1);
+	}
+
+	Frame * frame = get_frame_from_frame_id(frame_id);
+	FrameDecisionModel& frame_dec = FrameInfo::get_frame_info(frame)->decision_model;
+
+	frame_dec.statistics_window_by_count.initialize(window_length, 0.0);
+	frame_dec.statistics_window_by_time.initialize(0, window_seconds);
+	frame_dec.bHasLastWindowedExecTime = false;
+}
+
+void frame_report_quality(FrameID_t frame_id, double quality) {
+	Frame * frame = get_frame_from_frame_id(frame_id);
+	FrameInfo * frame_info = FrameInfo::get_frame_info(frame);
+
+	if(frame_info->bIsActive) { //credited on completion
+		frame_info->vQuality_reports_of_current_invocation.push_back(quality);
+		return;
+	}
+
+	FrameDecisionModel& frame_dec = frame_info->decision_model;
+	for(std::map<Parameter *, ThompsonSamplingModel *>::iterator mit = frame_dec.map_parm_to_thompson_model.begin();
+			mit != frame_dec.map_parm_to_thompson_model.end();
+			mit++
+	) {
+		mit->second->note_quality_of_last_invocation(quality);
+		if(frame_dec.bHasQualityFloorObjective)
+			mit->second->note_outcome_of_last_invocation(ThompsonSamplingModel::quality_floor_context_bin, quality >= frame_dec.min_quality);
+	}
+}
+
+
 
 
 
@@ -8,6 +8,7 @@
 #include <list>
 #include <sys/time.h>
 #include "opp.h"
+#include "opp_timing.h"
 #include "opp_decision_model.h"
 
 namespace Opp {
@@ -18,7 +19,8 @@ namespace Opp {
 		Frame * my_frame; //the frame corresponding to this FrameInfo instance
 		FrameDecisionModel decision_model;
 
-		//FIXME: add element for Constraints
+		Constraint constraint;
+			//type UNDEF if the Frame imposes no Constraint
 
 		bool bIsActive; //frame has been started but not yet completed
 
@@ -29,6 +31,8 @@ namespace Opp {
 		ExecTime_t current_invocation_exec_time;
 			//cumulative time spent in current invocation of frame,
 			//including all suspends and resumes of a piecewise frame
+		timeval invocation_start_timeval;
+			//when the current invocation started
 		int stack_index;
 			//location of an active frame in vFrameStack
 		Frame * curr_parent_frame;
@@ -37,24 +41,76 @@ namespace Opp {
 			//direct children that are currently active (atmost one can be Executing, rest Suspended)
 
 
+		ExecTime_t current_invocation_cpu_time;
+			//cumulative CPU time consumed by the current invocation of frame, measured only if
+			//  bMeasuresCpuTime (i.e., the frame's Objective is a quality_floor() with cost = CostCPU_TIME)
+
+		ExecTime_t current_invocation_controller_overhead;
+			//library time (see controller_overhead_begin()) within the executing segments of the current invocation,
+			//  subtracted from current_invocation_exec_time if feature_query_subtract_controller_overhead()
+
+
+		std::vector<double> vWorkload_hints;
+			//application-provided hints describing the current (or upcoming) invocation of frame,
+			//  retained across invocations until changed. Empty if no hints provided.
+
+		std::vector<double> vQuality_reports_of_current_invocation;
+			//qualities reported by the application while the current invocation was active,
+			//  credited to its decisions on completion
+
+
 		//Following defined only if frame is currently executing
 		//  i.e., bIsActive == true and bIsSuspended = false
 		timeval curr_enter_timeval;
+		double curr_enter_cpu_time; //defined iff bMeasuresCpuTime
+		double curr_enter_controller_overhead; //get_controller_overhead_until(curr_enter_timeval)
+
+		const bool bMeasuresCpuTime;
 
 
 		FrameInfo(Frame * my_frame)
 			: my_frame(my_frame), decision_model(my_frame), bIsActive(false),
 				bIsSuspended(false), current_invocation_exec_time(0.0),
-				stack_index(-1), curr_parent_frame(0)
+				stack_index(-1), curr_parent_frame(0), current_invocation_cpu_time(0.0),
+				current_invocation_controller_overhead(0.0),
+				curr_enter_cpu_time(0.0), curr_enter_controller_overhead(0.0), bMeasuresCpuTime(measures_cpu_time(objective))
 		{ }
 
 		FrameInfo(Frame * my_frame, const Objective& obj)
 			: objective(obj),
 				my_frame(my_frame), decision_model(my_frame), bIsActive(false),
 				bIsSuspended(false), current_invocation_exec_time(0.0),
-				stack_index(-1), curr_parent_frame(0)
+				stack_index(-1), curr_parent_frame(0), current_invocation_cpu_time(0.0),
+				current_invocation_controller_overhead(0.0),
+				curr_enter_cpu_time(0.0), curr_enter_controller_overhead(0.0), bMeasuresCpuTime(measures_cpu_time(objective))
 		{ }
 
+		FrameInfo(Frame * my_frame, const Objective& obj, const Constraint& con)
+			: objective(obj),
+				my_frame(my_frame), decision_model(my_frame), constraint(con), bIsActive(false),
+				bIsSuspended(false), current_invocation_exec_time(0.0),
+				stack_index(-1), curr_parent_frame(0), current_invocation_cpu_time(0.0),
+				current_invocation_controller_overhead(0.0),
+				curr_enter_cpu_time(0.0), curr_enter_controller_overhead(0.0), bMeasuresCpuTime(measures_cpu_time(objective))
+		{ }
+
+
+		static bool measures_cpu_time(const Objective& obj)
+			{ return obj.isDefined && obj.type == Objective::ObjQUALITY_FLOOR && obj.cost == Objective::CostCPU_TIME; }
+
+		//cost of the current invocation w.r.t. a quality_floor() Objective, once the frame is Suspended
+		ExecTime_t get_current_invocation_cost() const
+			{ return bMeasuresCpuTime ? current_invocation_cpu_time : current_invocation_exec_time; }
+
+		//includes time since the frame was last entered, if currently executing
+		ExecTime_t get_elapsed_exec_time_of_current_invocation() const {
+			if(bIsActive == false)
+				return 0.0;
+			if(bIsSuspended)
+				return current_invocation_exec_time;
+			return current_invocation_exec_time + diff_time(curr_enter_timeval, get_curr_timeval());
+		}
+
 
 		//being a friend of class Frame
 		static FrameInfo * get_frame_info(Frame * frame)
@@ -2,10 +2,10 @@
 //
 // Author: Tushar Kumar, tushardeveloper@gmail.com
 
-#include <map>
 #include <algorithm>
 
 #include "opp_parameter_spread.h"
+#include "opp_snapshot.h"
 
 namespace Opp {
 
@@ -33,10 +33,26 @@ std::vector<int> ParameterExecSpread::get_complementary_bin_indices(std::vector<
 	return vComplementarySpreadBinIndices;
 }
 
+//Index of value in vSorted_Values (ascending), inserting it with zero counts if absent
+static int find_or_insert_sorted_value(
+	std::vector<ParameterValue_t>& vSorted_Values,
+	std::vector<double>& vCount_FOR,
+	std::vector<double>& vCount_AGAINST,
+	ParameterValue_t value
+) {
+	int index = (int)(std::lower_bound(vSorted_Values.begin(), vSorted_Values.end(), value) - vSorted_Values.begin());
+	if(index == (int)vSorted_Values.size() || vSorted_Values[index] != value) {
+		vSorted_Values.insert(vSorted_Values.begin() + index, value);
+		vCount_FOR.insert(vCount_FOR.begin() + index, 0.0);
+		vCount_AGAINST.insert(vCount_AGAINST.begin() + index, 0.0);
+	}
+	return index;
+}
+
 void ParameterExecSpread::get_discriminating_values(
-	std::vector<int> vGivenSpreadBinIndices,
+	const std::vector<int>& vGivenSpreadBinIndices,
 	double FOR_discrimination_factor,
-	std::vector<int>& result_FOR_vValues,
+	std::vector<ParameterValue_t>& result_FOR_vValues,
 	std::vector<double>& result_FOR_vCounts,
 	std::vector<double>& result_FOR_vProbs
 )
@@ -51,24 +67,24 @@ void ParameterExecSpread::get_discriminating_values(
 
 	//Now: vOpposingSpreadBinIndices contains the complement of the bin-indices in vGivenSpreadBinIndices
 
-	std::map<int, double> map_FOR_value_to_count;
-	std::map<int, double> map_AGAINST_value_to_count;
-		//both maps will have identical keys
+	//occuring values in sorted order, with their FOR and AGAINST counts: kept in flat vectors rather
+	//  than maps, as this is done for every decision of the default strategy
+	std::vector<ParameterValue_t> vSorted_Values;
+	std::vector<double> vCount_FOR;
+	std::vector<double> vCount_AGAINST;
 
 	for(int j=0; j<(int)vGivenSpreadBinIndices.size(); j++) {
 		int bin_index = vGivenSpreadBinIndices[j];
 		assert(0 <= bin_index && bin_index < (int)vExecSpreadBins.size());
 
 		IntValueCache& spread_bin = vExecSpreadBins[bin_index];
+		if(spread_bin.get_sample_count() == 0.0) //nothing would be added to the counts
+			continue;
 		for(int k=0; k<(int)spread_bin.vCacheEntries.size(); k++) { //for each tag-value in cache
 			IntCacheEntry& ce = spread_bin.vCacheEntries[k];
 			if(ce.valid) {
-				if(map_FOR_value_to_count.count(ce.tag) == 0)
-					map_FOR_value_to_count[ce.tag] = 0.0;
-				if(map_AGAINST_value_to_count.count(ce.tag) == 0)
-					map_AGAINST_value_to_count[ce.tag] = 0.0;
-
-				map_FOR_value_to_count[ce.tag] += ce.count;
+				int value_index = find_or_insert_sorted_value(vSorted_Values, vCount_FOR, vCount_AGAINST, ce.tag);
+				vCount_FOR[value_index] += ce.count;
 			}
 		}
 	}
@@ -78,15 +94,13 @@ void ParameterExecSpread::get_discriminating_values(
 		assert(0 <= bin_index && bin_index < (int)vExecSpreadBins.size());
 
 		IntValueCache& spread_bin = vExecSpreadBins[bin_index];
+		if(spread_bin.get_sample_count() == 0.0) //nothing would be added to the counts
+			continue;
 		for(int k=0; k<(int)spread_bin.vCacheEntries.size(); k++) { //for each tag-value in cache
 			IntCacheEntry& ce = spread_bin.vCacheEntries[k];
 			if(ce.valid) {
-				if(map_FOR_value_to_count.count(ce.tag) == 0)
-					map_FOR_value_to_count[ce.tag] = 0.0;
-				if(map_AGAINST_value_to_count.count(ce.tag) == 0)
-					map_AGAINST_value_to_count[ce.tag] = 0.0;
-
-				map_AGAINST_value_to_count[ce.tag] += ce.count;
+				int value_index = find_or_insert_sorted_value(vSorted_Values, vCount_FOR, vCount_AGAINST, ce.tag);
+				vCount_AGAINST[value_index] += ce.count;
 			}
 		}
 	}
@@ -97,21 +111,10 @@ void ParameterExecSpread::get_discriminating_values(
 	if(spread_total_sample_count == 0.0)
 		spread_total_sample_count = 1.0; //avoid divide-by-zero, all numerators will be 0.0 anyways
 
-	std::vector<int> vSorted_Values; //occuring values in sorted order
-
-	for(std::map<int, double>::iterator mit_FOR = map_FOR_value_to_count.begin();
-			mit_FOR != map_FOR_value_to_count.end();
-			mit_FOR++
-	) {
-		int value = mit_FOR->first;
-		vSorted_Values.push_back(value);
-	}
-	std::sort(vSorted_Values.begin(), vSorted_Values.end()); //sort ascending
-
 	for(int i=0; i<(int)vSorted_Values.size(); i++) {
-		int value = vSorted_Values[i];
-		double count_FOR = map_FOR_value_to_count[value];
-		double count_AGAINST = map_AGAINST_value_to_count[value];
+		ParameterValue_t value = vSorted_Values[i];
+		double count_FOR = vCount_FOR[i];
+		double count_AGAINST = vCount_AGAINST[i];
 		double total_count = count_FOR + count_AGAINST;
 
 		if(count_FOR / total_count >= FOR_discrimination_factor) {
@@ -156,7 +159,7 @@ void ParameterExecSpread::detect_parameter_discrimination_to_spread(
 		if(vExecSpreadBins[i].get_sample_count() >= dominant_sample_count_threshold)
 			vDominantBinIndices.push_back(i);
 
-	std::vector<int> vParameterValuesConcatenation;
+	std::vector<ParameterValue_t> vParameterValuesConcatenation;
 	for(int bi=0; bi<(int)vDominantBinIndices.size(); bi++) {
 		IntValueCache& exec_bin = vExecSpreadBins[ vDominantBinIndices[bi] ];
 		for(int j=0; j<(int)exec_bin.vCacheEntries.size(); j++) {
@@ -167,7 +170,7 @@ void ParameterExecSpread::detect_parameter_discrimination_to_spread(
 	}
 	std::sort(vParameterValuesConcatenation.begin(), vParameterValuesConcatenation.end());
 
-	std::vector<int> vDomainParameterValues;
+	std::vector<ParameterValue_t> vDomainParameterValues;
 	for(int i=0; i<(int)vParameterValuesConcatenation.size(); i++) { //eliminate duplicated parameter values
 		if((int)vDomainParameterValues.size() == 0
 			|| vDomainParameterValues[vDomainParameterValues.size()-1] != vParameterValuesConcatenation[i]
@@ -202,7 +205,7 @@ void ParameterExecSpread::detect_parameter_discrimination_to_spread(
 	max_D_statistic = 0.0;
 	std::vector<double> vProgCDF(vDominantBinIndices.size(), 0.0);
 	for(int vi=0; vi<(int)vDomainParameterValues.size(); vi++) {
-		int value = vDomainParameterValues[vi];
+		ParameterValue_t value = vDomainParameterValues[vi];
 
 			//assumption: vDominantBinIndices.size() > 0, therefore step_m??_CDF will always be corrected
 		double step_min_CDF = 1.0;
@@ -225,4 +228,58 @@ void ParameterExecSpread::detect_parameter_discrimination_to_spread(
 	}
 }
 
+
+void IntValueCache::save_snapshot(SnapshotWriter& writer) const {
+	writer.put_double(max_count);
+	writer.put_double(sample_count);
+	writer.put_i64((long long)vCacheEntries.size());
+	for(int i=0; i<(int)vCacheEntries.size(); i++) {
+		writer.put_bool(vCacheEntries[i].valid);
+		writer.put_i64(vCacheEntries[i].tag);
+		writer.put_double(vCacheEntries[i].count);
+	}
+}
+
+bool IntValueCache::load_snapshot(SnapshotReader& reader) {
+	//decode into loaded, leaving this cache untouched unless the whole record is well-formed
+	IntValueCache loaded;
+	long long num_entries = 0;
+	reader.get_double(loaded.max_count);
+	reader.get_double(loaded.sample_count);
+	if(reader.get_length(num_entries, 2 * sizeof(long long) + sizeof(double)) == false)
+		return false;
+	loaded.vCacheEntries.resize((size_t)num_entries);
+	for(int i=0; i<(int)loaded.vCacheEntries.size() && reader.ok(); i++) {
+		reader.get_bool(loaded.vCacheEntries[i].valid);
+		reader.get_i64(loaded.vCacheEntries[i].tag);
+		reader.get_double(loaded.vCacheEntries[i].count);
+	}
+	if(reader.ok() == false)
+		return false;
+
+	max_count = loaded.max_count;
+	sample_count = loaded.sample_count;
+	vCacheEntries.swap(loaded.vCacheEntries);
+	return true;
+}
+
+void ParameterExecSpread::save_snapshot(SnapshotWriter& writer) const {
+	writer.put_i64((long long)vExecSpreadBins.size());
+	for(int i=0; i<(int)vExecSpreadBins.size(); i++)
+		vExecSpreadBins[i].save_snapshot(writer);
+}
+
+bool ParameterExecSpread::load_snapshot(SnapshotReader& reader) {
+	long long num_spread_bins = 0;
+	if(reader.get_i64(num_spread_bins) == false || num_spread_bins != (long long)vExecSpreadBins.size())
+		return false;
+	std::vector<IntValueCache> vLoaded_bins(vExecSpreadBins.size());
+	for(int i=0; i<(int)vLoaded_bins.size(); i++) {
+		if(vLoaded_bins[i].load_snapshot(reader) == false)
+			return false;
+	}
+	vExecSpreadBins.swap(vLoaded_bins);
+	return true;
+}
+
 } //namespace Opp
@@ -12,6 +12,14 @@
 
 namespace Opp {
 
+	class SnapshotWriter;
+	class SnapshotReader;
+
+	typedef long long ParameterValue_t;
+		//value taken by a Parameter: an execution-time bin index, or a decision-vector key
+	typedef ParameterValue_t DecisionKey_t;
+		//mixed-radix encoding of an ExecFrame's decision-vector (see ExecFrameInfo::convert_decision_vector_to_int())
+
 
 	/////////////////////////////////
 	// Caching
@@ -20,13 +28,13 @@ namespace Opp {
 	class IntCacheEntry {
 	public:
 		bool valid;
-		int tag; //should be >= 0 when valid
+		ParameterValue_t tag; //should be >= 0 when valid
 		double count;
 
 		IntCacheEntry()
 			: valid(false), tag(-1), count(0.0) { }
 
-		inline void initialize(int new_tag) {
+		inline void initialize(ParameterValue_t new_tag) {
 			valid = true;
 			tag = new_tag;
 			count = 0.0;
@@ -82,7 +90,7 @@ namespace Opp {
 
 	public:
 		  //returns occurence-count of tag, 0.0 if tag does not occur
-		double tag_occurence_count(int tag) const {
+		double tag_occurence_count(ParameterValue_t tag) const {
 			for(int i=0; i<(int)vCacheEntries.size(); i++)
 				if(vCacheEntries[i].valid && vCacheEntries[i].tag == tag)
 					return vCacheEntries[i].count;
@@ -90,7 +98,7 @@ namespace Opp {
 		}
 
 		  //evicts if necessary to accomodate given tag
-		void note_sample(int tag, double add_count = 1.0) {
+		void note_sample(ParameterValue_t tag, double add_count = 1.0) {
 			int cache_entry_index = -1;
 			for(int i=0; i<(int)vCacheEntries.size(); i++) {
 				if(vCacheEntries[i].valid && vCacheEntries[i].tag == tag) {
@@ -172,6 +180,10 @@ namespace Opp {
 			}
 			sample_count = 0.0;
 		}
+
+		void save_snapshot(SnapshotWriter& writer) const;
+		bool load_snapshot(SnapshotReader& reader);
+			//restores state written by save_snapshot(), returns false if malformed
 	};
 
 	/////////////////////////////////
@@ -190,7 +202,7 @@ namespace Opp {
 
 		void note_spread_bin_occurence(
 			int exec_sample_spread_bin_index,
-			int occured_parameter_value_tag,
+			ParameterValue_t occured_parameter_value_tag,
 			double add_count = 1.0
 		)
 		{ vExecSpreadBins.at(exec_sample_spread_bin_index)
@@ -208,9 +220,9 @@ namespace Opp {
 		std::vector<int> get_complementary_bin_indices(std::vector<int> vGivenSpreadBinIndices);
 
 		void get_discriminating_values(
-			std::vector<int> vGivenSpreadBinIndices, //must not repeat bin-indices
+			const std::vector<int>& vGivenSpreadBinIndices, //must not repeat bin-indices
 			double FOR_discrimination_factor,            //between 0 .. 1, representing 0% - 100%
-			std::vector<int>& result_FOR_vValues,        //values discriminating FOR given-spread-bins
+			std::vector<ParameterValue_t>& result_FOR_vValues, //values discriminating FOR given-spread-bins
 			std::vector<double>& result_FOR_vCounts,     //occurence-counts of corresponding FOR discriminating values, normalized against total-sample-count of all spread bins
 			std::vector<double>& result_FOR_vProbs       //probability in favor of FOR, for corresponding discriminating values
 		);
@@ -223,6 +235,10 @@ namespace Opp {
 			double& max_D_statistic            // Defined if bIsRunExercising==true, gives the maximal D statistic between
 			                                   //    CDFs of parameter-value-probabilites across all execution-spread bins
 		);
+
+		void save_snapshot(SnapshotWriter& writer) const;
+		bool load_snapshot(SnapshotReader& reader);
+			//restores state written by save_snapshot(), returns false if malformed
 	};
 
 
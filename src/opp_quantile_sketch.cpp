@@ -0,0 +1,201 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#include <sstream>
+#include <algorithm>
+#include <cassert>
+
+#include "opp_quantile_sketch.h"
+
+namespace Opp {
+
+//////////////////////////////////////////
+//class P2QuantileEstimator definitions
+//////////////////////////////////////////
+
+void P2QuantileEstimator::initialize(double p) {
+	assert(0.0 < p && p < 1.0);
+	this->p = p;
+	count = 0;
+	for(int i=0; i<5; i++) {
+		q[i] = 0.0;
+		n[i] = i;
+	}
+
+	np[0] = 0.0; np[1] = 2.0 * p; np[2] = 4.0 * p; np[3] = 2.0 + 2.0 * p; np[4] = 4.0;
+	dn[0] = 0.0; dn[1] = p / 2.0; dn[2] = p; dn[3] = (1.0 + p) / 2.0; dn[4] = 1.0;
+}
+
+void P2QuantileEstimator::note_sample(double x) {
+	if(count < 5) { //collecting initial marker heights
+		q[count] = x;
+		count++;
+		if(count == 5)
+			std::sort(q, q + 5);
+		return;
+	}
+	count++;
+
+	//find cell k such that q[k] <= x < q[k+1], extending extreme markers if needed
+	int k;
+	if(x < q[0]) {
+		q[0] = x;
+		k = 0;
+	}
+	else if(x >= q[4]) {
+		q[4] = x;
+		k = 3;
+	}
+	else {
+		k = 0;
+		while(k < 3 && x >= q[k+1])
+			k++;
+	}
+
+	for(int i=k+1; i<5; i++)
+		n[i] += 1.0;
+	for(int i=0; i<5; i++)
+		np[i] += dn[i];
+
+	//adjust heights of middle markers if they are off their desired positions
+	for(int i=1; i<=3; i++) {
+		double d = np[i] - n[i];
+		if( (d >= 1.0 && n[i+1] - n[i] > 1.0) || (d <= -1.0 && n[i-1] - n[i] < -1.0) ) {
+			int sign = (d >= 0.0 ? +1 : -1);
+
+			//piecewise-parabolic prediction
+			double q_parabolic = q[i] + sign / (n[i+1] - n[i-1])
+				* ( (n[i] - n[i-1] + sign) * (q[i+1] - q[i]) / (n[i+1] - n[i])
+					+ (n[i+1] - n[i] - sign) * (q[i] - q[i-1]) / (n[i] - n[i-1]) );
+
+			if(q[i-1] < q_parabolic && q_parabolic < q[i+1])
+				q[i] = q_parabolic;
+			else //linear prediction
+				q[i] = q[i] + sign * (q[i+sign] - q[i]) / (n[i+sign] - n[i]);
+
+			n[i] += sign;
+		}
+	}
+}
+
+double P2QuantileEstimator::get_estimate() const {
+	if(count == 0)
+		return 0.0;
+
+	if(count < 5) { //exact quantile of the few samples seen
+		double sorted_q[5];
+		std::copy(q, q + count, sorted_q);
+		std::sort(sorted_q, sorted_q + count);
+		int index = int(p * (count - 1) + 0.5);
+		return sorted_q[index];
+	}
+
+	return q[2];
+}
+
+
+//////////////////////////////////////////
+//class StreamingQuantileSketch definitions
+//////////////////////////////////////////
+
+void StreamingQuantileSketch::initialize(const std::vector<double>& vQuantileProbs, int block_length) {
+	assert(block_length > 0);
+
+	this->vQuantileProbs = vQuantileProbs;
+	this->block_length = block_length;
+
+	vCurrentBlock.clear();
+	vPreviousBlock.clear();
+	for(int i=0; i<(int)vQuantileProbs.size(); i++) {
+		vCurrentBlock.push_back( P2QuantileEstimator(vQuantileProbs[i]) );
+		vPreviousBlock.push_back( P2QuantileEstimator(vQuantileProbs[i]) );
+	}
+}
+
+void StreamingQuantileSketch::note_sample(double x) {
+	if(vCurrentBlock.size() == 0)
+		return;
+
+	if(vCurrentBlock[0].get_sample_count() >= block_length) { //tumble
+		vPreviousBlock = vCurrentBlock;
+		for(int i=0; i<(int)vCurrentBlock.size(); i++)
+			vCurrentBlock[i].initialize(vQuantileProbs[i]);
+	}
+
+	for(int i=0; i<(int)vCurrentBlock.size(); i++)
+		vCurrentBlock[i].note_sample(x);
+}
+
+long long StreamingQuantileSketch::get_sample_count() const {
+	if(vCurrentBlock.size() == 0)
+		return 0;
+	return vCurrentBlock[0].get_sample_count() + vPreviousBlock[0].get_sample_count();
+}
+
+double StreamingQuantileSketch::get_quantile(int quantile_index) const {
+	const P2QuantileEstimator& current = vCurrentBlock.at(quantile_index);
+	const P2QuantileEstimator& previous = vPreviousBlock.at(quantile_index);
+
+	if(previous.get_sample_count() == 0)
+		return current.get_estimate();
+	if(current.get_sample_count() == 0)
+		return previous.get_estimate();
+
+	double current_weight = current.get_sample_count() / (double)block_length;
+	return current_weight * current.get_estimate() + (1.0 - current_weight) * previous.get_estimate();
+}
+
+std::string StreamingQuantileSketch::print_string() const {
+	std::ostringstream oss;
+	oss << "[";
+	for(int i=0; i<(int)vQuantileProbs.size(); i++)
+		oss << "p" << vQuantileProbs[i] * 100.0 << " = " << get_quantile(i) << ", ";
+	oss << "] over " << get_sample_count() << " samples";
+	return oss.str();
+}
+
+
+//////////////////////////////////////////
+//class WindowFractionCounter definitions
+//////////////////////////////////////////
+
+void WindowFractionCounter::initialize(int block_length) {
+	assert(block_length >= 0);
+	this->block_length = block_length;
+	current_hits = 0;
+	current_total = 0;
+	previous_hits = 0;
+	previous_total = 0;
+}
+
+void WindowFractionCounter::note_event(bool bHit) {
+	if(block_length > 0 && current_total >= block_length) { //tumble
+		previous_hits = current_hits;
+		previous_total = current_total;
+		current_hits = 0;
+		current_total = 0;
+	}
+
+	current_total++;
+	if(bHit)
+		current_hits++;
+}
+
+double WindowFractionCounter::get_sample_count() const {
+	if(block_length == 0)
+		return current_total;
+	double previous_weight = 1.0 - current_total / (double)block_length;
+	return current_total + previous_weight * previous_total;
+}
+
+double WindowFractionCounter::get_fraction() const {
+	double previous_weight = (block_length == 0 ? 0.0 : 1.0 - current_total / (double)block_length);
+	double hits = current_hits + previous_weight * previous_hits;
+	double total = current_total + previous_weight * previous_total;
+	if(total == 0.0)
+		return 0.0;
+	return hits / total;
+}
+
+} //namespace Opp
@@ -0,0 +1,103 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_QUANTILE_SKETCH_H
+#define OPP_QUANTILE_SKETCH_H
+
+#include <vector>
+#include <string>
+
+namespace Opp {
+
+	/////////////////////////////////
+	// Constant-memory streaming statistics over recent invocations
+	/////////////////////////////////
+
+	// P2QuantileEstimator: the P-Square algorithm (Jain and Chlamtac, CACM 1985) estimates
+	//   a single quantile of a stream with 5 markers, without storing the samples.
+
+	class P2QuantileEstimator {
+		double p;
+		long long count;
+		double q[5];   //marker heights
+		double n[5];   //actual marker positions (0-based)
+		double np[5];  //desired marker positions
+		double dn[5];  //increments to desired marker positions per sample
+
+	public:
+		P2QuantileEstimator(double p = 0.5)
+		{ initialize(p); }
+
+		void initialize(double p);
+
+		void note_sample(double x);
+
+		long long get_sample_count() const
+			{ return count; }
+
+		double get_estimate() const;
+			//0.0 if no samples noted
+	};
+
+
+	// StreamingQuantileSketch: estimates a fixed set of quantiles over approximately the last
+	//   'block_length' samples. Samples go into tumbling blocks of block_length, each
+	//   summarized by one P2QuantileEstimator per quantile. Estimates blend the current, partially
+	//   filled block with the previous complete block in proportion to how full the current block is.
+
+	class StreamingQuantileSketch {
+		std::vector<double> vQuantileProbs;
+		int block_length;
+
+		std::vector<P2QuantileEstimator> vCurrentBlock;
+		std::vector<P2QuantileEstimator> vPreviousBlock;
+
+	public:
+		StreamingQuantileSketch() : block_length(0) { }
+
+		void initialize(const std::vector<double>& vQuantileProbs, int block_length);
+
+		void note_sample(double x);
+
+		long long get_sample_count() const;
+			//number of samples represented by the estimates, at most 2 * block_length
+
+		double get_quantile(int quantile_index) const;
+			//estimate of quantile vQuantileProbs[quantile_index]
+
+		const std::vector<double>& get_quantile_probs() const
+			{ return vQuantileProbs; }
+
+		std::string print_string() const;
+	};
+
+
+	// WindowFractionCounter: fraction of approximately the last 'block_length' events that were hits,
+	//   using the same tumbling-block blending as StreamingQuantileSketch (block_length = 0 counts all events).
+
+	class WindowFractionCounter {
+		int block_length;
+
+		long long current_hits;
+		long long current_total;
+		long long previous_hits;
+		long long previous_total;
+
+	public:
+		WindowFractionCounter() { initialize(0); }
+
+		void initialize(int block_length);
+
+		void note_event(bool bHit);
+
+		double get_sample_count() const;
+			//(blended) number of events represented by get_fraction()
+
+		double get_fraction() const;
+			//0.0 if no events noted
+	};
+
+} //namespace Opp
+
+#endif //OPP_QUANTILE_SKETCH_H
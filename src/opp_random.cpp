@@ -0,0 +1,111 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#include <cmath>
+#include <cassert>
+
+#include "opp_random.h"
+
+namespace Opp {
+
+static unsigned long long random_base_seed = 0x5EED5EED12345678ULL;
+static unsigned long long random_thread_count = 0;
+	//number of threads that have seeded their state so far
+
+static __thread bool random_is_seeded = false;
+static __thread unsigned long long random_state[2];
+
+
+static unsigned long long splitmix64(unsigned long long& x) {
+	x += 0x9E3779B97F4A7C15ULL;
+	unsigned long long z = x;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static void seed_thread_state(unsigned long long seed) {
+	random_state[0] = splitmix64(seed);
+	random_state[1] = splitmix64(seed);
+	if(random_state[0] == 0 && random_state[1] == 0) //all-zero state is a fixed point of xorshift
+		random_state[1] = 1;
+	random_is_seeded = true;
+}
+
+void random_set_base_seed(unsigned long long seed) {
+	random_base_seed = seed;
+	seed_thread_state(seed);
+}
+
+unsigned long long random_next_u64() {
+	if(random_is_seeded == false) {
+		unsigned long long thread_index = __sync_fetch_and_add(&random_thread_count, 1ULL);
+		seed_thread_state(random_base_seed + thread_index * 0xD1B54A32D192ED03ULL);
+	}
+
+	unsigned long long s1 = random_state[0];
+	const unsigned long long s0 = random_state[1];
+	random_state[0] = s0;
+	s1 ^= s1 << 23;
+	random_state[1] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26);
+	return random_state[1] + s0;
+}
+
+double random_uniform() {
+	//top 53 bits fill the mantissa of a double exactly
+	return (random_next_u64() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double random_standard_normal() {
+	//Marsaglia polar method (second variate discarded to keep no extra per-thread state)
+	double u, v, s;
+	do {
+		u = 2.0 * random_uniform() - 1.0;
+		v = 2.0 * random_uniform() - 1.0;
+		s = u * u + v * v;
+	} while(s >= 1.0 || s == 0.0);
+	return u * sqrt(-2.0 * log(s) / s);
+}
+
+double random_gamma(double shape) {
+	assert(shape > 0.0);
+
+	if(shape < 1.0) {
+		//Gamma(a) = Gamma(a+1) * U^(1/a)
+		double u = random_uniform();
+		while(u == 0.0)
+			u = random_uniform();
+		return random_gamma(shape + 1.0) * pow(u, 1.0 / shape);
+	}
+
+	//Marsaglia and Tsang, "A Simple Method for Generating Gamma Variables", 2000
+	double d = shape - 1.0 / 3.0;
+	double c = 1.0 / sqrt(9.0 * d);
+	while(1) {
+		double x, v;
+		do {
+			x = random_standard_normal();
+			v = 1.0 + c * x;
+		} while(v <= 0.0);
+		v = v * v * v;
+
+		double u = random_uniform();
+		if(u < 1.0 - 0.0331 * (x * x) * (x * x))
+			return d * v;
+		if(u > 0.0 && log(u) < 0.5 * x * x + d * (1.0 - v + log(v)))
+			return d * v;
+	}
+}
+
+double random_beta(double alpha, double beta) {
+	assert(alpha > 0.0 && beta > 0.0);
+
+	double x = random_gamma(alpha);
+	double y = random_gamma(beta);
+	if(x + y == 0.0) //possible only on underflow for tiny shapes
+		return (alpha >= beta ? 1.0 : 0.0);
+	return x / (x + y);
+}
+
+} //namespace Opp
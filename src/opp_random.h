@@ -0,0 +1,39 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_RANDOM_H
+#define OPP_RANDOM_H
+
+namespace Opp {
+
+	/////////////////////////////////
+	// Per-thread Pseudo-Random Numbers
+	/////////////////////////////////
+
+	// xorshift128+ generator with state local to each thread, so that decision strategies
+	//   running in different threads neither contend on nor perturb a shared generator
+	//   (as std::rand() would). Each thread's state is seeded on first use from the base seed
+	//   and the order in which threads first draw a number, making single-threaded runs reproducible.
+
+	void random_set_base_seed(unsigned long long seed);
+		//Re-seeds the calling thread, and determines the seeds of threads that have not yet drawn a number.
+		//Default base seed is a fixed constant.
+
+	unsigned long long random_next_u64();
+
+	double random_uniform();
+		//uniform in [0.0, 1.0)
+
+	double random_standard_normal();
+		//mean 0.0, standard deviation 1.0
+
+	double random_gamma(double shape);
+		//Gamma(shape, scale = 1.0), shape > 0.0
+
+	double random_beta(double alpha, double beta);
+		//Beta(alpha, beta), alpha > 0.0, beta > 0.0
+
+} //namespace Opp
+
+#endif //OPP_RANDOM_H
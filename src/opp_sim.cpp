@@ -0,0 +1,604 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+// opp_sim: replays recorded costs through the decision strategies under a virtual clock, to evaluate
+//   controller settings in milliseconds instead of re-running the application for each of them.
+//
+// The simulated application mirrors samples/mpeg2enc_changes: a Frame with a mean-objective, running
+//   one ExecFrame with a single integer Knob per invocation. The knob's setting s costs cost[i][s] seconds
+//   of virtual time in the i-th invocation (setting 0 being the highest feature level).
+//
+// Usage: opp_sim.exe <cost_file> [options]
+//        opp_sim.exe -suite [options]
+//   cost_file: either a cost table, with one line per invocation listing the cost (in seconds) of each
+//     setting ('#' starts a comment), or a trace written by trace_open(). From a trace, the runs of one
+//     ExecFrame give the average cost of each decision (interpolated for decisions never run), and each run
+//     scales the costs of its invocation by how its decision's cost compared to that average.
+//     Decisions are taken as settings of a single knob, i.e. the ExecFrame must have one decision variable.
+//   cost_file may instead name a synthetic plant as plant:<name>, with 8 settings costing 10ms down to 3ms
+//     (before the workload factor, and +-3% noise) over 2000 invocations:
+//       step          workload factor steps from 1.0 to 1.5 at 1/3 of the invocations, and back at 2/3
+//       drift         workload factor drifts linearly from 0.7 to 1.4
+//       bursty        bursts of 1-5 invocations at workload factor 2.0, starting with probability 0.03
+//       bimodal       workload factor 0.7 or 1.3 at random in each invocation
+//       lag           as step, but a setting only affects the cost 3 invocations after it was chosen
+//       nonmonotonic  settings cost 10, 8, 9, 6, 7.5, 4.5, 6 and 3ms, i.e. lower feature levels are not always cheaper
+//   -suite runs every plant against every strategy (unless -strategy is given), labelling lines with the plant.
+//
+//   Options taking comma-separated lists sweep all combinations (as samples/run_mpeg2enc/run_exp.perl):
+//     -mean m,...             Objective mean in seconds (default: average cost of the middle setting)
+//     -window_frac f,...      Objective window fraction, both sides (default 0.2)
+//     -sliding_window n,...   Objective sliding window size (default 7)
+//     -coeff c,...            Fast Reaction Strategy coefficient, -1 = initial guess rescaled by the strategy (default -1)
+//     -srt l,...              -1 = setting decided by SRT, k >= 0 = fixed at setting k (default -1)
+//     -strategy s,...         frs, thompson or rl (default frs)
+//   and
+//     -frames N               number of invocations to replay, cycling through the costs (default: one pass)
+//     -execframe id           trace input: ExecFrame whose runs to replay (default: that of the first run recorded)
+//     -jobs J                 sweep points simulated concurrently, in separate processes (default: number of cores)
+//
+// Prints one line per sweep point: its settings, then
+//   satisfaction = fraction of invocations whose sliding-window average execution-time met the objective window,
+//   jitter = average change in execution-time between consecutive invocations, relative to the objective mean,
+//   feature_level = average of 1 - setting/(num_settings-1), i.e. 1.0 if the highest feature level was always used,
+//   convergence = invocations after each step of a step or lag plant until the sliding-window average stays within
+//     the objective window for sliding_window invocations, averaged over the steps (-1 if some step never settled,
+//     - for plants without steps),
+//   halfcycles = swings of the execution-time from below the objective window to above it, or back,
+//   overhead_us = real time per invocation in microseconds, i.e. the controller's own overhead (costs being virtual),
+//   frames_per_ms = invocations replayed per millisecond of real time.
+// The last two measure the library as built: the Makefile's default CFLAGS do not optimize, so build with
+//   make CFLAGS="-Wall -O2" for the overhead of a release build (about 1000 frames/ms for the Fast Reaction Strategy).
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <list>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "opp.h"
+#include "opp_debug_control.h"
+#include "opp_timing.h"
+#include "opp_trace.h"
+
+static std::vector< std::vector<double> > vvCost; //[invocation][setting]
+
+static int sim_lag = 0;
+	//invocations before a chosen setting affects the cost
+static std::vector<long long> vStepInvocations;
+	//invocations at which the cost steps, for measuring convergence
+
+static bool read_cost_table(const std::string& filename) {
+	std::ifstream ifs(filename.c_str());
+	if(!ifs)
+		return false;
+
+	std::string line;
+	while(std::getline(ifs, line)) {
+		std::string::size_type comment = line.find('#');
+		if(comment != std::string::npos)
+			line.erase(comment);
+
+		std::istringstream iss(line);
+		std::vector<double> vRow;
+		double cost;
+		while(iss >> cost)
+			vRow.push_back(cost);
+		if(vRow.empty())
+			continue;
+		if(vvCost.size() > 0 && vRow.size() != vvCost[0].size()) {
+			std::cerr << "opp_sim: ERROR: '" << filename << "' invocation #" << vvCost.size() << " has " << vRow.size()
+				<< " costs, previous invocations had " << vvCost[0].size() << std::endl;
+			exit(1);
+		}
+		vvCost.push_back(vRow);
+	}
+	return vvCost.size() > 0;
+}
+
+static bool read_trace(const std::string& filename, long long execframe_id) {
+	Opp::TraceReader reader;
+	if(reader.open(filename) == false)
+		return false;
+
+	std::vector<long long> vKey;
+	std::vector<double> vDuration;
+	for(int r=0; r<(int)reader.get_records().size(); r++) {
+		const Opp::TraceRecord& rec = reader.get_records()[r];
+		if(rec.record_type != Opp::TraceEXECFRAME_RUN || rec.decision_key < 0)
+			continue;
+		if(execframe_id == -1)
+			execframe_id = rec.frame_id;
+		if(rec.frame_id != execframe_id)
+			continue;
+		vKey.push_back(rec.decision_key);
+		vDuration.push_back(rec.active_duration);
+	}
+	if(vKey.empty()) {
+		std::cerr << "opp_sim: ERROR: trace '" << filename << "' has no runs of ExecFrame #" << execframe_id << std::endl;
+		exit(1);
+	}
+
+	int num_settings = 0;
+	for(int i=0; i<(int)vKey.size(); i++)
+		num_settings = std::max(num_settings, (int)vKey[i] + 1);
+
+	std::vector<double> vSum(num_settings, 0.0);
+	std::vector<int> vCount(num_settings, 0);
+	for(int i=0; i<(int)vKey.size(); i++) {
+		vSum[vKey[i]] += vDuration[i];
+		vCount[vKey[i]]++;
+	}
+
+	//average cost per setting, linearly interpolated (or held constant beyond the ends) for settings never run
+	std::vector<double> vAverage(num_settings, 0.0);
+	std::vector<int> vObserved;
+	for(int s=0; s<num_settings; s++) {
+		if(vCount[s] > 0) {
+			vAverage[s] = vSum[s] / vCount[s];
+			vObserved.push_back(s);
+		}
+	}
+	for(int s=0; s<num_settings; s++) {
+		if(vCount[s] > 0)
+			continue;
+		int lower = -1, upper = -1;
+		for(int k=0; k<(int)vObserved.size(); k++) {
+			if(vObserved[k] < s)
+				lower = vObserved[k];
+			else if(upper == -1)
+				upper = vObserved[k];
+		}
+		if(lower == -1)
+			vAverage[s] = vAverage[upper];
+		else if(upper == -1)
+			vAverage[s] = vAverage[lower];
+		else
+			vAverage[s] = vAverage[lower] + (vAverage[upper] - vAverage[lower]) * (s - lower) / (double)(upper - lower);
+	}
+
+	for(int i=0; i<(int)vKey.size(); i++) {
+		double workload_factor = (vAverage[vKey[i]] > 0.0 ? vDuration[i] / vAverage[vKey[i]] : 1.0);
+		std::vector<double> vRow(num_settings);
+		for(int s=0; s<num_settings; s++)
+			vRow[s] = vAverage[s] * workload_factor;
+		vvCost.push_back(vRow);
+	}
+
+	std::cerr << "opp_sim: replaying " << vKey.size() << " runs of ExecFrame #" << execframe_id << " from trace '"
+		<< filename << "' (" << reader.get_num_lost_records() << " records lost)" << std::endl;
+	return true;
+}
+
+
+
+////////////////////////////
+// Synthetic plants
+////////////////////////////
+
+static const int num_plants = 6;
+static const char * plant_names[num_plants] = {"step", "drift", "bursty", "bimodal", "lag", "nonmonotonic"};
+static const int plant_num_settings = 8;
+static const long long plant_length = 2000;
+
+static unsigned long long plant_random_state = 1;
+
+static double plant_random_uniform() { //[0, 1), the same sequence in every run
+	plant_random_state = plant_random_state * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (plant_random_state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static bool make_plant(const std::string& name) {
+	vvCost.clear();
+	vStepInvocations.clear();
+	sim_lag = 0;
+	plant_random_state = 1;
+
+	static const double nonmonotonic_ms[plant_num_settings] = {10.0, 8.0, 9.0, 6.0, 7.5, 4.5, 6.0, 3.0};
+	std::vector<double> vBase(plant_num_settings);
+	for(int s=0; s<plant_num_settings; s++)
+		vBase[s] = (name == "nonmonotonic" ? nonmonotonic_ms[s] * 0.001 : 0.010 - 0.001 * s);
+
+	if(name == "step" || name == "lag") {
+		vStepInvocations.push_back(plant_length / 3);
+		vStepInvocations.push_back(2 * plant_length / 3);
+	}
+	if(name == "lag")
+		sim_lag = 3;
+
+	int burst_remaining = 0;
+	for(long long i=0; i<plant_length; i++) {
+		double factor = 1.0;
+		if(name == "step" || name == "lag")
+			factor = (i >= vStepInvocations[0] && i < vStepInvocations[1] ? 1.5 : 1.0);
+		else if(name == "drift")
+			factor = 0.7 + 0.7 * i / (double)(plant_length - 1);
+		else if(name == "bursty") {
+			if(burst_remaining == 0 && plant_random_uniform() < 0.03)
+				burst_remaining = 1 + (int)(plant_random_uniform() * 5);
+			if(burst_remaining > 0) {
+				factor = 2.0;
+				burst_remaining--;
+			}
+		}
+		else if(name == "bimodal")
+			factor = (plant_random_uniform() < 0.5 ? 0.7 : 1.3);
+		else if(name != "nonmonotonic")
+			return false;
+
+		factor *= 1.0 + 0.06 * (plant_random_uniform() - 0.5);
+		std::vector<double> vRow(plant_num_settings);
+		for(int s=0; s<plant_num_settings; s++)
+			vRow[s] = vBase[s] * factor;
+		vvCost.push_back(vRow);
+	}
+	return true;
+}
+
+
+struct SweepPoint {
+	double mean;
+	double window_frac;
+	int sliding_window;
+	double coeff;
+	int srt;
+	std::string strategy;
+};
+
+struct SimResult {
+	double satisfaction;
+	double jitter;
+	double feature_level;
+	double convergence; //-2 if no steps
+	long long halfcycles;
+	double overhead_us;
+	double frames_per_ms;
+};
+
+static long long sim_invocation_index = 0;
+static int sim_chosen_setting = 0;
+static std::vector<int> vSim_chosen_settings; //for plants with control lag
+
+static void apply_setting(double knob_value) {
+	int num_settings = (int)vvCost[0].size();
+	int setting = (int)floor(knob_value + 0.5);
+	if(setting < 0)
+		setting = 0;
+	if(setting > num_settings - 1)
+		setting = num_settings - 1;
+	sim_chosen_setting = setting;
+
+	int effective_setting = setting;
+	if(sim_lag > 0) {
+		vSim_chosen_settings.push_back(setting);
+		effective_setting = vSim_chosen_settings[ std::max(0, (int)vSim_chosen_settings.size() - 1 - sim_lag) ];
+	}
+	Opp::timing_advance_virtual_clock( vvCost[sim_invocation_index % vvCost.size()][effective_setting] );
+}
+
+static SimResult simulate(const SweepPoint& point, long long num_frames) {
+	Opp::feature_control_debug_message_level(Opp::DebugMsgNONE);
+	Opp::timing_use_virtual_clock(true);
+	Opp::feature_control_use_fast_reaction_strategy(point.strategy == "frs");
+	Opp::feature_control_use_thompson_sampling_strategy(point.strategy == "thompson");
+
+	int num_settings = (int)vvCost[0].size();
+	std::vector<Opp::Model> vM;
+	vM.push_back( Opp::Model::integer_knob(0, apply_setting, 0, num_settings - 1, point.srt,
+		(point.coeff == -1.0 ? 0.0 : point.coeff)) );
+	Opp::Model model(vM);
+
+	Opp::Frame frame(Opp::Objective(point.mean, point.window_frac, point.window_frac, 0.90, point.sliding_window));
+	Opp::ExecFrame execframe(model);
+	execframe.force_default_selection(point.srt >= 0);
+	execframe.force_fast_reaction_strategy_fixed_coeff(point.coeff != -1.0);
+
+	std::list<double> listWindow;
+	double window_sum = 0.0;
+	long long num_satisfied = 0;
+	double sum_abs_change = 0.0;
+	double sum_feature_level = 0.0;
+	double previous_exec_time = 0.0;
+	std::vector<bool> vSatisfied;
+	long long halfcycles = 0;
+	int side = 0; //+1 above the objective window, -1 below, 0 before leaving it the first time
+	vSim_chosen_settings.clear();
+
+	timeval real_start = Opp::get_real_timeval();
+	for(sim_invocation_index = 0; sim_invocation_index < num_frames; sim_invocation_index++) {
+		double start = Opp::timing_get_virtual_clock();
+		Opp::frame_enter(frame.id);
+		execframe.run();
+		Opp::frame_exit_complete(frame.id);
+		double exec_time = Opp::timing_get_virtual_clock() - start;
+
+		listWindow.push_back(exec_time);
+		window_sum += exec_time;
+		if((int)listWindow.size() > point.sliding_window) {
+			window_sum -= listWindow.front();
+			listWindow.pop_front();
+		}
+		double window_average = window_sum / listWindow.size();
+		bool bSatisfied = (window_average >= point.mean * (1.0 - point.window_frac) && window_average <= point.mean * (1.0 + point.window_frac));
+		if(bSatisfied)
+			num_satisfied++;
+		vSatisfied.push_back(bSatisfied);
+
+		int new_side = (exec_time > point.mean * (1.0 + point.window_frac) ? +1
+						: (exec_time < point.mean * (1.0 - point.window_frac) ? -1 : side));
+		if(side != 0 && new_side != side)
+			halfcycles++;
+		side = new_side;
+
+		if(sim_invocation_index > 0)
+			sum_abs_change += fabs(exec_time - previous_exec_time);
+		previous_exec_time = exec_time;
+
+		sum_feature_level += (num_settings > 1 ? 1.0 - sim_chosen_setting / (double)(num_settings - 1) : 1.0);
+	}
+	double real_elapsed = Opp::diff_time(real_start, Opp::get_real_timeval());
+
+	//convergence: after each step, invocations until sliding_window consecutive satisfied ones start
+	double convergence = -2.0;
+	int num_steps = 0;
+	for(int k=0; k<(int)vStepInvocations.size() && vStepInvocations[k] < num_frames; k++) {
+		long long next_step = (k + 1 < (int)vStepInvocations.size() ? std::min(vStepInvocations[k + 1], num_frames) : num_frames);
+		long long settled = -1;
+		long long run_length = 0;
+		for(long long i=vStepInvocations[k]; i<next_step && settled == -1; i++) {
+			run_length = (vSatisfied[i] ? run_length + 1 : 0);
+			if(run_length >= point.sliding_window)
+				settled = i + 1 - run_length;
+		}
+		if(num_steps == 0)
+			convergence = 0.0;
+		num_steps++;
+		if(convergence < 0.0 || settled == -1)
+			convergence = -1.0;
+		else
+			convergence += settled - vStepInvocations[k];
+	}
+	if(convergence > 0.0)
+		convergence /= num_steps;
+
+	SimResult result;
+	result.satisfaction = num_satisfied / (double)num_frames;
+	result.jitter = (num_frames > 1 ? sum_abs_change / (num_frames - 1) / point.mean : 0.0);
+	result.feature_level = sum_feature_level / num_frames;
+	result.convergence = convergence;
+	result.halfcycles = halfcycles;
+	result.overhead_us = real_elapsed * 1.0e6 / num_frames;
+	result.frames_per_ms = (real_elapsed > 0.0 ? num_frames / (real_elapsed * 1000.0) : 0.0);
+	return result;
+}
+
+
+static std::vector<std::string> split_list(const std::string& list) {
+	std::vector<std::string> vItems;
+	std::istringstream iss(list);
+	std::string item;
+	while(std::getline(iss, item, ','))
+		if(item.empty() == false)
+			vItems.push_back(item);
+	return vItems;
+}
+
+static std::vector<double> parse_double_list(const std::string& option, const std::string& list) {
+	std::vector<std::string> vItems = split_list(list);
+	std::vector<double> vValues;
+	for(int i=0; i<(int)vItems.size(); i++) {
+		char * end;
+		double value = strtod(vItems[i].c_str(), &end);
+		if(*end != '\0') {
+			std::cerr << "opp_sim: ERROR: " << option << " expects numbers, given '" << vItems[i] << "'" << std::endl;
+			exit(1);
+		}
+		vValues.push_back(value);
+	}
+	if(vValues.empty()) {
+		std::cerr << "opp_sim: ERROR: " << option << " given no values" << std::endl;
+		exit(1);
+	}
+	return vValues;
+}
+
+static void usage() {
+	std::cerr << "Usage: opp_sim.exe <cost_file>|plant:<name>|-suite [-mean m,...] [-window_frac f,...] [-sliding_window n,...]" << std::endl
+		<< "         [-coeff c,...] [-srt l,...] [-strategy frs|thompson|rl,...] [-frames N] [-execframe id] [-jobs J]" << std::endl
+		<< "  (see opp_sim.cpp for details)" << std::endl;
+	exit(1);
+}
+
+
+struct SweepOptions {
+	std::vector<double> vMean; //empty for the default
+	std::vector<double> vWindowFrac;
+	std::vector<double> vSlidingWindow;
+	std::vector<double> vCoeff;
+	std::vector<double> vSrt;
+	std::vector<std::string> vStrategy;
+	long long num_frames; //0 for one pass
+	int num_jobs;
+};
+
+//Simulates every sweep point on the costs in vvCost, printing a line per point prefixed by label (if not empty).
+//  Returns false if a simulation failed.
+static bool run_sweep(const std::string& label, const SweepOptions& options) {
+	long long num_frames = (options.num_frames > 0 ? options.num_frames : (long long)vvCost.size());
+
+	int num_settings = (int)vvCost[0].size();
+	std::vector<double> vMean = options.vMean;
+	if(vMean.empty()) {
+		double sum = 0.0;
+		for(int i=0; i<(int)vvCost.size(); i++)
+			sum += vvCost[i][num_settings / 2];
+		vMean.push_back(sum / vvCost.size());
+	}
+
+	std::vector<SweepPoint> vPoints;
+	for(int st=0; st<(int)options.vStrategy.size(); st++)
+	for(int l=0; l<(int)options.vSrt.size(); l++)
+	for(int m=0; m<(int)vMean.size(); m++)
+	for(int w=0; w<(int)options.vWindowFrac.size(); w++)
+	for(int sw=0; sw<(int)options.vSlidingWindow.size(); sw++)
+	for(int c=0; c<(int)options.vCoeff.size(); c++) {
+		SweepPoint point;
+		point.mean = vMean[m];
+		point.window_frac = options.vWindowFrac[w];
+		point.sliding_window = (int)options.vSlidingWindow[sw];
+		point.coeff = options.vCoeff[c];
+		point.srt = (int)options.vSrt[l];
+		point.strategy = options.vStrategy[st];
+		if(point.srt >= num_settings) {
+			std::cerr << "opp_sim: ERROR: -srt " << point.srt << " is not one of the " << num_settings << " settings" << std::endl;
+			exit(1);
+		}
+		vPoints.push_back(point);
+		if(point.srt >= 0)
+			break; //fixed settings do not use coeff
+	}
+
+	//Each sweep point is simulated in a child process, as the library's state is global.
+	//  The child writes its SimResult into a pipe, well within the pipe's capacity.
+	std::vector<int> vPipe_fd(vPoints.size(), -1);
+	int num_running = 0;
+	for(int p=0; p<=(int)vPoints.size(); p++) {
+		while(num_running > 0 && (num_running >= options.num_jobs || p == (int)vPoints.size())) {
+			int status;
+			if(wait(&status) > 0)
+				num_running--;
+		}
+		if(p == (int)vPoints.size())
+			break;
+
+		int fds[2];
+		if(pipe(fds) != 0) {
+			std::cerr << "opp_sim: ERROR: pipe() failed" << std::endl;
+			exit(1);
+		}
+		pid_t pid = fork();
+		if(pid < 0) {
+			std::cerr << "opp_sim: ERROR: fork() failed" << std::endl;
+			exit(1);
+		}
+		if(pid == 0) {
+			close(fds[0]);
+			SimResult result = simulate(vPoints[p], num_frames);
+			ssize_t written = write(fds[1], &result, sizeof(result));
+			_exit(written == (ssize_t)sizeof(result) ? 0 : 1);
+		}
+		close(fds[1]);
+		vPipe_fd[p] = fds[0];
+		num_running++;
+	}
+
+	printf("# %s%d settings, %lld invocations per sweep point\n", (label.empty() ? "" : (label + ": ").c_str()), num_settings, num_frames);
+	bool bSucceeded = true;
+	for(int p=0; p<(int)vPoints.size(); p++) {
+		const SweepPoint& point = vPoints[p];
+		if(label.empty() == false)
+			printf("%s ", label.c_str());
+		printf("%s %d %g %g %d %g : ", point.strategy.c_str(), point.srt, point.mean, point.window_frac, point.sliding_window, point.coeff);
+		SimResult result;
+		if(read(vPipe_fd[p], &result, sizeof(result)) == (ssize_t)sizeof(result)) {
+			printf("%.4f %.4f %.4f ", result.satisfaction, result.jitter, result.feature_level);
+			if(result.convergence == -2.0)
+				printf("- ");
+			else
+				printf("%.1f ", result.convergence);
+			printf("%lld %.2f %.1f\n", result.halfcycles, result.overhead_us, result.frames_per_ms);
+		}
+		else {
+			printf("FAILED\n");
+			bSucceeded = false;
+		}
+		close(vPipe_fd[p]);
+	}
+	fflush(stdout);
+	return bSucceeded;
+}
+
+int main(int argc, char * argv[]) {
+	if(argc < 2)
+		usage();
+	std::string cost_filename = argv[1];
+	bool bSuite = (cost_filename == "-suite");
+
+	SweepOptions options;
+	options.vWindowFrac.assign(1, 0.2);
+	options.vSlidingWindow.assign(1, 7);
+	options.vCoeff.assign(1, -1.0);
+	options.vSrt.assign(1, -1);
+	options.num_frames = 0;
+	options.num_jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	long long execframe_id = -1;
+
+	for(int a=2; a<argc; a++) {
+		std::string option = argv[a];
+		if(a + 1 >= argc)
+			usage();
+		std::string value = argv[++a];
+
+		if(option == "-mean") options.vMean = parse_double_list(option, value);
+		else if(option == "-window_frac") options.vWindowFrac = parse_double_list(option, value);
+		else if(option == "-sliding_window") options.vSlidingWindow = parse_double_list(option, value);
+		else if(option == "-coeff") options.vCoeff = parse_double_list(option, value);
+		else if(option == "-srt") options.vSrt = parse_double_list(option, value);
+		else if(option == "-strategy") options.vStrategy = split_list(value);
+		else if(option == "-frames") options.num_frames = atoll(value.c_str());
+		else if(option == "-execframe") execframe_id = atoll(value.c_str());
+		else if(option == "-jobs") options.num_jobs = atoi(value.c_str());
+		else usage();
+	}
+	if(options.vStrategy.empty()) {
+		if(bSuite) {
+			options.vStrategy.push_back("frs");
+			options.vStrategy.push_back("thompson");
+			options.vStrategy.push_back("rl");
+		}
+		else
+			options.vStrategy.push_back("frs");
+	}
+	for(int i=0; i<(int)options.vStrategy.size(); i++) {
+		if(options.vStrategy[i] != "frs" && options.vStrategy[i] != "thompson" && options.vStrategy[i] != "rl") {
+			std::cerr << "opp_sim: ERROR: unknown strategy '" << options.vStrategy[i] << "'" << std::endl;
+			exit(1);
+		}
+	}
+	if(options.num_jobs < 1)
+		options.num_jobs = 1;
+
+	if(bSuite) {
+		printf("# plant strategy srt mean window_frac sliding_window coeff : satisfaction jitter feature_level convergence halfcycles overhead_us frames_per_ms\n");
+		bool bSucceeded = true;
+		for(int p=0; p<num_plants; p++) {
+			make_plant(plant_names[p]);
+			if(run_sweep(plant_names[p], options) == false)
+				bSucceeded = false;
+		}
+		return bSucceeded ? 0 : 1;
+	}
+
+	if(cost_filename.compare(0, 6, "plant:") == 0) {
+		if(make_plant(cost_filename.substr(6)) == false) {
+			std::cerr << "opp_sim: ERROR: unknown plant '" << cost_filename.substr(6) << "'" << std::endl;
+			exit(1);
+		}
+	}
+	else if(read_trace(cost_filename, execframe_id) == false && read_cost_table(cost_filename) == false) {
+		std::cerr << "opp_sim: ERROR: could not read a cost table or trace from '" << cost_filename << "'" << std::endl;
+		exit(1);
+	}
+
+	printf("# strategy srt mean window_frac sliding_window coeff : satisfaction jitter feature_level convergence halfcycles overhead_us frames_per_ms\n");
+	return run_sweep("", options) ? 0 : 1;
+}
@@ -0,0 +1,474 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cassert>
+
+#include "opp_snapshot.h"
+#include "opp_baseframe.h"
+#include "opp_frame_info.h"
+#include "opp_execframe.h"
+#include "opp_utilities.h"
+
+namespace Opp {
+
+static const char snapshot_magic[8] = {'O', 'P', 'P', 'S', 'N', 'A', 'P', '\0'};
+static const unsigned int snapshot_byte_order_marker = 0x01020304;
+
+
+////////////////////////////////////
+//class SnapshotWriter definitions
+////////////////////////////////////
+
+void SnapshotWriter::put_i64(long long x) {
+	char bytes[sizeof(long long)];
+	memcpy(bytes, &x, sizeof(long long));
+	buf.append(bytes, sizeof(long long));
+}
+
+void SnapshotWriter::put_double(double x) {
+	char bytes[sizeof(double)];
+	memcpy(bytes, &x, sizeof(double));
+	buf.append(bytes, sizeof(double));
+}
+
+void SnapshotWriter::put_string(const std::string& s) {
+	put_i64((long long)s.size());
+	buf.append(s);
+}
+
+void SnapshotWriter::put_vector(const std::vector<double>& v) {
+	put_i64((long long)v.size());
+	for(int i=0; i<(int)v.size(); i++)
+		put_double(v[i]);
+}
+
+void SnapshotWriter::put_vector(const std::vector<long long>& v) {
+	put_i64((long long)v.size());
+	for(int i=0; i<(int)v.size(); i++)
+		put_i64(v[i]);
+}
+
+void SnapshotWriter::put_vector(const std::vector<int>& v) {
+	put_i64((long long)v.size());
+	for(int i=0; i<(int)v.size(); i++)
+		put_i64(v[i]);
+}
+
+void SnapshotWriter::put_pair_vector(const std::vector< std::pair<double, double> >& v) {
+	put_i64((long long)v.size());
+	for(int i=0; i<(int)v.size(); i++) {
+		put_double(v[i].first);
+		put_double(v[i].second);
+	}
+}
+
+void SnapshotWriter::put_pair_map(const std::map<long long, std::pair<double, double> >& m) {
+	put_i64((long long)m.size());
+	for(std::map<long long, std::pair<double, double> >::const_iterator mit = m.begin(); mit != m.end(); mit++) {
+		put_i64(mit->first);
+		put_double(mit->second.first);
+		put_double(mit->second.second);
+	}
+}
+
+
+////////////////////////////////////
+//class SnapshotReader definitions
+////////////////////////////////////
+
+bool SnapshotReader::get_bytes(void * dest, size_t num_bytes) {
+	if(bOk == false || buf.size() - pos < num_bytes) {
+		bOk = false;
+		return false;
+	}
+	memcpy(dest, buf.data() + pos, num_bytes);
+	pos += num_bytes;
+	return true;
+}
+
+bool SnapshotReader::get_length(long long& n, size_t min_bytes_per_element) {
+	if(get_bytes(&n, sizeof(long long)) == false)
+		return false;
+	if(n < 0 || (unsigned long long)n > (buf.size() - pos) / min_bytes_per_element)
+		bOk = false; //cannot possibly fit in what remains
+	return bOk;
+}
+
+bool SnapshotReader::get_i64(long long& x)
+	{ return get_bytes(&x, sizeof(long long)); }
+
+bool SnapshotReader::get_int(int& x) {
+	long long y = 0;
+	if(get_i64(y))
+		x = (int)y;
+	return bOk;
+}
+
+bool SnapshotReader::get_double(double& x)
+	{ return get_bytes(&x, sizeof(double)); }
+
+bool SnapshotReader::get_bool(bool& x) {
+	long long y = 0;
+	if(get_i64(y))
+		x = (y != 0);
+	return bOk;
+}
+
+bool SnapshotReader::get_string(std::string& s) {
+	long long n = 0;
+	if(get_length(n, 1) == false)
+		return false;
+	s.assign(buf, pos, (size_t)n);
+	pos += (size_t)n;
+	return true;
+}
+
+bool SnapshotReader::get_vector(std::vector<double>& v) {
+	long long n = 0;
+	if(get_length(n, sizeof(double)) == false)
+		return false;
+	v.resize((size_t)n);
+	for(int i=0; i<(int)n; i++)
+		get_double(v[i]);
+	return bOk;
+}
+
+bool SnapshotReader::get_vector(std::vector<long long>& v) {
+	long long n = 0;
+	if(get_length(n, sizeof(long long)) == false)
+		return false;
+	v.resize((size_t)n);
+	for(int i=0; i<(int)n; i++)
+		get_i64(v[i]);
+	return bOk;
+}
+
+bool SnapshotReader::get_vector(std::vector<int>& v) {
+	long long n = 0;
+	if(get_length(n, sizeof(long long)) == false)
+		return false;
+	v.resize((size_t)n);
+	for(int i=0; i<(int)n; i++)
+		get_int(v[i]);
+	return bOk;
+}
+
+bool SnapshotReader::get_pair_vector(std::vector< std::pair<double, double> >& v) {
+	long long n = 0;
+	if(get_length(n, 2 * sizeof(double)) == false)
+		return false;
+	v.resize((size_t)n);
+	for(int i=0; i<(int)n; i++) {
+		get_double(v[i].first);
+		get_double(v[i].second);
+	}
+	return bOk;
+}
+
+bool SnapshotReader::get_pair_map(std::map<long long, std::pair<double, double> >& m) {
+	long long n = 0;
+	if(get_length(n, sizeof(long long) + 2 * sizeof(double)) == false)
+		return false;
+	m.clear();
+	for(int i=0; i<(int)n; i++) {
+		long long key = 0;
+		std::pair<double, double> value(0.0, 0.0);
+		get_i64(key);
+		get_double(value.first);
+		get_double(value.second);
+		m[key] = value;
+	}
+	return bOk;
+}
+
+
+/////////////////////////////////
+// Snapshot records
+/////////////////////////////////
+
+typedef std::pair<std::string, std::string> ConsumerSourceNames_t;
+
+static std::map<std::string, std::string> map_frame_name_to_loaded_record;
+static std::map<ConsumerSourceNames_t, std::string> map_consumer_source_names_to_loaded_record;
+	//payloads read by snapshot_load() and not yet restored in the current run
+
+static std::string autosave_filename; //empty if autosave not set
+static int autosave_period = 0;
+static long long autosave_top_level_completions = 0;
+
+
+//shapes the frame record of frame depends on
+static std::vector<int> get_frame_signature(Frame * frame) {
+	std::vector<int> vSignature;
+	vSignature.push_back( FrameInfo::get_frame_info(frame)->decision_model.exec_time_parameter_num_spread_bins );
+	return vSignature;
+}
+
+//shapes the consumer record of parm (sourced from parm->source) in consumer depends on
+static std::vector<int> get_consumer_signature(Frame * consumer, Parameter * parm) {
+	std::vector<int> vSignature;
+	vSignature.push_back( FrameInfo::get_frame_info(consumer)->decision_model.exec_time_parameter_num_spread_bins );
+	vSignature.push_back( (int)parm->source->get_type() );
+	if(parm->source->get_type() == BaseFrame::EXECFRAME) { //decision-vector parameter: range of each decision-variable
+		ExecFrameInfo * execframe_info = ExecFrameInfo::get_execframe_info( dynamic_cast<ExecFrame *>(parm->source) );
+		for(int i=0; i<(int)execframe_info->vVarPriority.size(); i++)
+			vSignature.push_back( (int)execframe_info->vVarPriority[i].size() );
+	}
+	return vSignature;
+}
+
+static std::string save_frame_record(Frame * frame) {
+	FrameDecisionModel& frame_dec = FrameInfo::get_frame_info(frame)->decision_model;
+
+	SnapshotWriter writer;
+	writer.put_vector( get_frame_signature(frame) );
+	frame_dec.exec_time_record.save_snapshot(writer);
+	writer.put_double(frame_dec.recent_exec_time);
+	writer.put_double(frame_dec.previous_invocation_exec_time);
+	return writer.get_buffer();
+}
+
+static std::string save_consumer_record(Frame * consumer, Parameter * parm) {
+	FrameDecisionModel& consumer_dec = FrameInfo::get_frame_info(consumer)->decision_model;
+	assert(consumer_dec.map_parm_to_spread.count(parm) == 1);
+
+	SnapshotWriter writer;
+	writer.put_vector( get_consumer_signature(consumer, parm) );
+	consumer_dec.map_parm_to_spread[parm]->save_snapshot(writer);
+	consumer_dec.map_parm_to_thompson_model[parm]->save_snapshot(writer);
+	consumer_dec.map_parm_to_fast_reaction_state[parm]->save_snapshot(writer);
+	return writer.get_buffer();
+}
+
+void snapshot_restore_frame_state(Frame * frame) {
+	if(frame->name.empty())
+		return;
+	std::map<std::string, std::string>::iterator mit = map_frame_name_to_loaded_record.find(frame->name);
+	if(mit == map_frame_name_to_loaded_record.end())
+		return;
+
+	FrameDecisionModel& frame_dec = FrameInfo::get_frame_info(frame)->decision_model;
+
+	SnapshotReader reader(mit->second);
+	std::vector<int> vSignature;
+	IntValueCache exec_time_record;
+	double recent_exec_time = 0.0;
+	double previous_invocation_exec_time = 0.0;
+
+	reader.get_vector(vSignature);
+	bool bRestored = (reader.ok() && vSignature == get_frame_signature(frame));
+	if(bRestored) {
+		bRestored = exec_time_record.load_snapshot(reader);
+		reader.get_double(recent_exec_time);
+		reader.get_double(previous_invocation_exec_time);
+		bRestored = (bRestored && reader.ok() && reader.at_end());
+	}
+	if(bRestored) {
+		frame_dec.exec_time_record = exec_time_record;
+		frame_dec.recent_exec_time = recent_exec_time;
+		frame_dec.previous_invocation_exec_time = previous_invocation_exec_time;
+	}
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "snapshot_restore_frame_state(): Frame '" << frame->name << "' "
+		<< (bRestored ? "restored" : "NOT restored: record malformed or learned for a different objective")
+		<< std::endl;
+
+	map_frame_name_to_loaded_record.erase(mit);
+}
+
+void snapshot_restore_consumer_state(Frame * consumer, Parameter * parm) {
+	if(consumer->name.empty() || parm->source->name.empty())
+		return;
+	std::map<ConsumerSourceNames_t, std::string>::iterator mit
+		= map_consumer_source_names_to_loaded_record.find( ConsumerSourceNames_t(consumer->name, parm->source->name) );
+	if(mit == map_consumer_source_names_to_loaded_record.end())
+		return;
+
+	FrameDecisionModel& consumer_dec = FrameInfo::get_frame_info(consumer)->decision_model;
+	assert(consumer_dec.map_parm_to_spread.count(parm) == 1);
+
+	SnapshotReader reader(mit->second);
+	std::vector<int> vSignature;
+	ParameterExecSpread spread(consumer_dec.exec_time_parameter_num_spread_bins);
+	ThompsonSamplingModel thompson_model;
+	FastReactionState frs;
+
+	reader.get_vector(vSignature);
+	bool bRestored = (reader.ok() && vSignature == get_consumer_signature(consumer, parm));
+	if(bRestored) {
+		bRestored = (spread.load_snapshot(reader)
+			&& thompson_model.load_snapshot(reader)
+			&& frs.load_snapshot(reader)
+			&& reader.at_end());
+	}
+	if(bRestored) {
+		*(consumer_dec.map_parm_to_spread[parm]) = spread;
+		*(consumer_dec.map_parm_to_thompson_model[parm]) = thompson_model;
+		*(consumer_dec.map_parm_to_fast_reaction_state[parm]) = frs;
+	}
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "snapshot_restore_consumer_state(): Frame '" << consumer->name << "' tracking '" << parm->source->name << "' "
+		<< (bRestored ? "restored" : "NOT restored: record malformed or learned for a different objective or model")
+		<< std::endl;
+
+	map_consumer_source_names_to_loaded_record.erase(mit);
+}
+
+
+/////////////////////////////////
+// Snapshot files
+/////////////////////////////////
+
+bool snapshot_load(const std::string& filename) {
+	std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
+	if(!ifs) {
+		OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "snapshot_load(): no snapshot found at '" << filename << "'" << std::endl;
+		return false;
+	}
+	std::ostringstream oss;
+	oss << ifs.rdbuf();
+	std::string contents = oss.str();
+
+	unsigned int version_and_marker[2] = {0, 0};
+	bool bValid = ( contents.size() >= sizeof(snapshot_magic) + sizeof(version_and_marker)
+		&& memcmp(contents.data(), snapshot_magic, sizeof(snapshot_magic)) == 0 );
+	if(bValid) {
+		memcpy(version_and_marker, contents.data() + sizeof(snapshot_magic), sizeof(version_and_marker));
+		bValid = (version_and_marker[0] == snapshot_version && version_and_marker[1] == snapshot_byte_order_marker);
+	}
+	if(bValid == false) {
+		std::cerr << "snapshot_load(): WARNING: '" << filename << "' is not a snapshot of version " << snapshot_version
+			<< " in native byte order, ignored" << std::endl;
+		return false;
+	}
+	std::string body = contents.substr(sizeof(snapshot_magic) + sizeof(version_and_marker));
+	SnapshotReader body_reader(body);
+
+	std::map<std::string, std::string> map_frame_records;
+	std::map<ConsumerSourceNames_t, std::string> map_consumer_records;
+
+	long long num_frame_records = 0;
+	body_reader.get_i64(num_frame_records);
+	for(long long k=0; k<num_frame_records && body_reader.ok(); k++) {
+		std::string name;
+		body_reader.get_string(name);
+		body_reader.get_string(map_frame_records[name]);
+	}
+	long long num_consumer_records = 0;
+	body_reader.get_i64(num_consumer_records);
+	for(long long k=0; k<num_consumer_records && body_reader.ok(); k++) {
+		ConsumerSourceNames_t names;
+		body_reader.get_string(names.first);
+		body_reader.get_string(names.second);
+		body_reader.get_string(map_consumer_records[names]);
+	}
+
+	if(body_reader.ok() == false || body_reader.at_end() == false) {
+		std::cerr << "snapshot_load(): WARNING: '" << filename << "' is truncated or corrupt, ignored" << std::endl;
+		return false;
+	}
+
+	map_frame_name_to_loaded_record.swap(map_frame_records);
+	map_consumer_source_names_to_loaded_record.swap(map_consumer_records);
+	OPP_DEBUG_MESSAGE(DebugMsgEVENTS) << "snapshot_load(): loaded " << num_frame_records << " frame records and "
+		<< num_consumer_records << " consumer records from '" << filename << "'" << std::endl;
+	return true;
+}
+
+bool snapshot_save(const std::string& filename) {
+	std::map<std::string, std::string> map_frame_records = map_frame_name_to_loaded_record;
+	std::map<ConsumerSourceNames_t, std::string> map_consumer_records = map_consumer_source_names_to_loaded_record;
+		//carry over records not restored in the current run, overwritten below by the state of frames in use
+
+	for(int i=0; i<(int)vBaseFrames.size(); i++) {
+		Frame * frame = dynamic_cast<Frame *>(vBaseFrames[i]);
+		if(frame == 0 || frame->name.empty())
+			continue;
+		FrameDecisionModel& frame_dec = FrameInfo::get_frame_info(frame)->decision_model;
+		if(frame_dec.isObjectiveInitialized() == false) //never entered in the current run
+			continue;
+
+		map_frame_records[frame->name] = save_frame_record(frame);
+
+		for(std::map<Parameter *, ParameterExecSpread *>::iterator mit = frame_dec.map_parm_to_spread.begin();
+				mit != frame_dec.map_parm_to_spread.end();
+				mit++
+		) {
+			Parameter * parm = mit->first;
+			if(parm->source->name.empty())
+				continue;
+			map_consumer_records[ ConsumerSourceNames_t(frame->name, parm->source->name) ] = save_consumer_record(frame, parm);
+		}
+	}
+
+	SnapshotWriter body_writer;
+	body_writer.put_i64((long long)map_frame_records.size());
+	for(std::map<std::string, std::string>::iterator mit = map_frame_records.begin(); mit != map_frame_records.end(); mit++) {
+		body_writer.put_string(mit->first);
+		body_writer.put_string(mit->second);
+	}
+	body_writer.put_i64((long long)map_consumer_records.size());
+	for(std::map<ConsumerSourceNames_t, std::string>::iterator mit = map_consumer_records.begin(); mit != map_consumer_records.end(); mit++) {
+		body_writer.put_string(mit->first.first);
+		body_writer.put_string(mit->first.second);
+		body_writer.put_string(mit->second);
+	}
+
+	std::string temp_filename = filename + ".tmp";
+	{
+		std::ofstream ofs(temp_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		unsigned int version_and_marker[2] = {snapshot_version, snapshot_byte_order_marker};
+		ofs.write(snapshot_magic, sizeof(snapshot_magic));
+		ofs.write((const char *)version_and_marker, sizeof(version_and_marker));
+		ofs.write(body_writer.get_buffer().data(), body_writer.get_buffer().size());
+		ofs.close();
+		if(!ofs) {
+			std::cerr << "snapshot_save(): WARNING: could not write '" << temp_filename << "'" << std::endl;
+			remove(temp_filename.c_str());
+			return false;
+		}
+	}
+	if(rename(temp_filename.c_str(), filename.c_str()) != 0) {
+		std::cerr << "snapshot_save(): WARNING: could not replace '" << filename << "'" << std::endl;
+		remove(temp_filename.c_str());
+		return false;
+	}
+	return true;
+}
+
+static void snapshot_save_at_exit() {
+	if(autosave_filename.empty() == false)
+		snapshot_save(autosave_filename);
+}
+
+void snapshot_set_autosave(const std::string& filename, int save_period) {
+	if(filename.empty() || save_period < 0) {
+		std::cerr << "snapshot_set_autosave(): ERROR: need a filename and save_period >= 0, given '"
+			<< filename << "' and " << save_period << std::endl;
+		exit(1);
+	}
+
+	static bool bRegisteredAtExit = false;
+	if(bRegisteredAtExit == false) {
+		atexit(snapshot_save_at_exit);
+		bRegisteredAtExit = true;
+	}
+	autosave_filename = filename;
+	autosave_period = save_period;
+	autosave_top_level_completions = 0;
+}
+
+void snapshot_note_top_level_completion() {
+	if(autosave_filename.empty() || autosave_period == 0)
+		return;
+	autosave_top_level_completions++;
+	if(autosave_top_level_completions % autosave_period == 0)
+		snapshot_save(autosave_filename);
+}
+
+} //namespace Opp
@@ -0,0 +1,103 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_SNAPSHOT_H
+#define OPP_SNAPSHOT_H
+
+#include <vector>
+#include <map>
+#include <string>
+
+#include "opp.h"
+
+namespace Opp {
+
+	class Parameter;
+
+	/////////////////////////////////
+	// Warm-start Snapshots
+	/////////////////////////////////
+
+	// A snapshot holds the learned state of named Frames (see frame_set_name()), so that a later run of the
+	//   application starts from the operating point its previous run converged to. File layout, in native
+	//   byte order (a byte-order marker rejects files from machines of other endianness):
+	//
+	//     magic "OPPSNAP" '\0', u32 version, u32 byte-order marker 0x01020304
+	//     i64 number of frame records, then each: string frame-name, string payload
+	//     i64 number of consumer records, then each: string consumer frame-name, string source name, string payload
+	//
+	//   where a string is an i64 length followed by its bytes. A frame record holds the state of a Frame's own
+	//   FrameDecisionModel; a consumer record the state a Frame (consumer) learned about a Parameter of a
+	//   Frame or ExecFrame (source), i.e. its ParameterExecSpread, ThompsonSamplingModel and FastReactionState.
+	//   Every payload starts with a signature of the shapes it was learned for, and is skipped on restore if
+	//   the shapes differ in the current run (e.g. a Model gained a choice).
+	//
+	// Records are restored lazily, when the corresponding state is first allocated in the current run:
+	//   frame records when the Frame is first entered, consumer records when the consumer first tracks
+	//   the source. Records of frames not used in the current run are carried over into the next save.
+
+	static const unsigned int snapshot_version = 1;
+
+	class SnapshotWriter {
+		std::string buf;
+	public:
+		void put_i64(long long x);
+		void put_double(double x);
+		void put_bool(bool x)
+			{ put_i64(x ? 1 : 0); }
+		void put_string(const std::string& s);
+		void put_vector(const std::vector<double>& v);
+		void put_vector(const std::vector<long long>& v);
+		void put_vector(const std::vector<int>& v);
+		void put_pair_vector(const std::vector< std::pair<double, double> >& v);
+		void put_pair_map(const std::map<long long, std::pair<double, double> >& m);
+
+		const std::string& get_buffer() const
+			{ return buf; }
+	};
+
+	class SnapshotReader {
+		const std::string& buf;
+		size_t pos;
+		bool bOk;
+			//false once a read ran past the end of buf, or found an implausible length
+	public:
+		SnapshotReader(const std::string& buf)
+			: buf(buf), pos(0), bOk(true) { }
+
+		bool ok() const
+			{ return bOk; }
+		bool at_end() const
+			{ return pos == buf.size(); }
+
+		//each returns ok()
+		bool get_i64(long long& x);
+		bool get_int(int& x);
+		bool get_double(double& x);
+		bool get_bool(bool& x);
+		bool get_string(std::string& s);
+		bool get_vector(std::vector<double>& v);
+		bool get_vector(std::vector<long long>& v);
+		bool get_vector(std::vector<int>& v);
+		bool get_pair_vector(std::vector< std::pair<double, double> >& v);
+		bool get_pair_map(std::map<long long, std::pair<double, double> >& m);
+
+		bool get_length(long long& n, size_t min_bytes_per_element);
+			//reads an element count, failing if n elements of atleast min_bytes_per_element cannot remain
+
+	private:
+		bool get_bytes(void * dest, size_t num_bytes);
+	};
+
+
+	//Called when state is allocated in the current run, restore any matching record loaded by snapshot_load()
+	void snapshot_restore_frame_state(Frame * frame);
+	void snapshot_restore_consumer_state(Frame * consumer, Parameter * parm);
+
+	void snapshot_note_top_level_completion();
+		//periodic save, see snapshot_set_autosave()
+
+} //namespace Opp
+
+#endif //OPP_SNAPSHOT_H
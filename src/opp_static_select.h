@@ -0,0 +1,267 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_STATIC_SELECT_H
+#define OPP_STATIC_SELECT_H
+
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <cstdlib>
+
+#include "opp.h"
+
+namespace Opp {
+
+	/////////////////////////////////////////////
+	// Header-only ExecFrame with static choices
+	/////////////////////////////////////////////
+
+	// StaticSelect<f0, f1, ...>: an ExecFrame selecting one of up to 8 alternative functions fixed at compile-time, e.g.
+	//
+	//     static Opp::StaticSelect<filter_full, filter_half, filter_quarter> filter(0);
+	//     ...
+	//     filter.run(); //runs the alternative chosen for this run
+	//
+	//   Equivalent to an ExecFrame of the Select model Model(select_var_id, {f0, f1, ...}) (same decision strategies,
+	//   Constraints on select_var_id, and statistics), but the chosen alternative is called through a switch over
+	//   direct calls, which the compiler can inline: no Caller to rebind before each run, no Func allocated and
+	//   eval()'d, and no walk of the Model. Intended for ExecFrames run many times per Frame invocation.
+	//
+	//   Alternatives are given in decreasing order of quality, as the choices of a Select model. Unused trailing
+	//   template arguments are left to their default. Arguments are passed to the alternatives through user state.
+	//   The alternatives must have external linkage (i.e., not be static, nor in an anonymous namespace).
+
+	inline void static_select_none() { }
+		//default for unused alternatives
+
+	template<void (* f)()>
+	struct StaticSelectIsNone {
+		static const int value = 0;
+	};
+
+	template<>
+	struct StaticSelectIsNone<static_select_none> {
+		static const int value = 1;
+	};
+
+	template<
+		void (* f0)(), void (* f1)(),
+		void (* f2)() = static_select_none, void (* f3)() = static_select_none,
+		void (* f4)() = static_select_none, void (* f5)() = static_select_none,
+		void (* f6)() = static_select_none, void (* f7)() = static_select_none
+	>
+	class StaticSelect {
+	public:
+		enum {
+			num_choices = 8 - StaticSelectIsNone<f2>::value - StaticSelectIsNone<f3>::value - StaticSelectIsNone<f4>::value
+				- StaticSelectIsNone<f5>::value - StaticSelectIsNone<f6>::value - StaticSelectIsNone<f7>::value
+		};
+
+	private:
+		typedef char assert_unused_alternatives_are_trailing[
+			StaticSelectIsNone<f2>::value <= StaticSelectIsNone<f3>::value
+			&& StaticSelectIsNone<f3>::value <= StaticSelectIsNone<f4>::value
+			&& StaticSelectIsNone<f4>::value <= StaticSelectIsNone<f5>::value
+			&& StaticSelectIsNone<f5>::value <= StaticSelectIsNone<f6>::value
+			&& StaticSelectIsNone<f6>::value <= StaticSelectIsNone<f7>::value ? 1 : -1];
+
+		ExecFrame execframe;
+
+		static Model make_model(int select_var_id, int default_choice_index_for_select_var_id, double fast_reaction_strategy_coeff)
+			{ return Model(select_var_id, std::vector<Model>(num_choices), default_choice_index_for_select_var_id, fast_reaction_strategy_coeff); }
+
+	public:
+		StaticSelect(int select_var_id, int stickiness_length = 0, int default_choice_index_for_select_var_id = -1,
+				double fast_reaction_strategy_coeff = 0.0)
+			: execframe(make_model(select_var_id, default_choice_index_for_select_var_id, fast_reaction_strategy_coeff), stickiness_length)
+		{ }
+
+		void run() {
+			int choice = execframe.run_begin()[0];
+			switch(choice) {
+				case 0: f0(); break;
+				case 1: f1(); break;
+				case 2: f2(); break;
+				case 3: f3(); break;
+				case 4: f4(); break;
+				case 5: f5(); break;
+				case 6: f6(); break;
+				case 7: f7(); break;
+			}
+			execframe.run_end();
+		}
+
+		ExecFrame& get_execframe()
+			{ return execframe; }
+			//for ExecFrameStatistics(get_execframe().id), calibrate(), force_default_selection(), etc.
+
+	private:
+		StaticSelect(const StaticSelect&);
+		StaticSelect& operator=(const StaticSelect&);
+	};
+
+
+	// StaticBatchSelect<Item, f0, f1, ...>: as StaticSelect, for fine-grained work made of many small items of type Item
+	//   (e.g., macroblocks), each processed by a call f(item) to the chosen alternative f, e.g.
+	//
+	//     static Opp::StaticBatchSelect<Macroblock&, me_full, me_diamond, me_zero> motion_estimation(0);
+	//     ...
+	//     motion_estimation.run_batch(vMacroblocks.begin(), vMacroblocks.end());
+	//
+	//   One decision is made, and timed, per batch rather than per item (see ExecFrame::run_batch()); the chosen
+	//   alternative is then called directly in a loop over the items. run_paced() runs the items of an invocation of
+	//   the enclosing Frame in batches of K, re-deciding after each batch to meet a deadline (see ExecFrame::pace()).
+
+	template<typename Item>
+	inline void static_batch_select_none(Item) { }
+		//default for unused alternatives
+
+	template<
+		typename Item,
+		void (* f0)(Item), void (* f1)(Item),
+		void (* f2)(Item) = static_batch_select_none<Item>, void (* f3)(Item) = static_batch_select_none<Item>,
+		void (* f4)(Item) = static_batch_select_none<Item>, void (* f5)(Item) = static_batch_select_none<Item>,
+		void (* f6)(Item) = static_batch_select_none<Item>, void (* f7)(Item) = static_batch_select_none<Item>
+	>
+	class StaticBatchSelect {
+		template<void (* f)(Item), int unused = 0>
+		struct IsNone {
+			static const int value = 0;
+		};
+
+		template<int unused>
+		struct IsNone<static_batch_select_none<Item>, unused> {
+			static const int value = 1;
+		};
+			//as StaticSelectIsNone, for alternatives taking an Item (partially specialized, as a member of a class template)
+
+	public:
+		enum {
+			num_choices = 8 - IsNone<f2>::value - IsNone<f3>::value - IsNone<f4>::value
+				- IsNone<f5>::value - IsNone<f6>::value - IsNone<f7>::value
+		};
+
+	private:
+		typedef char assert_unused_alternatives_are_trailing[
+			IsNone<f2>::value <= IsNone<f3>::value
+			&& IsNone<f3>::value <= IsNone<f4>::value
+			&& IsNone<f4>::value <= IsNone<f5>::value
+			&& IsNone<f5>::value <= IsNone<f6>::value
+			&& IsNone<f6>::value <= IsNone<f7>::value ? 1 : -1];
+
+		ExecFrame execframe;
+
+		static Model make_model(int select_var_id, int default_choice_index_for_select_var_id, double fast_reaction_strategy_coeff)
+			{ return Model(select_var_id, std::vector<Model>(num_choices), default_choice_index_for_select_var_id, fast_reaction_strategy_coeff); }
+
+		template<void (* f)(Item), typename Iterator>
+		static long long run_items(Iterator first, Iterator last) {
+			long long num_items = 0;
+			for(; first != last; ++first, num_items++)
+				f(*first);
+			return num_items;
+		}
+
+		template<void (* f)(Item)>
+		static void run_indices(long long first_index, long long last_index) {
+			for(long long i=first_index; i<last_index; i++)
+				f(i);
+		}
+
+		void run_index_range(long long first_index, long long last_index) {
+			int choice = execframe.run_begin()[0];
+			switch(choice) {
+				case 0: run_indices<f0>(first_index, last_index); break;
+				case 1: run_indices<f1>(first_index, last_index); break;
+				case 2: run_indices<f2>(first_index, last_index); break;
+				case 3: run_indices<f3>(first_index, last_index); break;
+				case 4: run_indices<f4>(first_index, last_index); break;
+				case 5: run_indices<f5>(first_index, last_index); break;
+				case 6: run_indices<f6>(first_index, last_index); break;
+				case 7: run_indices<f7>(first_index, last_index); break;
+			}
+			execframe.run_end(last_index - first_index);
+		}
+
+		static void check_period_is_valid(long long check_period) {
+			if(check_period < 1) {
+				std::cerr << "StaticBatchSelect::run_paced(): ERROR: invalid check_period = " << check_period << std::endl;
+				exit(1);
+			}
+		}
+
+	public:
+		StaticBatchSelect(int select_var_id, int stickiness_length = 0, int default_choice_index_for_select_var_id = -1,
+				double fast_reaction_strategy_coeff = 0.0)
+			: execframe(make_model(select_var_id, default_choice_index_for_select_var_id, fast_reaction_strategy_coeff), stickiness_length)
+		{ }
+
+		template<typename Iterator>
+		void run_batch(Iterator first, Iterator last) {
+			//calls the chosen alternative on each item in [first, last); no run if the range is empty
+			if(first == last)
+				return;
+			long long num_items = 0;
+			int choice = execframe.run_begin()[0];
+			switch(choice) {
+				case 0: num_items = run_items<f0>(first, last); break;
+				case 1: num_items = run_items<f1>(first, last); break;
+				case 2: num_items = run_items<f2>(first, last); break;
+				case 3: num_items = run_items<f3>(first, last); break;
+				case 4: num_items = run_items<f4>(first, last); break;
+				case 5: num_items = run_items<f5>(first, last); break;
+				case 6: num_items = run_items<f6>(first, last); break;
+				case 7: num_items = run_items<f7>(first, last); break;
+			}
+			execframe.run_end(num_items);
+		}
+
+		void run_batch(long long num_items) {
+			//calls the chosen alternative on the item indices 0 .. num_items-1 (Item must be an integral type);
+			//  no run if num_items <= 0
+			if(num_items <= 0)
+				return;
+			run_index_range(0, num_items);
+		}
+
+		template<typename Iterator>
+		void run_paced(Iterator first, Iterator last, ExecTime_t deadline, long long check_period) {
+			//runs the items in [first, last) in batches of check_period items, paced to complete by deadline seconds
+			//  of the enclosing Frame's invocation (see ExecFrame::pace())
+			check_period_is_valid(check_period);
+			long long num_items = std::distance(first, last);
+			if(num_items == 0)
+				return;
+			execframe.pace(num_items, deadline, check_period);
+			while(first != last) {
+				Iterator batch_last = first;
+				for(long long i=0; i<check_period && batch_last != last; i++)
+					++batch_last;
+				run_batch(first, batch_last);
+				first = batch_last;
+			}
+		}
+
+		void run_paced(long long num_items, ExecTime_t deadline, long long check_period) {
+			//as above, on the item indices 0 .. num_items-1
+			check_period_is_valid(check_period);
+			if(num_items <= 0)
+				return;
+			execframe.pace(num_items, deadline, check_period);
+			for(long long first_index=0; first_index<num_items; first_index+=check_period)
+				run_index_range(first_index, std::min(first_index + check_period, num_items));
+		}
+
+		ExecFrame& get_execframe()
+			{ return execframe; }
+
+	private:
+		StaticBatchSelect(const StaticBatchSelect&);
+		StaticBatchSelect& operator=(const StaticBatchSelect&);
+	};
+
+} //namespace Opp
+
+#endif //OPP_STATIC_SELECT_H
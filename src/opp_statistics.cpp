@@ -3,16 +3,233 @@
 // Author: Tushar Kumar, tushardeveloper@gmail.com
 
 #include <sstream>
+#include <algorithm>
+#include <cmath>
 
 #include "opp.h"
 #include "opp_frame.h"
 #include "opp_frame_info.h"
 #include "opp_execframe.h"
+#include "opp_timing.h"
 
 #include "opp_utilities.h"
 
 namespace Opp {
 
+//////////////////////////
+// class LatencyHistogram
+//////////////////////////
+
+const int LatencyHistogram::sub_bucket_half_count_magnitude;
+const int LatencyHistogram::sub_bucket_half_count;
+const int LatencyHistogram::bucket_count;
+const int LatencyHistogram::counts_length;
+const long long LatencyHistogram::highest_trackable_ns;
+
+void LatencyHistogram::reset() {
+	vCounts.clear();
+	total_count = 0;
+	min_ns = 0;
+	max_ns = 0;
+	bExactExtremes = true;
+	sum_ns = 0.0;
+}
+
+int LatencyHistogram::get_counts_index(long long value_ns) {
+	assert(0 <= value_ns && value_ns <= highest_trackable_ns);
+
+	//bucket_index = floor(log2(value_ns)) - 7, or 0 for values below 256
+	int bucket_index = (63 - __builtin_clzll( (unsigned long long)value_ns | 0xFFULL )) - sub_bucket_half_count_magnitude;
+	int sub_bucket_index = (int)(value_ns >> bucket_index); //in [0, 256) for bucket 0, else [128, 256)
+	return (bucket_index << sub_bucket_half_count_magnitude) + sub_bucket_index;
+}
+
+long long LatencyHistogram::get_lowest_value_at_index(int counts_index) {
+	assert(0 <= counts_index && counts_index < counts_length);
+
+	int bucket_index = (counts_index >> sub_bucket_half_count_magnitude) - 1;
+	int sub_bucket_index = (counts_index & (sub_bucket_half_count - 1)) + sub_bucket_half_count;
+	if(bucket_index < 0) {
+		sub_bucket_index -= sub_bucket_half_count;
+		bucket_index = 0;
+	}
+	return (long long)sub_bucket_index << bucket_index;
+}
+
+long long LatencyHistogram::get_highest_value_at_index(int counts_index) {
+	int bucket_index = std::max( (counts_index >> sub_bucket_half_count_magnitude) - 1, 0 );
+	return get_lowest_value_at_index(counts_index) + (1LL << bucket_index) - 1;
+}
+
+void LatencyHistogram::record(ExecTime_t exec_time) {
+	double exec_time_ns = exec_time * 1.0e9 + 0.5;
+	if(exec_time_ns < 0.0)
+		exec_time_ns = 0.0;
+	if(exec_time_ns > (double)highest_trackable_ns)
+		exec_time_ns = (double)highest_trackable_ns;
+	record_ns( (long long)exec_time_ns );
+}
+
+void LatencyHistogram::record_ns(long long exec_time_ns) {
+	if(exec_time_ns < 0)
+		exec_time_ns = 0;
+	if(exec_time_ns > highest_trackable_ns)
+		exec_time_ns = highest_trackable_ns;
+
+	if(vCounts.empty())
+		vCounts.resize(counts_length, 0);
+	vCounts[ get_counts_index(exec_time_ns) ]++;
+
+	if(total_count == 0 || exec_time_ns < min_ns)
+		min_ns = exec_time_ns;
+	if(total_count == 0 || exec_time_ns > max_ns)
+		max_ns = exec_time_ns;
+	total_count++;
+	sum_ns += (double)exec_time_ns;
+}
+
+void LatencyHistogram::unrecord(ExecTime_t exec_time) {
+	double exec_time_ns = exec_time * 1.0e9 + 0.5;
+	if(exec_time_ns < 0.0)
+		exec_time_ns = 0.0;
+	if(exec_time_ns > (double)highest_trackable_ns)
+		exec_time_ns = (double)highest_trackable_ns;
+	unrecord_ns( (long long)exec_time_ns );
+}
+
+void LatencyHistogram::unrecord_ns(long long exec_time_ns) {
+	if(exec_time_ns < 0)
+		exec_time_ns = 0;
+	if(exec_time_ns > highest_trackable_ns)
+		exec_time_ns = highest_trackable_ns;
+
+	int counts_index = get_counts_index(exec_time_ns);
+	assert(total_count > 0 && vCounts[counts_index] > 0);
+	vCounts[counts_index]--;
+	total_count--;
+	sum_ns -= (double)exec_time_ns;
+
+	if(total_count == 0)
+		reset();
+	else
+		bExactExtremes = false;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+	if(other.total_count == 0)
+		return;
+
+	if(vCounts.empty())
+		vCounts.resize(counts_length, 0);
+	for(int i=0; i<counts_length; i++)
+		vCounts[i] += other.vCounts[i];
+
+	if(total_count == 0 || other.min_ns < min_ns)
+		min_ns = other.min_ns;
+	if(total_count == 0 || other.max_ns > max_ns)
+		max_ns = other.max_ns;
+	if(other.bExactExtremes == false)
+		bExactExtremes = false;
+	total_count += other.total_count;
+	sum_ns += other.sum_ns;
+}
+
+ExecTime_t LatencyHistogram::get_min() const {
+	if(bExactExtremes == false && total_count > 0) {
+		for(int i=0; i<counts_length; i++)
+			if(vCounts[i] > 0)
+				return get_lowest_value_at_index(i) * 1.0e-9;
+	}
+	return min_ns * 1.0e-9;
+}
+
+ExecTime_t LatencyHistogram::get_max() const {
+	if(bExactExtremes == false && total_count > 0) {
+		for(int i=counts_length-1; i>=0; i--)
+			if(vCounts[i] > 0)
+				return get_highest_value_at_index(i) * 1.0e-9;
+	}
+	return max_ns * 1.0e-9;
+}
+
+ExecTime_t LatencyHistogram::get_mean() const {
+	if(total_count == 0)
+		return 0.0;
+	return sum_ns / total_count * 1.0e-9;
+}
+
+ExecTime_t LatencyHistogram::get_value_at_percentile(double percentile) const {
+	if(total_count == 0)
+		return 0.0;
+
+	percentile = std::min(std::max(percentile, 0.0), 100.0);
+	long long count_at_percentile = (long long)ceil(percentile / 100.0 * total_count);
+	if(count_at_percentile < 1)
+		count_at_percentile = 1;
+
+	long long cumulative_count = 0;
+	for(int i=0; i<counts_length; i++) {
+		cumulative_count += vCounts[i];
+		if(cumulative_count >= count_at_percentile)
+			return (bExactExtremes ? std::min(get_highest_value_at_index(i), max_ns) : get_highest_value_at_index(i)) * 1.0e-9;
+	}
+	return get_max();
+}
+
+double LatencyHistogram::get_fraction_at_or_below(ExecTime_t exec_time) const {
+	if(total_count == 0 || exec_time < 0.0)
+		return 0.0;
+	if(exec_time * 1.0e9 >= (double)highest_trackable_ns)
+		return 1.0;
+
+	int last_index = get_counts_index( (long long)(exec_time * 1.0e9) );
+	long long cumulative_count = 0;
+	for(int i=0; i<=last_index; i++)
+		cumulative_count += vCounts[i];
+	return cumulative_count / (double)total_count;
+}
+
+std::string LatencyHistogram::print_string() const {
+	std::ostringstream oss;
+	oss << "count = " << total_count;
+	if(total_count > 0) {
+		oss << " min = " << get_min() << " mean = " << get_mean()
+			<< " p50 = " << get_value_at_percentile(50.0) << " p90 = " << get_value_at_percentile(90.0)
+			<< " p99 = " << get_value_at_percentile(99.0) << " p99.9 = " << get_value_at_percentile(99.9)
+			<< " max = " << get_max();
+	}
+	return oss.str();
+}
+
+
+
+
+////////////////////////////////
+// class FrameWindowStatistics
+////////////////////////////////
+
+std::string FrameWindowStatistics::print_string() const {
+	std::ostringstream oss;
+	if(window_length > 0)
+		oss << "last " << window_length << " invocations:";
+	else
+		oss << "last " << window_seconds << " seconds:";
+	oss << " count = " << get_count();
+	if(get_count() > 0) {
+		oss << " satisfaction_ratio = " << get_satisfaction_ratio()
+			<< " exec_time p50 = " << get_exec_time_percentile(50.0) << " p90 = " << get_exec_time_percentile(90.0)
+			<< " p99 = " << get_exec_time_percentile(99.0);
+	}
+	if(jitter_histogram.get_total_count() > 0) {
+		oss << " jitter p50 = " << get_jitter_percentile(50.0) << " p90 = " << get_jitter_percentile(90.0)
+			<< " p99 = " << get_jitter_percentile(99.0);
+	}
+	return oss.str();
+}
+
+
+
+
 //////////////////////////
 // class FrameStatistics
 //////////////////////////
@@ -27,6 +244,16 @@ FrameStatistics& FrameStatistics::refresh() {
 	vFailure_Runlengths_wrt_specified_objective.clear();
 	satisfaction_ratio_wrt_active_objective = 0.0;
 	vFailure_Runlengths_wrt_active_objective.clear();
+	vExecTime_quantile_probs.clear();
+	vExecTime_quantiles.clear();
+	enforced_objective_measure = 0.0;
+	satisfaction_ratio_wrt_enforced_objective = 0.0;
+	exec_time_histogram.reset();
+	controller_overhead_total = 0.0;
+	controller_overhead_per_invocation = 0.0;
+	controller_overhead_fraction = 0.0;
+	window_by_count = FrameWindowStatistics();
+	window_by_time = FrameWindowStatistics();
 
 	Frame * frame = get_frame_from_frame_id(frame_id);
 	if(frame == 0) //frame not yet defined, or has been destroyed
@@ -50,6 +277,19 @@ FrameStatistics& FrameStatistics::refresh() {
 			vExecTime_bin_frequencies.at( frame_dec.exec_time_record.vCacheEntries[ic].tag ) = frame_dec.exec_time_record.vCacheEntries[ic].count;
 	}
 
+	exec_time_histogram = frame_dec.exec_time_histogram;
+
+	controller_overhead_total = frame_dec.total_controller_overhead;
+	if(exec_time_histogram.get_total_count() > 0)
+		controller_overhead_per_invocation = controller_overhead_total / exec_time_histogram.get_total_count();
+	if(frame_dec.total_exec_time_with_controller_overhead > 0.0)
+		controller_overhead_fraction = controller_overhead_total / frame_dec.total_exec_time_with_controller_overhead;
+
+	window_by_count = frame_dec.statistics_window_by_count.stats;
+	if(frame_dec.statistics_window_by_time.stats.is_maintained())
+		frame_dec.statistics_window_by_time.evict_expired( get_curr_timeval() ); //as of now, also after idle periods
+	window_by_time = frame_dec.statistics_window_by_time.stats;
+
 	vSpecified_Objective_bin_indices = local_vFOR_ObjectiveWindowBinIndices;
 
 	if(frame_info->bIsActive)
@@ -77,6 +317,16 @@ FrameStatistics& FrameStatistics::refresh() {
 	
 	vFailure_Runlengths_wrt_active_objective = frame_dec.vFailure_Runlengths_wrt_active_objective;
 
+	if(frame_dec.enforcement != Objective::EnfPER_FRAME) {
+		vExecTime_quantile_probs = frame_dec.exec_time_quantile_sketch.get_quantile_probs();
+		for(int i=0; i<(int)vExecTime_quantile_probs.size(); i++)
+			vExecTime_quantiles.push_back( frame_dec.exec_time_quantile_sketch.get_quantile(i) );
+
+		enforced_objective_measure = frame_dec.enforced_objective_measure;
+		if(frame_dec.enforced_objective_evaluated_count > 0)
+			satisfaction_ratio_wrt_enforced_objective = frame_dec.enforced_objective_satisfied_count / (double)frame_dec.enforced_objective_evaluated_count;
+	}
+
 	return *this;
 }
 
@@ -92,6 +342,20 @@ std::string FrameStatistics::print_string() const {
 	oss << "$$   vActive_Objective_bin_indices    = " << vActive_Objective_bin_indices << std::endl;
 	oss << "$$   satisfaction_ratio_wrt_active_objective    = " << satisfaction_ratio_wrt_active_objective << std::endl;
 	oss << "$$   vFailure_Runlengths_wrt_active_objective    = " << vFailure_Runlengths_wrt_active_objective << std::endl;
+	if(vExecTime_quantile_probs.size() > 0) {
+		oss << "$$   vExecTime_quantile_probs = " << vExecTime_quantile_probs << std::endl;
+		oss << "$$   vExecTime_quantiles      = " << vExecTime_quantiles << std::endl;
+		oss << "$$   enforced_objective_measure = " << enforced_objective_measure << std::endl;
+		oss << "$$   satisfaction_ratio_wrt_enforced_objective = " << satisfaction_ratio_wrt_enforced_objective << std::endl;
+	}
+	oss << "$$   exec_time_histogram = " << exec_time_histogram.print_string() << std::endl;
+	oss << "$$   controller_overhead_total = " << controller_overhead_total
+		<< " controller_overhead_per_invocation = " << controller_overhead_per_invocation
+		<< " controller_overhead_fraction = " << controller_overhead_fraction << std::endl;
+	if(window_by_count.is_maintained())
+		oss << "$$   window_by_count: " << window_by_count.print_string() << std::endl;
+	if(window_by_time.is_maintained())
+		oss << "$$   window_by_time: " << window_by_time.print_string() << std::endl;
 
 	return oss.str();
 }
@@ -110,13 +374,13 @@ void create_ExecTime_vs_ModelDecision_Distribution(
 	etmd_distr.vModelChoices.clear();
 	etmd_distr.vvCounts.clear();
 
-	std::map<int, int> map_decision_value_to_index_in_vModelChoices;
+	std::map<DecisionKey_t, int> map_decision_value_to_index_in_vModelChoices;
 	for(int i=0; i<(int)parm_exec_spread->vExecSpreadBins.size(); i++) {
 		for(int j=0; j<(int)parm_exec_spread->vExecSpreadBins[i].vCacheEntries.size(); j++) {
 			const IntCacheEntry& ice = parm_exec_spread->vExecSpreadBins[i].vCacheEntries[j];
 			if(ice.valid == false)
 				continue;
-			int decision_value = ice.tag;
+			DecisionKey_t decision_value = ice.tag;
 			if(map_decision_value_to_index_in_vModelChoices.count(decision_value) == 0) {
 				map_decision_value_to_index_in_vModelChoices[decision_value] = (int)etmd_distr.vModelChoices.size();
 				etmd_distr.vModelChoices.push_back(decision_value);
@@ -136,7 +400,7 @@ void create_ExecTime_vs_ModelDecision_Distribution(
 			const IntCacheEntry& ice = parm_exec_spread->vExecSpreadBins[i].vCacheEntries[j];
 			if(ice.valid == false)
 				continue;
-			int decision_value = ice.tag;
+			DecisionKey_t decision_value = ice.tag;
 			double count = ice.count;
 
 			int column_index = map_decision_value_to_index_in_vModelChoices[decision_value];
@@ -149,6 +413,11 @@ ExecFrameStatistics& ExecFrameStatistics::refresh()
 {
 	vTracking_FrameIDs.clear();
 	map_tracking_frame_to_exectime_distribution.clear();
+	run_count = 0;
+	item_count = 0;
+	run_time_total = 0.0;
+	item_cost = 0.0;
+	map_decision_to_item_cost.clear();
 
 	ExecFrame * execframe = get_execframe_from_execframe_id(execframe_id);
 	if(execframe == 0) //execframe not yet defined, or has been destroyed
@@ -157,6 +426,18 @@ ExecFrameStatistics& ExecFrameStatistics::refresh()
 	ExecFrameInfo * execframe_info = ExecFrameInfo::get_execframe_info(execframe);
 	ExecFrameDecisionModel& execframe_dec = execframe_info->decision_model;
 
+	run_count = execframe_dec.total_runs;
+	item_count = execframe_dec.total_items;
+	run_time_total = execframe_dec.total_run_time;
+	if(item_count > 0)
+		item_cost = run_time_total / item_count;
+	for(std::map<DecisionKey_t, ExecTime_t>::iterator mit = execframe_dec.map_decision_to_item_cost.begin();
+		mit != execframe_dec.map_decision_to_item_cost.end();
+		mit++
+	) {
+		map_decision_to_item_cost[mit->first] = mit->second;
+	}
+
 	for(std::map<Frame *, IntValueCache *>::iterator mit = execframe_dec.decision_vector_parameter.map_consumer_caches.begin();
 		mit != execframe_dec.decision_vector_parameter.map_consumer_caches.end();
 		mit++
@@ -210,6 +491,12 @@ std::string ExecFrameStatistics::print_string() {
 
 	oss << "$$ ExecFrame #" << execframe_id << ": Statistics" << std::endl;
 	oss << "$$   vTracking_FrameIDs = " << vTracking_FrameIDs << std::endl;
+	oss << "$$   run_count = " << run_count << " item_count = " << item_count << " run_time_total = " << run_time_total
+		<< " item_cost = " << item_cost << std::endl;
+	oss << "$$   map_decision_to_item_cost = {";
+	for(std::map<long long, ExecTime_t>::const_iterator mit = map_decision_to_item_cost.begin(); mit != map_decision_to_item_cost.end(); mit++)
+		oss << " " << mit->first << ": " << mit->second;
+	oss << " }" << std::endl;
 
 	for(int f=0; f<(int)vTracking_FrameIDs.size(); f++) {
 		oss << "$$ ---- Tracking Frame #" << vTracking_FrameIDs[f] << " ----" << std::endl;
@@ -0,0 +1,287 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <cstdlib>
+#include <cassert>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "opp_stats_page.h"
+#include "opp_frame_info.h"
+#include "opp_execframe.h"
+#include "opp_utilities.h"
+
+namespace Opp {
+
+static const char stats_page_magic[8] = {'O', 'P', 'P', 'S', 'T', 'A', 'T', 'S'};
+
+bool bStatsPagePublished = false;
+
+static StatsPageHeader * stats_page_header = 0; //start of the mapping
+static StatsFrameSlot * stats_page_slots = 0;
+static size_t stats_page_mapping_length = 0;
+static std::string stats_page_shm_name;
+
+static std::vector<int> vFrameID_to_slot_index;
+	//-1 for Frames not yet assigned a slot
+
+
+bool stats_page_publish(const std::string& shm_name, int max_frames) {
+	assert(sizeof(StatsPageHeader) == stats_page_header_size && sizeof(StatsFrameSlot) == stats_page_slot_size);
+
+	if(max_frames <= 0) {
+		std::cerr << "stats_page_publish(): ERROR: max_frames = " << max_frames << " must be > 0" << std::endl;
+		exit(1);
+	}
+
+	stats_page_unpublish();
+
+	size_t length = stats_page_header_size + (size_t)max_frames * stats_page_slot_size;
+
+	int fd = shm_open(shm_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		return false;
+	if(ftruncate(fd, (off_t)length) != 0) {
+		::close(fd);
+		shm_unlink(shm_name.c_str());
+		return false;
+	}
+	void * mapping = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd); //the mapping keeps the segment open
+	if(mapping == MAP_FAILED) {
+		shm_unlink(shm_name.c_str());
+		return false;
+	}
+
+	//touch every page now, rather than fault them in on the frame path
+	memset(mapping, 0, length);
+
+	stats_page_header = (StatsPageHeader *)mapping;
+	stats_page_slots = (StatsFrameSlot *)((char *)mapping + stats_page_header_size);
+	stats_page_mapping_length = length;
+	stats_page_shm_name = shm_name;
+	vFrameID_to_slot_index.clear();
+
+	stats_page_header->version = stats_page_version;
+	stats_page_header->byte_order_marker = stats_page_byte_order_marker;
+	stats_page_header->header_size = stats_page_header_size;
+	stats_page_header->slot_size = stats_page_slot_size;
+	stats_page_header->max_frames = (uint32_t)max_frames;
+	stats_page_header->num_slots_used = 0;
+	stats_page_header->publisher_pid = (int64_t)getpid();
+	shared_memory_store_barrier();
+	memcpy(stats_page_header->magic, stats_page_magic, sizeof(stats_page_magic)); //readers check magic last
+
+	bStatsPagePublished = true;
+	return true;
+}
+
+void stats_page_unpublish() {
+	if(bStatsPagePublished == false)
+		return;
+	bStatsPagePublished = false;
+
+	munmap(stats_page_header, stats_page_mapping_length);
+	shm_unlink(stats_page_shm_name.c_str());
+	stats_page_header = 0;
+	stats_page_slots = 0;
+	stats_page_mapping_length = 0;
+	stats_page_shm_name.clear();
+	vFrameID_to_slot_index.clear();
+}
+
+
+//Returns 0 if the page is full
+static StatsFrameSlot * get_slot(Frame * frame) {
+	if(frame->id >= (FrameID_t)vFrameID_to_slot_index.size())
+		vFrameID_to_slot_index.resize(frame->id + 1, -1);
+
+	int slot_index = vFrameID_to_slot_index[frame->id];
+	if(slot_index == -1) {
+		if(stats_page_header->num_slots_used >= stats_page_header->max_frames)
+			return 0;
+		slot_index = (int)stats_page_header->num_slots_used;
+		vFrameID_to_slot_index[frame->id] = slot_index;
+
+		StatsFrameSlot * slot = &stats_page_slots[slot_index];
+		slot->frame_id = frame->id;
+		strncpy(slot->name, frame->name.c_str(), stats_page_max_name_length);
+		slot->name[stats_page_max_name_length] = '\0';
+		slot->decision_execframe_id = -1;
+		shared_memory_store_barrier();
+		stats_page_header->num_slots_used = slot_index + 1;
+	}
+	return &stats_page_slots[slot_index];
+}
+
+static inline void begin_slot_update(StatsFrameSlot * slot) {
+	slot->sequence = slot->sequence + 1; //odd
+	shared_memory_store_barrier();
+}
+
+static inline void end_slot_update(StatsFrameSlot * slot) {
+	shared_memory_store_barrier();
+	slot->sequence = slot->sequence + 1; //even
+}
+
+static void copy_runlengths(uint64_t * dest, const std::vector<long long>& vRunlengths) {
+	for(int i=0; i<stats_page_max_runlength_bins; i++)
+		dest[i] = 0;
+	for(int i=0; i<(int)vRunlengths.size(); i++)
+		dest[ std::min(i, stats_page_max_runlength_bins - 1) ] += vRunlengths[i];
+}
+
+
+void stats_page_note_frame_completion(Frame * frame) {
+	if(bStatsPagePublished == false)
+		return;
+
+	StatsFrameSlot * slot = get_slot(frame);
+	if(slot == 0)
+		return;
+
+	FrameInfo * frame_info = FrameInfo::get_frame_info(frame);
+	FrameDecisionModel& frame_dec = frame_info->decision_model;
+
+	begin_slot_update(slot);
+	slot->invocation_count++;
+	slot->last_exec_time = frame_info->current_invocation_exec_time;
+	if(frame_dec.bHasMeanObjectiveDefined) {
+		slot->mean_objective = frame_dec.mean_objective;
+		slot->unbinned_satisfaction_ratio = frame_dec.unbinned_satisfaction_ratio;
+		slot->unbinned_mean = frame_dec.unbinned_mean;
+		slot->unbinned_variance = frame_dec.unbinned_variance;
+	}
+	copy_runlengths(slot->failure_runlengths_wrt_specified_objective, frame_dec.vFailure_Runlengths_wrt_specified_objective);
+	copy_runlengths(slot->failure_runlengths_wrt_active_objective, frame_dec.vFailure_Runlengths_wrt_active_objective);
+	end_slot_update(slot);
+}
+
+void stats_page_note_execframe_run(ExecFrame * execframe, Frame * parent_frame, long long decision_key,
+	const std::vector<int>& vDecisionVector)
+{
+	if(bStatsPagePublished == false || parent_frame == 0)
+		return;
+
+	StatsFrameSlot * slot = get_slot(parent_frame);
+	if(slot == 0)
+		return;
+
+	FrameDecisionModel& parent_frame_dec = FrameInfo::get_frame_info(parent_frame)->decision_model;
+	Parameter * decision_vector_parameter = &(ExecFrameInfo::get_execframe_info(execframe)->decision_model.decision_vector_parameter);
+	std::map<Parameter *, FastReactionState *>::iterator mit = parent_frame_dec.map_parm_to_fast_reaction_state.find(decision_vector_parameter);
+
+	begin_slot_update(slot);
+	slot->decision_execframe_id = execframe->id;
+	slot->decision_key = decision_key;
+	slot->num_decision_variables = (uint32_t)vDecisionVector.size();
+	for(int i=0; i<stats_page_max_decision_variables; i++)
+		slot->decision_vector[i] = (i < (int)vDecisionVector.size() ? vDecisionVector[i] : 0);
+
+	slot->num_coeffs = 0;
+	if(mit != parent_frame_dec.map_parm_to_fast_reaction_state.end())
+		slot->num_coeffs = (uint32_t)std::min((int)mit->second->vCoeffs_a.size(), stats_page_max_decision_variables);
+	for(int i=0; i<stats_page_max_decision_variables; i++)
+		slot->coeffs[i] = (i < (int)slot->num_coeffs ? mit->second->vCoeffs_a[i] : 0.0);
+	end_slot_update(slot);
+}
+
+
+
+////////////////////////////////////
+//class StatsPageReader definitions
+////////////////////////////////////
+
+bool StatsPageReader::open(const std::string& shm_name) {
+	close();
+
+	int fd = shm_open(shm_name.c_str(), O_RDONLY, 0);
+	if(fd < 0)
+		return false;
+	struct stat st;
+	if(fstat(fd, &st) != 0 || (size_t)st.st_size < stats_page_header_size) {
+		::close(fd);
+		return false;
+	}
+	size_t length = (size_t)st.st_size;
+	void * mapping = mmap(0, length, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if(mapping == MAP_FAILED)
+		return false;
+
+	const StatsPageHeader * page_header = (const StatsPageHeader *)mapping;
+	if(memcmp(page_header->magic, stats_page_magic, sizeof(stats_page_magic)) != 0
+		|| page_header->version != stats_page_version || page_header->byte_order_marker != stats_page_byte_order_marker
+		|| page_header->header_size != stats_page_header_size || page_header->slot_size != stats_page_slot_size
+		|| length < stats_page_header_size + (size_t)page_header->max_frames * stats_page_slot_size)
+	{
+		munmap(mapping, length);
+		return false;
+	}
+
+	header = page_header;
+	mapping_length = length;
+	return true;
+}
+
+void StatsPageReader::close() {
+	if(header != 0)
+		munmap((void *)header, mapping_length);
+	header = 0;
+	mapping_length = 0;
+}
+
+int StatsPageReader::get_num_slots_used() const {
+	if(header == 0)
+		return 0;
+	uint32_t num_slots_used = header->num_slots_used;
+	return (int)std::min(num_slots_used, header->max_frames);
+}
+
+bool StatsPageReader::read_slot(int slot_index, StatsFrameSlot& slot) const {
+	if(slot_index < 0 || slot_index >= get_num_slots_used())
+		return false;
+	shared_memory_load_barrier(); //num_slots_used before the slot's contents
+
+	const StatsFrameSlot * shared_slot = (const StatsFrameSlot *)((const char *)header + stats_page_header_size) + slot_index;
+	for(int attempt=0; attempt<1000; attempt++) {
+		uint64_t sequence_before = shared_slot->sequence;
+		if(sequence_before % 2 == 1)
+			continue;
+		shared_memory_load_barrier();
+		memcpy(&slot, (const void *)shared_slot, sizeof(StatsFrameSlot));
+		shared_memory_load_barrier();
+		if(shared_slot->sequence == sequence_before)
+			return true;
+	}
+	return false;
+}
+
+std::string StatsPageReader::print_string(const StatsFrameSlot& slot) {
+	std::vector<long long> vSpecified(slot.failure_runlengths_wrt_specified_objective,
+		slot.failure_runlengths_wrt_specified_objective + stats_page_max_runlength_bins);
+	std::vector<int> vDecisionVector(slot.decision_vector,
+		slot.decision_vector + std::min((int)slot.num_decision_variables, stats_page_max_decision_variables));
+	std::vector<double> vCoeffs(slot.coeffs, slot.coeffs + slot.num_coeffs);
+
+	std::ostringstream oss;
+	oss << "Frame #" << slot.frame_id << " '" << slot.name << "' invocations = " << slot.invocation_count
+		<< " last_exec_time = " << slot.last_exec_time << " mean_objective = " << slot.mean_objective
+		<< " unbinned_satisfaction_ratio = " << slot.unbinned_satisfaction_ratio
+		<< " unbinned_mean = " << slot.unbinned_mean << " unbinned_variance = " << slot.unbinned_variance
+		<< " failure_runlengths_wrt_specified_objective = " << vSpecified;
+	if(slot.decision_execframe_id != -1)
+		oss << " ExecFrame #" << slot.decision_execframe_id << " decision_key = " << slot.decision_key
+			<< " decision_vector = " << vDecisionVector << " coeffs = " << vCoeffs;
+	return oss.str();
+}
+
+} //namespace Opp
@@ -0,0 +1,127 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_STATS_PAGE_H
+#define OPP_STATS_PAGE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "opp.h"
+
+namespace Opp {
+
+	/////////////////////////////////
+	// Shared-memory Statistics Page
+	/////////////////////////////////
+
+	// A statistics page (see stats_page_publish()) is a POSIX shared-memory segment holding one fixed-size slot of
+	//   live counters per Frame, for external monitoring processes to read while the application runs.
+	//   Layout, in native byte order (readers on the same machine; the byte-order marker guards against misuse):
+	//
+	//     StatsPageHeader (stats_page_header_size bytes), then max_frames StatsFrameSlot (stats_page_slot_size bytes each)
+	//
+	//   Slots are assigned in the order Frames first complete an invocation; num_slots_used only grows. Each slot is
+	//   updated under a sequence lock: its sequence number is odd while the slot is being written, and is incremented
+	//   to the next even number once the slot is consistent. A reader copies the slot, and retries if the sequence
+	//   number was odd or changed during the copy (StatsPageReader does so).
+	//
+	// Version history:
+	//   1: initial layout
+
+	static const uint32_t stats_page_version = 1;
+	static const uint32_t stats_page_byte_order_marker = 0x01020304;
+
+	static const int stats_page_max_runlength_bins = 16;
+	static const int stats_page_max_decision_variables = 8;
+	static const int stats_page_max_name_length = 31;
+
+	struct StatsPageHeader {
+		char magic[8];                    //"OPPSTATS"
+		uint32_t version;                 //stats_page_version
+		uint32_t byte_order_marker;       //stats_page_byte_order_marker
+		uint32_t header_size;             //sizeof(StatsPageHeader)
+		uint32_t slot_size;               //sizeof(StatsFrameSlot)
+		uint32_t max_frames;              //number of slots
+		volatile uint32_t num_slots_used; //slots [0, num_slots_used) have been assigned to Frames
+		int64_t publisher_pid;
+		uint8_t reserved[24];
+	};
+
+	static const size_t stats_page_header_size = 64;
+
+	struct StatsFrameSlot {
+		volatile uint64_t sequence;       //sequence lock: odd while being written
+		int64_t frame_id;
+		char name[stats_page_max_name_length + 1];
+			//name given by frame_set_name() ('\0'-terminated, truncated), empty if none
+
+		//Updated on each completed invocation of the Frame
+		uint64_t invocation_count;        //completed invocations
+		double last_exec_time;            //measured execution-time of the last completed invocation
+		double mean_objective;            //0.0 if the Frame has no mean objective (then the unbinned_* fields are 0.0)
+		double unbinned_satisfaction_ratio;
+			//fraction of invocations whose (rescaled, sliding-window averaged) execution-time met the objective window
+		double unbinned_mean;
+		double unbinned_variance;
+		uint64_t failure_runlengths_wrt_specified_objective[stats_page_max_runlength_bins];
+		uint64_t failure_runlengths_wrt_active_objective[stats_page_max_runlength_bins];
+			//element i counts runs-of-continuous-failures of lengths in (2^(i-1), 2^i], the last element also counting longer runs
+
+		//Updated on each ExecFrame run directly within the Frame
+		int64_t decision_execframe_id;    //ExecFrame run last, -1 if none yet
+		int64_t decision_key;             //decision-vector it ran, as its DecisionKey_t
+		uint32_t num_decision_variables;  //of which the first stats_page_max_decision_variables are given below
+		uint32_t num_coeffs;              //Fast Reaction Strategy coefficients given below, 0 if it has no state for the ExecFrame
+		int32_t decision_vector[stats_page_max_decision_variables];
+		double coeffs[stats_page_max_decision_variables];
+
+		uint8_t reserved[40];
+	};
+
+	static const size_t stats_page_slot_size = 512;
+
+
+	// StatsPageReader: maps a statistics page published by another process, read-only.
+
+	class StatsPageReader {
+		const StatsPageHeader * header;
+		size_t mapping_length;
+
+	public:
+		StatsPageReader() : header(0), mapping_length(0) { }
+		~StatsPageReader()
+			{ close(); }
+
+		bool open(const std::string& shm_name);
+			//Returns false if shm_name does not exist, or is not a statistics page of the current version and byte order.
+		void close();
+
+		const StatsPageHeader * get_header() const
+			{ return header; }
+
+		int get_num_slots_used() const;
+
+		bool read_slot(int slot_index, StatsFrameSlot& slot) const;
+			//Consistent copy of slot slot_index. Returns false if the slot stayed busy through repeated attempts.
+
+		static std::string print_string(const StatsFrameSlot& slot);
+
+	private:
+		StatsPageReader(const StatsPageReader&);
+		StatsPageReader& operator=(const StatsPageReader&);
+	};
+
+
+	//Called by the library to publish, if a statistics page is published
+	extern bool bStatsPagePublished;
+
+	void stats_page_note_frame_completion(Frame * frame);
+	void stats_page_note_execframe_run(ExecFrame * execframe, Frame * parent_frame, long long decision_key,
+		const std::vector<int>& vDecisionVector);
+
+} //namespace Opp
+
+#endif //OPP_STATS_PAGE_H
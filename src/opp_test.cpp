@@ -3,9 +3,26 @@
 // Author: Tushar Kumar, tushardeveloper@gmail.com
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
 
 #include "opp.h"
 #include "opp_debug_control.h"
+#include "opp_static_select.h"
+#include "opp_timing.h"
+#include "opp_workload_hints.h"
+#include "opp_thompson_sampling.h"
+#include "opp_decision_model.h"
+#include "opp_execframe.h"
+#include "opp_frame_info.h"
+#include "opp_quantile_sketch.h"
+#include "opp_change_point.h"
+#include "opp_constraint.h"
+#include "opp_parameter_spread.h"
+#include "opp_snapshot.h"
 
 void f1(int x) {
 	std::cout << "Inside f1" << std::endl;
@@ -84,6 +101,660 @@ void ww() {
 	std::cout << stats_f_ww.refresh().print_string() << std::endl;
 }
 
+
+/////////////////////////////////////////
+// Focused checks of library components
+/////////////////////////////////////////
+
+static int num_failed_checks = 0;
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+static void check(bool bPassed, const char * condition, int line) {
+	if(bPassed == false) {
+		std::cout << "CHECK FAILED (opp_test.cpp:" << line << "): " << condition << std::endl;
+		num_failed_checks++;
+	}
+}
+
+static bool is_near(double value, double expected, double tolerance)
+	{ return fabs(value - expected) <= tolerance; }
+
+static void test_workload_hint_regression() {
+	//Y = 2 + 3*h + 0.5*x + 0.25*h*x is learned exactly from persistently exciting samples
+	Opp::WorkloadHintRegression regression;
+	std::vector<double> vHints(1), vDecisionValues(1);
+	for(int i=0; i<60; i++) {
+		vHints[0] = i % 5;
+		vDecisionValues[0] = (i / 5) % 4;
+		regression.note_invocation(vHints, vDecisionValues, 2.0 + 3.0 * vHints[0] + 0.5 * vDecisionValues[0] + 0.25 * vHints[0] * vDecisionValues[0]);
+	}
+	CHECK(regression.is_trained());
+	vHints[0] = 2.5;
+	vDecisionValues[0] = 1.5;
+	CHECK(is_near(regression.predict(vHints, vDecisionValues), 2.0 + 7.5 + 0.75 + 0.9375, 1e-3));
+
+	//deviation from the nominal hints, for the same decision values
+	std::vector<double> vNominal_hints = regression.get_nominal_hints();
+	CHECK(is_near(regression.predict_deviation_from_nominal(vHints, vDecisionValues),
+		(3.0 + 0.25 * 1.5) * (2.5 - vNominal_hints[0]), 1e-3));
+
+	//untrained, or of other dimensions: no prediction
+	Opp::WorkloadHintRegression untrained;
+	untrained.note_invocation(vHints, vDecisionValues, 1.0);
+	CHECK(untrained.predict_deviation_from_nominal(vHints, vDecisionValues) == 0.0);
+	CHECK(regression.predict(std::vector<double>(2, 1.0), vDecisionValues) == 0.0);
+}
+
+static void test_thompson_sampling_posterior() {
+	Opp::ThompsonSamplingModel model;
+	for(int i=0; i<100; i++)
+		model.note_outcome(1, 3, 1.0, i < 90);
+	model.note_outcome(1, 5, 0.5, true);
+
+	CHECK(is_near(model.get_observation_count(1, 3), 100.0, 1e-9));
+	CHECK(is_near(model.get_observation_count(1, 5), 0.5, 1e-9));
+	CHECK(model.get_observation_count(0, 3) == 0.0); //contexts are separate
+
+	//posterior mean of Beta(1 + 90, 1 + 10)
+	double sum = 0.0;
+	for(int i=0; i<4000; i++)
+		sum += model.sample_success_probability(1, 3);
+	CHECK(is_near(sum / 4000, 91.0 / 102.0, 0.01));
+}
+
+static void test_thompson_sampling_success_follows_enforcement() {
+	//p90 of exec time <= 10ms: an invocation succeeds iff it is within the bound, however fast
+	Opp::FrameDecisionModel quantile_model(0);
+	quantile_model.initialize_objective(true, 0.010, 0.1, 0.0, 0.9, 1, 0, Opp::Objective::EnfQUANTILE, 100);
+	CHECK(quantile_model.is_invocation_objective_success(0.002));
+	CHECK(quantile_model.is_invocation_objective_success(0.010));
+	CHECK(quantile_model.is_invocation_objective_success(0.0101) == false);
+
+	Opp::FrameDecisionModel window_model(0);
+	window_model.initialize_objective(true, 0.010, 0.1, 0.1, 0.9, 1, 0, Opp::Objective::EnfPER_FRAME, 0);
+	CHECK(window_model.is_invocation_objective_success(0.002) == false);
+	CHECK(window_model.is_invocation_objective_success(0.0105));
+}
+
+static void test_p2_quantile_accuracy() {
+	//a permutation of 0.000 .. 0.999
+	Opp::P2QuantileEstimator median(0.5), p90(0.9), p99(0.99);
+	CHECK(median.get_estimate() == 0.0);
+	for(int i=0; i<1000; i++) {
+		double x = ((i * 7919) % 1000) / 1000.0;
+		median.note_sample(x);
+		p90.note_sample(x);
+		p99.note_sample(x);
+	}
+	CHECK(median.get_sample_count() == 1000);
+	CHECK(is_near(median.get_estimate(), 0.5, 0.02));
+	CHECK(is_near(p90.get_estimate(), 0.9, 0.02));
+	CHECK(is_near(p99.get_estimate(), 0.99, 0.02));
+
+	//fewer than 5 samples: exact
+	Opp::P2QuantileEstimator few(0.5);
+	few.note_sample(3.0);
+	few.note_sample(1.0);
+	few.note_sample(2.0);
+	CHECK(few.get_estimate() == 2.0);
+}
+
+static void test_quantile_sketch_block_blending() {
+	std::vector<double> vQuantileProbs(1, 0.5);
+	Opp::StreamingQuantileSketch sketch;
+	sketch.initialize(vQuantileProbs, 100);
+	for(int i=0; i<100; i++)
+		sketch.note_sample(1.0);
+	CHECK(sketch.get_quantile(0) == 1.0);
+
+	//a quarter into the next block: 1/4 of the new regime, 3/4 of the previous block
+	for(int i=0; i<25; i++)
+		sketch.note_sample(3.0);
+	CHECK(sketch.get_sample_count() == 125);
+	CHECK(is_near(sketch.get_quantile(0), 1.5, 1e-9));
+
+	Opp::WindowFractionCounter counter;
+	counter.initialize(10);
+	for(int i=0; i<10; i++)
+		counter.note_event(true);
+	CHECK(counter.get_fraction() == 1.0);
+	for(int i=0; i<5; i++)
+		counter.note_event(false);
+	CHECK(is_near(counter.get_sample_count(), 10.0, 1e-9));
+	CHECK(is_near(counter.get_fraction(), 0.5, 1e-9));
+}
+
+static bool satisfies_test_constraint(const std::vector<int>& dec_vec)
+	{ return dec_vec[0] >= dec_vec[1] && dec_vec[2] != dec_vec[3]; }
+
+static void test_validity_oracle_tabulated_and_per_query() {
+	Opp::Constraint constraint = (Opp::VID(0) >= Opp::VID(1)) && ~(Opp::VID(2) == Opp::VID(3));
+
+	//4 variables of 4 values: tabulated
+	std::vector<int> vDecisionVector;
+	for(int i=0; i<4; i++)
+		vDecisionVector.push_back(i);
+	Opp::DecisionValidityOracle tabulated(constraint, vDecisionVector, std::vector<int>(4, 4));
+	CHECK(tabulated.constrains_decisions() && tabulated.is_tabulated());
+	int num_valid = 0;
+	for(Opp::DecisionKey_t key=0; key<256; key++) {
+		std::vector<int> dec_vec(4);
+		for(int i=0; i<4; i++)
+			dec_vec[i] = (int)((key >> (2 * (3 - i))) & 3); //last variable least significant
+		CHECK(tabulated.is_valid(dec_vec) == satisfies_test_constraint(dec_vec));
+		CHECK(tabulated.is_valid_key(key) == satisfies_test_constraint(dec_vec));
+		if(satisfies_test_constraint(dec_vec))
+			num_valid++;
+	}
+	CHECK((int)tabulated.get_valid_keys().size() == num_valid);
+
+	//21 binary variables: beyond max_tabulated_decision_vectors, evaluated per query to the same result
+	vDecisionVector.clear();
+	for(int i=0; i<21; i++)
+		vDecisionVector.push_back(i);
+	Opp::DecisionValidityOracle per_query(constraint, vDecisionVector, std::vector<int>(21, 2));
+	CHECK(per_query.constrains_decisions() && per_query.is_tabulated() == false);
+	for(int k=0; k<64; k++) {
+		std::vector<int> dec_vec(21);
+		Opp::DecisionKey_t key = 0;
+		for(int i=0; i<21; i++) {
+			dec_vec[i] = (i < 4 ? (k >> i) & 1 : (k >> (i % 6)) & 1);
+			key = key * 2 + dec_vec[i];
+		}
+		CHECK(per_query.is_valid(dec_vec) == satisfies_test_constraint(dec_vec));
+		CHECK(per_query.is_valid_key(key) == satisfies_test_constraint(dec_vec));
+	}
+
+	//3-valued evaluation of partial assignments
+	std::vector<int> partial_dec_vec(21, -1);
+	partial_dec_vec[2] = 1;
+	CHECK(per_query.is_consistent(partial_dec_vec));
+	partial_dec_vec[3] = 1;
+	CHECK(per_query.is_consistent(partial_dec_vec) == false);
+}
+
+static int knob_a_value = -1;
+static int knob_b_value = -1;
+void set_knob_a(double value) { knob_a_value = (int)value; }
+void set_knob_b(double value) { knob_b_value = (int)value; }
+
+static void test_forced_decision_projected_onto_valid() {
+	//knob a must not be below knob b; the forced default (0, 3) is not valid
+	static Opp::Frame f_constrained(Opp::Objective(0.001, 0.2, 0.2, 0.9, 3), Opp::VID(0) >= Opp::VID(1));
+	std::vector<Opp::Model> vM;
+	vM.push_back( Opp::Model::integer_knob(0, set_knob_a, 0, 3, 0) );
+	vM.push_back( Opp::Model::integer_knob(1, set_knob_b, 0, 3, 3) );
+	Opp::Model model_knobs(vM);
+	static Opp::ExecFrame ef_knobs(model_knobs);
+
+	ef_knobs.force_default_selection(true);
+	Opp::frame_enter(f_constrained.id);
+	ef_knobs.run();
+	Opp::frame_exit_complete(f_constrained.id);
+	//the nearest valid decision-vectors, (0,0), (1,1), (2,2) and (3,3), are at distance 3
+	CHECK(knob_a_value >= knob_b_value && abs(knob_a_value - 0) + abs(knob_b_value - 3) == 3);
+
+	//no strategy executes an invalid decision-vector
+	ef_knobs.force_default_selection(false);
+	bool bAllValid = true;
+	for(int i=0; i<200; i++) {
+		Opp::frame_enter(f_constrained.id);
+		ef_knobs.run();
+		bAllValid = bAllValid && (knob_a_value >= knob_b_value);
+		Opp::frame_exit_complete(f_constrained.id);
+	}
+	CHECK(bAllValid);
+}
+
+static std::string read_file(const char * filename) {
+	std::ifstream ifs(filename, std::ios::in | std::ios::binary);
+	std::ostringstream oss;
+	oss << ifs.rdbuf();
+	return oss.str();
+}
+
+static void write_file(const char * filename, const std::string& contents) {
+	std::ofstream ofs(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	ofs << contents;
+}
+
+static void test_snapshot_round_trip_and_rejection() {
+	Opp::IntValueCache cache(4, 100.0);
+	cache.note_sample(7, 2.0);
+	cache.note_sample(9, 3.0);
+	Opp::SnapshotWriter writer;
+	cache.save_snapshot(writer);
+
+	Opp::IntValueCache loaded;
+	Opp::SnapshotReader reader(writer.get_buffer());
+	CHECK(loaded.load_snapshot(reader) && reader.at_end());
+	CHECK(loaded.get_sample_count() == 5.0 && loaded.tag_occurence_count(7) == 2.0 && loaded.tag_occurence_count(9) == 3.0);
+
+	//a truncated record leaves the cache as it was
+	std::string truncated = writer.get_buffer().substr(0, writer.get_buffer().size() - 1);
+	Opp::SnapshotReader truncated_reader(truncated);
+	CHECK(loaded.load_snapshot(truncated_reader) == false);
+	CHECK(loaded.get_sample_count() == 5.0 && loaded.tag_occurence_count(9) == 3.0);
+
+	//a spread of another number of bins is rejected, leaving the spread as it was
+	Opp::ParameterExecSpread spread(3);
+	spread.note_spread_bin_occurence(1, 7);
+	Opp::SnapshotWriter spread_writer;
+	spread.save_snapshot(spread_writer);
+	Opp::ParameterExecSpread other_spread(4);
+	other_spread.note_spread_bin_occurence(2, 5);
+	Opp::SnapshotReader spread_reader(spread_writer.get_buffer());
+	CHECK(other_spread.load_snapshot(spread_reader) == false);
+	CHECK(other_spread.current_sample_count() == 1.0 && other_spread.vExecSpreadBins[2].tag_occurence_count(5) == 1.0);
+
+	//files: the state of a named Frame survives a save-load-save round trip
+	static Opp::Frame f_snapshot(Opp::Objective(0.001, 0.2, 0.2, 0.9, 3));
+	Opp::frame_set_name(f_snapshot.id, "f_snapshot");
+	for(int i=0; i<20; i++) {
+		Opp::frame_enter(f_snapshot.id);
+		Opp::frame_exit_complete(f_snapshot.id);
+	}
+	const char * filename = "opp_test_snapshot.tmp";
+	CHECK(Opp::snapshot_save(filename));
+	std::string saved = read_file(filename);
+	CHECK(Opp::snapshot_load(filename));
+	CHECK(Opp::snapshot_save(filename) && read_file(filename) == saved);
+
+	//truncated and foreign files are rejected
+	write_file(filename, saved.substr(0, saved.size() - 1));
+	CHECK(Opp::snapshot_load(filename) == false);
+	write_file(filename, "not a snapshot");
+	CHECK(Opp::snapshot_load(filename) == false);
+	remove(filename);
+}
+
+static int samples_until_change_detected(Opp::PageHinkleyDetector& detector, double x, double threshold, int max_samples, int& detected) {
+	for(int i=1; i<=max_samples; i++) {
+		detected = detector.note_sample(x, threshold);
+		if(detected != 0)
+			return i;
+	}
+	detected = 0;
+	return max_samples + 1;
+}
+
+static void test_page_hinkley_detection() {
+	Opp::PageHinkleyDetector detector(0.1);
+	int detected = 0;
+
+	//a stationary stream, and a shift smaller than delta, are never detected
+	CHECK(samples_until_change_detected(detector, 1.0, 2.0, 100, detected) == 101);
+	CHECK(samples_until_change_detected(detector, 1.05, 2.0, 1000, detected) == 1001);
+
+	//an increase of 1.0 is detected within a few samples, and the detector restarts from the new regime
+	detector.reset();
+	samples_until_change_detected(detector, 1.0, 2.0, 100, detected);
+	int delay = samples_until_change_detected(detector, 2.0, 2.0, 100, detected);
+	CHECK(detected == +1 && delay <= 5);
+	CHECK(detector.get_sample_count() == 0);
+
+	//a decrease
+	samples_until_change_detected(detector, 2.0, 2.0, 100, detected);
+	delay = samples_until_change_detected(detector, 0.5, 2.0, 100, detected);
+	CHECK(detected == -1 && delay <= 5);
+}
+
+static void test_latency_histogram_precision_and_merge() {
+	//each value is reported to within one sub-bucket: a relative error below 1/128 above 256 ns
+	bool bWithinPrecision = true;
+	for(long long value_ns=1; value_ns<=Opp::LatencyHistogram::highest_trackable_ns / 2; value_ns=value_ns*3+1) {
+		int counts_index = Opp::LatencyHistogram::get_counts_index(value_ns);
+		long long lowest_ns = Opp::LatencyHistogram::get_lowest_value_at_index(counts_index);
+		long long highest_ns = Opp::LatencyHistogram::get_highest_value_at_index(counts_index);
+		bWithinPrecision = bWithinPrecision && lowest_ns <= value_ns && value_ns <= highest_ns
+			&& (value_ns < 256 ? lowest_ns == highest_ns : (highest_ns - lowest_ns + 1) * 128 <= lowest_ns);
+	}
+	CHECK(bWithinPrecision);
+
+	//1 .. 1000 us, split into two histograms and merged
+	Opp::LatencyHistogram all, lower, upper;
+	for(int us=1; us<=1000; us++) {
+		all.record(us * 1e-6);
+		(us <= 500 ? lower : upper).record(us * 1e-6);
+	}
+	CHECK(all.get_total_count() == 1000);
+	CHECK(is_near(all.get_value_at_percentile(50.0), 500e-6, 500e-6 / 128));
+	CHECK(is_near(all.get_value_at_percentile(99.0), 990e-6, 990e-6 / 128));
+	CHECK(is_near(all.get_fraction_at_or_below(250e-6), 0.25, 0.01));
+	CHECK(is_near(all.get_min(), 1e-6, 1e-9) && is_near(all.get_max(), 1000e-6, 1e-9)); //exact, to the ns
+	CHECK(is_near(all.get_mean(), 500.5e-6, 1e-9));
+
+	lower.merge(upper);
+	CHECK(lower.get_total_count() == all.get_total_count());
+	CHECK(lower.get_min() == all.get_min() && lower.get_max() == all.get_max());
+	CHECK(is_near(lower.get_mean(), all.get_mean(), 1e-12));
+	bool bSamePercentiles = true;
+	for(double percentile=0.0; percentile<=100.0; percentile+=2.5)
+		bSamePercentiles = bSamePercentiles && lower.get_value_at_percentile(percentile) == all.get_value_at_percentile(percentile);
+	CHECK(bSamePercentiles);
+
+	Opp::LatencyHistogram empty;
+	CHECK(empty.get_value_at_percentile(50.0) == 0.0 && empty.get_fraction_at_or_below(1.0) == 0.0);
+}
+
+static void test_latency_histogram_unrecord() {
+	Opp::LatencyHistogram histogram;
+	for(int us=1; us<=1000; us++)
+		histogram.record(us * 1e-6);
+	for(int us=1; us<=500; us++)
+		histogram.unrecord(us * 1e-6);
+	CHECK(histogram.get_total_count() == 500);
+	CHECK(is_near(histogram.get_value_at_percentile(50.0), 750e-6, 750e-6 / 128));
+	CHECK(is_near(histogram.get_min(), 501e-6, 501e-6 / 128)); //to within the histogram's precision
+	CHECK(is_near(histogram.get_max(), 1000e-6, 1000e-6 / 128));
+	CHECK(is_near(histogram.get_mean(), 750.5e-6, 1e-9));
+
+	for(int us=501; us<=1000; us++)
+		histogram.unrecord(us * 1e-6);
+	CHECK(histogram.get_total_count() == 0 && histogram.get_min() == 0.0 && histogram.get_max() == 0.0);
+}
+
+static void test_statistics_windows() {
+	Opp::timing_use_virtual_clock(true);
+	static Opp::Frame f_windowed(Opp::Objective(0.001, 0.2, 0.2, 0.9, 1));
+	Opp::frame_set_statistics_windows(f_windowed.id, 5, 1.0);
+	for(int i=0; i<10; i++) {
+		Opp::frame_enter(f_windowed.id);
+		Opp::timing_advance_virtual_clock(0.001);
+		Opp::frame_exit_complete(f_windowed.id);
+	}
+	Opp::FrameStatistics stats(f_windowed.id);
+	stats.refresh();
+	CHECK(stats.window_by_count.get_count() == 5);
+	CHECK(stats.window_by_time.get_count() == 10);
+	CHECK(stats.window_by_count.get_satisfaction_ratio() == 1.0);
+
+	//no invocation completes for longer than the window: read as of now, the window by time is empty
+	Opp::timing_advance_virtual_clock(2.0);
+	stats.refresh();
+	CHECK(stats.window_by_count.get_count() == 5);
+	CHECK(stats.window_by_time.get_count() == 0);
+	Opp::timing_use_virtual_clock(false);
+}
+
+static int vAlternative_calls[3] = {0, 0, 0};
+void alternative_0() { vAlternative_calls[0]++; }
+void alternative_1() { vAlternative_calls[1]++; }
+void alternative_2() { vAlternative_calls[2]++; }
+
+static void test_static_select() {
+	CHECK((Opp::StaticSelect<alternative_0, alternative_1>::num_choices == 2));
+	CHECK((Opp::StaticSelect<alternative_0, alternative_1, alternative_2>::num_choices == 3));
+
+	static Opp::Frame f_static_select(Opp::Objective(0.001, 0.2, 0.2, 0.9, 3));
+	static Opp::StaticSelect<alternative_0, alternative_1, alternative_2> select(0, 0, 2);
+	for(int i=0; i<50; i++) {
+		Opp::frame_enter(f_static_select.id);
+		select.run();
+		select.run();
+		Opp::frame_exit_complete(f_static_select.id);
+	}
+	//exactly one alternative per run, each run accounted for
+	CHECK(vAlternative_calls[0] + vAlternative_calls[1] + vAlternative_calls[2] == 100);
+	CHECK(Opp::ExecFrameStatistics(select.get_execframe().id).refresh().run_count == 100);
+
+	select.get_execframe().force_default_selection(true);
+	int calls_before = vAlternative_calls[2];
+	Opp::frame_enter(f_static_select.id);
+	select.run();
+	Opp::frame_exit_complete(f_static_select.id);
+	select.get_execframe().force_default_selection(false);
+	CHECK(vAlternative_calls[2] == calls_before + 1);
+}
+
+void batch_alternative_0(long long) { Opp::timing_advance_virtual_clock(0.001); }
+void batch_alternative_1(long long) { Opp::timing_advance_virtual_clock(0.0001); }
+
+static void test_run_batch() {
+	Opp::timing_use_virtual_clock(true);
+	static Opp::Frame f_batch(Opp::Objective(0.05, 0.2, 0.2, 0.9, 3));
+	static Opp::StaticBatchSelect<long long, batch_alternative_0, batch_alternative_1> batch_select(0);
+	Opp::Parameter& decision_parm = Opp::ExecFrameInfo::get_execframe_info(&batch_select.get_execframe())
+		->decision_model.decision_vector_parameter;
+	bool bOneSamplePerBatch = true;
+	for(int i=0; i<20; i++) {
+		Opp::frame_enter(f_batch.id);
+		batch_select.run_batch(1);
+		batch_select.run_batch(500);
+		//a large batch does not saturate the enclosing Frame's record of the invocation's decisions
+		if(decision_parm.map_consumer_caches.count(&f_batch) == 1)
+			bOneSamplePerBatch = bOneSamplePerBatch && decision_parm.map_consumer_caches[&f_batch]->get_sample_count() == 2.0;
+		Opp::frame_exit_complete(f_batch.id);
+	}
+	CHECK(decision_parm.map_consumer_caches.count(&f_batch) == 1);
+	CHECK(bOneSamplePerBatch);
+
+	Opp::ExecFrameStatistics stats(batch_select.get_execframe().id);
+	stats.refresh();
+	CHECK(stats.run_count == 40);
+	CHECK(stats.item_count == 20 * 501);
+	bool bItemCostsMeasured = stats.map_decision_to_item_cost.size() >= 1;
+	for(std::map<long long, Opp::ExecTime_t>::iterator mit = stats.map_decision_to_item_cost.begin(); mit != stats.map_decision_to_item_cost.end(); mit++) {
+		Opp::ExecTime_t item_cost = 0.0;
+		bItemCostsMeasured = bItemCostsMeasured
+			&& Opp::ExecFrameInfo::get_execframe_info(&batch_select.get_execframe())->decision_model.get_item_cost(mit->first, item_cost)
+			&& item_cost == mit->second
+			&& is_near(mit->second, (mit->first == 0 ? 0.001 : 0.0001), 1e-6);
+	}
+	CHECK(bItemCostsMeasured);
+	Opp::timing_use_virtual_clock(false);
+}
+
+static int last_paced_alternative = -1;
+void paced_alternative_0(long long) { last_paced_alternative = 0; Opp::timing_advance_virtual_clock(0.001); }
+void paced_alternative_1(long long) { last_paced_alternative = 1; Opp::timing_advance_virtual_clock(0.0005); }
+void paced_alternative_2(long long) { last_paced_alternative = 2; Opp::timing_advance_virtual_clock(0.0001); }
+
+static void test_pace() {
+	Opp::timing_use_virtual_clock(true);
+	static Opp::Frame f_paced(Opp::Objective(0.05, 0.2, 0.2, 0.9, 3));
+	static Opp::StaticBatchSelect<long long, paced_alternative_0, paced_alternative_1, paced_alternative_2> paced_select(0);
+	Opp::ExecFrame& ef = paced_select.get_execframe();
+
+	//100 items in 0.06s: only alternatives 1 and 2 fit, once measured
+	bool bDeadlinesMet = true;
+	for(int i=0; i<20; i++) {
+		double start = Opp::timing_get_virtual_clock();
+		Opp::frame_enter(f_paced.id);
+		paced_select.run_paced(100, 0.06, 10);
+		Opp::frame_exit_complete(f_paced.id);
+		if(i >= 5)
+			bDeadlinesMet = bDeadlinesMet && Opp::timing_get_virtual_clock() - start <= 0.06 + 1e-9;
+	}
+	CHECK(bDeadlinesMet);
+
+	//one item per run, in 0.03s: the decision shifts from alternative 2 up to 1 as time is saved,
+	//  but is revisited only every check_period items
+	bool bKeptBetweenChecks = true;
+	int num_shifts = 0;
+	double start = Opp::timing_get_virtual_clock();
+	Opp::frame_enter(f_paced.id);
+	ef.pace(100, 0.03, 25);
+	int previous_alternative = -1;
+	for(int i=0; i<100; i++) {
+		paced_select.run_batch(1);
+		if(i % 25 != 0)
+			bKeptBetweenChecks = bKeptBetweenChecks && last_paced_alternative == previous_alternative;
+		else if(previous_alternative != -1 && last_paced_alternative != previous_alternative)
+			num_shifts++;
+		previous_alternative = last_paced_alternative;
+	}
+	Opp::frame_exit_complete(f_paced.id);
+	CHECK(bKeptBetweenChecks);
+	CHECK(num_shifts >= 1);
+	CHECK(Opp::timing_get_virtual_clock() - start <= 0.03 + 1e-9);
+
+	//the valid decision-vectors are enumerated once per set of active Constraints
+	Opp::ExecFrameInfo * info = Opp::ExecFrameInfo::get_execframe_info(&ef);
+	CHECK(&info->get_valid_decision_keys() == &info->get_valid_decision_keys());
+	CHECK(info->get_valid_decision_keys().size() == 3);
+	Opp::timing_use_virtual_clock(false);
+}
+
+static Opp::FastReactionState * new_learned_fast_reaction_state(double coeff_a, double max_x, double x) {
+	Opp::FastReactionState * frs = new Opp::FastReactionState();
+	frs->vCoeffs_a.push_back(coeff_a);
+	frs->vMax_X.push_back(max_x);
+	frs->vPrevious_model_choice_double_value.push_back(x);
+	return frs;
+}
+
+static void test_budget_share_retargeting() {
+	static Opp::Frame f_budget(Opp::Objective(0.010, 0.2, 0.2, 0.9, 1));
+	static Opp::Frame f_share_a(Opp::Objective::budget_share(f_budget.id, 0.3, 0.2, 0.2, 0.9));
+	static Opp::Frame f_share_b(Opp::Objective::budget_share(f_budget.id, 0.5, 0.2, 0.2, 0.9));
+	Opp::frame_enter(f_budget.id);
+	Opp::frame_enter(f_share_a.id);
+	Opp::frame_exit_complete(f_share_a.id);
+	Opp::frame_enter(f_share_b.id);
+	Opp::frame_exit_complete(f_share_b.id);
+	Opp::frame_exit_complete(f_budget.id);
+
+	Opp::FrameDecisionModel& budget_dec = Opp::FrameInfo::get_frame_info(&f_budget)->decision_model;
+	Opp::FrameDecisionModel& a_dec = Opp::FrameInfo::get_frame_info(&f_share_a)->decision_model;
+	Opp::FrameDecisionModel& b_dec = Opp::FrameInfo::get_frame_info(&f_share_b)->decision_model;
+	CHECK(budget_dec.vBudget_share_frames.size() == 2);
+
+	//costs not learned yet: initial shares of the budget frame's mean objective
+	budget_dec.recent_exec_time = a_dec.recent_exec_time = b_dec.recent_exec_time = 0.0;
+	Opp::retarget_budget_share_objective(&f_share_a);
+	Opp::retarget_budget_share_objective(&f_share_b);
+	CHECK(is_near(a_dec.mean_objective, 0.003, 1e-12));
+	CHECK(is_near(b_dec.mean_objective, 0.005, 1e-12));
+
+	//a: cost 0.002 at the lowest feature level, range 0.004; b: 0.002, range 0.002
+	Opp::Parameter parm_a(0), parm_b(0);
+	a_dec.map_parm_to_fast_reaction_state[&parm_a] = new_learned_fast_reaction_state(-0.001, 4.0, 2.0);
+	b_dec.map_parm_to_fast_reaction_state[&parm_b] = new_learned_fast_reaction_state(-0.0005, 4.0, 2.0);
+	a_dec.recent_exec_time = 0.004;
+	b_dec.recent_exec_time = 0.003;
+
+	//budget 0.010 less 0.001 outside the sharing frames: each gets its lowest-feature cost, then the rest of the
+	//  budget goes to the cheapest range first (all of b's, 0.002), and then to a (0.003 of its 0.004)
+	budget_dec.recent_exec_time = 0.008;
+	Opp::retarget_budget_share_objective(&f_share_a);
+	Opp::retarget_budget_share_objective(&f_share_b);
+	CHECK(is_near(a_dec.mean_objective, 0.005, 1e-12));
+	CHECK(is_near(b_dec.mean_objective, 0.004, 1e-12));
+
+	//over budget even at the lowest feature levels: lowest-feature costs scaled down proportionately
+	budget_dec.recent_exec_time = 0.0;
+	budget_dec.mean_objective = 0.003;
+	Opp::retarget_budget_share_objective(&f_share_a);
+	Opp::retarget_budget_share_objective(&f_share_b);
+	CHECK(is_near(a_dec.mean_objective, 0.0015, 1e-12));
+	CHECK(is_near(b_dec.mean_objective, 0.0015, 1e-12));
+
+	//b not learned yet: b keeps its initial share, a gets its lowest-feature cost and the rest, upto its range
+	budget_dec.mean_objective = 0.010;
+	b_dec.recent_exec_time = 0.0;
+	Opp::retarget_budget_share_objective(&f_share_a);
+	Opp::retarget_budget_share_objective(&f_share_b);
+	CHECK(is_near(a_dec.mean_objective, 0.005, 1e-12));
+	CHECK(is_near(b_dec.mean_objective, 0.005, 1e-12));
+
+	//retargeting restarts a potential halfcycle only if the last execution time is on the other side of the new mean
+	Opp::FastReactionState& frs = *(a_dec.map_parm_to_fast_reaction_state[&parm_a]);
+	frs.previous_Y = 0.0045;
+	frs.halfcycle_start_deflection_sign = -1;
+	frs.has_halfcycle_crossed_mean = false;
+	frs.halfcycle_length = 5;
+	a_dec.retarget_mean_objective(0.005);
+	CHECK(frs.halfcycle_start_deflection_sign == -1 && frs.halfcycle_length == 5);
+	a_dec.retarget_mean_objective(0.004);
+	CHECK(frs.halfcycle_start_deflection_sign == +1 && frs.halfcycle_length == 0 && frs.has_halfcycle_crossed_mean == false);
+
+	delete a_dec.map_parm_to_fast_reaction_state[&parm_a];
+	delete b_dec.map_parm_to_fast_reaction_state[&parm_b];
+	a_dec.map_parm_to_fast_reaction_state.erase(&parm_a);
+	b_dec.map_parm_to_fast_reaction_state.erase(&parm_b);
+}
+
+static int last_quality_alternative = -1;
+void quality_alternative_0() { last_quality_alternative = 0; Opp::timing_advance_virtual_clock(0.001); }
+void quality_alternative_1() { last_quality_alternative = 1; Opp::timing_advance_virtual_clock(0.001); }
+void quality_alternative_2() { last_quality_alternative = 2; Opp::timing_advance_virtual_clock(0.001); }
+
+static void test_quality_feedback_changes_decision() {
+	Opp::timing_use_virtual_clock(true);
+	bool bWasFastReaction = Opp::feature_query_use_fast_reaction_strategy();
+	Opp::feature_control_use_fast_reaction_strategy(false);
+	Opp::feature_control_use_thompson_sampling_strategy(true);
+
+	//every alternative meets the objective; only the lowest-priority one is reported to achieve quality
+	static Opp::Frame f_quality(Opp::Objective(0.001, 0.2, 0.2, 0.9, 1));
+	static Opp::Frame f_unreported(Opp::Objective(0.001, 0.2, 0.2, 0.9, 1));
+	static Opp::StaticSelect<quality_alternative_0, quality_alternative_1, quality_alternative_2> quality_select(0);
+	static Opp::StaticSelect<quality_alternative_0, quality_alternative_1, quality_alternative_2> unreported_select(0);
+	int num_quality_choices = 0;
+	int num_unreported_priority_choices = 0;
+	for(int i=0; i<300; i++) {
+		Opp::frame_enter(f_quality.id);
+		quality_select.run();
+		Opp::frame_report_quality(f_quality.id, last_quality_alternative == 2 ? 1.0 : 0.0);
+		Opp::frame_exit_complete(f_quality.id);
+		if(i >= 200 && last_quality_alternative == 2)
+			num_quality_choices++;
+
+		Opp::frame_enter(f_unreported.id);
+		unreported_select.run();
+		Opp::frame_exit_complete(f_unreported.id);
+		if(i >= 200 && last_quality_alternative == 0)
+			num_unreported_priority_choices++;
+	}
+	CHECK(num_quality_choices >= 80);
+	CHECK(num_unreported_priority_choices >= 80);
+
+	Opp::feature_control_use_thompson_sampling_strategy(false);
+	Opp::feature_control_use_fast_reaction_strategy(bWasFastReaction);
+	Opp::timing_use_virtual_clock(false);
+}
+
+static int last_floor_alternative = -1;
+void floor_alternative_0() { last_floor_alternative = 0; Opp::timing_advance_virtual_clock(0.003); }
+void floor_alternative_1() { last_floor_alternative = 1; Opp::timing_advance_virtual_clock(0.002); }
+void floor_alternative_2() { last_floor_alternative = 2; Opp::timing_advance_virtual_clock(0.001); }
+
+static void test_quality_floor() {
+	Opp::timing_use_virtual_clock(true);
+	//qualities 1.0, 0.9 and 0.5 from the most to the least expensive alternative: only the first two meet the floor
+	static Opp::Frame f_floor(Opp::Objective::quality_floor(0.8, 0.9));
+	static Opp::StaticSelect<floor_alternative_0, floor_alternative_1, floor_alternative_2> floor_select(0);
+	const double vQuality[3] = {1.0, 0.9, 0.5};
+	int num_cheapest_meeting_floor = 0;
+	for(int i=0; i<300; i++) {
+		Opp::frame_enter(f_floor.id);
+		floor_select.run();
+		Opp::frame_report_quality(f_floor.id, vQuality[last_floor_alternative]);
+		Opp::frame_exit_complete(f_floor.id);
+		if(i >= 200 && last_floor_alternative == 1)
+			num_cheapest_meeting_floor++;
+	}
+	CHECK(num_cheapest_meeting_floor >= 80);
+
+	//reports arriving after the invocation completed count as one trial each, for its decision
+	Opp::Parameter * decision_parm = &(Opp::ExecFrameInfo::get_execframe_info(&floor_select.get_execframe())->decision_model.decision_vector_parameter);
+	Opp::FrameDecisionModel& floor_dec = Opp::FrameInfo::get_frame_info(&f_floor)->decision_model;
+	CHECK(floor_dec.map_parm_to_thompson_model.count(decision_parm) == 1);
+	Opp::ThompsonSamplingModel * thompson_model = floor_dec.map_parm_to_thompson_model[decision_parm];
+	Opp::frame_enter(f_floor.id);
+	floor_select.run();
+	Opp::frame_exit_complete(f_floor.id);
+	double trials_before = thompson_model->get_observation_count(Opp::ThompsonSamplingModel::quality_floor_context_bin, last_floor_alternative);
+	Opp::frame_report_quality(f_floor.id, 1.0);
+	Opp::frame_report_quality(f_floor.id, 0.0);
+	CHECK(is_near(thompson_model->get_observation_count(Opp::ThompsonSamplingModel::quality_floor_context_bin, last_floor_alternative),
+		trials_before + 2.0, 1e-9));
+	Opp::timing_use_virtual_clock(false);
+}
+
+
 int main() {
 	Opp::feature_control_use_fast_reaction_strategy(true);
 
@@ -99,5 +770,26 @@ int main() {
 
 	Opp::frame_exit_complete(f_main.id);
 	std::cout << stats_f_main.refresh().print_string() << std::endl;
-	return 0;
+
+	test_workload_hint_regression();
+	test_thompson_sampling_posterior();
+	test_thompson_sampling_success_follows_enforcement();
+	test_p2_quantile_accuracy();
+	test_quantile_sketch_block_blending();
+	test_validity_oracle_tabulated_and_per_query();
+	test_forced_decision_projected_onto_valid();
+	test_snapshot_round_trip_and_rejection();
+	test_page_hinkley_detection();
+	test_latency_histogram_precision_and_merge();
+	test_latency_histogram_unrecord();
+	test_statistics_windows();
+	test_static_select();
+	test_run_batch();
+	test_pace();
+	test_budget_share_retargeting();
+	test_quality_feedback_changes_decision();
+	test_quality_floor();
+
+	std::cout << (num_failed_checks == 0 ? "All checks passed" : "CHECKS FAILED") << std::endl;
+	return (num_failed_checks == 0 ? 0 : 1);
 }
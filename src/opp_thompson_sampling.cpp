@@ -0,0 +1,406 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#include <sstream>
+#include <algorithm>
+#include <cassert>
+
+#include "opp_thompson_sampling.h"
+#include "opp_random.h"
+#include "opp_snapshot.h"
+
+namespace Opp {
+
+/////////////////////////////////////////
+//class ThompsonSamplingModel definitions
+/////////////////////////////////////////
+
+const double ThompsonSamplingModel::prior_successes = 1.0;
+const double ThompsonSamplingModel::prior_failures = 1.0;
+const double ThompsonSamplingModel::miss_penalty = 1.0;
+const double ThompsonSamplingModel::min_retained_count = 0.01;
+const double ThompsonSamplingModel::prior_quality_weight = 0.25;
+const double ThompsonSamplingModel::quality_cost_preference = 0.1;
+const double ThompsonSamplingModel::prior_cost_weight = 0.25;
+
+int ThompsonSamplingModel::get_context_bin(
+	ExecTime_t recent_exec_time,
+	ExecTime_t mean_objective,
+	double window_frac_lower,
+	double window_frac_upper
+)
+{
+	if(recent_exec_time < mean_objective * (1.0 - window_frac_lower))
+		return 0;
+	if(recent_exec_time < mean_objective)
+		return 1;
+	if(recent_exec_time <= mean_objective * (1.0 + window_frac_upper))
+		return 2;
+	if(recent_exec_time <= mean_objective * (1.0 + 2.0 * window_frac_upper))
+		return 3;
+	return 4;
+}
+
+void ThompsonSamplingModel::initialize_factorization(const std::vector<int>& vNum_values) {
+	this->vNum_values = vNum_values;
+	vContext_Variable_Value_SuccessFailureCounts.assign(num_context_bins, std::vector< std::vector< std::pair<double, double> > >());
+	for(int c=0; c<num_context_bins; c++) {
+		for(int i=0; i<(int)vNum_values.size(); i++) {
+			assert(vNum_values[i] > 0);
+			vContext_Variable_Value_SuccessFailureCounts[c].push_back(
+				std::vector< std::pair<double, double> >(vNum_values[i], std::make_pair(0.0, 0.0)) );
+		}
+	}
+
+	vVariable_Value_QualitySumWeight.clear();
+	vVariable_Value_CostSumWeight.clear();
+	for(int i=0; i<(int)vNum_values.size(); i++) {
+		vVariable_Value_QualitySumWeight.push_back( std::vector< std::pair<double, double> >(vNum_values[i], std::make_pair(0.0, 0.0)) );
+		vVariable_Value_CostSumWeight.push_back( std::vector< std::pair<double, double> >(vNum_values[i], std::make_pair(0.0, 0.0)) );
+	}
+}
+
+double ThompsonSamplingModel::get_observation_count(int context_bin, DecisionKey_t decision_int_value) const {
+	const std::map<DecisionKey_t, std::pair<double, double> >& map_counts = vContext_Decision_SuccessFailureCounts.at(context_bin);
+	std::map<DecisionKey_t, std::pair<double, double> >::const_iterator mit = map_counts.find(decision_int_value);
+	if(mit == map_counts.end())
+		return 0.0;
+	return mit->second.first + mit->second.second;
+}
+
+double ThompsonSamplingModel::sample_success_probability(int context_bin, DecisionKey_t decision_int_value) const {
+	const std::map<DecisionKey_t, std::pair<double, double> >& map_counts = vContext_Decision_SuccessFailureCounts.at(context_bin);
+	std::map<DecisionKey_t, std::pair<double, double> >::const_iterator mit = map_counts.find(decision_int_value);
+
+	double successes = 0.0;
+	double failures = 0.0;
+	if(mit != map_counts.end()) {
+		successes = mit->second.first;
+		failures = mit->second.second;
+	}
+	return random_beta(prior_successes + successes, prior_failures + failures);
+}
+
+double ThompsonSamplingModel::sample_variable_success_probability(int context_bin, int dec_var_index, int value) const {
+	assert(is_factorized());
+	const std::pair<double, double>& counts = vContext_Variable_Value_SuccessFailureCounts.at(context_bin).at(dec_var_index).at(value);
+	return random_beta(prior_successes + counts.first, prior_failures + counts.second);
+}
+
+void ThompsonSamplingModel::note_outcome(int context_bin, DecisionKey_t decision_int_value, double weight, bool bSuccess) {
+	assert(weight >= 0.0);
+
+	std::pair<double, double>& counts = vContext_Decision_SuccessFailureCounts.at(context_bin)[decision_int_value];
+	if(bSuccess)
+		counts.first += weight;
+	else
+		counts.second += weight;
+
+	if(is_factorized()) { //decode the decision-vector, last variable least significant
+		for(int i=(int)vNum_values.size()-1; i >= 0; i--) {
+			int value = (int)(decision_int_value % vNum_values[i]);
+			decision_int_value /= vNum_values[i];
+
+			std::pair<double, double>& variable_counts = vContext_Variable_Value_SuccessFailureCounts.at(context_bin)[i][value];
+			if(bSuccess)
+				variable_counts.first += weight;
+			else
+				variable_counts.second += weight;
+		}
+		assert(decision_int_value == 0);
+	}
+}
+
+void ThompsonSamplingModel::note_last_invocation_decisions(const std::vector< std::pair<DecisionKey_t, double> >& vDecisions) {
+	vLast_invocation_decisions = vDecisions;
+}
+
+//adds value (weighted by each decision-vector's share of the invocation) to the sums of the decision-vectors
+//  in vDecisions, and of their variables' values if vVariable_Value_SumWeight is non-empty
+static void credit_decisions(
+	const std::vector< std::pair<DecisionKey_t, double> >& vDecisions,
+	double value,
+	const std::vector<int>& vNum_values,
+	std::map<DecisionKey_t, std::pair<double, double> >& map_Decision_SumWeight,
+	std::vector< std::vector< std::pair<double, double> > >& vVariable_Value_SumWeight
+)
+{
+	for(int k=0; k<(int)vDecisions.size(); k++) {
+		DecisionKey_t decision_int_value = vDecisions[k].first;
+		double weight = vDecisions[k].second;
+
+		std::pair<double, double>& sum_weight = map_Decision_SumWeight[decision_int_value];
+		sum_weight.first += weight * value;
+		sum_weight.second += weight;
+
+		if(vVariable_Value_SumWeight.size() > 0) { //decode the decision-vector, last variable least significant
+			for(int i=(int)vNum_values.size()-1; i >= 0; i--) {
+				int v = (int)(decision_int_value % vNum_values[i]);
+				decision_int_value /= vNum_values[i];
+				vVariable_Value_SumWeight[i][v].first += weight * value;
+				vVariable_Value_SumWeight[i][v].second += weight;
+			}
+		}
+	}
+}
+
+void ThompsonSamplingModel::note_quality_of_last_invocation(double quality) {
+	if(bHasQualityReports == false) {
+		lowest_reported_quality = quality;
+		highest_reported_quality = quality;
+		bHasQualityReports = true;
+	}
+	lowest_reported_quality = std::min(lowest_reported_quality, quality);
+	highest_reported_quality = std::max(highest_reported_quality, quality);
+
+	credit_decisions(vLast_invocation_decisions, quality, vNum_values, map_Decision_QualitySumWeight, vVariable_Value_QualitySumWeight);
+}
+
+void ThompsonSamplingModel::note_outcome_of_last_invocation(int context_bin, bool bSuccess) {
+	for(int k=0; k<(int)vLast_invocation_decisions.size(); k++)
+		note_outcome(context_bin, vLast_invocation_decisions[k].first, vLast_invocation_decisions[k].second, bSuccess);
+}
+
+void ThompsonSamplingModel::note_cost_of_last_invocation(ExecTime_t cost) {
+	if(vLast_invocation_decisions.size() == 0)
+		return;
+
+	if(bHasCostObservations == false) {
+		lowest_observed_cost = cost;
+		highest_observed_cost = cost;
+		bHasCostObservations = true;
+	}
+	lowest_observed_cost = std::min(lowest_observed_cost, cost);
+	highest_observed_cost = std::max(highest_observed_cost, cost);
+
+	credit_decisions(vLast_invocation_decisions, cost, vNum_values, map_Decision_CostSumWeight, vVariable_Value_CostSumWeight);
+}
+
+static double expected_quality_level(
+	const std::pair<double, double>& sum_weight,
+	double feature_level,
+	double lowest_quality,
+	double highest_quality,
+	double prior_weight
+)
+{
+	double quality_range = highest_quality - lowest_quality;
+	if(quality_range <= 0.0)
+		return feature_level;
+
+	double prior_quality = lowest_quality + feature_level * quality_range;
+	double expected_quality = (prior_weight * prior_quality + sum_weight.first) / (prior_weight + sum_weight.second);
+	double quality_level = std::max(0.0, std::min(1.0, (expected_quality - lowest_quality) / quality_range));
+	return quality_level - ThompsonSamplingModel::quality_cost_preference * feature_level;
+}
+
+double ThompsonSamplingModel::get_expected_quality_level(DecisionKey_t decision_int_value, double feature_level) const {
+	if(bHasQualityReports == false)
+		return feature_level;
+
+	std::pair<double, double> sum_weight(0.0, 0.0);
+	std::map<DecisionKey_t, std::pair<double, double> >::const_iterator mit = map_Decision_QualitySumWeight.find(decision_int_value);
+	if(mit != map_Decision_QualitySumWeight.end())
+		sum_weight = mit->second;
+	return expected_quality_level(sum_weight, feature_level, lowest_reported_quality, highest_reported_quality, prior_quality_weight);
+}
+
+double ThompsonSamplingModel::get_expected_variable_quality_level(int dec_var_index, int value, double variable_feature_level) const {
+	assert(is_factorized());
+	if(bHasQualityReports == false)
+		return variable_feature_level;
+
+	return expected_quality_level(vVariable_Value_QualitySumWeight.at(dec_var_index).at(value), variable_feature_level,
+		lowest_reported_quality, highest_reported_quality, prior_quality_weight);
+}
+
+static double expected_cost_level(
+	const std::pair<double, double>& sum_weight,
+	double feature_level,
+	double lowest_cost,
+	double highest_cost,
+	double prior_weight
+)
+{
+	double cost_range = highest_cost - lowest_cost;
+	if(cost_range <= 0.0)
+		return feature_level;
+
+	double prior_cost = lowest_cost + feature_level * cost_range;
+	double expected_cost = (prior_weight * prior_cost + sum_weight.first) / (prior_weight + sum_weight.second);
+	return std::max(0.0, std::min(1.0, (expected_cost - lowest_cost) / cost_range));
+}
+
+double ThompsonSamplingModel::get_expected_cost_level(DecisionKey_t decision_int_value, double feature_level) const {
+	if(bHasCostObservations == false)
+		return feature_level;
+
+	std::pair<double, double> sum_weight(0.0, 0.0);
+	std::map<DecisionKey_t, std::pair<double, double> >::const_iterator mit = map_Decision_CostSumWeight.find(decision_int_value);
+	if(mit != map_Decision_CostSumWeight.end())
+		sum_weight = mit->second;
+	return expected_cost_level(sum_weight, feature_level, lowest_observed_cost, highest_observed_cost, prior_cost_weight);
+}
+
+double ThompsonSamplingModel::get_expected_variable_cost_level(int dec_var_index, int value, double variable_feature_level) const {
+	assert(is_factorized());
+	if(bHasCostObservations == false)
+		return variable_feature_level;
+
+	return expected_cost_level(vVariable_Value_CostSumWeight.at(dec_var_index).at(value), variable_feature_level,
+		lowest_observed_cost, highest_observed_cost, prior_cost_weight);
+}
+
+double ThompsonSamplingModel::quality_floor_reward(double theta, double prob, double cost_level) {
+	if(theta >= prob)
+		return 1.0 - cost_level;
+	return theta - prob; //negative: worse than any decision-vector expected to meet the floor
+}
+
+void ThompsonSamplingModel::deemphasize_history(double alpha_rate) {
+	for(int c=0; c<(int)vContext_Decision_SuccessFailureCounts.size(); c++) {
+		std::map<DecisionKey_t, std::pair<double, double> >& map_counts = vContext_Decision_SuccessFailureCounts[c];
+		std::map<DecisionKey_t, std::pair<double, double> >::iterator mit = map_counts.begin();
+		while(mit != map_counts.end()) {
+			mit->second.first *= alpha_rate;
+			mit->second.second *= alpha_rate;
+			if(mit->second.first + mit->second.second < min_retained_count)
+				map_counts.erase(mit++);
+			else
+				mit++;
+		}
+	}
+
+	for(int c=0; c<(int)vContext_Variable_Value_SuccessFailureCounts.size(); c++) {
+		for(int i=0; i<(int)vContext_Variable_Value_SuccessFailureCounts[c].size(); i++) {
+			std::vector< std::pair<double, double> >& vValue_counts = vContext_Variable_Value_SuccessFailureCounts[c][i];
+			for(int v=0; v<(int)vValue_counts.size(); v++) {
+				vValue_counts[v].first *= alpha_rate;
+				vValue_counts[v].second *= alpha_rate;
+			}
+		}
+	}
+
+	for(std::map<DecisionKey_t, std::pair<double, double> >::iterator mit = map_Decision_QualitySumWeight.begin();
+			mit != map_Decision_QualitySumWeight.end(); mit++) {
+		mit->second.first *= alpha_rate;
+		mit->second.second *= alpha_rate;
+	}
+	for(int i=0; i<(int)vVariable_Value_QualitySumWeight.size(); i++) {
+		for(int v=0; v<(int)vVariable_Value_QualitySumWeight[i].size(); v++) {
+			vVariable_Value_QualitySumWeight[i][v].first *= alpha_rate;
+			vVariable_Value_QualitySumWeight[i][v].second *= alpha_rate;
+		}
+	}
+
+	for(std::map<DecisionKey_t, std::pair<double, double> >::iterator mit = map_Decision_CostSumWeight.begin();
+			mit != map_Decision_CostSumWeight.end(); mit++) {
+		mit->second.first *= alpha_rate;
+		mit->second.second *= alpha_rate;
+	}
+	for(int i=0; i<(int)vVariable_Value_CostSumWeight.size(); i++) {
+		for(int v=0; v<(int)vVariable_Value_CostSumWeight[i].size(); v++) {
+			vVariable_Value_CostSumWeight[i][v].first *= alpha_rate;
+			vVariable_Value_CostSumWeight[i][v].second *= alpha_rate;
+		}
+	}
+}
+
+static void save_variable_value_pairs(SnapshotWriter& writer, const std::vector< std::vector< std::pair<double, double> > >& vVariable_Value_Pairs) {
+	writer.put_i64((long long)vVariable_Value_Pairs.size());
+	for(int i=0; i<(int)vVariable_Value_Pairs.size(); i++)
+		writer.put_pair_vector(vVariable_Value_Pairs[i]);
+}
+
+static bool load_variable_value_pairs(SnapshotReader& reader, std::vector< std::vector< std::pair<double, double> > >& vVariable_Value_Pairs) {
+	long long num_variables = 0;
+	if(reader.get_length(num_variables, sizeof(long long)) == false)
+		return false;
+	vVariable_Value_Pairs.resize((size_t)num_variables);
+	for(int i=0; i<(int)num_variables && reader.ok(); i++)
+		reader.get_pair_vector(vVariable_Value_Pairs[i]);
+	return reader.ok();
+}
+
+void ThompsonSamplingModel::save_snapshot(SnapshotWriter& writer) const {
+	writer.put_i64((long long)vContext_Decision_SuccessFailureCounts.size());
+	for(int c=0; c<(int)vContext_Decision_SuccessFailureCounts.size(); c++)
+		writer.put_pair_map(vContext_Decision_SuccessFailureCounts[c]);
+
+	writer.put_vector(vNum_values);
+	writer.put_i64((long long)vContext_Variable_Value_SuccessFailureCounts.size());
+	for(int c=0; c<(int)vContext_Variable_Value_SuccessFailureCounts.size(); c++)
+		save_variable_value_pairs(writer, vContext_Variable_Value_SuccessFailureCounts[c]);
+	writer.put_vector(vIncumbent_decision_vector);
+
+	writer.put_pair_map(map_Decision_QualitySumWeight);
+	save_variable_value_pairs(writer, vVariable_Value_QualitySumWeight);
+	writer.put_double(lowest_reported_quality);
+	writer.put_double(highest_reported_quality);
+	writer.put_bool(bHasQualityReports);
+
+	writer.put_pair_map(map_Decision_CostSumWeight);
+	save_variable_value_pairs(writer, vVariable_Value_CostSumWeight);
+	writer.put_double(lowest_observed_cost);
+	writer.put_double(highest_observed_cost);
+	writer.put_bool(bHasCostObservations);
+}
+
+bool ThompsonSamplingModel::load_snapshot(SnapshotReader& reader) {
+	long long num_contexts = 0;
+	if(reader.get_i64(num_contexts) == false || num_contexts != num_context_bins)
+		return false;
+	for(int c=0; c<num_context_bins && reader.ok(); c++)
+		reader.get_pair_map(vContext_Decision_SuccessFailureCounts[c]);
+
+	reader.get_vector(vNum_values);
+	long long num_factorized_contexts = 0;
+	if(reader.get_i64(num_factorized_contexts) == false
+			|| (num_factorized_contexts != 0 && num_factorized_contexts != num_context_bins))
+		return false;
+	vContext_Variable_Value_SuccessFailureCounts.resize((size_t)num_factorized_contexts);
+	for(int c=0; c<(int)num_factorized_contexts && reader.ok(); c++)
+		load_variable_value_pairs(reader, vContext_Variable_Value_SuccessFailureCounts[c]);
+	reader.get_vector(vIncumbent_decision_vector);
+
+	reader.get_pair_map(map_Decision_QualitySumWeight);
+	load_variable_value_pairs(reader, vVariable_Value_QualitySumWeight);
+	reader.get_double(lowest_reported_quality);
+	reader.get_double(highest_reported_quality);
+	reader.get_bool(bHasQualityReports);
+
+	reader.get_pair_map(map_Decision_CostSumWeight);
+	load_variable_value_pairs(reader, vVariable_Value_CostSumWeight);
+	reader.get_double(lowest_observed_cost);
+	reader.get_double(highest_observed_cost);
+	reader.get_bool(bHasCostObservations);
+
+	active_context_bin = -1;
+	vLast_invocation_decisions.clear();
+	return reader.ok();
+}
+
+std::string ThompsonSamplingModel::print_string() const {
+	std::ostringstream oss;
+	oss << "active_context_bin = " << active_context_bin;
+	for(int c=0; c<(int)vContext_Decision_SuccessFailureCounts.size(); c++) {
+		oss << " [" << c << "]:";
+		const std::map<DecisionKey_t, std::pair<double, double> >& map_counts = vContext_Decision_SuccessFailureCounts[c];
+		for(std::map<DecisionKey_t, std::pair<double, double> >::const_iterator mit = map_counts.begin(); mit != map_counts.end(); mit++)
+			oss << " (" << mit->first << ": " << mit->second.first << "/" << mit->second.second << ")";
+	}
+	if(bHasQualityReports)
+		oss << " qualities reported in [" << lowest_reported_quality << ", " << highest_reported_quality << "]";
+	if(bHasCostObservations)
+		oss << " costs observed in [" << lowest_observed_cost << ", " << highest_observed_cost << "]";
+	if(is_factorized()) {
+		oss << " factorized over " << vNum_values.size() << " variables, incumbent = [";
+		for(int i=0; i<(int)vIncumbent_decision_vector.size(); i++)
+			oss << vIncumbent_decision_vector[i] << " ";
+		oss << "]";
+	}
+	return oss.str();
+}
+
+} //namespace Opp
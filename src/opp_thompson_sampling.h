@@ -0,0 +1,194 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_THOMPSON_SAMPLING_H
+#define OPP_THOMPSON_SAMPLING_H
+
+#include <vector>
+#include <map>
+#include <string>
+
+#include "opp.h"
+#include "opp_parameter_spread.h"
+
+namespace Opp {
+
+	class SnapshotWriter;
+	class SnapshotReader;
+
+	/////////////////////////////////
+	// Thompson Sampling Strategy
+	/////////////////////////////////
+
+	// A contextual bandit over the decision-vectors of an ExecFrame, as seen by one consuming
+	//   (parent) Frame. The context is the bin into which the parent's recent (sliding-window
+	//   averaged) execution time falls relative to its objective window. For each context and each
+	//   decision-vector (as its int value), the probability theta that the parent's invocation meets
+	//   its objective is modeled by a Beta(prior + successes, prior + failures) posterior.
+	//
+	// A decision is made by drawing theta for every decision-vector and picking the one maximizing
+	//   the expected reward:
+	//
+	//     reward = theta * feature_level - (1 - theta) * miss_penalty
+	//
+	// where feature_level in [0.0, 1.0] is derived from the priorities of the decision-vector's values
+	//   (1.0 for the highest priority decision-vector). Decision-vectors never tried in a context
+	//   are sampled from the prior, which provides exploration.
+	//
+	// When the decision space is too large to enumerate, the model is additionally factorized: each
+	//   decision-variable's value keeps its own Beta posterior per context, updated with every outcome of
+	//   a decision-vector taking that value. theta of a decision-vector is then approximated by the
+	//   geometric mean of its values' sampled thetas, and the reward is maximized by a DecisionSearch_t
+	//   strategy rather than by enumeration.
+	//
+	// When the application reports the quality achieved by the parent's invocations (frame_report_quality()),
+	//   feature_level is replaced by the expected quality level of the decision-vector: the mean quality reported
+	//   for invocations that took it, normalized to the range of qualities reported so far. The priority-derived
+	//   feature_level serves as the prior mean, worth prior_quality_weight reports. Of decision-vectors with
+	//   practically equal expected quality, the one of lower priority (presumably cheaper) is preferred.
+	//
+	// For a parent with a quality_floor() objective the direction is flipped: theta is the probability that a
+	//   reported quality meets the floor (in the single context quality_floor_context_bin), and the decision-vector
+	//   maximizing
+	//
+	//     reward = (theta >= prob) ? (1 - cost_level) : (theta - prob)
+	//
+	//   is picked, where cost_level in [0.0, 1.0] is the expected cost (execution or CPU time) of the parent's
+	//   invocations that took the decision-vector, normalized to the range of costs observed so far. As for quality,
+	//   the feature_level serves as the prior mean of cost_level, worth prior_cost_weight observations.
+
+	class ThompsonSamplingModel {
+	public:
+		static const int num_context_bins = 5;
+			// 0: Y < m*(1-wl)                     below objective window
+			// 1: m*(1-wl) <= Y < m                in window, below mean
+			// 2: m <= Y <= m*(1+wu)               in window, above mean
+			// 3: m*(1+wu) < Y <= m*(1+2*wu)       just above window
+			// 4: m*(1+2*wu) < Y                   far above window
+
+		static const double prior_successes;
+		static const double prior_failures;
+			//parameters of the uniform Beta(1,1) prior
+
+		static const double miss_penalty;
+			//reward lost on missing the objective, relative to a feature_level of 1.0
+
+		static const double min_retained_count;
+			//pseudo-counts of a decision-vector in a context are dropped once de-emphasized below this
+
+		static const double prior_quality_weight;
+		static const double quality_cost_preference;
+			//expected quality level lost per unit of feature_level, once qualities have been reported
+
+		static const int quality_floor_context_bin = 0;
+		static const double prior_cost_weight;
+
+	private:
+		std::vector< std::map<DecisionKey_t, std::pair<double, double> > > vContext_Decision_SuccessFailureCounts;
+			//for each context bin: decision-vector int value -> observed (successes, failures) counts
+
+		std::vector<int> vNum_values;
+			//range of each decision-variable if factorized, empty otherwise
+		std::vector< std::vector< std::vector< std::pair<double, double> > > > vContext_Variable_Value_SuccessFailureCounts;
+			//for each context bin, decision-variable and value: observed (successes, failures) counts
+
+	public:
+		int active_context_bin;
+			//context bin in which decisions were made during the parent's current invocation, -1 if none
+
+		std::vector<int> vIncumbent_decision_vector;
+			//last decision-vector chosen by factorized search, from which the next search starts
+
+	private:
+		std::map<DecisionKey_t, std::pair<double, double> > map_Decision_QualitySumWeight;
+			//decision-vector int value -> (weighted sum of reported qualities, sum of weights)
+		std::vector< std::vector< std::pair<double, double> > > vVariable_Value_QualitySumWeight;
+			//for each decision-variable and value, if factorized
+		double lowest_reported_quality;
+		double highest_reported_quality;
+		bool bHasQualityReports;
+
+		std::map<DecisionKey_t, std::pair<double, double> > map_Decision_CostSumWeight;
+			//decision-vector int value -> (weighted sum of observed costs, sum of weights), for quality floor objectives
+		std::vector< std::vector< std::pair<double, double> > > vVariable_Value_CostSumWeight;
+			//for each decision-variable and value, if factorized
+		double lowest_observed_cost;
+		double highest_observed_cost;
+		bool bHasCostObservations;
+
+		std::vector< std::pair<DecisionKey_t, double> > vLast_invocation_decisions;
+			//decision-vectors taken in the parent's last completed invocation, with the fraction of decisions that took each
+
+	public:
+
+		ThompsonSamplingModel()
+			: vContext_Decision_SuccessFailureCounts(num_context_bins), active_context_bin(-1),
+				lowest_reported_quality(0.0), highest_reported_quality(0.0), bHasQualityReports(false),
+				lowest_observed_cost(0.0), highest_observed_cost(0.0), bHasCostObservations(false) { }
+
+		static int get_context_bin(
+			ExecTime_t recent_exec_time,
+			ExecTime_t mean_objective,
+			double window_frac_lower,
+			double window_frac_upper
+		);
+
+		void initialize_factorization(const std::vector<int>& vNum_values);
+			//vNum_values: range of each decision-variable, in the order used by the decision-vector int encoding
+
+		bool is_factorized() const
+			{ return vNum_values.size() > 0; }
+
+		double get_observation_count(int context_bin, DecisionKey_t decision_int_value) const;
+			//successes + failures observed (possibly de-emphasized)
+
+		double sample_success_probability(int context_bin, DecisionKey_t decision_int_value) const;
+			//draws theta from the posterior
+
+		double sample_variable_success_probability(int context_bin, int dec_var_index, int value) const;
+			//draws theta from the posterior of a decision-variable's value; requires factorization
+
+		void note_outcome(int context_bin, DecisionKey_t decision_int_value, double weight, bool bSuccess);
+			//weight is the fraction of the invocation's decisions that took decision_int_value
+
+		void note_last_invocation_decisions(const std::vector< std::pair<DecisionKey_t, double> >& vDecisions);
+			//decision-vectors (with weights) taken in the parent's invocation that just completed
+
+		void note_quality_of_last_invocation(double quality);
+			//credits the decision-vectors of the parent's last completed invocation with the reported quality
+
+		void note_outcome_of_last_invocation(int context_bin, bool bSuccess);
+			//note_outcome() for each decision-vector of the parent's last completed invocation
+
+		void note_cost_of_last_invocation(ExecTime_t cost);
+			//credits the decision-vectors of the parent's last completed invocation with its cost
+
+		double get_expected_quality_level(DecisionKey_t decision_int_value, double feature_level) const;
+			//up to 1.0; feature_level of the decision-vector as is, until qualities have been reported
+
+		double get_expected_variable_quality_level(int dec_var_index, int value, double variable_feature_level) const;
+			//as above, for a decision-variable's value; requires factorization
+
+		double get_expected_cost_level(DecisionKey_t decision_int_value, double feature_level) const;
+			//in [0.0, 1.0]; feature_level of the decision-vector as is, until distinct costs have been observed
+
+		double get_expected_variable_cost_level(int dec_var_index, int value, double variable_feature_level) const;
+			//as above, for a decision-variable's value; requires factorization
+
+		static double quality_floor_reward(double theta, double prob, double cost_level);
+
+		void deemphasize_history(double alpha_rate);
+			//scales down all observed counts, moving posteriors back towards the prior
+
+		void save_snapshot(SnapshotWriter& writer) const;
+		bool load_snapshot(SnapshotReader& reader);
+			//restores state written by save_snapshot() (all but the transient per-invocation state),
+			//  returns false if malformed
+
+		std::string print_string() const;
+	};
+
+} //namespace Opp
+
+#endif //OPP_THOMPSON_SAMPLING_H
@@ -3,8 +3,11 @@
 // Author: Tushar Kumar, tushardeveloper@gmail.com
 
 #include <iostream>
+#include <cstdlib>
 #include <cassert>
+#include <time.h>
 #include "opp_timing.h"
+#include "opp_utilities.h"
 
 namespace Opp {
 
@@ -21,9 +24,64 @@ double get_curr_time_seconds() {
 }
 #endif
 
+static bool bUseVirtualClock = false;
+static long long virtual_clock_ns = 0;
+
+void timing_use_virtual_clock(bool bEnable) {
+	bUseVirtualClock = bEnable;
+	virtual_clock_ns = 0;
+}
+
+void timing_advance_virtual_clock(double seconds) {
+	assert(seconds >= 0.0);
+	virtual_clock_ns += (long long)(seconds * 1.0e9 + 0.5);
+}
+
+double timing_get_virtual_clock() {
+	return virtual_clock_ns * 1.0e-9;
+}
+
+
+static int controller_overhead_depth = 0;
+static timeval controller_overhead_start_timeval;
+static double controller_overhead_total = 0.0;
+
+timeval controller_overhead_begin() {
+	timeval now = get_curr_timeval();
+	if(controller_overhead_depth++ == 0)
+		controller_overhead_start_timeval = now;
+	return now;
+}
+
+timeval controller_overhead_end() {
+	timeval now = get_curr_timeval();
+	assert(controller_overhead_depth > 0);
+	if(--controller_overhead_depth == 0)
+		controller_overhead_total += diff_time(controller_overhead_start_timeval, now);
+	return now;
+}
+
+double get_controller_overhead_until(timeval now) {
+	if(controller_overhead_depth == 0)
+		return controller_overhead_total;
+	return controller_overhead_total + diff_time(controller_overhead_start_timeval, now);
+}
+
+
 timeval get_curr_timeval() {
 	struct timeval tv;
 
+	if(bUseVirtualClock) {
+		tv.tv_sec = (time_t)(virtual_clock_ns / 1000000000LL);
+		tv.tv_usec = (suseconds_t)((virtual_clock_ns % 1000000000LL) / 1000);
+		return tv;
+	}
+	return get_real_timeval();
+}
+
+timeval get_real_timeval() {
+	struct timeval tv;
+
 	gettimeofday(&tv, NULL);
 	return tv;
 }
@@ -31,7 +89,7 @@ timeval get_curr_timeval() {
 double diff_time(timeval start, timeval end) {
 	timeval diff;
 
-	std::cout << "diff_time: "
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << "diff_time: "
 		<< "start = (" << start.tv_sec << ", " << start.tv_usec << ") "
 		<< "end = (" << end.tv_sec << ", " << end.tv_usec << ") ";
 
@@ -47,9 +105,22 @@ double diff_time(timeval start, timeval end) {
 	}
 
 	double diff_val = double(diff.tv_sec) + double(diff.tv_usec)/1000000;
-	std::cout << " diff = " << diff_val << std::endl;
+	OPP_DEBUG_MESSAGE(DebugMsgALL) << " diff = " << diff_val << std::endl;
 
 	return diff_val; //in seconds
 }
 
+double get_thread_cpu_time() {
+	struct timespec ts;
+
+	if(bUseVirtualClock)
+		return timing_get_virtual_clock();
+
+	if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+		std::cerr << "get_thread_cpu_time(): ERROR: clock_gettime(CLOCK_THREAD_CPUTIME_ID) failed" << std::endl;
+		exit(1);
+	}
+	return double(ts.tv_sec) + double(ts.tv_nsec)/1000000000; //in seconds
+}
+
 } //namespace Opp
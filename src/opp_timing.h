@@ -1,21 +1,48 @@
-// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
-//
-// Author: Tushar Kumar, tushardeveloper@gmail.com
-
-#ifndef OPP_TIMING_H
-#define OPP_TIMING_H
-
-#include <sys/time.h> 
-
-namespace Opp {
-#if 0
-	double get_curr_time_seconds();
-		//returns current time in seconds
-#endif
-
-	timeval get_curr_timeval();
-
-	double diff_time(timeval start, timeval end);
-}
-
-#endif //OPP_TIMING_H
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_TIMING_H
+#define OPP_TIMING_H
+
+#include <sys/time.h> 
+
+namespace Opp {
+#if 0
+	double get_curr_time_seconds();
+		//returns current time in seconds
+#endif
+
+	timeval get_curr_timeval();
+
+	timeval get_real_timeval();
+		//as get_curr_timeval(), ignoring the virtual clock
+
+	double diff_time(timeval start, timeval end);
+
+	double get_thread_cpu_time();
+		//returns CPU time consumed so far by the calling thread, in seconds
+
+
+	//Virtual clock, for simulating execution-times (e.g., replaying recorded costs through the decision strategies)
+	void timing_use_virtual_clock(bool bEnable);
+		//While enabled, get_curr_timeval() and get_thread_cpu_time() report a virtual time that starts at 0 and only
+		//  advances through timing_advance_virtual_clock(). Must not be toggled while Frames are active.
+
+	void timing_advance_virtual_clock(double seconds);
+
+	double timing_get_virtual_clock();
+		//in seconds
+
+
+	//Controller overhead: time spent in the library's own code while the application's Frames are being timed
+	timeval controller_overhead_begin();
+	timeval controller_overhead_end();
+		//Bracket library code (frame_enter(), frame_exit_*(), decisions of ExecFrame runs). Both return the current time.
+		//  Nested brackets count once, from the outermost begin to its end.
+
+	double get_controller_overhead_until(timeval now);
+		//Overhead accumulated so far in seconds, including the bracket in progress (if any) up to now
+}
+
+#endif //OPP_TIMING_H
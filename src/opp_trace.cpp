@@ -0,0 +1,323 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <map>
+#include <cstdlib>
+#include <cassert>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "opp_trace.h"
+#include "opp_frame_info.h"
+#include "opp_execframe.h"
+#include "opp_utilities.h"
+
+namespace Opp {
+
+static const char trace_magic[8] = {'O', 'P', 'P', 'T', 'R', 'A', 'C', 'E'};
+
+bool bTraceOpen = false;
+
+static TraceFileHeader * trace_header = 0; //start of the mapping
+static TraceRecord * trace_slots = 0;
+static size_t trace_mapping_length = 0;
+static timeval trace_start_timeval;
+
+static __thread uint32_t cached_thread_id = 0;
+
+static uint32_t get_thread_id() {
+	if(cached_thread_id == 0)
+		cached_thread_id = (uint32_t)syscall(SYS_gettid);
+	return cached_thread_id;
+}
+
+
+bool trace_open(const std::string& filename, long long capacity) {
+	assert(sizeof(TraceFileHeader) == trace_header_size && sizeof(TraceRecord) == trace_record_size);
+
+	if(capacity <= 0) {
+		std::cerr << "trace_open(): ERROR: capacity = " << capacity << " must be > 0" << std::endl;
+		exit(1);
+	}
+
+	trace_close();
+
+	size_t length = trace_header_size + (size_t)capacity * trace_record_size;
+
+	int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		return false;
+	if(ftruncate(fd, (off_t)length) != 0) {
+		::close(fd);
+		return false;
+	}
+	void * mapping = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd); //the mapping keeps the file open
+	if(mapping == MAP_FAILED)
+		return false;
+
+	//touch every page now, rather than fault them in while recording
+	memset(mapping, 0, length);
+
+	trace_header = (TraceFileHeader *)mapping;
+	trace_slots = (TraceRecord *)((char *)mapping + trace_header_size);
+	trace_mapping_length = length;
+	trace_start_timeval = get_curr_timeval();
+
+	memcpy(trace_header->magic, trace_magic, sizeof(trace_magic));
+	trace_header->version = trace_version;
+	trace_header->byte_order_marker = trace_byte_order_marker;
+	trace_header->header_size = trace_header_size;
+	trace_header->record_size = trace_record_size;
+	trace_header->capacity = (uint64_t)capacity;
+	trace_header->write_count = 0;
+	trace_header->start_time_us = (int64_t)trace_start_timeval.tv_sec * 1000000 + trace_start_timeval.tv_usec;
+
+	bTraceOpen = true;
+	return true;
+}
+
+void trace_close() {
+	if(bTraceOpen == false)
+		return;
+	bTraceOpen = false;
+
+	msync(trace_header, trace_mapping_length, MS_SYNC);
+	munmap(trace_header, trace_mapping_length);
+	trace_header = 0;
+	trace_slots = 0;
+	trace_mapping_length = 0;
+}
+
+
+static TraceRecord * begin_record(TraceRecordType_t record_type, FrameID_t frame_id, timeval start_timeval, ExecTime_t active_duration) {
+	uint64_t sequence = trace_header->write_count;
+	TraceRecord * rec = &trace_slots[sequence % trace_header->capacity];
+
+	rec->sequence = ~(uint64_t)0; //invalid while being written
+	rec->frame_id = frame_id;
+	rec->parent_frame_id = -1;
+	rec->start_tick_ns = ((int64_t)(start_timeval.tv_sec - trace_start_timeval.tv_sec) * 1000000
+							+ (start_timeval.tv_usec - trace_start_timeval.tv_usec)) * 1000;
+	rec->active_duration = active_duration;
+	rec->decision_key = -1;
+	rec->thread_id = get_thread_id();
+	rec->record_type = (uint16_t)record_type;
+	rec->flags = 0;
+	rec->controller_y_delta = 0.0;
+	rec->controller_coeff = 0.0;
+	rec->controller_x = 0.0;
+	return rec;
+}
+
+static void commit_record(TraceRecord * rec) {
+	uint64_t sequence = trace_header->write_count;
+	shared_memory_store_barrier(); //fields before sequence number, sequence number before write_count
+	rec->sequence = sequence;
+	shared_memory_store_barrier();
+	trace_header->write_count = sequence + 1;
+}
+
+
+void trace_note_frame_segment(Frame * frame, ExecTime_t segment_exec_time) {
+	if(bTraceOpen == false)
+		return;
+
+	FrameInfo * frame_info = FrameInfo::get_frame_info(frame);
+
+	TraceRecord * rec = begin_record(TraceFRAME_SEGMENT, frame->id, frame_info->curr_enter_timeval, segment_exec_time);
+	if(frame_info->curr_parent_frame != 0)
+		rec->parent_frame_id = frame_info->curr_parent_frame->id;
+	if(frame_info->curr_enter_timeval.tv_sec != frame_info->invocation_start_timeval.tv_sec
+		|| frame_info->curr_enter_timeval.tv_usec != frame_info->invocation_start_timeval.tv_usec)
+	{
+		rec->flags |= trace_flag_resumed;
+	}
+	commit_record(rec);
+}
+
+void trace_note_frame_completion(Frame * frame, ExecTime_t rescaled_exec_time) {
+	if(bTraceOpen == false)
+		return;
+
+	FrameInfo * frame_info = FrameInfo::get_frame_info(frame);
+	FrameDecisionModel& frame_dec = frame_info->decision_model;
+
+	TraceRecord * rec = begin_record(TraceFRAME_COMPLETION, frame->id,
+		frame_info->invocation_start_timeval, frame_info->current_invocation_exec_time);
+	if(frame_info->curr_parent_frame != 0)
+		rec->parent_frame_id = frame_info->curr_parent_frame->id;
+
+	if(frame_dec.bHasMeanObjectiveDefined) {
+		rec->flags |= trace_flag_has_objective;
+		if(rescaled_exec_time >= frame_dec.mean_objective * (1.0 - frame_dec.window_frac_lower)
+			&& rescaled_exec_time <= frame_dec.mean_objective * (1.0 + frame_dec.window_frac_upper))
+		{
+			rec->flags |= trace_flag_objective_met;
+		}
+		rec->controller_y_delta = rescaled_exec_time - frame_dec.mean_objective;
+	}
+	commit_record(rec);
+}
+
+void trace_note_execframe_run(ExecFrame * execframe, Frame * parent_frame, timeval start_timeval,
+	ExecTime_t consumed_time, long long decision_key)
+{
+	if(bTraceOpen == false)
+		return;
+
+	TraceRecord * rec = begin_record(TraceEXECFRAME_RUN, execframe->id, start_timeval, consumed_time);
+	rec->decision_key = decision_key;
+
+	if(parent_frame != 0) {
+		rec->parent_frame_id = parent_frame->id;
+
+		FrameDecisionModel& parent_frame_dec = FrameInfo::get_frame_info(parent_frame)->decision_model;
+		if(parent_frame_dec.bHasMeanObjectiveDefined && parent_frame_dec.previous_invocation_exec_time > 0.0)
+			rec->controller_y_delta = parent_frame_dec.previous_invocation_exec_time - parent_frame_dec.mean_objective;
+
+		Parameter * decision_vector_parameter = &(ExecFrameInfo::get_execframe_info(execframe)->decision_model.decision_vector_parameter);
+		std::map<Parameter *, FastReactionState *>::iterator mit = parent_frame_dec.map_parm_to_fast_reaction_state.find(decision_vector_parameter);
+		if(mit != parent_frame_dec.map_parm_to_fast_reaction_state.end()
+			&& mit->second->vCoeffs_a.size() > 0 && mit->second->vCurrent_invocation_model_choice_double_value.size() > 0)
+		{
+			rec->flags |= trace_flag_has_fast_reaction_state;
+			rec->controller_coeff = mit->second->vCoeffs_a[0];
+			rec->controller_x = mit->second->vCurrent_invocation_model_choice_double_value[0];
+		}
+	}
+	commit_record(rec);
+}
+
+
+
+////////////////////////////////////
+//class TraceReader definitions
+////////////////////////////////////
+
+bool TraceReader::open(const std::string& filename) {
+	vRecords.clear();
+	memset(&header, 0, sizeof(header));
+
+	std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
+	if(!ifs)
+		return false;
+
+	TraceFileHeader file_header;
+	if(!ifs.read((char *)&file_header, sizeof(file_header)))
+		return false;
+	if(memcmp(file_header.magic, trace_magic, sizeof(trace_magic)) != 0
+		|| file_header.version < 1 || file_header.version > trace_version || file_header.byte_order_marker != trace_byte_order_marker
+		|| file_header.header_size != trace_header_size || file_header.record_size != trace_record_size
+		|| file_header.capacity == 0)
+	{
+		return false;
+	}
+
+	std::vector<TraceRecord> vSlots(file_header.capacity);
+	if(!ifs.read((char *)&vSlots[0], file_header.capacity * trace_record_size))
+		return false;
+
+	header = file_header;
+	uint64_t write_count = file_header.write_count;
+	uint64_t first_sequence = (write_count > file_header.capacity ? write_count - file_header.capacity : 0);
+	for(uint64_t s = first_sequence; s < write_count; s++) {
+		const TraceRecord& rec = vSlots[s % file_header.capacity];
+		if(rec.sequence == s)
+			vRecords.push_back(rec);
+	}
+	return true;
+}
+
+long long TraceReader::get_num_lost_records() const {
+	return (long long)header.write_count - (long long)vRecords.size();
+}
+
+//JSON string of the event name
+static std::string chrome_trace_event_name(const TraceRecord& rec) {
+	std::ostringstream oss;
+	oss << (rec.record_type == TraceEXECFRAME_RUN ? "\"ExecFrame #" : "\"Frame #") << rec.frame_id << "\"";
+	return oss.str();
+}
+
+bool TraceReader::write_chrome_trace(const std::string& filename) const {
+	std::ofstream ofs(filename.c_str());
+	if(!ofs)
+		return false;
+	ofs.precision(15);
+
+	std::map<std::pair<uint32_t, int64_t>, double> map_frame_to_last_segment_end_us;
+		//(thread_id, frame_id) -> end of the Frame's last recorded segment, placing its completion
+
+	ofs << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"start_time_us\":" << header.start_time_us
+		<< ",\"lost_records\":" << get_num_lost_records() << "},\"traceEvents\":[";
+	for(int r=0; r<(int)vRecords.size(); r++) {
+		const TraceRecord& rec = vRecords[r];
+		double ts_us = rec.start_tick_ns / 1000.0;
+		double dur_us = rec.active_duration * 1e6;
+		std::pair<uint32_t, int64_t> thread_frame(rec.thread_id, rec.frame_id);
+
+		ofs << (r == 0 ? "\n" : ",\n");
+		if(rec.record_type == TraceFRAME_SEGMENT) {
+			map_frame_to_last_segment_end_us[thread_frame] = ts_us + dur_us;
+			ofs << "{\"name\":" << chrome_trace_event_name(rec) << ",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":" << ts_us
+				<< ",\"dur\":" << dur_us << ",\"pid\":0,\"tid\":" << rec.thread_id
+				<< ",\"args\":{\"parent\":" << rec.parent_frame_id
+				<< ",\"resumed\":" << ((rec.flags & trace_flag_resumed) ? 1 : 0) << "}}";
+		}
+		else if(rec.record_type == TraceEXECFRAME_RUN) {
+			ofs << "{\"name\":" << chrome_trace_event_name(rec) << ",\"cat\":\"execframe\",\"ph\":\"X\",\"ts\":" << ts_us
+				<< ",\"dur\":" << dur_us << ",\"pid\":0,\"tid\":" << rec.thread_id
+				<< ",\"args\":{\"parent\":" << rec.parent_frame_id << ",\"decision_key\":" << rec.decision_key
+				<< ",\"controller_y_delta\":" << rec.controller_y_delta;
+			if(rec.flags & trace_flag_has_fast_reaction_state)
+				ofs << ",\"controller_coeff\":" << rec.controller_coeff << ",\"controller_x\":" << rec.controller_x;
+			ofs << "}}";
+		}
+		else { //TraceFRAME_COMPLETION
+			std::map<std::pair<uint32_t, int64_t>, double>::iterator mit = map_frame_to_last_segment_end_us.find(thread_frame);
+			double completion_us = (mit != map_frame_to_last_segment_end_us.end() ? mit->second : ts_us + dur_us);
+				//traces without segment records: the end of the active execution-time
+			ofs << "{\"name\":" << chrome_trace_event_name(rec) << ",\"cat\":\"completion\",\"ph\":\"i\",\"s\":\"t\",\"ts\":" << completion_us
+				<< ",\"pid\":0,\"tid\":" << rec.thread_id
+				<< ",\"args\":{\"parent\":" << rec.parent_frame_id << ",\"invocation_start_us\":" << ts_us
+				<< ",\"active_duration\":" << rec.active_duration;
+			if(rec.flags & trace_flag_has_objective)
+				ofs << ",\"objective_met\":" << ((rec.flags & trace_flag_objective_met) ? 1 : 0)
+					<< ",\"controller_y_delta\":" << rec.controller_y_delta;
+			ofs << "}}";
+		}
+	}
+	ofs << "\n]}\n";
+
+	return (bool)ofs;
+}
+
+std::string TraceReader::print_string(const TraceRecord& rec) {
+	std::ostringstream oss;
+	oss << "#" << rec.sequence
+		<< (rec.record_type == TraceEXECFRAME_RUN ? " ExecFrame #" : " Frame #") << rec.frame_id
+		<< (rec.record_type == TraceFRAME_SEGMENT ? " segment" : "")
+		<< " parent = " << rec.parent_frame_id << " thread = " << rec.thread_id
+		<< " start_tick_ns = " << rec.start_tick_ns << " active_duration = " << rec.active_duration;
+	if(rec.record_type == TraceEXECFRAME_RUN)
+		oss << " decision_key = " << rec.decision_key;
+	if(rec.record_type == TraceFRAME_SEGMENT)
+		oss << " resumed = " << ((rec.flags & trace_flag_resumed) ? 1 : 0);
+	if(rec.flags & trace_flag_has_objective)
+		oss << " objective_met = " << ((rec.flags & trace_flag_objective_met) ? 1 : 0);
+	oss << " controller_y_delta = " << rec.controller_y_delta;
+	if(rec.flags & trace_flag_has_fast_reaction_state)
+		oss << " controller_coeff = " << rec.controller_coeff << " controller_x = " << rec.controller_x;
+	return oss.str();
+}
+
+} //namespace Opp
@@ -0,0 +1,141 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_TRACE_H
+#define OPP_TRACE_H
+
+#include <stdint.h>
+#include <sys/time.h>
+#include <string>
+#include <vector>
+
+#include "opp.h"
+
+namespace Opp {
+
+	/////////////////////////////////
+	// Binary Invocation Trace
+	/////////////////////////////////
+
+	// A trace file (see trace_open()) is a memory-mapped ring buffer of fixed-size records, one per executing
+	//   segment of a Frame, one per completed Frame invocation and one per ExecFrame run. Records are written by
+	//   plain stores into the mapping, so the file holds everything recorded so far even if the application
+	//   crashes, and the kernel writes it back without involving the recording threads. File layout, in native
+	//   byte order (a byte-order marker lets readers reject files from machines of other endianness):
+	//
+	//     TraceFileHeader (trace_header_size bytes), then capacity slots of TraceRecord (trace_record_size bytes each)
+	//
+	//   The record with sequence number s (counting from 0 over the whole run) is in slot s % capacity. The
+	//   writer fills all fields of a slot before storing its sequence number, and then increments the header's
+	//   write_count. Only the last min(write_count, capacity) records are retained; a reader skips slots whose
+	//   sequence number is not the one expected (overwritten, or being written, while it read the file).
+	//
+	// Version history:
+	//   1: initial format
+	//   2: adds FRAME_SEGMENT records (same layout, version 1 files remain readable)
+
+	static const uint32_t trace_version = 2;
+	static const uint32_t trace_byte_order_marker = 0x01020304;
+
+	struct TraceFileHeader {
+		char magic[8];                    //"OPPTRACE"
+		uint32_t version;                 //trace_version
+		uint32_t byte_order_marker;       //trace_byte_order_marker
+		uint32_t header_size;             //sizeof(TraceFileHeader)
+		uint32_t record_size;             //sizeof(TraceRecord)
+		uint64_t capacity;                //number of record slots
+		volatile uint64_t write_count;    //number of records written so far
+		int64_t start_time_us;            //gettimeofday() at trace_open(), in microseconds since the epoch
+		uint8_t reserved[16];
+	};
+
+	static const size_t trace_header_size = 64;
+
+	typedef enum {
+		TraceFRAME_COMPLETION = 1,
+			//completed invocation of the Frame frame_id
+		TraceEXECFRAME_RUN = 2,
+			//run of the ExecFrame frame_id, within Frame parent_frame_id
+		TraceFRAME_SEGMENT = 3
+			//executing segment of the Frame frame_id, from its entry or resumption until it was suspended
+			//  (or completed); a suspended Frame is recorded as one segment per resumption
+	} TraceRecordType_t;
+
+	//TraceRecord::flags
+	static const uint16_t trace_flag_has_objective = 0x1;
+		//FRAME_COMPLETION: the frame has a mean objective, and objective_met is defined
+	static const uint16_t trace_flag_objective_met = 0x2;
+		//FRAME_COMPLETION: the (rescaled) execution-time fell within the objective window
+	static const uint16_t trace_flag_has_fast_reaction_state = 0x4;
+		//EXECFRAME_RUN: controller_coeff and controller_x are defined
+	static const uint16_t trace_flag_resumed = 0x8;
+		//FRAME_SEGMENT: the segment resumed a suspended invocation, rather than starting it
+
+	struct TraceRecord {
+		uint64_t sequence;                //sequence number of the record, stored last
+		int64_t frame_id;                 //Frame or ExecFrame the record is about
+		int64_t parent_frame_id;          //enclosing Frame, -1 for a top-level Frame or ExecFrame run outside Frames
+		int64_t start_tick_ns;            //start of the invocation or run, in nanoseconds since start_time_us
+		double active_duration;
+			//seconds, excluding the time a piecewise Frame spent suspended (FRAME_SEGMENT: duration of the segment)
+		int64_t decision_key;             //EXECFRAME_RUN: decision-vector run, as its DecisionKey_t; else -1
+		uint32_t thread_id;               //kernel thread id of the recording thread
+		uint16_t record_type;             //TraceRecordType_t
+		uint16_t flags;                   //trace_flag_* bits
+		double controller_y_delta;
+			//FRAME_COMPLETION: rescaled execution-time minus the mean objective
+			//EXECFRAME_RUN: the parent's previous (steering) execution-time minus its mean objective, which the decision reacted to
+			//0.0 if the (parent) frame has no mean objective
+		double controller_coeff;          //EXECFRAME_RUN: Fast Reaction Strategy's coefficient of the first decision variable
+		double controller_x;              //EXECFRAME_RUN: Fast Reaction Strategy's (fractional) choice for the first decision variable
+	};
+
+	static const size_t trace_record_size = 80;
+
+
+	// TraceReader: reads a trace file written by trace_open(), possibly while it is being written.
+
+	class TraceReader {
+		TraceFileHeader header;
+		std::vector<TraceRecord> vRecords; //oldest first
+
+	public:
+		bool open(const std::string& filename);
+			//Reads the retained records of filename. Returns false, reading nothing, if the file is not
+			//  a trace of a known version in this machine's byte order.
+
+		const TraceFileHeader& get_header() const
+			{ return header; }
+
+		const std::vector<TraceRecord>& get_records() const
+			{ return vRecords; }
+			//retained records in order of sequence number, skipping any overwritten while being read
+
+		long long get_num_lost_records() const;
+			//records written but not retained (overwritten in the ring, or torn while reading)
+
+		bool write_chrome_trace(const std::string& filename) const;
+			//Write the retained records as Chrome trace-event JSON (loadable by chrome://tracing, Perfetto UI and
+			//  other viewers), one timeline track per recording thread:
+			//   - FRAME_SEGMENT: a slice per segment (nested as Frames were), "Frame #id", noting resumption
+			//   - EXECFRAME_RUN: a slice per run, "ExecFrame #id", with its decision and controller state
+			//   - FRAME_COMPLETION: an instant event at the end of the Frame's last segment, with its active
+			//       execution-time and objective outcome
+			//Returns false if filename could not be written.
+
+		static std::string print_string(const TraceRecord& rec);
+	};
+
+
+	//Called by the library to record, if a trace is open
+	extern bool bTraceOpen;
+
+	void trace_note_frame_segment(Frame * frame, ExecTime_t segment_exec_time);
+	void trace_note_frame_completion(Frame * frame, ExecTime_t rescaled_exec_time);
+	void trace_note_execframe_run(ExecFrame * execframe, Frame * parent_frame, timeval start_timeval,
+		ExecTime_t consumed_time, long long decision_key);
+
+} //namespace Opp
+
+#endif //OPP_TRACE_H
@@ -0,0 +1,47 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+// opp_trace_export: converts a trace written by trace_open() for viewing, possibly while the application
+//   is still recording it.
+//
+// Usage: opp_trace_export.exe <trace_file> [json_file]
+//   json_file given: writes the retained records as Chrome trace-event JSON, to be loaded into chrome://tracing
+//     or the Perfetto UI (ui.perfetto.dev), showing Frame nesting, suspend/resume segments, ExecFrame runs
+//     with their decisions, and Frame completions with their objective outcome
+//   otherwise: prints the retained records, one per line
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "opp.h"
+#include "opp_trace.h"
+
+int main(int argc, char * argv[]) {
+	if(argc < 2 || argc > 3) {
+		std::cerr << "Usage: " << argv[0] << " <trace_file> [json_file]" << std::endl;
+		exit(1);
+	}
+
+	Opp::TraceReader reader;
+	if(reader.open(argv[1]) == false) {
+		std::cerr << "main(): ERROR: could not read trace file '" << argv[1] << "'" << std::endl;
+		exit(1);
+	}
+
+	if(argc == 3) {
+		if(reader.write_chrome_trace(argv[2]) == false) {
+			std::cerr << "main(): ERROR: could not write '" << argv[2] << "'" << std::endl;
+			exit(1);
+		}
+		std::cout << reader.get_records().size() << " records exported, "
+			<< reader.get_num_lost_records() << " lost" << std::endl;
+	}
+	else {
+		for(int r=0; r<(int)reader.get_records().size(); r++)
+			std::cout << Opp::TraceReader::print_string(reader.get_records()[r]) << "\n";
+	}
+
+	return 0;
+}
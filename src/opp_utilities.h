@@ -5,12 +5,39 @@
 #ifndef OPP_UTILITIES_H
 #define OPP_UTILITIES_H
 
+#include <iostream>
 #include <sstream>
 #include <vector>
 #include <string>
 
+#include "opp_debug_control.h"
+
 namespace Opp {
 
+extern DebugMessageLevel_t debug_message_level;
+
+//Use as OPP_DEBUG_MESSAGE(level) << ... in place of std::cout << ..., the message being printed (and its
+//  operands evaluated) only if debug_message_level >= level
+#define OPP_DEBUG_MESSAGE(level) if(Opp::debug_message_level < (level)) { } else std::cout
+
+
+//Order accesses to memory shared with another process (x86 reorders neither stores with stores, nor loads with loads)
+inline void shared_memory_store_barrier() {
+#if defined(__i386__) || defined(__x86_64__)
+	__asm__ __volatile__("" ::: "memory");
+#else
+	__sync_synchronize();
+#endif
+}
+
+inline void shared_memory_load_barrier() {
+#if defined(__i386__) || defined(__x86_64__)
+	__asm__ __volatile__("" ::: "memory");
+#else
+	__sync_synchronize();
+#endif
+}
+
 template<typename T>
 	std::basic_ostream<char>& operator<<(std::basic_ostream<char>& bos, const std::vector<T>& vT)
 {
@@ -0,0 +1,199 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#include <sstream>
+#include <cassert>
+
+#include "opp_workload_hints.h"
+#include "opp_utilities.h"
+#include "opp_snapshot.h"
+
+namespace Opp {
+
+//////////////////////////////////////////
+//class WorkloadHintRegression definitions
+//////////////////////////////////////////
+
+const double WorkloadHintRegression::forgetting_factor = 0.98;
+const double WorkloadHintRegression::initial_covariance = 1000.0;
+const double WorkloadHintRegression::nominal_hints_rate = 0.1;
+
+void WorkloadHintRegression::initialize(int num_hints, int num_decision_vars) {
+	assert(num_hints >= 0 && num_decision_vars >= 0);
+
+	this->num_hints = num_hints;
+	this->num_decision_vars = num_decision_vars;
+
+	int num_features = get_num_features();
+	vTheta.clear();
+	vTheta.resize(num_features, 0.0);
+
+	vvP.clear();
+	vvP.resize(num_features, std::vector<double>(num_features, 0.0));
+	for(int i=0; i<num_features; i++)
+		vvP[i][i] = initial_covariance;
+
+	sample_count = 0;
+	vNominal_hints.clear();
+}
+
+void WorkloadHintRegression::construct_features(
+	const std::vector<double>& vHints,
+	const std::vector<double>& vDecisionValues,
+	std::vector<double>& result_vFeatures
+) const
+{
+	assert(dimensions_match(vHints, vDecisionValues));
+
+	result_vFeatures.clear();
+	result_vFeatures.push_back(1.0);
+	for(int j=0; j<num_hints; j++)
+		result_vFeatures.push_back(vHints[j]);
+	for(int i=0; i<num_decision_vars; i++)
+		result_vFeatures.push_back(vDecisionValues[i]);
+	for(int j=0; j<num_hints; j++) {
+		for(int i=0; i<num_decision_vars; i++)
+			result_vFeatures.push_back(vHints[j] * vDecisionValues[i]);
+	}
+}
+
+void WorkloadHintRegression::note_invocation(
+	const std::vector<double>& vHints,
+	const std::vector<double>& vDecisionValues,
+	ExecTime_t exec_time
+)
+{
+	if(vTheta.size() == 0 || dimensions_match(vHints, vDecisionValues) == false)
+		initialize((int)vHints.size(), (int)vDecisionValues.size());
+
+	std::vector<double> vPhi;
+	construct_features(vHints, vDecisionValues, vPhi);
+	int n = (int)vPhi.size();
+
+	//RLS update:
+	//  k = P.phi / (lambda + phi'.P.phi)
+	//  theta = theta + k * (y - phi'.theta)
+	//  P = (P - k.phi'.P) / lambda
+	std::vector<double> vP_phi(n, 0.0);
+	for(int r=0; r<n; r++) {
+		for(int c=0; c<n; c++)
+			vP_phi[r] += vvP[r][c] * vPhi[c];
+	}
+
+	double denominator = forgetting_factor;
+	for(int r=0; r<n; r++)
+		denominator += vPhi[r] * vP_phi[r];
+	assert(denominator > 0.0);
+
+	double prediction_error = exec_time;
+	for(int r=0; r<n; r++)
+		prediction_error -= vTheta[r] * vPhi[r];
+
+	for(int r=0; r<n; r++)
+		vTheta[r] += vP_phi[r] / denominator * prediction_error;
+
+	for(int r=0; r<n; r++) {
+		for(int c=0; c<n; c++) {
+			//P is symmetric, so phi'.P == (P.phi)'
+			vvP[r][c] = (vvP[r][c] - vP_phi[r] * vP_phi[c] / denominator) / forgetting_factor;
+		}
+	}
+
+	//guard against covariance wind-up when hints are not persistently exciting
+	for(int r=0; r<n; r++) {
+		if(vvP[r][r] > initial_covariance) {
+			double ratio = initial_covariance / vvP[r][r];
+			for(int c=0; c<n; c++) {
+				vvP[r][c] *= ratio;
+				vvP[c][r] *= ratio;
+			}
+		}
+	}
+
+	sample_count++;
+
+	if(vNominal_hints.size() == 0)
+		vNominal_hints = vHints;
+	else {
+		for(int j=0; j<num_hints; j++)
+			vNominal_hints[j] = vNominal_hints[j] * (1.0 - nominal_hints_rate) + vHints[j] * nominal_hints_rate;
+	}
+}
+
+ExecTime_t WorkloadHintRegression::predict(
+	const std::vector<double>& vHints,
+	const std::vector<double>& vDecisionValues
+) const
+{
+	if(vTheta.size() == 0 || dimensions_match(vHints, vDecisionValues) == false)
+		return 0.0;
+
+	std::vector<double> vPhi;
+	construct_features(vHints, vDecisionValues, vPhi);
+
+	ExecTime_t prediction = 0.0;
+	for(int r=0; r<(int)vPhi.size(); r++)
+		prediction += vTheta[r] * vPhi[r];
+	return prediction;
+}
+
+ExecTime_t WorkloadHintRegression::predict_deviation_from_nominal(
+	const std::vector<double>& vHints,
+	const std::vector<double>& vDecisionValues
+) const
+{
+	if(is_trained() == false || dimensions_match(vHints, vDecisionValues) == false)
+		return 0.0;
+
+	return predict(vHints, vDecisionValues) - predict(vNominal_hints, vDecisionValues);
+}
+
+std::string WorkloadHintRegression::print_string() const {
+	std::ostringstream oss;
+	oss << "num_hints = " << num_hints << " num_decision_vars = " << num_decision_vars
+		<< " sample_count = " << sample_count << " is_trained = " << is_trained()
+		<< " vTheta = " << vTheta << " vNominal_hints = " << vNominal_hints;
+	return oss.str();
+}
+
+void WorkloadHintRegression::save_snapshot(SnapshotWriter& writer) const {
+	writer.put_i64(num_hints);
+	writer.put_i64(num_decision_vars);
+	writer.put_vector(vTheta);
+	writer.put_i64((long long)vvP.size());
+	for(int i=0; i<(int)vvP.size(); i++)
+		writer.put_vector(vvP[i]);
+	writer.put_i64(sample_count);
+	writer.put_vector(vNominal_hints);
+}
+
+bool WorkloadHintRegression::load_snapshot(SnapshotReader& reader) {
+	reader.get_int(num_hints);
+	reader.get_int(num_decision_vars);
+	reader.get_vector(vTheta);
+	long long num_rows = 0;
+	if(reader.get_length(num_rows, sizeof(long long)) == false)
+		return false;
+	vvP.resize((size_t)num_rows);
+	for(int i=0; i<(int)num_rows && reader.ok(); i++)
+		reader.get_vector(vvP[i]);
+	reader.get_i64(sample_count);
+	reader.get_vector(vNominal_hints);
+	if(reader.ok() == false)
+		return false;
+
+	if(num_hints < 0 || num_decision_vars < 0)
+		return false;
+	if(vTheta.size() == 0 && vvP.size() == 0 && sample_count == 0) //never initialized
+		return true;
+	if((int)vTheta.size() != get_num_features() || (int)vvP.size() != get_num_features())
+		return false;
+	for(int i=0; i<(int)vvP.size(); i++) {
+		if((int)vvP[i].size() != get_num_features())
+			return false;
+	}
+	return true;
+}
+
+} //namespace Opp
@@ -0,0 +1,123 @@
+// Copyright 2011, Tushar Kumar, Georgia Institute of Technology, under the 3-clause BSD license
+//
+// Author: Tushar Kumar, tushardeveloper@gmail.com
+
+#ifndef OPP_WORKLOAD_HINTS_H
+#define OPP_WORKLOAD_HINTS_H
+
+#include <vector>
+#include <string>
+
+#include "opp.h"
+
+namespace Opp {
+
+	class SnapshotWriter;
+	class SnapshotReader;
+
+	/////////////////////////////////
+	// Feed-forward Workload Hints
+	/////////////////////////////////
+
+	// The application may attach numeric hints to a Frame before the ExecFrames within it
+	//   are run (e.g., picture-type, motion magnitude, number of tracked objects).
+	//
+	// WorkloadHintRegression learns, online, a linear model of the frame's (rescaled) execution-time
+	//   in terms of the hints, the decision values taken for the invocation and their products:
+	//
+	//     Y = t0 + sum_j(th_j * h_j) + sum_i(tx_i * x_i) + sum_j,i(thx_ji * h_j * x_i)
+	//
+	// using Recursive Least Squares with exponential forgetting. The Fast Reaction Strategy
+	//   uses the model to anticipate the deviation in Y caused by the upcoming invocation's hints
+	//   relative to the nominal (recently typical) hints, and applies a feed-forward correction
+	//   to the decision values before the invocation is run.
+
+	class WorkloadHintRegression {
+	public:
+		static const int min_samples_per_feature = 2;
+			//model is used for prediction only after these many samples per regression feature
+
+		static const double forgetting_factor;
+			//RLS forgetting factor lambda, (0.0, 1.0]
+
+		static const double initial_covariance;
+			//diagonal of initial RLS covariance matrix (large => uninformative prior)
+
+		static const double nominal_hints_rate;
+			//EWMA rate with which vNominal_hints tracks the hints observed
+
+	private:
+		int num_hints;
+		int num_decision_vars;
+
+		std::vector<double> vTheta;
+			//regression coefficients
+		std::vector< std::vector<double> > vvP;
+			//RLS inverse-correlation (covariance) matrix
+
+		long long sample_count;
+
+		std::vector<double> vNominal_hints;
+			//exponentially weighted moving average of hints noted so far
+
+	public:
+		WorkloadHintRegression()
+			: num_hints(0), num_decision_vars(0), sample_count(0) { }
+
+		void initialize(int num_hints, int num_decision_vars);
+			//discards all learned state
+
+		int get_num_features() const
+			{ return 1 + num_hints + num_decision_vars + num_hints * num_decision_vars; }
+
+		long long get_sample_count() const
+			{ return sample_count; }
+
+		const std::vector<double>& get_nominal_hints() const
+			{ return vNominal_hints; }
+
+		bool is_trained() const
+			{ return sample_count >= (long long)min_samples_per_feature * get_num_features(); }
+
+		void note_invocation(
+			const std::vector<double>& vHints,
+			const std::vector<double>& vDecisionValues,
+			ExecTime_t exec_time
+		);
+		//Updates model with the hints and decision values (double-valued, as used by the
+		//  Fast Reaction Strategy) that resulted in exec_time for one invocation.
+		//Re-initializes the model if the number of hints or decision values has changed.
+
+		ExecTime_t predict(
+			const std::vector<double>& vHints,
+			const std::vector<double>& vDecisionValues
+		) const;
+		//Returns 0.0 if dimensions don't match the model
+
+		ExecTime_t predict_deviation_from_nominal(
+			const std::vector<double>& vHints,
+			const std::vector<double>& vDecisionValues
+		) const;
+		//Returns anticipated change in execution-time due to vHints differing from the nominal hints,
+		//  for the same decision values. Returns 0.0 if model is not yet trained.
+
+		std::string print_string() const;
+
+		void save_snapshot(SnapshotWriter& writer) const;
+		bool load_snapshot(SnapshotReader& reader);
+			//restores state written by save_snapshot(), returns false if malformed
+
+	private:
+		bool dimensions_match(const std::vector<double>& vHints, const std::vector<double>& vDecisionValues) const
+			{ return ((int)vHints.size() == num_hints && (int)vDecisionValues.size() == num_decision_vars); }
+
+		void construct_features(
+			const std::vector<double>& vHints,
+			const std::vector<double>& vDecisionValues,
+			std::vector<double>& result_vFeatures
+		) const;
+	};
+
+} //namespace Opp
+
+#endif //OPP_WORKLOAD_HINTS_H